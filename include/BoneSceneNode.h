@@ -32,6 +32,7 @@ public:
 
 	//! Some file formats alternatively let bones specify a transformation matrix.
 	//! If this is set, it overrides the TRS properties.
+	//! Call setRelativeTransformationDirty() after changing it.
 	std::optional<core::matrix4> Matrix;
 
 	BoneSceneNode(ISceneNode *parent,
@@ -70,6 +71,7 @@ public:
 	void setRotation(const core::vector3df &rotation) override
 	{
 		Rotation = core::quaternion(rotation * core::DEGTORAD).makeInverse();
+		setRelativeTransformationDirty();
 	}
 
 	core::vector3df getRotation() const override
@@ -86,6 +88,7 @@ public:
 		setPosition(transform.translation);
 		Rotation = transform.rotation;
 		setScale(transform.scale);
+		setRelativeTransformationDirty();
 	}
 
 	core::Transform getTransform() const
@@ -0,0 +1,39 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IrrCompileConfig.h" // for IRRLICHT_API
+#include "aabbox3d.h"
+#include "matrix4.h"
+
+namespace irr
+{
+namespace core
+{
+
+//! Bounding box of many positions, using SIMD where the CPU has it.
+/** Gives exactly the same box as aabbox3d::reset() with the first position
+followed by addInternalPoint() with all others.
+\param positions First position, e.g. the Pos member of the first vertex.
+\param count Number of positions.
+\param stride Bytes from one position to the next, e.g. the vertex size.
+\return Bounding box, or a box at the origin if count is 0. */
+IRRLICHT_API aabbox3df getBoundingBox(const vector3df *positions, u32 count,
+		u32 stride = sizeof(vector3df));
+
+//! Transforms each box by its own matrix, using SIMD where the CPU has it.
+/** Gives exactly the same boxes as matrix4::transformBoxEx().
+\param matrices One matrix per box.
+\param in Boxes to transform.
+\param out Receives the transformed boxes, may be the same array as in.
+\param count Number of boxes. */
+IRRLICHT_API void transformBoxes(const matrix4 *matrices, const aabbox3df *in,
+		aabbox3df *out, u32 count);
+
+//! Transforms all boxes by the same matrix, see transformBoxes().
+IRRLICHT_API void transformBoxes(const matrix4 &matrix, const aabbox3df *in,
+		aabbox3df *out, u32 count);
+
+} // end namespace core
+} // end namespace irr
@@ -146,6 +146,13 @@ public:
 protected:
 	//! Breaks the single text line.
 	void breakText();
+	//! Breaks only the paragraphs touched since the last break, see markTextChanged()
+	void breakChangedText();
+	//! Breaks the text from begin to end into lines, appending them to the arrays
+	void breakTextRange(s32 begin, s32 end, core::array<core::stringw> &lines,
+			core::array<s32> &positions, core::array<core::dimension2du> &sizes);
+	//! Remembers that the text from begin was replaced by the characters up to newEnd
+	void markTextChanged(s32 begin, s32 newEnd);
 	//! sets the area of the given line
 	void setTextRect(s32 line);
 	//! returns the line number that the cursor is on
@@ -217,6 +224,11 @@ protected:
 
 	core::array<core::stringw> BrokenText;
 	core::array<s32> BrokenTextPositions;
+	//! font dimension of each broken line
+	core::array<core::dimension2du> BrokenTextSizes;
+	//! text size when it was broken, and the part changed since then
+	s32 BrokenTextLength = 0;
+	s32 ChangedBegin = -1, ChangedTail = 0;
 
 	core::rect<s32> CurrentTextRect, FrameRect; // temporary values
 };
@@ -56,6 +56,8 @@ public:
 
 //! Standard 16-bit buffer
 typedef CIndexBuffer<u16> SIndexBuffer;
+//! 32-bit buffer, for meshbuffers with more than 65536 vertices
+typedef CIndexBuffer<u32> SIndexBuffer32;
 
 } // end namespace scene
 } // end namespace irr
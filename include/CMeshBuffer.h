@@ -8,13 +8,16 @@
 #include "IMeshBuffer.h"
 #include "CVertexBuffer.h"
 #include "CIndexBuffer.h"
+#include "BoundingBoxes.h"
 
 namespace irr
 {
 namespace scene
 {
 //! Template implementation of the IMeshBuffer interface
-template <class T>
+/** \tparam T Vertex type
+\tparam TIndex Index type, u16 or u32 */
+template <class T, class TIndex = u16>
 class CMeshBuffer final : public IMeshBuffer
 {
 public:
@@ -23,7 +26,7 @@ public:
 			PrimitiveType(EPT_TRIANGLES)
 	{
 		Vertices = new CVertexBuffer<T>();
-		Indices = new SIndexBuffer();
+		Indices = new CIndexBuffer<TIndex>();
 	}
 
 	~CMeshBuffer()
@@ -85,12 +88,9 @@ public:
 	/** should be called if the mesh changed. */
 	void recalculateBoundingBox() override
 	{
-		if (Vertices->getCount()) {
-			BoundingBox.reset(Vertices->getPosition(0));
-			const u32 vsize = Vertices->getCount();
-			for (u32 i = 1; i < vsize; ++i)
-				BoundingBox.addInternalPoint(Vertices->getPosition(i));
-		} else
+		if (Vertices->getCount())
+			BoundingBox = core::getBoundingBox(&Vertices->Data[0].Pos, Vertices->getCount(), sizeof(T));
+		else
 			BoundingBox.reset(0, 0, 0);
 	}
 
@@ -132,7 +132,7 @@ public:
 	//! Vertex buffer
 	CVertexBuffer<T> *Vertices;
 	//! Index buffer
-	SIndexBuffer *Indices;
+	CIndexBuffer<TIndex> *Indices;
 	//! Bounding box of this meshbuffer.
 	core::aabbox3d<f32> BoundingBox{{0, 0, 0}};
 	//! Primitive type used for rendering (triangles, lines, ...)
@@ -145,5 +145,30 @@ typedef CMeshBuffer<video::S3DVertex> SMeshBuffer;
 typedef CMeshBuffer<video::S3DVertex2TCoords> SMeshBufferLightMap;
 //! Meshbuffer with vertices having tangents stored, e.g. for normal mapping
 typedef CMeshBuffer<video::S3DVertexTangents> SMeshBufferTangents;
+//! Standard meshbuffer with 32-bit indices
+typedef CMeshBuffer<video::S3DVertex, u32> SMeshBuffer32;
+//! Meshbuffer with two texture coords per vertex and 32-bit indices
+typedef CMeshBuffer<video::S3DVertex2TCoords, u32> SMeshBufferLightMap32;
+//! Meshbuffer with tangents per vertex and 32-bit indices
+typedef CMeshBuffer<video::S3DVertexTangents, u32> SMeshBufferTangents32;
+
+//! Creates a meshbuffer holding the given vertices and triangle indices
+/** 16-bit indices are used when they can address all vertices, 32-bit
+ones otherwise. The indices are not checked.
+\return The new meshbuffer. Drop it when you no longer need it. */
+template <class T>
+IMeshBuffer *createMeshBuffer(std::vector<T> &&vertices, std::vector<u32> &&indices)
+{
+	if (vertices.size() <= 65536) {
+		auto *buffer = new CMeshBuffer<T, u16>();
+		buffer->Vertices->Data = std::move(vertices);
+		buffer->Indices->Data.assign(indices.begin(), indices.end());
+		return buffer;
+	}
+	auto *buffer = new CMeshBuffer<T, u32>();
+	buffer->Vertices->Data = std::move(vertices);
+	buffer->Indices->Data = std::move(indices);
+	return buffer;
+}
 } // end namespace scene
 } // end namespace irr
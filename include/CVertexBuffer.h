@@ -10,6 +10,7 @@
 #include "HWBuffer.h"
 #include "IVertexBuffer.h"
 #include "WeightBuffer.h"
+#include "QuantizedVertexBuffer.h"
 #include "irrPtr.h"
 
 namespace irr
@@ -98,12 +99,20 @@ struct CVertexBuffer final : public IVertexBuffer
 		Weights->updateStaticPose(this);
 	}
 
+	const QuantizedVertexBuffer *getQuantizedBuffer() const override
+	{
+		return Quantized.get();
+	}
+
 	//! Vertices of this buffer
 	std::vector<T> Data;
 
 	//! Optional weights for skinning
 	irr_ptr<WeightBuffer> Weights;
 	bool UseSwSkinning = false;
+
+	//! Optional compact copy for drawing
+	irr_ptr<QuantizedVertexBuffer> Quantized;
 };
 
 //! Standard buffer
@@ -140,6 +140,9 @@ enum E_VIDEO_DRIVER_FEATURE
 	// (This refers to at least ECF_R16F, ECF_R32F, ECF_A16B16G16R16F and ECF_A32B32G32R32F)
 	EVDF_RENDER_TO_FLOAT_TEXTURE,
 
+	//! Support for 32-bit indices, so meshbuffers can have more than 65536 vertices.
+	EVDF_32BIT_INDICES,
+
 	//! Only used for counting the elements of this enum
 	EVDF_COUNT
 };
@@ -57,6 +57,9 @@ enum EGUI_ELEMENT_TYPE
 	//! A tool bar (IGUIToolBar)
 	EGUIET_TOOL_BAR,
 
+	//! An element keeping the drawing of its children (IGUIRenderCache)
+	EGUIET_RENDER_CACHE,
+
 	//! Unknown type.
 	EGUIET_ELEMENT,
 
@@ -15,6 +15,7 @@ struct IRRLICHT_API HWBuffer : public virtual IReferenceCounted {
 		VERTEX,
 		INDEX,
 		WEIGHT,
+		QUANTIZED_VERTEX,
 	};
 	/// Type of the buffer for faster type checks than dynamic_cast
 	virtual Type getBufferType() const = 0;
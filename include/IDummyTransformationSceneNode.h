@@ -28,7 +28,8 @@ public:
 
 	//! Returns a reference to the current relative transformation matrix.
 	/** This is the matrix, this scene node uses instead of scale, translation
-	and rotation. */
+	and rotation. When changing it through a reference kept from an earlier
+	call, call setRelativeTransformationDirty(). */
 	virtual core::matrix4 &getRelativeTransformationMatrix() = 0;
 };
 
@@ -12,6 +12,7 @@
 #include "EGUIAlignment.h"
 #include <cassert>
 #include <list>
+#include <memory>
 #include <vector>
 
 namespace irr
@@ -33,7 +34,8 @@ public:
 			MaxSize(0, 0), MinSize(1, 1), IsVisible(true), IsEnabled(true),
 			IsSubElement(false), NoClip(false), ID(id), IsTabStop(false), TabOrder(-1), IsTabGroup(false),
 			AlignLeft(EGUIA_UPPERLEFT), AlignRight(EGUIA_UPPERLEFT), AlignTop(EGUIA_UPPERLEFT), AlignBottom(EGUIA_UPPERLEFT),
-			Environment(environment), Type(type)
+			Environment(environment), Type(type), SubtreeClippingRect(rectangle), SubtreeClippingRectDirty(true),
+			HitTestGridDirty(true)
 	{
 		// if we were given a parent to attach to
 		if (parent) {
@@ -238,9 +240,17 @@ public:
 	*/
 	virtual IGUIElement *getElementFromPoint(const core::position2d<s32> &point)
 	{
+		// neither this element nor its descendants reach outside of it
+		if (!isVisible() || !getSubtreeClippingRect().isPointInside(point))
+			return 0;
+
 		IGUIElement *target = 0;
 
-		if (isVisible()) {
+		if (HitTestGrid) {
+			target = getChildFromHitTestGrid(point);
+			if (target)
+				return target;
+		} else {
 			// we have to search from back to front, because later children
 			// might be drawn over the top of earlier ones.
 			auto it = Children.rbegin();
@@ -254,19 +264,66 @@ public:
 			}
 		}
 
-		if (isVisible() && isPointInside(point))
+		if (isPointInside(point))
 			target = this;
 
 		return target;
 	}
 
 	//! Returns true if a point is within this element.
-	/** Elements with a shape other than a rectangle should override this method */
+	/** Elements with a shape other than a rectangle should override this method.
+	getElementFromPoint() only asks for points within the clipping rectangle
+	of the element or of one of its descendants. */
 	virtual bool isPointInside(const core::position2d<s32> &point) const
 	{
 		return AbsoluteClippingRect.isPointInside(point);
 	}
 
+	//! Returns the rectangle around the clipping rectangles of this element and all its descendants.
+	/** Invisible elements are included. The rectangle is recalculated when
+	it is asked for after a descendant moved, or was added or removed. */
+	const core::rect<s32> &getSubtreeClippingRect() const
+	{
+		if (SubtreeClippingRectDirty) {
+			SubtreeClippingRect = AbsoluteClippingRect;
+			for (auto child : Children) {
+				const core::rect<s32> &r = child->getSubtreeClippingRect();
+				if (!r.isValid())
+					continue;
+				if (!SubtreeClippingRect.isValid()) {
+					SubtreeClippingRect = r;
+				} else {
+					SubtreeClippingRect.addInternalPoint(r.UpperLeftCorner);
+					SubtreeClippingRect.addInternalPoint(r.LowerRightCorner);
+				}
+			}
+			SubtreeClippingRectDirty = false;
+		}
+		return SubtreeClippingRect;
+	}
+
+	//! Sets whether to sort the children into a grid to find them at a point faster.
+	/** Without the grid, getElementFromPoint() asks each child in turn,
+	which gets slow for an element with thousands of children, e.g. a big
+	panel or the root element of a large GUI. The grid is rebuilt at the
+	next search after the layout of the children changed, so it does not
+	suit elements whose children move all the time. */
+	void setHitTestGridEnabled(bool enable)
+	{
+		if (enable && !HitTestGrid) {
+			HitTestGrid.reset(new SHitTestGrid());
+			HitTestGridDirty = true;
+		} else if (!enable) {
+			HitTestGrid.reset();
+		}
+	}
+
+	//! Returns whether the children are sorted into a grid to find them at a point faster.
+	bool isHitTestGridEnabled() const
+	{
+		return HitTestGrid != nullptr;
+	}
+
 	//! Adds a GUI element as new child of this element.
 	virtual void addChild(IGUIElement *child)
 	{
@@ -282,6 +339,7 @@ public:
 		assert(child->Parent == this);
 		Children.erase(child->ParentPos);
 		child->Parent = nullptr;
+		invalidateSubtreeClippingRect();
 		child->drop();
 	}
 
@@ -506,6 +564,7 @@ public:
 			return true;
 		Children.erase(child->ParentPos);
 		child->ParentPos = Children.insert(Children.end(), child);
+		HitTestGridDirty = true;
 		return true;
 	}
 
@@ -519,6 +578,7 @@ public:
 			return true;
 		Children.erase(child->ParentPos);
 		child->ParentPos = Children.insert(Children.begin(), child);
+		HitTestGridDirty = true;
 		return true;
 	}
 
@@ -699,6 +759,7 @@ protected:
 			child->LastParentRect = getAbsolutePosition();
 			child->Parent = this;
 			child->ParentPos = Children.insert(Children.end(), child);
+			invalidateSubtreeClippingRect();
 		}
 	}
 
@@ -729,6 +790,7 @@ protected:
 			++from;
 		}
 		assert(from == to);
+		HitTestGridDirty = true;
 	}
 
 	// not virtual because needed in constructor
@@ -842,6 +904,8 @@ protected:
 
 		LastParentRect = parentAbsolute;
 
+		invalidateSubtreeClippingRect();
+
 		if (recursive) {
 			// update all children
 			for (auto child : Children) {
@@ -850,6 +914,85 @@ protected:
 		}
 	}
 
+	//! marks the subtree rectangles of this element and its ancestors for recalculation
+	void invalidateSubtreeClippingRect()
+	{
+		// a dirty element has dirty ancestors, so stop at the first one
+		for (IGUIElement *e = this; e && !e->SubtreeClippingRectDirty; e = e->Parent) {
+			e->SubtreeClippingRectDirty = true;
+			e->HitTestGridDirty = true;
+		}
+	}
+
+	//! returns the topmost element of the children in the cell of a point
+	IGUIElement *getChildFromHitTestGrid(const core::position2d<s32> &point)
+	{
+		if (HitTestGridDirty)
+			rebuildHitTestGrid();
+
+		const SHitTestGrid &grid = *HitTestGrid;
+		if (!grid.Bounds.isPointInside(point))
+			return 0;
+
+		const u32 cell = (u32)((point.Y - grid.Bounds.UpperLeftCorner.Y) / grid.CellHeight * grid.Cells +
+								(point.X - grid.Bounds.UpperLeftCorner.X) / grid.CellWidth);
+		for (u32 i = grid.CellStart[cell + 1]; i > grid.CellStart[cell]; --i) {
+			IGUIElement *target = grid.Children[grid.Indices[i - 1]]->getElementFromPoint(point);
+			if (target)
+				return target;
+		}
+		return 0;
+	}
+
+	//! sorts the children into the cells of the grid they reach into
+	void rebuildHitTestGrid()
+	{
+		SHitTestGrid &grid = *HitTestGrid;
+		grid.Children.assign(Children.begin(), Children.end());
+		grid.Bounds = getSubtreeClippingRect();
+
+		// about two children per cell when they are spread evenly
+		s32 cells = 1;
+		while (cells < 256 && cells * cells * 2 < (s32)grid.Children.size())
+			++cells;
+		grid.Cells = cells;
+		// one more so that the lower right corner is still in the last cell
+		grid.CellWidth = core::max_(grid.Bounds.getWidth(), 0) / cells + 1;
+		grid.CellHeight = core::max_(grid.Bounds.getHeight(), 0) / cells + 1;
+
+		// count the children of each cell, sum the counts up to the end of
+		// each cell, then place the children from the end of the cells
+		grid.CellStart.assign(cells * cells + 1, 0);
+		for (int pass = 0; pass < 2; ++pass) {
+			if (pass == 1) {
+				for (u32 c = 1; c < grid.CellStart.size(); ++c)
+					grid.CellStart[c] += grid.CellStart[c - 1];
+				grid.Indices.resize(grid.CellStart.back());
+			}
+			for (u32 i = grid.Children.size(); i > 0; --i) {
+				const core::rect<s32> &r = grid.Children[i - 1]->getSubtreeClippingRect();
+				// empty ones still contain their corner, like in isPointInside()
+				if (!r.isValid())
+					continue;
+				const s32 x0 = core::max_(r.UpperLeftCorner.X - grid.Bounds.UpperLeftCorner.X, 0) / grid.CellWidth;
+				const s32 y0 = core::max_(r.UpperLeftCorner.Y - grid.Bounds.UpperLeftCorner.Y, 0) / grid.CellHeight;
+				const s32 x1 = core::min_((r.LowerRightCorner.X - grid.Bounds.UpperLeftCorner.X) / grid.CellWidth, cells - 1);
+				const s32 y1 = core::min_((r.LowerRightCorner.Y - grid.Bounds.UpperLeftCorner.Y) / grid.CellHeight, cells - 1);
+				for (s32 y = y0; y <= y1; ++y) {
+					for (s32 x = x0; x <= x1; ++x) {
+						// the last child first, so the children end up in
+						// drawing order and CellStart at the start of each cell
+						if (pass == 0)
+							++grid.CellStart[y * cells + x];
+						else
+							grid.Indices[--grid.CellStart[y * cells + x]] = i - 1;
+					}
+				}
+			}
+		}
+		HitTestGridDirty = false;
+	}
+
 protected:
 	//! List of all children of this element
 	std::list<IGUIElement *> Children;
@@ -923,6 +1066,24 @@ protected:
 
 	//! type of element
 	EGUI_ELEMENT_TYPE Type;
+
+private:
+	//! the children sorted into cells, see setHitTestGridEnabled()
+	struct SHitTestGrid
+	{
+		std::vector<IGUIElement *> Children;
+		//! indices into Children for each cell, from CellStart[cell] to CellStart[cell + 1]
+		std::vector<u32> Indices;
+		std::vector<u32> CellStart;
+		core::rect<s32> Bounds;
+		s32 Cells = 1;
+		s32 CellWidth = 1, CellHeight = 1;
+	};
+
+	mutable core::rect<s32> SubtreeClippingRect;
+	mutable bool SubtreeClippingRectDirty;
+	bool HitTestGridDirty;
+	std::unique_ptr<SHitTestGrid> HitTestGrid;
 };
 
 } // end namespace gui
@@ -31,6 +31,7 @@ namespace gui
 
 class IGUIElement;
 class IGUIFont;
+class IGUIFontDistanceField;
 class IGUISpriteBank;
 class IGUIScrollBar;
 class IGUIImage;
@@ -44,6 +45,7 @@ class IGUITabControl;
 class IGUITab;
 class IGUIComboBox;
 class IGUIButton;
+class IGUIRenderCache;
 
 //! GUI Environment. Used as factory and manager of all other GUI elements.
 /** \par This element can create the following events of type EGUI_EVENT_TYPE (which are passed on to focused sub-elements):
@@ -167,6 +169,20 @@ public:
 	more information. */
 	virtual IGUIFont *getFont(const io::path &filename) = 0;
 
+	//! Returns pointer to the distance field font made from the specified file.
+	/** Loads a bitmap font image like getFont() and turns it into a
+	signed distance field texture, which is drawn sharply at any size.
+	Use IGUIFontDistanceField::createSizedFont() for more sizes sharing
+	the texture. The font is stored under the filename like other fonts.
+	\param filename Filename of the bitmap font image. Larger characters
+	give more accurate outlines, the texture is scaled down to about 32
+	pixels per line.
+	\return Pointer to the font. Returns 0 if the font could not be
+	loaded or another type of font was stored under the name.
+	This pointer should not be dropped. See IReferenceCounted::drop() for
+	more information. */
+	virtual IGUIFontDistanceField *getDistanceFieldFont(const io::path &filename) = 0;
+
 	//! Adds an externally loaded font to the font list.
 	/** This method allows to attach an already loaded font to the list of
 	existing fonts. The font is grabbed if non-null and adding was successful.
@@ -376,6 +392,20 @@ public:
 	virtual IGUIComboBox *addComboBox(const core::rect<s32> &rectangle,
 			IGUIElement *parent = 0, s32 id = -1) = 0;
 
+	//! Adds an element which keeps the drawing of its children in a texture.
+	/** Add the elements which should be drawn from the texture as
+	children of it. See IGUIRenderCache for when they are drawn again.
+	\param rectangle Rectangle specifying the borders of the element, the
+	children are clipped to it.
+	\param parent Parent item of the element, e.g. a window.
+	Set it to 0 to place the element directly in the environment.
+	\param id An identifier for the element.
+	\return Pointer to the created element. Returns 0 if an
+	error occurred. This pointer should not be dropped. See
+	IReferenceCounted::drop() for more information. */
+	virtual IGUIRenderCache *addRenderCache(const core::rect<s32> &rectangle,
+			IGUIElement *parent = 0, s32 id = -1) = 0;
+
 	//! Find the next element which would be selected when pressing the tab-key
 	/** If you set the focus for the result you can manually force focus-changes like they
 	would happen otherwise by the tab-keys.
@@ -8,6 +8,7 @@
 #include "SColor.h"
 #include "rect.h"
 #include "irrString.h"
+#include "irrArray.h"
 
 namespace irr
 {
@@ -30,6 +31,10 @@ enum EGUI_FONT_TYPE
 	/** Currently not used. */
 	EGFT_OS,
 
+	//! Fonts drawn from one signed distance field texture at any size.
+	/** Made from a bitmap font image, see IGUIFontDistanceField. */
+	EGFT_DISTANCE_FIELD,
+
 	//! An external font type provided by the user.
 	EGFT_CUSTOM
 };
@@ -62,6 +67,34 @@ public:
 	is on this position. (=the text is too short). */
 	virtual s32 getCharacterFromPos(const wchar_t *text, s32 pixel_x) const = 0;
 
+	//! Calculates the x positions after each character of a text in one pass.
+	/** Lets word wrapping and cursor placement measure any part of a line
+	by a subtraction instead of measuring each part on its own.
+	\param text: Text string.
+	\param widths: Receives one value more than the text has characters.
+	widths[i] is the width of the first i characters of the line which
+	character i is in, so the width of the characters from a to b (excluding
+	b) of one line is widths[b] - widths[a]. It is 0 at the start of the
+	text and after each line break character.
+	The default implementation adds up the widths of the single characters,
+	fonts with kerning pairs should override it. */
+	virtual void getPrefixWidths(const wchar_t *text, core::array<s32> &widths) const
+	{
+		widths.set_used(0);
+		widths.push_back(0);
+		s32 x = 0;
+		wchar_t c[2] = {0, 0};
+		for (const wchar_t *p = text; *p; ++p) {
+			if (*p == L'\r' || *p == L'\n') {
+				x = 0;
+			} else {
+				c[0] = *p;
+				x += getDimension(c).Width;
+			}
+			widths.push_back(x);
+		}
+	}
+
 	//! Returns the type of this font
 	virtual EGUI_FONT_TYPE getType() const { return EGFT_CUSTOM; }
 
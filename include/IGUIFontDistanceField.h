@@ -0,0 +1,46 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IGUIFont.h"
+
+namespace irr
+{
+namespace video
+{
+class ITexture;
+}
+
+namespace gui
+{
+
+//! Font drawn from a signed distance field texture.
+/** The texture keeps the distance of each texel to the outline of the
+characters instead of their pixels, so the outlines stay sharp when the
+characters are scaled. All sizes share one texture, see createSizedFont().
+Drivers without a shader for distance fields draw blurry outlines. */
+class IGUIFontDistanceField : public IGUIFont
+{
+public:
+	//! Returns the type of this font
+	EGUI_FONT_TYPE getType() const override { return EGFT_DISTANCE_FIELD; }
+
+	//! Sets the height of a line of text in pixels
+	virtual void setLineHeight(f32 height) = 0;
+
+	//! Returns the height of a line of text in pixels
+	virtual f32 getLineHeight() const = 0;
+
+	//! Creates a font drawing the same characters at another size
+	/** It shares the texture with this font.
+	\param height Height of a line of text in pixels.
+	\return The new font. Drop it when it is not needed anymore. */
+	virtual IGUIFontDistanceField *createSizedFont(f32 height) const = 0;
+
+	//! Returns the texture holding the distance fields of all characters
+	virtual video::ITexture *getTexture() const = 0;
+};
+
+} // end namespace gui
+} // end namespace irr
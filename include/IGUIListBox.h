@@ -29,6 +29,37 @@ enum EGUI_LISTBOX_COLOR
 	EGUI_LBC_COUNT
 };
 
+//! Supplies the items of a list box which does not store them itself
+/** Set with IGUIListBox::setItemProvider(). The list box only asks for the
+items it draws or searches, so a list of very many items does not need all
+their strings in memory. */
+class IGUIListBoxItemProvider
+{
+public:
+	//! Destructor
+	virtual ~IGUIListBoxItemProvider() {}
+
+	//! Returns the number of items, which may change from frame to frame
+	virtual u32 getItemCount() const = 0;
+
+	//! Returns the text of an item
+	/** \param index Index of the item, less than getItemCount().
+	\return Text of the item, it has to stay valid until the next call. */
+	virtual const wchar_t *getItemText(u32 index) const = 0;
+
+	//! Returns the icon of an item
+	/** \return Sprite index in the sprite bank of the list box, or -1 for
+	no icon. */
+	virtual s32 getItemIcon(u32 index) const { return -1; }
+
+	//! Returns whether an item overrides a color of the list box
+	/** \param index Index of the item.
+	\param colorType Which color.
+	\param color Receives the color of the item if it is overridden.
+	\return True if the item uses its own color. */
+	virtual bool getItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType, video::SColor &color) const { return false; }
+};
+
 //! Default list box GUI element.
 /** \par This element can create the following events of type EGUI_EVENT_TYPE:
 \li EGET_LISTBOX_CHANGED
@@ -130,6 +161,17 @@ public:
 
 	//! Access the vertical scrollbar
 	virtual IGUIScrollBar *getVerticalScrollBar() const = 0;
+
+	//! Shows the items of a provider instead of the ones of the list box
+	/** The items of the list box are cleared, and adding, inserting,
+	changing, removing, swapping and coloring items does nothing while a
+	provider is set. Drawing asks the provider only for the visible items.
+	\param provider Provider of the items, which has to stay valid while it
+	is set. Set it to 0 to use the items of the list box again. */
+	virtual void setItemProvider(IGUIListBoxItemProvider *provider) = 0;
+
+	//! Returns the provider of the items, or 0 if the list box has its own
+	virtual IGUIListBoxItemProvider *getItemProvider() const = 0;
 };
 
 } // end namespace gui
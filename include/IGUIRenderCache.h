@@ -0,0 +1,47 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IGUIElement.h"
+
+namespace irr
+{
+namespace gui
+{
+
+//! Keeps the drawing of its children in a texture.
+/** Children added to this element are drawn into a render target texture,
+which is then drawn each frame instead of the children. The children are
+only drawn again when something changed: the position, size, visibility,
+enabled state or text of an element of the subtree, which of them is
+focused or hovered, or a key, text or mouse button event, a wheel turn
+or a drag was sent to one of them. Changes which are not seen from
+IGUIElement, like the state of a check box set by the application, need a
+call to invalidate().
+
+Use it for parts of the GUI which rarely change, like a form or the panels
+of a HUD, not for elements which animate on their own, like the cursor of a
+focused edit box. Drivers without render target textures or separate
+alpha blending, and sizes the driver cannot make a texture of, draw the
+children each frame.
+
+The texture covers the visible part of this element and holds
+premultiplied alpha, so translucent children look the same as when drawn
+directly. */
+class IGUIRenderCache : public IGUIElement
+{
+public:
+	//! constructor
+	IGUIRenderCache(IGUIEnvironment *environment, IGUIElement *parent, s32 id, core::rect<s32> rectangle) :
+			IGUIElement(EGUIET_RENDER_CACHE, environment, parent, id, rectangle) {}
+
+	//! Makes the next draw() draw the children into the texture again
+	virtual void invalidate() = 0;
+
+	//! Returns how often the children were drawn into the texture
+	virtual u32 getRenderCount() const = 0;
+};
+
+} // end namespace gui
+} // end namespace irr
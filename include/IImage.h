@@ -15,6 +15,22 @@ namespace irr
 namespace video
 {
 
+//! Filters for IImage::copyToResampled
+enum E_IMAGE_RESAMPLE_FILTER
+{
+	//! Takes the source pixel closest to the target pixel center
+	EIRF_NEAREST = 0,
+
+	//! Triangle filter, interpolates when enlarging and averages neighbours when shrinking
+	EIRF_BILINEAR,
+
+	//! Averages the source pixels covered by each target pixel
+	EIRF_BOX,
+
+	//! Windowed sinc with three lobes, sharpest result but may ring at hard edges
+	EIRF_LANCZOS3
+};
+
 //! Interface for software image data.
 /** Image loaders create these images from files. IVideoDrivers convert
 these images into their (hardware) textures.
@@ -25,7 +41,8 @@ class IImage : public virtual IReferenceCounted
 public:
 	//! constructor
 	IImage(ECOLOR_FORMAT format, const core::dimension2d<u32> &size, bool deleteMemory) :
-			Format(format), Size(size), Data(0), BytesPerPixel(0), Pitch(0), DeleteMemory(deleteMemory)
+			Format(format), Size(size), Data(0), MipMapsData(0), MipMapLevels(0),
+			BytesPerPixel(0), Pitch(0), DeleteMemory(deleteMemory)
 	{
 		BytesPerPixel = getBitsPerPixelFromFormat(Format) / 8;
 		Pitch = BytesPerPixel * Size.Width;
@@ -36,6 +53,7 @@ public:
 	{
 		if (DeleteMemory)
 			delete[] Data;
+		delete[] MipMapsData;
 	}
 
 	//! Returns the color format
@@ -158,6 +176,46 @@ public:
 		return Data;
 	}
 
+	//! Returns the number of mipmap levels stored behind the image data.
+	/** Only images loaded together with their mipmaps, like block compressed
+	textures, store further levels. */
+	u32 getMipMapLevelCount() const
+	{
+		return MipMapLevels;
+	}
+
+	//! Returns the data of a stored mipmap level.
+	/** Level 0 is the image itself, see getData().
+	\return Pointer to the level data, or 0 if the level isn't stored. */
+	void *getMipMapsData(u32 mipmapLevel) const
+	{
+		if (mipmapLevel == 0)
+			return Data;
+		if (mipmapLevel > MipMapLevels)
+			return 0;
+
+		u32 offset = 0;
+		for (u32 i = 1; i < mipmapLevel; ++i) {
+			const core::dimension2du levelSize = getMipMapsSize(i);
+			offset += getDataSizeFromFormat(Format, levelSize.Width, levelSize.Height);
+		}
+		return MipMapsData + offset;
+	}
+
+	//! Takes over a chain of mipmap levels for this image.
+	/** The levels follow each other in the memory block, starting with
+	level 1 and halving the size each time.
+	\param data Memory allocated with new[], owned by the image afterwards,
+	or 0 to remove the stored levels.
+	\param levels Number of levels in data. */
+	void setMipMapsData(u8 *data, u32 levels)
+	{
+		if (data != MipMapsData)
+			delete[] MipMapsData;
+		MipMapsData = data;
+		MipMapLevels = data ? levels : 0;
+	}
+
 	//! Get the mipmap size for this image for a certain mipmap level
 	/** level 0 will be full image size. Every further level is half the size.
 		Doesn't care if the image actually has mipmaps, just which size would be needed. */
@@ -211,6 +269,17 @@ public:
 	//! copies this surface into another, scaling it to fit, applying a box filter
 	virtual void copyToScalingBoxFilter(IImage *target, s32 bias = 0, bool blend = false) = 0;
 
+	//! Copies the image into the target, resampling it to fit with the given filter.
+	/** Unlike copyToScaling, pixel centers of source and target are aligned and
+	filtering works on whole scanlines, using several threads for large images.
+	Filtering supports the formats convertible to ECF_A8R8G8B8,
+	EIRF_NEAREST also any uncompressed format when both formats are equal.
+	\param target Image to write to, its size defines the scale.
+	\param filter Resampling filter to apply.
+	\param threads Maximum number of threads to use, 0 for one per CPU core.
+	\return False if the formats are not supported. */
+	virtual bool copyToResampled(IImage *target, E_IMAGE_RESAMPLE_FILTER filter, u32 threads = 0) = 0;
+
 	//! fills the surface with given color
 	virtual void fill(const SColor &color) = 0;
 
@@ -256,6 +325,38 @@ public:
 			return 64;
 		case ECF_A32B32G32R32F:
 			return 128;
+		case ECF_DXT1:
+		case ECF_BC4:
+		case ECF_ETC2_RGB:
+			return 4;
+		case ECF_DXT3:
+		case ECF_DXT5:
+		case ECF_BC5:
+		case ECF_BC7:
+		case ECF_ETC2_ARGB:
+		case ECF_ASTC_4x4:
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	//! get the size in bytes of one 4x4 block of a compressed color format
+	/** \return Block size, or 0 if the format is not compressed. */
+	static u32 getBlockSizeFromFormat(const ECOLOR_FORMAT format)
+	{
+		switch (format) {
+		case ECF_DXT1:
+		case ECF_BC4:
+		case ECF_ETC2_RGB:
+			return 8;
+		case ECF_DXT3:
+		case ECF_DXT5:
+		case ECF_BC5:
+		case ECF_BC7:
+		case ECF_ETC2_ARGB:
+		case ECF_ASTC_4x4:
+			return 16;
 		default:
 			return 0;
 		}
@@ -264,6 +365,11 @@ public:
 	//! calculate image data size in bytes for selected format, width and height.
 	static u32 getDataSizeFromFormat(ECOLOR_FORMAT format, u32 width, u32 height)
 	{
+		// compressed formats store whole blocks, also for the smallest mipmaps
+		const u32 blockSize = getBlockSizeFromFormat(format);
+		if (blockSize)
+			return ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+
 		// non-compressed formats
 		u32 imageSize = getBitsPerPixelFromFormat(format) / 8 * width;
 		imageSize *= height;
@@ -274,7 +380,7 @@ public:
 	//! check if this is compressed color format
 	static bool isCompressedFormat(const ECOLOR_FORMAT format)
 	{
-		return false;
+		return getBlockSizeFromFormat(format) != 0;
 	}
 
 	//! check if the color format is only viable for depth/stencil textures
@@ -316,6 +422,8 @@ protected:
 	core::dimension2d<u32> Size;
 
 	u8 *Data;
+	u8 *MipMapsData;
+	u32 MipMapLevels;
 
 	u32 BytesPerPixel;
 	u32 Pitch;
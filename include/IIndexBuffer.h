@@ -34,6 +34,14 @@ public:
 	/** \return Number of indices in this buffer. */
 	virtual u32 getCount() const = 0;
 
+	//! Get the index at the given position, whatever the index type.
+	u32 getIndex(u32 i) const
+	{
+		if (getType() == video::EIT_16BIT)
+			return static_cast<const u16 *>(getData())[i];
+		return static_cast<const u32 *>(getData())[i];
+	}
+
 	//! Calculate how many geometric primitives would be drawn
 	u32 getPrimitiveCount(E_PRIMITIVE_TYPE primitiveType) const
 	{
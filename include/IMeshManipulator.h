@@ -10,6 +10,7 @@
 #include "IAnimatedMesh.h"
 #include "IMeshBuffer.h"
 #include "SVertexManipulator.h"
+#include <vector>
 
 namespace irr
 {
@@ -18,6 +19,43 @@ namespace scene
 
 struct SMesh;
 
+//! Result of simulating a post transform vertex cache on a triangle list
+struct SVertexCacheStatistics
+{
+	SVertexCacheStatistics() :
+			Transformed(0), ACMR(0.f), ATVR(0.f) {}
+
+	//! Number of vertices that had to be transformed
+	u32 Transformed;
+	//! Average cache miss ratio, transformed vertices per triangle
+	/** 3 if no vertex is reused, about 0.5 is the best possible for large meshes. */
+	f32 ACMR;
+	//! Average transform to vertex ratio, transformed vertices per used vertex
+	/** 1 is the best possible. */
+	f32 ATVR;
+};
+
+//! Range of a triangle list with the data to cull it
+/** See IMeshManipulator::buildClusters(). */
+struct SMeshCluster
+{
+	//! First index of the cluster in the index buffer
+	u32 FirstIndex;
+	//! Number of indices of the cluster
+	u32 IndexCount;
+	//! Center of the bounding sphere
+	core::vector3df Center;
+	//! Radius of the bounding sphere
+	f32 Radius;
+	//! Average direction of the triangle normals
+	core::vector3df ConeAxis;
+	//! Sine of the angle between the axis and the normal furthest from it
+	/** The cluster is facing away from a camera at position p if
+	(Center - p).dotProduct(ConeAxis) >= ConeCutoff * (Center - p).getLength() + Radius.
+	1 if the normals spread over more than a half sphere. */
+	f32 ConeCutoff;
+};
+
 //! An interface for easy manipulation of meshes.
 /** Scale, set alpha value, flip surfaces, and so on. This exists for
 fixing problems with wrong imported or exported meshes quickly after
@@ -41,6 +79,27 @@ public:
 	virtual void recalculateNormals(IMeshBuffer *buffer,
 			bool smooth = false, bool angleWeighted = false) const = 0;
 
+	//! Recalculates tangents and binormals of all mesh buffers with tangent vertices.
+	/** See recalculateTangents(IMeshBuffer*, bool, bool).
+	\param mesh: Mesh on which the operation is performed.
+	\param recalculateNormals: If smooth normals shall be calculated first.
+	\param angleWeighted: If these normals shall be smoothed in relation to their angles. */
+	virtual void recalculateTangents(IMesh *mesh, bool recalculateNormals = false,
+			bool angleWeighted = false) const = 0;
+
+	//! Recalculates tangents and binormals of a mesh buffer with tangent vertices.
+	/** The tangents are compatible with MikkTSpace for meshes which are
+	split at mirrored texture coordinates: they point along increasing U,
+	orthogonal to the vertex normal, and the triangles using a vertex are
+	weighted by their angle at it. Binormals point along decreasing V.
+	Buffers with other vertex types are not changed.
+	\param buffer: Mesh buffer on which the operation is performed.
+	\param recalculateNormals: If smooth normals shall be calculated first,
+	otherwise the tangents are made orthogonal to the current normals.
+	\param angleWeighted: If these normals shall be smoothed in relation to their angles. */
+	virtual void recalculateTangents(IMeshBuffer *buffer, bool recalculateNormals = false,
+			bool angleWeighted = false) const = 0;
+
 	//! Scales the actual mesh, not a scene node.
 	/** \param mesh Mesh on which the operation is performed.
 	\param factor Scale factor for each axis. */
@@ -58,14 +117,136 @@ public:
 	}
 
 	//! Clones a static IMesh into a modifiable SMesh.
-	/** All meshbuffers in the returned SMesh
-	are of type SMeshBuffer or SMeshBufferLightMap.
+	/** All meshbuffers in the returned SMesh are of type SMeshBuffer,
+	SMeshBufferLightMap or SMeshBufferTangents, or their 32-bit index
+	variants.
 	\param mesh Mesh to copy.
 	\return Cloned mesh. If you no longer need the
 	cloned mesh, you should call SMesh::drop(). See
 	IReferenceCounted::drop() for more information. */
 	virtual SMesh *createMeshCopy(IMesh *mesh) const = 0;
 
+	//! Merges mesh buffers which can be drawn together to reduce draw calls.
+	/** Mesh buffers of triangles with the same vertex type, material and
+	texture slot are joined into one, which takes the place of the first of
+	them. Merged buffers get 16-bit indices if these can address all their
+	vertices, 32-bit ones otherwise. Buffers with skinning weights are left
+	alone, compact vertex copies made by quantizeVertices() are not kept.
+	\param mesh Mesh on which the operation is performed.
+	\param allow32BitIndices Whether merged buffers may have more than 65536
+	vertices, pass IVideoDriver::queryFeature(video::EVDF_32BIT_INDICES).
+	\param ignoreTextureSlots Also merge buffers of different texture slots,
+	the merged buffer gets the slot of the first one. Every buffer of a loaded
+	mesh has its own slot, so use this unless textures are set per slot.
+	\return Number of mesh buffers removed from the mesh. */
+	virtual u32 mergeMeshBuffers(SMesh *mesh, bool allow32BitIndices,
+			bool ignoreTextureSlots = false) const = 0;
+
+	//! Reduces the triangles of a mesh buffer, keeping its vertices as they are.
+	/** Collapses edges in the order of their quadric error. A collapse moves
+	a vertex onto a neighbour, so vertices only drop out of the triangles and
+	their attributes stay valid, which also keeps skinned mesh buffers usable
+	with their weights. Vertices on UV seams, hard edges and open borders are
+	never removed. Only EPT_TRIANGLES buffers are changed.
+	\param buffer Mesh buffer on which the operation is performed.
+	\param ratio Fraction of the triangles to keep.
+	\return Largest collapse error relative to the size of the bounding box. */
+	virtual f32 simplifyMeshBuffer(IMeshBuffer *buffer, f32 ratio) const = 0;
+
+	//! Creates a copy of a mesh with fewer triangles.
+	/** Like createMeshCopy(), then simplifyMeshBuffer() on every mesh buffer,
+	dropping the vertices which are no longer used.
+	\param mesh Mesh to copy.
+	\param ratio Fraction of the triangles to keep.
+	\param error Receives the largest error of the mesh buffers, see simplifyMeshBuffer().
+	\return Simplified mesh, drop it when no longer needed. */
+	virtual SMesh *createSimplifiedMesh(IMesh *mesh, f32 ratio, f32 *error = 0) const = 0;
+
+	//! Creates meshes with decreasing detail for IMeshSceneNode::setLODLevels().
+	/** \param mesh Mesh to simplify.
+	\param levels Number of meshes to create.
+	\param ratio Fraction of the triangles each level keeps of the previous one.
+	\param errors Receives the error of each level, see createSimplifiedMesh().
+	\return Meshes from the most to the least detailed, drop them when no longer needed. */
+	std::vector<SMesh *> createLODChain(IMesh *mesh, u32 levels, f32 ratio = 0.5f, std::vector<f32> *errors = 0) const
+	{
+		std::vector<SMesh *> chain;
+		f32 keep = 1.f;
+		for (u32 i = 0; i < levels; ++i) {
+			keep *= ratio;
+			f32 error = 0.f;
+			SMesh *lod = createSimplifiedMesh(mesh, keep, &error);
+			if (!lod)
+				break;
+			chain.push_back(lod);
+			if (errors)
+				errors->push_back(error);
+		}
+		return chain;
+	}
+
+	//! Reorders the triangles of a mesh buffer for the vertex cache of the GPU.
+	/** Uses Tom Forsyth's linear speed vertex cache optimisation, which works
+	well without knowing the cache size. Only EPT_TRIANGLES buffers are changed.
+	\param buffer Mesh buffer on which the operation is performed. */
+	virtual void optimizeVertexCache(IMeshBuffer *buffer) const = 0;
+
+	//! Reorders clusters of triangles of a mesh buffer to reduce overdraw.
+	/** Call it after optimizeVertexCache(). The triangle order is cut into
+	clusters, which are sorted so that clusters facing away from the mesh
+	center, likely occluders, are drawn first.
+	\param buffer Mesh buffer on which the operation is performed.
+	\param threshold How much the ACMR may grow by the cuts, 1.05 allows 5%. */
+	virtual void optimizeOverdraw(IMeshBuffer *buffer, f32 threshold = 1.05f) const = 0;
+
+	//! Reorders the vertices of a mesh buffer in the order they are first used.
+	/** Improves the locality of vertex fetches, call it after the triangle
+	order has been optimized. Do not use it on buffers of skinned meshes,
+	whose joints refer to vertices by index.
+	\param buffer Mesh buffer on which the operation is performed. */
+	virtual void optimizeVertexFetch(IMeshBuffer *buffer) const = 0;
+
+	//! Simulates a FIFO post transform vertex cache on a mesh buffer.
+	/** \param buffer Mesh buffer with EPT_TRIANGLES.
+	\param cacheSize Number of vertices the simulated cache holds.
+	\return Statistics, all zero if the buffer has no triangles. */
+	virtual SVertexCacheStatistics analyzeVertexCache(const IMeshBuffer *buffer, u32 cacheSize = 16) const = 0;
+
+	//! Splits the triangles of a mesh buffer into small clusters which can be culled on their own.
+	/** The triangles are reordered, so that each cluster is a contiguous
+	range of indices. Clusters are grown over neighbouring triangles, call
+	optimizeVertexCache() before to start them in a spatially coherent order.
+	\param buffer Mesh buffer with EPT_TRIANGLES.
+	\param clusters Receives the clusters in the order of their indices.
+	\param maxVertices Largest number of different vertices of a cluster.
+	\param maxTriangles Largest number of triangles of a cluster.
+	\return Number of clusters, 0 if the buffer has no triangles. */
+	virtual u32 buildClusters(IMeshBuffer *buffer, std::vector<SMeshCluster> &clusters,
+			u32 maxVertices = 64, u32 maxTriangles = 124) const = 0;
+
+	//! Creates a compact copy of the vertices of a mesh buffer for drawing.
+	/** Positions are stored as 16 bit integers relative to the bounding box,
+	normals as 8 bit integers and texture coordinates as half floats, see
+	QuantizedVertexBuffer. This halves the size of the vertices on the GPU
+	for the OpenGL 3 and OpenGL ES 3 drivers, no changes to shaders are
+	needed. The vertices of the buffer are kept for collisions and picking.
+	After they are changed, they are drawn again until this is called again.
+	\param buffer Mesh buffer of type EVT_STANDARD without skinning weights.
+	\return True if the copy was created. */
+	virtual bool quantizeVertices(IMeshBuffer *buffer) const = 0;
+
+	//! Creates compact copies of the vertices of all mesh buffers of a mesh.
+	/** See quantizeVertices(IMeshBuffer*).
+	\param mesh Mesh on which the operation is performed.
+	\return Number of mesh buffers with a compact copy. */
+	u32 quantizeVertices(IMesh *mesh) const
+	{
+		u32 count = 0;
+		for (u32 i = 0; mesh && i < mesh->getMeshBufferCount(); ++i)
+			count += quantizeVertices(mesh->getMeshBuffer(i)) ? 1 : 0;
+		return count;
+	}
+
 	//! Apply a manipulator on the Meshbuffer
 	/** \param func A functor defining the mesh manipulation.
 	\param buffer The Meshbuffer to apply the manipulator to.
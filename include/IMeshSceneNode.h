@@ -5,6 +5,7 @@
 #pragma once
 
 #include "ISceneNode.h"
+#include <vector>
 
 namespace irr
 {
@@ -27,7 +28,9 @@ public:
 			ISceneNode(parent, mgr, id, position, rotation, scale) {}
 
 	//! Sets a new mesh to display
-	/** \param mesh Mesh to display. */
+	/** Removes the detail levels set with setLODLevels() if the mesh
+	changes, as they were made from the former mesh.
+	\param mesh Mesh to display. */
 	virtual void setMesh(IMesh *mesh) = 0;
 
 	//! Get the currently defined mesh for display.
@@ -44,6 +47,24 @@ public:
 	/** This flag can be set by setSharedMaterials().
 	\return Whether the materials are shared. */
 	virtual bool isSharedMaterials() const = 0;
+
+	//! Sets meshes with less detail, drawn when the node is small on screen.
+	/** Each frame a level is picked from the projected size of the node's
+	bounding sphere for the active camera, as a fraction of the viewport
+	height. The meshes must have the same mesh buffers and materials as the
+	mesh of the node, as created by IMeshManipulator::createLODChain().
+	\param levels Meshes from the most to the least detailed. The mesh set
+	with setMesh() is level 0 and is not part of this list. Null entries are
+	skipped. Empty to disable.
+	\param screenSizes For each mesh in levels, the projected size below which
+	it is drawn, in decreasing order. */
+	virtual void setLODLevels(const std::vector<IMesh *> &levels, const std::vector<f32> &screenSizes) = 0;
+
+	//! Get the number of detail levels, including the mesh itself.
+	virtual u32 getLODLevelCount() const = 0;
+
+	//! Get the detail level selected for the last frame, 0 is the mesh itself.
+	virtual u32 getCurrentLODLevel() const = 0;
 };
 
 } // end namespace scene
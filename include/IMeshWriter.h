@@ -0,0 +1,56 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IReferenceCounted.h"
+#include "path.h"
+
+namespace irr
+{
+namespace io
+{
+class IWriteFile;
+} // end namespace io
+
+namespace scene
+{
+class IMesh;
+
+//! An enumeration for all supported types of built-in mesh writers
+/** A scene manager can create writers of these types with
+ISceneManager::createMeshWriter(). */
+enum EMESH_WRITER_TYPE
+{
+	//! Binary mesh cache (.meshcache)
+	/** Stores meshes and skinned meshes with their joints, key frames and
+	weights in the memory layout of the engine, ready to be drawn and animated
+	after loading. The files are only read by the same build of the engine, so
+	they are meant to be created from the source files on the target machine,
+	not to be shipped instead of them. */
+	EMWT_MESH_CACHE = MAKE_IRR_ID('m', 'c', 'c', 'h'),
+};
+
+//! Interface for writing meshes
+class IMeshWriter : public virtual IReferenceCounted
+{
+public:
+	//! Get the type of the mesh writer
+	virtual EMESH_WRITER_TYPE getType() const = 0;
+
+	//! Check if this writer writes files with the given extension
+	/** \param filename Name of the file to check.
+	\return True if the file extension matches the format of this writer. */
+	virtual bool isAWriteableFileExtension(const io::path &filename) const = 0;
+
+	//! Write a mesh to a file
+	/** \param file File handle to write to.
+	\param mesh Mesh to write. Skinned meshes are written in their static
+	pose, even while they are animated in software.
+	\param flags Writer specific flags.
+	\return True if the mesh was written successfully. */
+	virtual bool writeMesh(io::IWriteFile *file, IMesh *mesh, s32 flags = 0) = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
@@ -10,6 +10,9 @@
 #include "dimension2d.h"
 #include "SColor.h"
 #include "ESceneNodeTypes.h"
+#include "IMeshWriter.h"
+
+#include <vector>
 
 namespace irr
 {
@@ -83,6 +86,7 @@ class IMeshCache;
 class ISceneCollisionManager;
 class IMeshLoader;
 class IMeshManipulator;
+class IMeshWriter;
 class IMeshSceneNode;
 class ISceneNode;
 
@@ -159,6 +163,44 @@ public:
 			const core::vector3df &scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero = false) = 0;
 
+	//! Adds a scene node drawing static mesh scene nodes merged into few mesh buffers.
+	/** The mesh buffers of the nodes are transformed into world space with
+	the current transformations of the nodes and joined per material into
+	large buffers with the EHM_STATIC hint. The nodes are hidden, moving them
+	later has no effect on the batch. Nodes with children or with mesh buffers
+	of lines, points or skinned meshes are left out and stay visible. Each merged node keeps its bounding box,
+	so the parts outside of the view frustum are not drawn. Transparent parts
+	are not sorted by distance.
+	\param nodes: Static mesh scene nodes to merge.
+	\param parent: Parent of the scene node. Can be NULL if no parent.
+	\param id: Id of the node. This id can be used to identify the scene node.
+	\return Pointer to the created scene node.
+	This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+	virtual IMeshSceneNode *addStaticBatchSceneNode(const std::vector<IMeshSceneNode *> &nodes,
+			ISceneNode *parent = 0, s32 id = -1) = 0;
+
+	//! Adds a scene node for rendering a dense static mesh, culled in small clusters.
+	/** The triangles of each mesh buffer are reordered into clusters with
+	IMeshManipulator::buildClusters(). Clusters outside of the view frustum
+	are not drawn, nor are clusters facing away from the camera when the
+	material culls back faces and the node is scaled uniformly.
+	\param mesh: Pointer to the static mesh, its triangles are reordered.
+	\param parent: Parent of the scene node. Can be NULL if no parent.
+	\param id: Id of the node. This id can be used to identify the scene node.
+	\param position: Position of the space relative to its parent where the
+	scene node will be placed.
+	\param rotation: Initial rotation of the scene node.
+	\param scale: Initial scale of the scene node.
+	\param maxVertices: Largest number of vertices of a cluster.
+	\param maxTriangles: Largest number of triangles of a cluster.
+	\return Pointer to the created scene node.
+	This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+	virtual IMeshSceneNode *addClusteredMeshSceneNode(IMesh *mesh, ISceneNode *parent = 0, s32 id = -1,
+			const core::vector3df &position = core::vector3df(0, 0, 0),
+			const core::vector3df &rotation = core::vector3df(0, 0, 0),
+			const core::vector3df &scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			u32 maxVertices = 64, u32 maxTriangles = 124) = 0;
+
 	//! Adds a camera scene node to the scene graph and sets it as active camera.
 	/** This camera does not react on user input.
 	If you want to move or animate it, use ISceneNode::setPosition(),
@@ -327,6 +369,13 @@ public:
 	\return A pointer to the specified loader, 0 if the index is incorrect. */
 	virtual IMeshLoader *getMeshLoader(u32 index) const = 0;
 
+	//! Creates a mesh writer which is able to save a mesh into a file.
+	/** \param type Type of the mesh writer to create.
+	\return Pointer to the created mesh writer or 0 if there is no writer of
+	this type. If you no longer need the writer, you should call
+	IMeshWriter::drop(). See IReferenceCounted::drop() for more information. */
+	virtual IMeshWriter *createMeshWriter(EMESH_WRITER_TYPE type) = 0;
+
 	//! Get pointer to the scene collision manager.
 	/** \return Pointer to the collision manager
 	This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
@@ -416,6 +465,33 @@ public:
 	\return True if node is not visible in the current scene, else
 	false. */
 	virtual bool isCulled(const ISceneNode *node) const = 0;
+
+	//! Sets whether the absolute transformations are updated in one pass over flat arrays
+	/** By default, each scene node updates its absolute transformation in
+	OnAnimate(), before animating its children. With a transform hierarchy,
+	the scene manager keeps all nodes in arrays ordered by depth, with the
+	index of the parent of each, and updates them in one pass after all
+	nodes are animated. Only nodes for which
+	ISceneNode::setRelativeTransformationDirty() was called, as by
+	setPosition(), setRotation() and setScale(), and the nodes below them
+	are visited. The results are the same, but OnAnimate() of a node sees
+	the absolute transformation of its parent from the previous frame, and
+	overrides of ISceneNode::updateAbsolutePosition() are not called
+	during drawAll(). Scene nodes which calculate their relative
+	transformation from other values must call
+	setRelativeTransformationDirty() when these change.
+	The arrays are rebuilt when nodes are added or removed.
+	\param enable Whether to use the transform hierarchy.
+	\param threads Number of threads the nodes of large levels of the
+	hierarchy are split between, including the calling one, 0 for one per
+	CPU core. The other threads are started here and wait for the next
+	level while idle. With more than one,
+	ISceneNode::getRelativeTransformation() of different nodes must be
+	safe to call from several threads. */
+	virtual void setTransformHierarchyEnabled(bool enable, u32 threads = 1) = 0;
+
+	//! Returns whether the absolute transformations are updated in one pass, see setTransformHierarchyEnabled()
+	virtual bool isTransformHierarchyEnabled() const = 0;
 };
 
 } // end namespace scene
@@ -24,6 +24,7 @@ namespace scene
 {
 class ISceneNode;
 class ISceneManager;
+class CTransformHierarchy;
 
 //! Typedef for list of scene nodes
 typedef std::list<ISceneNode *> ISceneNodeList;
@@ -48,7 +49,7 @@ public:
 			RelativeRotation(rotation), RelativeScale(scale),
 			Parent(0), SceneManager(mgr), ID(id),
 			AutomaticCullingState(EAC_BOX), DebugDataVisible(EDS_OFF),
-			IsVisible(true), IsDebugObject(false)
+			IsVisible(true), IsDebugObject(false), TransformDirty(nullptr)
 	{
 		if (parent)
 			parent->addChild(this);
@@ -97,7 +98,9 @@ public:
 		if (!IsVisible && Children.empty())
 			return;
 
-		updateAbsolutePosition();
+		// nodes in a transform hierarchy are updated by the scene manager after animating
+		if (!TransformDirty)
+			updateAbsolutePosition();
 		for (auto *child : Children)
 			child->OnAnimate(timeMs);
 	}
@@ -157,7 +160,9 @@ public:
 	/** NOTE: For speed reasons the absolute transformation is not
 	automatically recalculated on each change of the relative
 	transformation or by a transformation change of an parent. Instead the
-	update usually happens once per frame in OnAnimate. You can enforce
+	update usually happens once per frame in OnAnimate, or after it when
+	the scene manager has a transform hierarchy, see
+	ISceneManager::setTransformHierarchyEnabled(). You can enforce
 	an update with updateAbsolutePosition().
 	\return The absolute transformation matrix. */
 	virtual const core::matrix4 &getAbsoluteTransformation() const
@@ -169,6 +174,8 @@ public:
 	/** The relative transformation is stored internally as 3
 	vectors: translation, rotation and scale. To get the relative
 	transformation matrix, it is calculated from these values.
+	Overrides which calculate it from other values must call
+	setRelativeTransformationDirty() when these change.
 	\return The relative transformation matrix. */
 	virtual core::matrix4 getRelativeTransformation() const
 	{
@@ -185,6 +192,16 @@ public:
 		return mat;
 	}
 
+	//! Tells the transform hierarchy of the scene manager that the relative transformation changed.
+	/** Called by setPosition(), setRotation() and setScale(). Nodes in a
+	transform hierarchy are only updated after this was called for them or
+	one of their parents, see ISceneManager::setTransformHierarchyEnabled(). */
+	void setRelativeTransformationDirty()
+	{
+		if (TransformDirty)
+			*TransformDirty = 1;
+	}
+
 	//! Returns whether the node should be visible (if all of its parents are visible).
 	/** This is only an option set by the user, but has nothing to
 	do with geometry culling
@@ -251,6 +268,8 @@ public:
 			// Note: This iterator is not invalidated until we erase it.
 			child->ThisIterator = Children.insert(Children.end(), child);
 			child->Parent = this;
+			if (TransformDirty)
+				invalidateTransformHierarchy();
 		}
 	}
 
@@ -269,6 +288,10 @@ public:
 		auto it = *child->ThisIterator;
 		child->ThisIterator = std::nullopt;
 		child->Parent = nullptr;
+		if (TransformDirty) {
+			leaveTransformHierarchy(child);
+			invalidateTransformHierarchy();
+		}
 		child->drop();
 		Children.erase(it);
 		return true;
@@ -283,8 +306,12 @@ public:
 		for (auto &child : Children) {
 			child->Parent = nullptr;
 			child->ThisIterator = std::nullopt;
+			if (TransformDirty)
+				leaveTransformHierarchy(child);
 			child->drop();
 		}
+		if (TransformDirty && !Children.empty())
+			invalidateTransformHierarchy();
 		Children.clear();
 	}
 
@@ -347,6 +374,7 @@ public:
 	virtual void setScale(const core::vector3df &scale)
 	{
 		RelativeScale = scale;
+		setRelativeTransformationDirty();
 	}
 
 	//! Gets the rotation of the node relative to its parent.
@@ -365,6 +393,7 @@ public:
 	virtual void setRotation(const core::vector3df &rotation)
 	{
 		RelativeRotation = rotation;
+		setRelativeTransformationDirty();
 	}
 
 	//! Gets the position of the node relative to its parent.
@@ -382,6 +411,7 @@ public:
 	virtual void setPosition(const core::vector3df &newpos)
 	{
 		RelativeTranslation = newpos;
+		setRelativeTransformationDirty();
 	}
 
 	//! Gets the absolute position of the node in world coordinates.
@@ -472,7 +502,9 @@ public:
 
 	//! Updates the absolute position based on the relative and the parents position
 	/** Note: This does not recursively update the parents absolute positions, so if you have a deeper
-		hierarchy you might want to update the parents first.*/
+		hierarchy you might want to update the parents first.
+		OnAnimate() does not call this for nodes in a transform hierarchy,
+		see ISceneManager::setTransformHierarchyEnabled(). */
 	virtual void updateAbsolutePosition()
 	{
 		if (Parent) {
@@ -540,6 +572,9 @@ protected:
 			(*it)->clone(this, newManager);
 	}
 
+	//! Called on the root of the tree when nodes were added to or removed from its transform hierarchy
+	virtual void OnTransformHierarchyChanged() {}
+
 	//! Sets the new scene manager for this node and all children.
 	//! Called by addChild when moving nodes between scene managers
 	void setSceneManager(ISceneManager *newManager)
@@ -592,6 +627,29 @@ protected:
 
 	//! Is debug object?
 	bool IsDebugObject;
+
+	//! Flag of this node in the transform hierarchy of the scene manager, or null if not in one
+	u8 *TransformDirty;
+
+private:
+	friend class CTransformHierarchy;
+
+	//! Tells the root of the tree that its transform hierarchy must be rebuilt
+	void invalidateTransformHierarchy()
+	{
+		ISceneNode *root = this;
+		while (root->Parent)
+			root = root->Parent;
+		root->OnTransformHierarchyChanged();
+	}
+
+	//! Takes a removed subtree out of the transform hierarchy
+	static void leaveTransformHierarchy(ISceneNode *node)
+	{
+		node->TransformDirty = nullptr;
+		for (auto *child : node->Children)
+			leaveTransformHierarchy(child);
+	}
 };
 
 } // end namespace scene
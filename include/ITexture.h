@@ -79,6 +79,14 @@ enum E_TEXTURE_CREATION_FLAG
 	*/
 	ETCF_ALLOW_MEMORY_COPY = 0x00000080,
 
+	//! Compress uncompressed images to a block compressed format when loading them from files
+	/** The format (ECF_DXT1 or ECF_DXT5) is only used when the driver supports it,
+	see IVideoDriver::queryTextureFormat. Saves 75% to 87.5% of texture memory,
+	but makes loading slower and loses some quality.
+	This is disabled by default.
+	*/
+	ETCF_COMPRESS_ON_LOAD = 0x00000100,
+
 	/** This flag is never used, it only forces the compiler to compile
 	these enumeration values to 32 bit. */
 	ETCF_FORCE_32_BIT_DO_NOT_USE = 0x7fffffff
@@ -14,6 +14,7 @@ namespace scene
 {
 
 struct WeightBuffer;
+struct QuantizedVertexBuffer;
 
 class IVertexBuffer : public virtual IReferenceCounted, public HWBuffer
 {
@@ -56,6 +57,10 @@ public:
 	virtual const WeightBuffer *getWeightBuffer() const = 0;
 	//! Enable software skinning
 	virtual void useSwSkinning() = 0;
+
+	//! Get the compact copy of the vertices for drawing, if any
+	/** See IMeshManipulator::quantizeVertices(). */
+	virtual const QuantizedVertexBuffer *getQuantizedBuffer() const = 0;
 };
 
 } // end namespace scene
@@ -683,6 +683,29 @@ public:
 			SColor color = SColor(255, 255, 255, 255),
 			bool useAlphaChannelOfTexture = false) = 0;
 
+	//! Draws a set of 2d images from a signed distance field texture.
+	/** The alpha channel of the texture holds the distance to the
+	outline of a shape, 0.5 being on the outline and higher values
+	inside. The shapes are filled with the color and keep sharp edges
+	at any scale, so one texture serves all sizes of a font. Drivers
+	without a shader for it draw the images as with draw2DImage().
+	\param texture Distance field texture, should be filtered linearly.
+	\param destRects Rectangles on the screen the images are scaled to.
+	\param sourceRects Source rectangles of the texture (based on it's OriginalSize)
+	\param clipRect Pointer to rectangle on the screen where the
+	images are clipped to.
+	If this pointer is 0 then the image is not clipped.
+	\param color Color with which the shapes are filled.
+	\param smoothing Half the width of the antialiased edge, as a
+	distance in the alpha channel. About a quarter of the alpha change
+	over one screen pixel gives an edge of one pixel. */
+	virtual void draw2DDistanceFieldBatch(const video::ITexture *texture,
+			const core::array<core::rect<s32>> &destRects,
+			const core::array<core::rect<s32>> &sourceRects,
+			const core::rect<s32> *clipRect = 0,
+			SColor color = SColor(255, 255, 255, 255),
+			f32 smoothing = 0.1f) = 0;
+
 	//! Draws a part of the texture into the rectangle. Note that colors must be an array of 4 colors if used.
 	/** Suggested and first implemented by zola.
 	\param texture The texture to draw from
@@ -758,6 +781,19 @@ public:
 		const scene::IIndexBuffer *ib, u32 primCount,
 		scene::E_PRIMITIVE_TYPE pType = scene::EPT_TRIANGLES) = 0;
 
+	/**
+	 * Draws part of a mesh from individual vertex and index buffers.
+	 * Lets buffers which hold several objects skip some of them.
+	 * @param vb vertices to use
+	 * @param ib indices to use
+	 * @param firstIndex index to start drawing at
+	 * @param primCount amount of primitives
+	 * @param pType primitive type
+	 */
+	virtual void drawBufferRange(const scene::IVertexBuffer *vb,
+		const scene::IIndexBuffer *ib, u32 firstIndex, u32 primCount,
+		scene::E_PRIMITIVE_TYPE pType = scene::EPT_TRIANGLES) = 0;
+
 	//! Draws normals of a mesh buffer
 	/** \param mb Buffer to draw the normals of
 	\param length length scale factor of the normals
@@ -803,6 +839,11 @@ public:
 	\return Size of render target or screen/window */
 	virtual const core::dimension2d<u32> &getCurrentRenderTargetSize() const = 0;
 
+	//! Get the current render target
+	/** \return The render target set by setRenderTargetEx() or
+	setRenderTarget(), or 0 if it is the screen. */
+	virtual IRenderTarget *getCurrentRenderTarget() const = 0;
+
 	//! Get statistics as a mutable reference so they
 	//! can be updated from outside during rendering.
 	//! \return Statistics about the last (current) frame.
@@ -1052,7 +1093,8 @@ public:
 	Please note that you have to enable/disable this effect with
 	enableMaterial2D(). This effect is costly, as it increases
 	the number of state changes considerably. Always reset the
-	values when done.
+	values when done. A BlendFactor set in it replaces the alpha
+	blending of 2d drawing, e.g. for premultiplied alpha.
 	\return Material reference which should be altered to reflect
 	the new settings.
 	*/
@@ -1063,6 +1105,9 @@ public:
 	enabled or disabled. */
 	virtual void enableMaterial2D(bool enable = true) = 0;
 
+	//! Check whether the 2d override material is enabled
+	virtual bool isMaterial2DEnabled() const = 0;
+
 	//! Get the graphics card vendor name.
 	virtual core::stringc getVendorInfo() = 0;
 
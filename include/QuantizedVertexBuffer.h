@@ -0,0 +1,86 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "HWBuffer.h"
+#include "S3DVertex.h"
+#include "aabbox3d.h"
+#include "matrix4.h"
+
+#include <vector>
+
+namespace irr
+{
+
+namespace scene
+{
+
+class IVertexBuffer;
+
+//! Compact copy of a vertex buffer for drawing static meshes.
+/** Created by IMeshManipulator::quantizeVertices(). Drivers which support it
+draw this copy instead of the vertices as long as the vertex buffer was not
+changed since, using 20 bytes per vertex instead of the 40 of S3DVertex.
+Positions are stored relative to a cube around the bounding box, the
+driver folds the matrix from getDequantizationMatrix() into the world
+transformation, so shaders see the usual vertex attributes. */
+struct IRRLICHT_API QuantizedVertexBuffer final : public HWBuffer
+{
+	struct Vertex {
+		//! Position in the cube, 0 is the minimum and 65535 the maximum edge
+		u16 pos[3];
+		//! Auxiliary value of the vertex
+		u16 aux;
+		//! Normal as normalized signed bytes, the fourth is padding
+		s8 normal[4];
+		video::SColor color;
+		//! Texture coordinates as half floats
+		u16 tcoords[2];
+	};
+	static_assert(sizeof(Vertex) == 20);
+
+	std::vector<Vertex> vertices;
+
+	//! Minimum corner of the cube
+	core::vector3df origin;
+	//! Edge length of the cube
+	f32 size = 0.f;
+
+	QuantizedVertexBuffer()
+	{ MappingHint = scene::EHM_STATIC; }
+
+	HWBuffer::Type getBufferType() const override
+	{ return HWBuffer::Type::QUANTIZED_VERTEX; }
+
+	u32 getCount() const override
+	{ return vertices.size(); }
+
+	u32 getElementSize() const override
+	{ return sizeof(Vertex); }
+
+	const void *getData() const override
+	{ return vertices.data(); }
+
+	/// Encodes the vertices of a buffer of type EVT_STANDARD
+	void encode(const IVertexBuffer *vbuf);
+
+	/// @return whether the vertex buffer is unchanged since it was encoded
+	bool isCurrent(const IVertexBuffer *vbuf) const;
+
+	/// Transformation from the stored positions, normalized to [0, 1], to the original ones
+	core::matrix4 getDequantizationMatrix() const;
+
+	/// Decodes vertex i as a driver would
+	video::S3DVertex decode(u32 i) const;
+
+	static u16 toHalf(f32 value);
+	static f32 fromHalf(u16 value);
+
+private:
+	u32 SourceChangedID = 0;
+	u32 SourceCount = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
@@ -89,6 +89,36 @@ enum ECOLOR_FORMAT
 	//! 32 bit format using 24 bits for depth and 8 bits for stencil.
 	ECF_D24S8,
 
+	/** Block compressed formats, they can only be used as texture data.
+	All of them encode blocks of 4x4 pixels. */
+
+	//! BC1, 8 bytes per block: RGB with optional 1 bit alpha.
+	ECF_DXT1,
+
+	//! BC2, 16 bytes per block: RGB with explicit 4 bit alpha.
+	ECF_DXT3,
+
+	//! BC3, 16 bytes per block: RGB with interpolated alpha.
+	ECF_DXT5,
+
+	//! BC4, 8 bytes per block: single red channel.
+	ECF_BC4,
+
+	//! BC5, 16 bytes per block: red and green channels.
+	ECF_BC5,
+
+	//! BC7, 16 bytes per block: high quality RGBA.
+	ECF_BC7,
+
+	//! ETC2, 8 bytes per block: RGB.
+	ECF_ETC2_RGB,
+
+	//! ETC2 with EAC alpha, 16 bytes per block: RGBA.
+	ECF_ETC2_ARGB,
+
+	//! ASTC with 4x4 blocks, 16 bytes per block: RGBA.
+	ECF_ASTC_4x4,
+
 	//! Unknown color format:
 	ECF_UNKNOWN
 };
@@ -114,6 +144,15 @@ const c8 *const ColorFormatNames[] = {
 		"D24",
 		"D32",
 		"D24S8",
+		"DXT1",
+		"DXT3",
+		"DXT5",
+		"BC4",
+		"BC5",
+		"BC7",
+		"ETC2_RGB",
+		"ETC2_ARGB",
+		"ASTC_4x4",
 		"UNKNOWN",
 		0,
 	};
@@ -7,6 +7,7 @@
 #include "IMeshBuffer.h"
 #include "CVertexBuffer.h"
 #include "CIndexBuffer.h"
+#include "BoundingBoxes.h"
 #include "WeightBuffer.h"
 #include "IVertexBuffer.h"
 #include "S3DVertex.h"
@@ -23,13 +24,14 @@ struct SSkinMeshBuffer final : public IMeshBuffer
 {
 	//! Default constructor
 	SSkinMeshBuffer(video::E_VERTEX_TYPE vt = video::EVT_STANDARD) :
-			VertexType(vt), PrimitiveType(EPT_TRIANGLES),
+			VertexType(vt), IndexType(video::EIT_16BIT), PrimitiveType(EPT_TRIANGLES),
 			BoundingBoxNeedsRecalculated(true)
 	{
 		Vertices_Tangents = new SVertexBufferTangents();
 		Vertices_2TCoords = new SVertexBufferLightMap();
 		Vertices_Standard = new SVertexBuffer();
 		Indices = new SIndexBuffer();
+		Indices32 = new SIndexBuffer32();
 	}
 
 	//! Constructor for standard vertices
@@ -46,6 +48,7 @@ struct SSkinMeshBuffer final : public IMeshBuffer
 		Vertices_2TCoords->drop();
 		Vertices_Standard->drop();
 		Indices->drop();
+		Indices32->drop();
 	}
 
 	//! Get Material of this buffer.
@@ -86,14 +89,34 @@ struct SSkinMeshBuffer final : public IMeshBuffer
 
 	const scene::IIndexBuffer *getIndexBuffer() const override
 	{
+		if (IndexType == video::EIT_32BIT)
+			return Indices32;
 		return Indices;
 	}
 
 	scene::IIndexBuffer *getIndexBuffer() override
 	{
+		if (IndexType == video::EIT_32BIT)
+			return Indices32;
 		return Indices;
 	}
 
+	//! Set the indices, call this after adding the vertices
+	/** 16-bit indices are used when they can address all vertices, 32-bit
+	ones otherwise. */
+	void setIndices(std::vector<u32> &&indices)
+	{
+		if (getVertexCount() <= 65536) {
+			Indices->Data.assign(indices.begin(), indices.end());
+			Indices32->Data.clear();
+			IndexType = video::EIT_16BIT;
+		} else {
+			Indices32->Data = std::move(indices);
+			Indices->Data.clear();
+			IndexType = video::EIT_32BIT;
+		}
+	}
+
 	//! Get standard vertex at given index
 	video::S3DVertex *getVertex(u32 index)
 	{
@@ -125,10 +148,7 @@ private:
 		if (!buf->getCount()) {
 			BoundingBox.reset(0, 0, 0);
 		} else {
-			auto &vertices = buf->Data;
-			BoundingBox.reset(vertices[0].Pos);
-			for (size_t i = 1; i < vertices.size(); ++i)
-				BoundingBox.addInternalPoint(vertices[i].Pos);
+			BoundingBox = core::getBoundingBox(&buf->Data[0].Pos, buf->getCount(), sizeof(T));
 		}
 	}
 
@@ -262,11 +282,14 @@ public:
 	SVertexBufferLightMap *Vertices_2TCoords;
 	SVertexBuffer *Vertices_Standard;
 	SIndexBuffer *Indices;
+	SIndexBuffer32 *Indices32;
 
 	core::matrix4 Transformation;
 
 	video::SMaterial Material;
 	video::E_VERTEX_TYPE VertexType;
+	//! Selects Indices or Indices32
+	video::E_INDEX_TYPE IndexType;
 
 	core::aabbox3d<f32> BoundingBox{{0, 0, 0}};
 
@@ -127,7 +127,8 @@ public:
 	std::optional<u32> getJointNumber(const std::string &name) const;
 
 	//! converts the vertex type of all meshbuffers to tangents.
-	/** E.g. used for bump mapping. */
+	/** E.g. used for bump mapping. The tangents are made orthogonal to the
+	normals of the mesh, see IMeshManipulator::recalculateTangents(). */
 	void convertMeshToTangents();
 
 	//! Does the mesh have no animation
@@ -346,12 +347,9 @@ protected:
 	void calculateJointBoundingBoxes();
 	void calculateBufferBoundingBoxes();
 
-	void calculateTangents(core::vector3df &normal,
-			core::vector3df &tangent, core::vector3df &binormal,
-			const core::vector3df &vt1, const core::vector3df &vt2, const core::vector3df &vt3,
-			const core::vector2df &tc1, const core::vector2df &tc2, const core::vector2df &tc3);
-
 	friend class SkinnedMeshBuilder;
+	friend class CMeshCacheWriter;
+	friend class CMeshCacheFileLoader;
 
 	std::vector<SSkinMeshBuffer *> *SkinningBuffers; // Meshbuffer to skin, default is to skin localBuffers
 
@@ -369,6 +367,9 @@ protected:
 	//! Bounding box of the mesh in static pose
 	core::aabbox3df StaticPoseBox{{0, 0, 0}};
 
+	//! Joint boxes transformed by calculateBoundingBox(), kept to not allocate every frame
+	std::vector<core::aabbox3df> JointBoxes;
+
 	f32 EndFrame;
 	f32 FramesPerSecond;
 
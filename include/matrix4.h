@@ -14,6 +14,13 @@
 #include "IrrCompileConfig.h" // for IRRLICHT_API
 #include <cassert>
 
+// SSE is part of the x86-64 baseline, so the f32 specializations using it
+// are selected at compile time.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define IRR_MATRIX4_SSE
+#endif
+
 namespace irr
 {
 namespace core
@@ -241,6 +248,20 @@ public:
 		out = transformVect(in);
 	}
 
+	//! Transforms many vectors by this matrix
+	/** Gives the same vectors as transformVect() for each of them.
+	\param in First vector, e.g. the Pos member of the first vertex.
+	\param out Receives the transformed vectors, may be the same as in.
+	\param count Number of vectors.
+	\param stride Bytes from one vector to the next in both in and out,
+	e.g. the vertex size. */
+	void transformVectArray(const vector3d<T> *in, vector3d<T> *out, u32 count,
+			u32 stride = sizeof(vector3d<T>)) const;
+
+	//! Rotates and scales many vectors, see transformVectArray() and rotateAndScaleVect()
+	void rotateAndScaleVectArray(const vector3d<T> *in, vector3d<T> *out, u32 count,
+			u32 stride = sizeof(vector3d<T>)) const;
+
 	//! An alternate transform vector method, writing into an array of 4 floats
 	/** This operation is performed as if the vector was 4d with the 4th component =1.
 		NOTE: out[3] will be written to (4th vector component)*/
@@ -670,6 +691,29 @@ inline CMatrix4<T> &CMatrix4<T>::setbyproduct_nocheck(const CMatrix4<T> &other_a
 	return *this;
 }
 
+#ifdef IRR_MATRIX4_SSE
+// Each row of the product is the sum of the rows of other_a scaled by a row
+// of other_b. The sums are added in the order of the generic version, so
+// the results are the same to the bit.
+template <>
+inline CMatrix4<f32> &CMatrix4<f32>::setbyproduct_nocheck(const CMatrix4<f32> &other_a, const CMatrix4<f32> &other_b)
+{
+	const __m128 a0 = _mm_loadu_ps(other_a.M);
+	const __m128 a1 = _mm_loadu_ps(other_a.M + 4);
+	const __m128 a2 = _mm_loadu_ps(other_a.M + 8);
+	const __m128 a3 = _mm_loadu_ps(other_a.M + 12);
+	for (u32 i = 0; i < 16; i += 4) {
+		const __m128 b = _mm_loadu_ps(other_b.M + i);
+		__m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1))));
+		r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2))));
+		r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3))));
+		_mm_storeu_ps(M + i, r);
+	}
+	return *this;
+}
+#endif
+
 //! multiply by another matrix
 // set this matrix to the product of two other matrices
 // goal is to reduce stack use and copy
@@ -684,29 +728,7 @@ template <class T>
 inline CMatrix4<T> CMatrix4<T>::operator*(const CMatrix4<T> &m2) const
 {
 	CMatrix4<T> m3(EM4CONST_NOTHING);
-
-	const T *m1 = M;
-
-	m3[0] = m1[0] * m2[0] + m1[4] * m2[1] + m1[8] * m2[2] + m1[12] * m2[3];
-	m3[1] = m1[1] * m2[0] + m1[5] * m2[1] + m1[9] * m2[2] + m1[13] * m2[3];
-	m3[2] = m1[2] * m2[0] + m1[6] * m2[1] + m1[10] * m2[2] + m1[14] * m2[3];
-	m3[3] = m1[3] * m2[0] + m1[7] * m2[1] + m1[11] * m2[2] + m1[15] * m2[3];
-
-	m3[4] = m1[0] * m2[4] + m1[4] * m2[5] + m1[8] * m2[6] + m1[12] * m2[7];
-	m3[5] = m1[1] * m2[4] + m1[5] * m2[5] + m1[9] * m2[6] + m1[13] * m2[7];
-	m3[6] = m1[2] * m2[4] + m1[6] * m2[5] + m1[10] * m2[6] + m1[14] * m2[7];
-	m3[7] = m1[3] * m2[4] + m1[7] * m2[5] + m1[11] * m2[6] + m1[15] * m2[7];
-
-	m3[8] = m1[0] * m2[8] + m1[4] * m2[9] + m1[8] * m2[10] + m1[12] * m2[11];
-	m3[9] = m1[1] * m2[8] + m1[5] * m2[9] + m1[9] * m2[10] + m1[13] * m2[11];
-	m3[10] = m1[2] * m2[8] + m1[6] * m2[9] + m1[10] * m2[10] + m1[14] * m2[11];
-	m3[11] = m1[3] * m2[8] + m1[7] * m2[9] + m1[11] * m2[10] + m1[15] * m2[11];
-
-	m3[12] = m1[0] * m2[12] + m1[4] * m2[13] + m1[8] * m2[14] + m1[12] * m2[15];
-	m3[13] = m1[1] * m2[12] + m1[5] * m2[13] + m1[9] * m2[14] + m1[13] * m2[15];
-	m3[14] = m1[2] * m2[12] + m1[6] * m2[13] + m1[10] * m2[14] + m1[14] * m2[15];
-	m3[15] = m1[3] * m2[12] + m1[7] * m2[13] + m1[11] * m2[14] + m1[15] * m2[15];
-	return m3;
+	return m3.setbyproduct_nocheck(*this, m2);
 }
 
 template <class T>
@@ -924,6 +946,19 @@ inline vector3d<T> CMatrix4<T>::rotateAndScaleVect(const vector3d<T> &v) const
 	};
 }
 
+#ifdef IRR_MATRIX4_SSE
+template <>
+inline vector3df CMatrix4<f32>::rotateAndScaleVect(const vector3df &v) const
+{
+	__m128 r = _mm_mul_ps(_mm_set1_ps(v.X), _mm_loadu_ps(M));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.Y), _mm_loadu_ps(M + 4)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.Z), _mm_loadu_ps(M + 8)));
+	f32 out[4];
+	_mm_storeu_ps(out, r);
+	return {out[0], out[1], out[2]};
+}
+#endif
+
 template <class T>
 inline vector3d<T> CMatrix4<T>::scaleThenInvRotVect(const vector3d<T> &v) const
 {
@@ -944,6 +979,19 @@ inline vector3d<T> CMatrix4<T>::transformVect(const vector3d<T> &v) const
 	};
 }
 
+#ifdef IRR_MATRIX4_SSE
+template <>
+inline vector3df CMatrix4<f32>::transformVect(const vector3df &v) const
+{
+	__m128 r = _mm_mul_ps(_mm_set1_ps(v.X), _mm_loadu_ps(M));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.Y), _mm_loadu_ps(M + 4)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.Z), _mm_loadu_ps(M + 8)));
+	f32 out[4];
+	_mm_storeu_ps(out, _mm_add_ps(r, _mm_loadu_ps(M + 12)));
+	return {out[0], out[1], out[2]};
+}
+#endif
+
 template <class T>
 inline void CMatrix4<T>::transformVect(T *out, const vector3df &in) const
 {
@@ -953,6 +1001,76 @@ inline void CMatrix4<T>::transformVect(T *out, const vector3df &in) const
 	out[3] = in.X * M[3] + in.Y * M[7] + in.Z * M[11] + M[15];
 }
 
+template <class T>
+inline void CMatrix4<T>::transformVectArray(const vector3d<T> *in, vector3d<T> *out, u32 count, u32 stride) const
+{
+	const u8 *src = reinterpret_cast<const u8 *>(in);
+	u8 *dst = reinterpret_cast<u8 *>(out);
+	for (u32 i = 0; i < count; ++i, src += stride, dst += stride)
+		*reinterpret_cast<vector3d<T> *>(dst) = transformVect(*reinterpret_cast<const vector3d<T> *>(src));
+}
+
+template <class T>
+inline void CMatrix4<T>::rotateAndScaleVectArray(const vector3d<T> *in, vector3d<T> *out, u32 count, u32 stride) const
+{
+	const u8 *src = reinterpret_cast<const u8 *>(in);
+	u8 *dst = reinterpret_cast<u8 *>(out);
+	for (u32 i = 0; i < count; ++i, src += stride, dst += stride)
+		*reinterpret_cast<vector3d<T> *>(dst) = rotateAndScaleVect(*reinterpret_cast<const vector3d<T> *>(src));
+}
+
+#ifdef IRR_MATRIX4_SSE
+// The rows are loaded once for all vectors, and only the three floats of
+// each vector are written, as the memory after them may be another
+// attribute of the vertex.
+template <>
+inline void CMatrix4<f32>::transformVectArray(const vector3df *in, vector3df *out, u32 count, u32 stride) const
+{
+	const __m128 m0 = _mm_loadu_ps(M);
+	const __m128 m1 = _mm_loadu_ps(M + 4);
+	const __m128 m2 = _mm_loadu_ps(M + 8);
+	const __m128 m3 = _mm_loadu_ps(M + 12);
+	const u8 *src = reinterpret_cast<const u8 *>(in);
+	u8 *dst = reinterpret_cast<u8 *>(out);
+	for (u32 i = 0; i < count; ++i, src += stride, dst += stride) {
+		const f32 *v = reinterpret_cast<const f32 *>(src);
+		__m128 r = _mm_mul_ps(_mm_set1_ps(v[0]), m0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[1]), m1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[2]), m2));
+		r = _mm_add_ps(r, m3);
+		_mm_storel_pi(reinterpret_cast<__m64 *>(dst), r);
+		_mm_store_ss(reinterpret_cast<f32 *>(dst) + 2, _mm_movehl_ps(r, r));
+	}
+}
+
+template <>
+inline void CMatrix4<f32>::rotateAndScaleVectArray(const vector3df *in, vector3df *out, u32 count, u32 stride) const
+{
+	const __m128 m0 = _mm_loadu_ps(M);
+	const __m128 m1 = _mm_loadu_ps(M + 4);
+	const __m128 m2 = _mm_loadu_ps(M + 8);
+	const u8 *src = reinterpret_cast<const u8 *>(in);
+	u8 *dst = reinterpret_cast<u8 *>(out);
+	for (u32 i = 0; i < count; ++i, src += stride, dst += stride) {
+		const f32 *v = reinterpret_cast<const f32 *>(src);
+		__m128 r = _mm_mul_ps(_mm_set1_ps(v[0]), m0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[1]), m1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[2]), m2));
+		_mm_storel_pi(reinterpret_cast<__m64 *>(dst), r);
+		_mm_store_ss(reinterpret_cast<f32 *>(dst) + 2, _mm_movehl_ps(r, r));
+	}
+}
+
+template <>
+inline void CMatrix4<f32>::transformVect(f32 *out, const vector3df &in) const
+{
+	__m128 r = _mm_mul_ps(_mm_set1_ps(in.X), _mm_loadu_ps(M));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(in.Y), _mm_loadu_ps(M + 4)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(in.Z), _mm_loadu_ps(M + 8)));
+	_mm_storeu_ps(out, _mm_add_ps(r, _mm_loadu_ps(M + 12)));
+}
+#endif
+
 template <class T>
 inline void CMatrix4<T>::transformVec3(T *out, const T *in) const
 {
@@ -563,6 +563,7 @@ void AnimatedMeshSceneNode::updateJointSceneNodes(
 			node->Matrix = std::nullopt;
 		} else {
 			node->Matrix = std::get<core::matrix4>(transform);
+			node->setRelativeTransformationDirty();
 		}
 	}
 }
@@ -0,0 +1,143 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "BoundingBoxes.h"
+#include "SIMD_helper.h"
+#include "os.h"
+
+// The kernels must give the same bits as the scalar code in aabbox3d.h and
+// matrix4.h, including for signed zeros and NaN: the operand order of each
+// min/max follows the comparisons there, and the sums are added in the same
+// order. See test/bounding_box_test.cpp.
+
+namespace irr
+{
+namespace core
+{
+
+namespace
+{
+
+inline const vector3df &positionAt(const vector3df *positions, u32 i, u32 stride)
+{
+	return *reinterpret_cast<const vector3df *>(reinterpret_cast<const u8 *>(positions) + (size_t)i * stride);
+}
+
+aabbox3df getBoundingBoxScalar(const vector3df *positions, u32 count, u32 stride)
+{
+	aabbox3df box(positions[0]);
+	for (u32 i = 1; i < count; ++i)
+		box.addInternalPoint(positionAt(positions, i, stride));
+	return box;
+}
+
+void transformBoxesScalar(const matrix4 *matrices, u32 matrixStep, const aabbox3df *in, aabbox3df *out, u32 count)
+{
+	for (u32 i = 0; i < count; ++i) {
+		aabbox3df box = in[i];
+		matrices[i * matrixStep].transformBoxEx(box);
+		out[i] = box;
+	}
+}
+
+#if defined(IRR_ARCH_X86)
+
+#define TARGET_SSE2 IRR_TARGET("sse2")
+
+//! Loads X, Y, Z into the low lanes, the fourth lane is not used
+TARGET_SSE2 inline __m128 loadPosition(const vector3df &p, bool canOverread)
+{
+	if (canOverread)
+		return _mm_loadu_ps(&p.X);
+	return _mm_setr_ps(p.X, p.Y, p.Z, 0.f);
+}
+
+TARGET_SSE2 inline void storePosition(vector3df &p, __m128 v)
+{
+	f32 lanes[4];
+	_mm_storeu_ps(lanes, v);
+	p.set(lanes[0], lanes[1], lanes[2]);
+}
+
+TARGET_SSE2 aabbox3df getBoundingBoxSSE2(const vector3df *positions, u32 count, u32 stride)
+{
+	// 16 bytes can be read from every position but the last one, which may
+	// end its array even with a larger stride, as Pos need not come first
+	__m128 minEdge = loadPosition(positions[0], count > 1);
+	__m128 maxEdge = minEdge;
+	for (u32 i = 1; i < count; ++i) {
+		const __m128 p = loadPosition(positionAt(positions, i, stride), i + 1 < count);
+		// p > max ? p : max, p < min ? p : min
+		maxEdge = _mm_max_ps(p, maxEdge);
+		minEdge = _mm_min_ps(p, minEdge);
+	}
+	aabbox3df box{{0.f, 0.f, 0.f}};
+	storePosition(box.MinEdge, minEdge);
+	storePosition(box.MaxEdge, maxEdge);
+	return box;
+}
+
+TARGET_SSE2 void transformBoxesSSE2(const matrix4 *matrices, u32 matrixStep, const aabbox3df *in, aabbox3df *out, u32 count)
+{
+	for (u32 i = 0; i < count; ++i) {
+		const f32 *m = matrices[i * matrixStep].pointer();
+		const f32 boxMin[3] = {in[i].MinEdge.X, in[i].MinEdge.Y, in[i].MinEdge.Z};
+		const f32 boxMax[3] = {in[i].MaxEdge.X, in[i].MaxEdge.Y, in[i].MaxEdge.Z};
+
+		// the lanes are the output axes, row j of the matrix scales input axis j
+		__m128 minEdge = _mm_loadu_ps(m + 12);
+		__m128 maxEdge = minEdge;
+		for (u32 j = 0; j < 3; ++j) {
+			const __m128 row = _mm_loadu_ps(m + j * 4);
+			const __m128 a = _mm_mul_ps(row, _mm_set1_ps(boxMin[j]));
+			const __m128 b = _mm_mul_ps(row, _mm_set1_ps(boxMax[j]));
+			// a < b ? a : b, and a < b ? b : a
+			minEdge = _mm_add_ps(minEdge, _mm_min_ps(a, b));
+			maxEdge = _mm_add_ps(maxEdge, _mm_max_ps(b, a));
+		}
+		storePosition(out[i].MinEdge, minEdge);
+		storePosition(out[i].MaxEdge, maxEdge);
+	}
+}
+
+#endif
+
+void transformBoxesT(const matrix4 *matrices, u32 matrixStep, const aabbox3df *in, aabbox3df *out, u32 count)
+{
+#if defined(IRR_ARCH_X86)
+	static const bool sse2 = os::CPU::hasSSE2();
+	if (sse2) {
+		transformBoxesSSE2(matrices, matrixStep, in, out, count);
+		return;
+	}
+#endif
+	transformBoxesScalar(matrices, matrixStep, in, out, count);
+}
+
+} // end anonymous namespace
+
+aabbox3df getBoundingBox(const vector3df *positions, u32 count, u32 stride)
+{
+	if (!count)
+		return aabbox3df{{0.f, 0.f, 0.f}};
+
+#if defined(IRR_ARCH_X86)
+	static const bool sse2 = os::CPU::hasSSE2();
+	if (sse2)
+		return getBoundingBoxSSE2(positions, count, stride);
+#endif
+	return getBoundingBoxScalar(positions, count, stride);
+}
+
+void transformBoxes(const matrix4 *matrices, const aabbox3df *in, aabbox3df *out, u32 count)
+{
+	transformBoxesT(matrices, 1, in, out, count);
+}
+
+void transformBoxes(const matrix4 &matrix, const aabbox3df *in, aabbox3df *out, u32 count)
+{
+	transformBoxesT(&matrix, 0, in, out, count);
+}
+
+} // end namespace core
+} // end namespace irr
@@ -250,15 +250,18 @@ bool CB3DMeshFileLoader::readChunkMESH(SkinnedMesh::SJoint *inJoint)
 			if (!NormalsInFile) {
 				s32 i;
 
-				auto &indices = meshBuffer->Indices->Data;
-				for (i = 0; i < (s32)indices.size(); i += 3) {
-					core::plane3df p(meshBuffer->getVertex(indices[i + 0])->Pos,
-							meshBuffer->getVertex(indices[i + 1])->Pos,
-							meshBuffer->getVertex(indices[i + 2])->Pos);
-
-					meshBuffer->getVertex(indices[i + 0])->Normal += p.Normal;
-					meshBuffer->getVertex(indices[i + 1])->Normal += p.Normal;
-					meshBuffer->getVertex(indices[i + 2])->Normal += p.Normal;
+				const IIndexBuffer *indices = meshBuffer->getIndexBuffer();
+				for (i = 0; i < (s32)indices->getCount(); i += 3) {
+					const u32 i0 = indices->getIndex(i + 0);
+					const u32 i1 = indices->getIndex(i + 1);
+					const u32 i2 = indices->getIndex(i + 2);
+					core::plane3df p(meshBuffer->getVertex(i0)->Pos,
+							meshBuffer->getVertex(i1)->Pos,
+							meshBuffer->getVertex(i2)->Pos);
+
+					meshBuffer->getVertex(i0)->Normal += p.Normal;
+					meshBuffer->getVertex(i1)->Normal += p.Normal;
+					meshBuffer->getVertex(i2)->Normal += p.Normal;
 				}
 
 				for (i = 0; i < (s32)meshBuffer->getVertexCount(); ++i) {
@@ -321,9 +324,7 @@ bool CB3DMeshFileLoader::readChunkVRTS(SkinnedMesh::SJoint *inJoint)
 		return false;
 	}
 
-	//------ Allocate Memory, for speed -----------//
-
-	s32 numberOfReads = 3;
+	u32 numberOfReads = 3;
 
 	if (flags & 1) {
 		NormalsInFile = true;
@@ -336,29 +337,43 @@ bool CB3DMeshFileLoader::readChunkVRTS(SkinnedMesh::SJoint *inJoint)
 
 	numberOfReads += tex_coord_sets * tex_coord_set_size;
 
-	const s32 memoryNeeded = (B3dStack.getLast().length / sizeof(f32)) / numberOfReads;
-
-	BaseVertices.reallocate(memoryNeeded + BaseVertices.size() + 1);
-	AnimatedVertices_VertexID.reallocate(memoryNeeded + AnimatedVertices_VertexID.size() + 1);
-
-	//--------------------------------------------//
+	std::vector<u32> data;
+	if (!readChunkRecords(data, numberOfReads))
+		return false;
 
-	while ((B3dStack.getLast().startposition + B3dStack.getLast().length) > B3DFile->getPos()) // this chunk repeats
-	{
+	const u32 vertexCount = data.size() / numberOfReads;
+	const u32 firstVertex = BaseVertices.size();
+	BaseVertices.set_used(firstVertex + vertexCount);
+	AnimatedVertices_VertexID.set_used(firstVertex + vertexCount);
+	AnimatedVertices_BufferID.set_used(firstVertex + vertexCount);
+	std::fill_n(AnimatedVertices_VertexID.pointer() + firstVertex, vertexCount, -1);
+	std::fill_n(AnimatedVertices_BufferID.pointer() + firstVertex, vertexCount, -1);
+
+	const u32 *in = data.data();
+	video::S3DVertex2TCoords *vertices = BaseVertices.pointer() + firstVertex;
+	video::S3DVertex2TCoords *out = vertices;
+	for (u32 v = 0; v < vertexCount; ++v, ++out) {
 		f32 position[3];
 		f32 normal[3] = {0.f, 0.f, 0.f};
 		f32 color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
 		f32 tex_coords[max_tex_coords][4];
 
-		readFloats(position, 3);
+		for (u32 i = 0; i < 3; ++i)
+			position[i] = core::FR(*in++);
 
-		if (flags & 1)
-			readFloats(normal, 3);
-		if (flags & 2)
-			readFloats(color, 4);
+		if (flags & 1) {
+			for (u32 i = 0; i < 3; ++i)
+				normal[i] = core::FR(*in++);
+		}
+		if (flags & 2) {
+			for (u32 i = 0; i < 4; ++i)
+				color[i] = core::FR(*in++);
+		}
 
-		for (s32 i = 0; i < tex_coord_sets; ++i)
-			readFloats(tex_coords[i], tex_coord_set_size);
+		for (s32 i = 0; i < tex_coord_sets; ++i) {
+			for (s32 j = 0; j < tex_coord_set_size; ++j)
+				tex_coords[i][j] = core::FR(*in++);
+		}
 
 		f32 tu = 0.0f, tv = 0.0f;
 		if (tex_coord_sets >= 1 && tex_coord_set_size >= 2) {
@@ -373,23 +388,19 @@ bool CB3DMeshFileLoader::readChunkVRTS(SkinnedMesh::SJoint *inJoint)
 		}
 
 		// Create Vertex...
-		video::S3DVertex2TCoords Vertex(position[0], position[1], position[2],
+		*out = video::S3DVertex2TCoords(position[0], position[1], position[2],
 				normal[0], normal[1], normal[2],
 				video::SColorf(color[0], color[1], color[2], color[3]).toSColor(),
 				tu, tv, tu2, tv2);
-
-		// Transform the Vertex position by nested node...
-		inJoint->GlobalMatrix.transformVect(Vertex.Pos);
-		Vertex.Normal = inJoint->GlobalMatrix.rotateAndScaleVect(Vertex.Normal);
-		Vertex.Normal.normalize(); // renormalize: normal might have been skewed by scaling
-
-		// Add it...
-		BaseVertices.push_back(Vertex);
-
-		AnimatedVertices_VertexID.push_back(-1);
-		AnimatedVertices_BufferID.push_back(-1);
 	}
 
+	// Transform the vertices by nested node...
+	const u32 stride = sizeof(video::S3DVertex2TCoords);
+	inJoint->GlobalMatrix.transformVectArray(&vertices->Pos, &vertices->Pos, vertexCount, stride);
+	inJoint->GlobalMatrix.rotateAndScaleVectArray(&vertices->Normal, &vertices->Normal, vertexCount, stride);
+	for (u32 v = 0; v < vertexCount; ++v)
+		vertices[v].Normal.normalize(); // renormalize: normal might have been skewed by scaling
+
 	B3dStack.erase(B3dStack.size() - 1);
 
 	return true;
@@ -425,24 +436,20 @@ bool CB3DMeshFileLoader::readChunkTRIS(scene::SSkinMeshBuffer *meshBuffer, u32 m
 		meshBuffer->Material = B3dMaterial->Material;
 	}
 
-	const s32 memoryNeeded = B3dStack.getLast().length / sizeof(s32);
-	meshBuffer->Indices->Data.reserve(memoryNeeded + meshBuffer->Indices->Data.size() + 1);
-
-	while ((B3dStack.getLast().startposition + B3dStack.getLast().length) > B3DFile->getPos()) // this chunk repeats
-	{
-		s32 vertex_id[3];
+	std::vector<u32> data;
+	if (!readChunkRecords(data, 3))
+		return false;
 
-		B3DFile->read(vertex_id, 3 * sizeof(s32));
-#ifdef __BIG_ENDIAN__
-		vertex_id[0] = os::Byteswap::byteswap(vertex_id[0]);
-		vertex_id[1] = os::Byteswap::byteswap(vertex_id[1]);
-		vertex_id[2] = os::Byteswap::byteswap(vertex_id[2]);
-#endif
+	// the index type is chosen once the vertex count is known
+	std::vector<u32> indices;
+	indices.reserve(data.size());
 
+	for (size_t t = 0; t < data.size(); t += 3) {
 		// Make Ids global:
-		vertex_id[0] += vertices_Start;
-		vertex_id[1] += vertices_Start;
-		vertex_id[2] += vertices_Start;
+		s32 vertex_id[3];
+		vertex_id[0] = (s32)data[t + 0] + vertices_Start;
+		vertex_id[1] = (s32)data[t + 1] + vertices_Start;
+		vertex_id[2] = (s32)data[t + 2] + vertices_Start;
 
 		for (s32 i = 0; i < 3; ++i) {
 			if ((u32)vertex_id[i] >= AnimatedVertices_VertexID.size()) {
@@ -498,10 +505,11 @@ bool CB3DMeshFileLoader::readChunkTRIS(scene::SSkinMeshBuffer *meshBuffer, u32 m
 			}
 		}
 
-		meshBuffer->Indices->Data.push_back(AnimatedVertices_VertexID[vertex_id[0]]);
-		meshBuffer->Indices->Data.push_back(AnimatedVertices_VertexID[vertex_id[1]]);
-		meshBuffer->Indices->Data.push_back(AnimatedVertices_VertexID[vertex_id[2]]);
+		indices.push_back(AnimatedVertices_VertexID[vertex_id[0]]);
+		indices.push_back(AnimatedVertices_VertexID[vertex_id[1]]);
+		indices.push_back(AnimatedVertices_VertexID[vertex_id[2]]);
 	}
+	meshBuffer->setIndices(std::move(indices));
 
 	B3dStack.erase(B3dStack.size() - 1);
 
@@ -522,17 +530,13 @@ bool CB3DMeshFileLoader::readChunkBONE(SkinnedMesh::SJoint *inJoint)
 #endif
 
 	if (B3dStack.getLast().length > 8) {
-		while ((B3dStack.getLast().startposition + B3dStack.getLast().length) > B3DFile->getPos()) // this chunk repeats
-		{
-			u32 globalVertexID;
-			f32 strength;
-			B3DFile->read(&globalVertexID, sizeof(globalVertexID));
-			B3DFile->read(&strength, sizeof(strength));
-#ifdef __BIG_ENDIAN__
-			globalVertexID = os::Byteswap::byteswap(globalVertexID);
-			strength = os::Byteswap::byteswap(strength);
-#endif
-			globalVertexID += VerticesStart;
+		std::vector<u32> data;
+		if (!readChunkRecords(data, 2))
+			return false;
+
+		for (size_t w = 0; w < data.size(); w += 2) {
+			const u32 globalVertexID = data[w] + VerticesStart;
+			const f32 strength = core::FR(data[w + 1]);
 
 			if (globalVertexID >= AnimatedVertices_VertexID.size()) {
 				os::Printer::log("Illegal vertex index found", B3DFile->getFileName(), ELL_ERROR);
@@ -573,14 +577,13 @@ bool CB3DMeshFileLoader::readChunkKEYS(SkinnedMesh::SJoint *inJoint)
 	flags = os::Byteswap::byteswap(flags);
 #endif
 
-	while ((B3dStack.getLast().startposition + B3dStack.getLast().length) > B3DFile->getPos()) // this chunk repeats
-	{
-		s32 frame;
+	const u32 valuesPerKey = 1 + ((flags & 1) ? 3 : 0) + ((flags & 2) ? 3 : 0) + ((flags & 4) ? 4 : 0);
+	std::vector<u32> keys;
+	if (!readChunkRecords(keys, valuesPerKey))
+		return false;
 
-		B3DFile->read(&frame, sizeof(frame));
-#ifdef __BIG_ENDIAN__
-		frame = os::Byteswap::byteswap(frame);
-#endif
+	for (const u32 *in = keys.data(), *end = in + keys.size(); in != end;) {
+		s32 frame = (s32)*in++;
 
 		if (frame < 1) {
 			os::Printer::log("Illegal frame number found", B3DFile->getFileName(), ELL_ERROR);
@@ -590,15 +593,18 @@ bool CB3DMeshFileLoader::readChunkKEYS(SkinnedMesh::SJoint *inJoint)
 		// Add key frames, frames in Irrlicht are zero-based
 		f32 data[4];
 		if (flags & 1) {
-			readFloats(data, 3);
+			for (u32 i = 0; i < 3; ++i)
+				data[i] = core::FR(*in++);
 			AnimatedMesh.addPositionKey(inJoint, frame - 1, {data[0], data[1], data[2]});
 		}
 		if (flags & 2) {
-			readFloats(data, 3);
+			for (u32 i = 0; i < 3; ++i)
+				data[i] = core::FR(*in++);
 			AnimatedMesh.addScaleKey(inJoint, frame - 1, {data[0], data[1], data[2]});
 		}
 		if (flags & 4) {
-			readFloats(data, 4);
+			for (u32 i = 0; i < 4; ++i)
+				data[i] = core::FR(*in++);
 			AnimatedMesh.addRotationKey(inJoint, frame - 1, core::quaternion(data[1], data[2], data[3], data[0]));
 		}
 	}
@@ -845,5 +851,33 @@ void CB3DMeshFileLoader::readFloats(f32 *vec, u32 count)
 #endif
 }
 
+bool CB3DMeshFileLoader::readChunkRecords(std::vector<u32> &data, u32 valuesPerRecord)
+{
+	const long chunkEnd = B3dStack.getLast().startposition + B3dStack.getLast().length;
+	// checked before allocating, as the chunk length comes from the file
+	if (chunkEnd > B3DFile->getSize()) {
+		os::Printer::log("Chunk reaches past the end of file", B3DFile->getFileName(), ELL_ERROR);
+		return false;
+	}
+	const long pos = B3DFile->getPos();
+	const u32 records = chunkEnd > pos ? (u32)(chunkEnd - pos) / (valuesPerRecord * sizeof(u32)) : 0;
+
+	data.resize((size_t)records * valuesPerRecord);
+	const size_t bytes = data.size() * sizeof(u32);
+	if (bytes && B3DFile->read(data.data(), bytes) != bytes) {
+		os::Printer::log("Unexpected end of file in chunk", B3DFile->getFileName(), ELL_ERROR);
+		return false;
+	}
+#ifdef __BIG_ENDIAN__
+	for (u32 &value : data)
+		value = os::Byteswap::byteswap(value);
+#endif
+
+	// skip the rest of a malformed chunk
+	if (B3DFile->getPos() < chunkEnd && !B3DFile->seek(chunkEnd))
+		return false;
+	return true;
+}
+
 } // end namespace scene
 } // end namespace irr
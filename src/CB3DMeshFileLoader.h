@@ -14,6 +14,8 @@
 #include "SB3DStructs.h"
 #include "IReadFile.h"
 
+#include <vector>
+
 namespace irr
 {
 
@@ -52,6 +54,11 @@ private:
 	std::string readString();
 	void readFloats(f32 *vec, u32 count);
 
+	//! Reads all whole records left in the current chunk with a single read call.
+	/** Records are made of 4 byte values, a partial record at the end of the
+	chunk is skipped. \return False if the file ends before the chunk. */
+	bool readChunkRecords(std::vector<u32> &data, u32 valuesPerRecord);
+
 	core::array<SB3dChunk> B3dStack;
 
 	core::array<SB3dMaterial> Materials;
@@ -0,0 +1,150 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CClusteredMeshSceneNode.h"
+#include "ICameraSceneNode.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CClusteredMeshSceneNode::CClusteredMeshSceneNode(IMesh *mesh, u32 maxVertices, u32 maxTriangles,
+		ISceneNode *parent, ISceneManager *mgr, s32 id,
+		const core::vector3df &position, const core::vector3df &rotation,
+		const core::vector3df &scale) :
+		CMeshSceneNode(mesh, parent, mgr, id, position, rotation, scale),
+		ClusteredMesh(mesh), CulledPrimitives(0)
+{
+	if (!mesh)
+		return;
+
+	IMeshManipulator *manipulator = mgr->getMeshManipulator();
+	Clusters.resize(mesh->getMeshBufferCount());
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i) {
+		SBufferClusters &buffer = Clusters[i];
+		manipulator->buildClusters(mesh->getMeshBuffer(i), buffer.Clusters, maxVertices, maxTriangles);
+		for (const SMeshCluster &cluster : buffer.Clusters) {
+			buffer.CenterX.push_back(cluster.Center.X);
+			buffer.CenterY.push_back(cluster.Center.Y);
+			buffer.CenterZ.push_back(cluster.Center.Z);
+			buffer.Radius.push_back(cluster.Radius);
+		}
+	}
+}
+
+void CClusteredMeshSceneNode::OnRegisterSceneNode()
+{
+	CulledPrimitives = 0;
+	CMeshSceneNode::OnRegisterSceneNode();
+}
+
+//! renders the visible clusters
+void CClusteredMeshSceneNode::render()
+{
+	video::IVideoDriver *driver = SceneManager->getVideoDriver();
+	const ICameraSceneNode *camera = SceneManager->getActiveCamera();
+
+	// another mesh was set, e.g. a level of detail
+	if (!Mesh || Mesh != ClusteredMesh || !camera) {
+		CMeshSceneNode::render();
+		return;
+	}
+
+	const bool isTransparentPass =
+			SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	// the clusters are culled in the space of the node
+	const core::matrix4 invTrans(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE);
+	SViewFrustum frustum = *camera->getViewFrustum();
+	frustum.transform(invTrans);
+	core::vector3df cameraPosition = camera->getAbsolutePosition();
+	invTrans.transformVect(cameraPosition);
+
+	// the normal cones only stay valid with a uniform scale
+	const core::vector3df scale = AbsoluteTransformation.getScale();
+	const bool uniformScale = core::equals(scale.X, scale.Y, scale.X * 0.001f) &&
+			core::equals(scale.X, scale.Z, scale.X * 0.001f);
+
+	for (u32 i = 0; i < Mesh->getMeshBufferCount(); ++i) {
+		const IMeshBuffer *mb = Mesh->getMeshBuffer(i);
+		const video::SMaterial &material = SharedMaterials ? mb->getMaterial() : Materials[i];
+		if (driver->needsTransparentRenderPass(material) != isTransparentPass)
+			continue;
+
+		const SBufferClusters &buffer = Clusters[i];
+		if (buffer.Clusters.empty()) {
+			// not a triangle list
+			driver->setMaterial(material);
+			driver->drawMeshBuffer(mb);
+			continue;
+		}
+
+		// sphere against the planes, without branches so the compiler can vectorize it
+		const u32 count = buffer.Clusters.size();
+		Visible.assign(count, 1);
+		for (u32 p = 0; p < SViewFrustum::VF_PLANE_COUNT; ++p) {
+			const core::plane3df &plane = frustum.planes[p];
+			const f32 nx = plane.Normal.X, ny = plane.Normal.Y, nz = plane.Normal.Z, d = plane.D;
+			const f32 *cx = buffer.CenterX.data(), *cy = buffer.CenterY.data(), *cz = buffer.CenterZ.data();
+			const f32 *r = buffer.Radius.data();
+			u8 *visible = Visible.data();
+			for (u32 c = 0; c < count; ++c)
+				visible[c] &= (nx * cx[c] + ny * cy[c] + nz * cz[c] + d) <= r[c];
+		}
+
+		if (material.BackfaceCulling && uniformScale) {
+			for (u32 c = 0; c < count; ++c) {
+				const SMeshCluster &cluster = buffer.Clusters[c];
+				const core::vector3df toCluster = cluster.Center - cameraPosition;
+				if (toCluster.dotProduct(cluster.ConeAxis) >= cluster.ConeCutoff * toCluster.getLength() + cluster.Radius)
+					Visible[c] = 0;
+			}
+		}
+
+		driver->setMaterial(material);
+
+		// neighbouring visible clusters are drawn together
+		u32 first = 0, indexCount = 0;
+		for (u32 c = 0; c < count; ++c) {
+			const SMeshCluster &cluster = buffer.Clusters[c];
+			if (!Visible[c]) {
+				CulledPrimitives += cluster.IndexCount / 3;
+				continue;
+			}
+			if (indexCount && first + indexCount == cluster.FirstIndex) {
+				indexCount += cluster.IndexCount;
+				continue;
+			}
+			if (indexCount)
+				driver->drawBufferRange(mb->getVertexBuffer(), mb->getIndexBuffer(), first, indexCount / 3);
+			first = cluster.FirstIndex;
+			indexCount = cluster.IndexCount;
+		}
+		if (indexCount)
+			driver->drawBufferRange(mb->getVertexBuffer(), mb->getIndexBuffer(), first, indexCount / 3);
+	}
+
+	if (DebugDataVisible & scene::EDS_BBOX_BUFFERS) {
+		video::SMaterial m;
+		m.AntiAliasing = video::EAAM_OFF;
+		m.ZBuffer = video::ECFN_DISABLED;
+		driver->setMaterial(m);
+		for (const SBufferClusters &buffer : Clusters) {
+			for (const SMeshCluster &cluster : buffer.Clusters) {
+				const core::vector3df extent(cluster.Radius, cluster.Radius, cluster.Radius);
+				driver->draw3DBox(core::aabbox3df(cluster.Center - extent, cluster.Center + extent),
+						video::SColor(255, 190, 128, 128));
+			}
+		}
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
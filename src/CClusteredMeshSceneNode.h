@@ -0,0 +1,58 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "CMeshSceneNode.h"
+#include "IMeshManipulator.h"
+
+#include <vector>
+
+namespace irr
+{
+namespace scene
+{
+
+//! Draws a static mesh split into clusters which are culled one by one
+/** The clusters outside of the view frustum, or facing away from the camera
+when back faces are culled, are skipped, neighbouring visible clusters are
+drawn with one call. */
+class CClusteredMeshSceneNode : public CMeshSceneNode
+{
+public:
+	//! constructor, reorders the triangles of the mesh into clusters
+	CClusteredMeshSceneNode(IMesh *mesh, u32 maxVertices, u32 maxTriangles,
+			ISceneNode *parent, ISceneManager *mgr, s32 id,
+			const core::vector3df &position = core::vector3df(0, 0, 0),
+			const core::vector3df &rotation = core::vector3df(0, 0, 0),
+			const core::vector3df &scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+	//! renders the visible clusters
+	void render() override;
+
+	void OnRegisterSceneNode() override;
+
+	//! Get the clusters of a mesh buffer
+	const std::vector<SMeshCluster> &getClusters(u32 buffer) const { return Clusters[buffer].Clusters; }
+
+	//! Number of triangles skipped by the render() calls of this frame
+	u32 getCulledPrimitiveCount() const { return CulledPrimitives; }
+
+private:
+	struct SBufferClusters
+	{
+		std::vector<SMeshCluster> Clusters;
+		//! Bounding spheres as separate arrays for the culling loop
+		std::vector<f32> CenterX, CenterY, CenterZ, Radius;
+	};
+
+	//! Mesh the clusters were built for
+	const IMesh *ClusteredMesh;
+	std::vector<SBufferClusters> Clusters;
+	//! Whether each cluster of the buffer being drawn is visible
+	std::vector<u8> Visible;
+	u32 CulledPrimitives;
+};
+
+} // end namespace scene
+} // end namespace irr
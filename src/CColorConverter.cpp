@@ -6,6 +6,7 @@
 #include "SColor.h"
 #include "os.h"
 #include "irrString.h"
+#include "CColorConverterSIMD.h"
 
 // Warning: The naming of Irrlicht color formats
 // is not consistent regarding actual component order in memory.
@@ -21,6 +22,63 @@ namespace irr
 namespace video
 {
 
+namespace
+{
+struct SActiveKernels
+{
+	CColorConverter::E_SIMD_LEVEL Level;
+	ColorConverterSIMD::SConvertKernels Kernels;
+
+	SActiveKernels() :
+			Level(CColorConverter::getBestSIMDLevel()),
+			Kernels(ColorConverterSIMD::getKernels(Level))
+	{
+	}
+};
+
+SActiveKernels &activeKernels()
+{
+	static SActiveKernels active;
+	return active;
+}
+
+inline const ColorConverterSIMD::SConvertKernels &kernels()
+{
+	return activeKernels().Kernels;
+}
+
+//! Runs the accelerated kernel, if any, and returns the number of pixels it converted
+inline s32 convertBulk(ColorConverterSIMD::ConvertKernel kernel, const void *sP, s32 sN, void *dP)
+{
+	return (kernel && sN > 0) ? kernel(sP, sN, dP) : 0;
+}
+}
+
+CColorConverter::E_SIMD_LEVEL CColorConverter::getBestSIMDLevel()
+{
+	const E_SIMD_LEVEL preferred[] = {ESL_NEON, ESL_AVX2, ESL_SSSE3, ESL_SSE2};
+	for (E_SIMD_LEVEL level : preferred) {
+		if (ColorConverterSIMD::isSupported(level))
+			return level;
+	}
+	return ESL_SCALAR;
+}
+
+CColorConverter::E_SIMD_LEVEL CColorConverter::getSIMDLevel()
+{
+	return activeKernels().Level;
+}
+
+bool CColorConverter::setSIMDLevel(E_SIMD_LEVEL level)
+{
+	if (!ColorConverterSIMD::isSupported(level))
+		return false;
+	SActiveKernels &active = activeKernels();
+	active.Level = level;
+	active.Kernels = ColorConverterSIMD::getKernels(level);
+	return true;
+}
+
 //! converts a monochrome bitmap to A1R5G5B5 data
 void CColorConverter::convert1BitTo16Bit(const u8 *in, s16 *out, s32 width, s32 height, s32 linepad, bool flip)
 {
@@ -323,10 +381,11 @@ void CColorConverter::convert_A1R5G5B5toB8G8R8(const void *sP, s32 sN, void *dP)
 
 void CColorConverter::convert_A1R5G5B5toR5G5B5A1(const void *sP, s32 sN, void *dP)
 {
-	const u16 *sB = (const u16 *)sP;
-	u16 *dB = (u16 *)dP;
+	const s32 done = convertBulk(kernels().A1R5G5B5toR5G5B5A1, sP, sN, dP);
+	const u16 *sB = (const u16 *)sP + done;
+	u16 *dB = (u16 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		*dB = (*sB << 1) | (*sB >> 15);
 		++sB;
 		++dB;
@@ -335,10 +394,11 @@ void CColorConverter::convert_A1R5G5B5toR5G5B5A1(const void *sP, s32 sN, void *d
 
 void CColorConverter::convert_A1R5G5B5toA8R8G8B8(const void *sP, s32 sN, void *dP)
 {
-	u16 *sB = (u16 *)sP;
-	u32 *dB = (u32 *)dP;
+	const s32 done = convertBulk(kernels().A1R5G5B5toA8R8G8B8, sP, sN, dP);
+	u16 *sB = (u16 *)sP + done;
+	u32 *dB = (u32 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A1R5G5B5toA8R8G8B8(*sB++);
 }
 
@@ -349,19 +409,21 @@ void CColorConverter::convert_A1R5G5B5toA1R5G5B5(const void *sP, s32 sN, void *d
 
 void CColorConverter::convert_A1R5G5B5toR5G6B5(const void *sP, s32 sN, void *dP)
 {
-	u16 *sB = (u16 *)sP;
-	u16 *dB = (u16 *)dP;
+	const s32 done = convertBulk(kernels().A1R5G5B5toR5G6B5, sP, sN, dP);
+	u16 *sB = (u16 *)sP + done;
+	u16 *dB = (u16 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A1R5G5B5toR5G6B5(*sB++);
 }
 
 void CColorConverter::convert_A8R8G8B8toR8G8B8(const void *sP, s32 sN, void *dP)
 {
-	u8 *sB = (u8 *)sP;
-	u8 *dB = (u8 *)dP;
+	const s32 done = convertBulk(kernels().A8R8G8B8toR8G8B8, sP, sN, dP);
+	u8 *sB = (u8 *)sP + done * 4;
+	u8 *dB = (u8 *)dP + done * 3;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		// sB[3] is alpha
 		dB[0] = sB[2];
 		dB[1] = sB[1];
@@ -374,10 +436,11 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8(const void *sP, s32 sN, void *dP)
 
 void CColorConverter::convert_A8R8G8B8toB8G8R8(const void *sP, s32 sN, void *dP)
 {
-	u8 *sB = (u8 *)sP;
-	u8 *dB = (u8 *)dP;
+	const s32 done = convertBulk(kernels().A8R8G8B8toB8G8R8, sP, sN, dP);
+	u8 *sB = (u8 *)sP + done * 4;
+	u8 *dB = (u8 *)dP + done * 3;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		// sB[3] is alpha
 		dB[0] = sB[0];
 		dB[1] = sB[1];
@@ -395,19 +458,21 @@ void CColorConverter::convert_A8R8G8B8toA8R8G8B8(const void *sP, s32 sN, void *d
 
 void CColorConverter::convert_A8R8G8B8toA1R5G5B5(const void *sP, s32 sN, void *dP)
 {
-	u32 *sB = (u32 *)sP;
-	u16 *dB = (u16 *)dP;
+	const s32 done = convertBulk(kernels().A8R8G8B8toA1R5G5B5, sP, sN, dP);
+	u32 *sB = (u32 *)sP + done;
+	u16 *dB = (u16 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A8R8G8B8toA1R5G5B5(*sB++);
 }
 
 void CColorConverter::convert_A8R8G8B8toA1B5G5R5(const void *sP, s32 sN, void *dP)
 {
-	u8 *sB = (u8 *)sP;
-	u16 *dB = (u16 *)dP;
+	const s32 done = convertBulk(kernels().A8R8G8B8toA1B5G5R5, sP, sN, dP);
+	u8 *sB = (u8 *)sP + done * 4;
+	u16 *dB = (u16 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		s32 r = sB[0] >> 3;
 		s32 g = sB[1] >> 3;
 		s32 b = sB[2] >> 3;
@@ -422,10 +487,11 @@ void CColorConverter::convert_A8R8G8B8toA1B5G5R5(const void *sP, s32 sN, void *d
 
 void CColorConverter::convert_A8R8G8B8toR5G6B5(const void *sP, s32 sN, void *dP)
 {
-	u8 *sB = (u8 *)sP;
-	u16 *dB = (u16 *)dP;
+	const s32 done = convertBulk(kernels().A8R8G8B8toR5G6B5, sP, sN, dP);
+	u8 *sB = (u8 *)sP + done * 4;
+	u16 *dB = (u16 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		s32 r = sB[2] >> 3;
 		s32 g = sB[1] >> 2;
 		s32 b = sB[0] >> 3;
@@ -461,10 +527,11 @@ void CColorConverter::convert_R8G8B8toR8G8B8(const void *sP, s32 sN, void *dP)
 
 void CColorConverter::convert_R8G8B8toA8R8G8B8(const void *sP, s32 sN, void *dP)
 {
-	u8 *sB = (u8 *)sP;
-	u32 *dB = (u32 *)dP;
+	const s32 done = convertBulk(kernels().R8G8B8toA8R8G8B8, sP, sN, dP);
+	u8 *sB = (u8 *)sP + done * 3;
+	u32 *dB = (u32 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		*dB = 0xff000000 | (sB[0] << 16) | (sB[1] << 8) | sB[2];
 
 		sB += 3;
@@ -474,10 +541,11 @@ void CColorConverter::convert_R8G8B8toA8R8G8B8(const void *sP, s32 sN, void *dP)
 
 void CColorConverter::convert_R8G8B8toA1R5G5B5(const void *sP, s32 sN, void *dP)
 {
-	u8 *sB = (u8 *)sP;
-	u16 *dB = (u16 *)dP;
+	const s32 done = convertBulk(kernels().R8G8B8toA1R5G5B5, sP, sN, dP);
+	u8 *sB = (u8 *)sP + done * 3;
+	u16 *dB = (u16 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		s32 r = sB[0] >> 3;
 		s32 g = sB[1] >> 3;
 		s32 b = sB[2] >> 3;
@@ -491,10 +559,11 @@ void CColorConverter::convert_R8G8B8toA1R5G5B5(const void *sP, s32 sN, void *dP)
 
 void CColorConverter::convert_A8R8G8B8toR8G8B8A8(const void *sP, s32 sN, void *dP)
 {
-	const u32 *sB = (const u32 *)sP;
-	u32 *dB = (u32 *)dP;
+	const s32 done = convertBulk(kernels().A8R8G8B8toR8G8B8A8, sP, sN, dP);
+	const u32 *sB = (const u32 *)sP + done;
+	u32 *dB = (u32 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		*dB++ = (*sB << 8) | (*sB >> 24);
 		++sB;
 	}
@@ -502,10 +571,11 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8A8(const void *sP, s32 sN, void *d
 
 void CColorConverter::convert_A8R8G8B8toA8B8G8R8(const void *sP, s32 sN, void *dP)
 {
-	const u32 *sB = (const u32 *)sP;
-	u32 *dB = (u32 *)dP;
+	const s32 done = convertBulk(kernels().A8R8G8B8toA8B8G8R8, sP, sN, dP);
+	const u32 *sB = (const u32 *)sP + done;
+	u32 *dB = (u32 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		*dB++ = (*sB & 0xff00ff00) | ((*sB & 0x00ff0000) >> 16) | ((*sB & 0x000000ff) << 16);
 		++sB;
 	}
@@ -513,10 +583,11 @@ void CColorConverter::convert_A8R8G8B8toA8B8G8R8(const void *sP, s32 sN, void *d
 
 void CColorConverter::convert_R8G8B8toB8G8R8(const void *sP, s32 sN, void *dP)
 {
-	u8 *sB = (u8 *)sP;
-	u8 *dB = (u8 *)dP;
+	const s32 done = convertBulk(kernels().R8G8B8toB8G8R8, sP, sN, dP);
+	u8 *sB = (u8 *)sP + done * 3;
+	u8 *dB = (u8 *)dP + done * 3;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		dB[2] = sB[0];
 		dB[1] = sB[1];
 		dB[0] = sB[2];
@@ -528,10 +599,11 @@ void CColorConverter::convert_R8G8B8toB8G8R8(const void *sP, s32 sN, void *dP)
 
 void CColorConverter::convert_R8G8B8toR5G6B5(const void *sP, s32 sN, void *dP)
 {
-	u8 *sB = (u8 *)sP;
-	u16 *dB = (u16 *)dP;
+	const s32 done = convertBulk(kernels().R8G8B8toR5G6B5, sP, sN, dP);
+	u8 *sB = (u8 *)sP + done * 3;
+	u16 *dB = (u16 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		s32 r = sB[0] >> 3;
 		s32 g = sB[1] >> 2;
 		s32 b = sB[2] >> 3;
@@ -580,19 +652,21 @@ void CColorConverter::convert_R5G6B5toB8G8R8(const void *sP, s32 sN, void *dP)
 
 void CColorConverter::convert_R5G6B5toA8R8G8B8(const void *sP, s32 sN, void *dP)
 {
-	u16 *sB = (u16 *)sP;
-	u32 *dB = (u32 *)dP;
+	const s32 done = convertBulk(kernels().R5G6B5toA8R8G8B8, sP, sN, dP);
+	u16 *sB = (u16 *)sP + done;
+	u32 *dB = (u32 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = R5G6B5toA8R8G8B8(*sB++);
 }
 
 void CColorConverter::convert_R5G6B5toA1R5G5B5(const void *sP, s32 sN, void *dP)
 {
-	u16 *sB = (u16 *)sP;
-	u16 *dB = (u16 *)dP;
+	const s32 done = convertBulk(kernels().R5G6B5toA1R5G5B5, sP, sN, dP);
+	u16 *sB = (u16 *)sP + done;
+	u16 *dB = (u16 *)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = R5G6B5toA1R5G5B5(*sB++);
 }
 
@@ -15,6 +15,29 @@ namespace video
 class CColorConverter
 {
 public:
+	//! Instruction sets the convert_* routines can be accelerated with
+	enum E_SIMD_LEVEL
+	{
+		//! plain C++, the reference implementation
+		ESL_SCALAR = 0,
+		ESL_SSE2,
+		ESL_SSSE3,
+		ESL_AVX2,
+		ESL_NEON
+	};
+
+	//! Returns the best instruction set supported by the build and the processor
+	static E_SIMD_LEVEL getBestSIMDLevel();
+
+	//! Returns the instruction set currently used by the convert_* routines
+	static E_SIMD_LEVEL getSIMDLevel();
+
+	//! Selects the instruction set used by the convert_* routines.
+	/** Mainly useful to verify the accelerated routines against ESL_SCALAR.
+	Not thread-safe with conversions running in parallel.
+	\return False if the level is not supported, nothing is changed then. */
+	static bool setSIMDLevel(E_SIMD_LEVEL level);
+
 	//! converts a monochrome bitmap to A1R5G5B5
 	static void convert1BitTo16Bit(const u8 *in, s16 *out, s32 width, s32 height, s32 linepad = 0, bool flip = false);
 
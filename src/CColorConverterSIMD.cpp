@@ -0,0 +1,722 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CColorConverterSIMD.h"
+#include "SIMD_helper.h"
+#include "os.h"
+
+// Every kernel must produce exactly the same bytes as the scalar code in
+// CColorConverter.cpp, including its quirks (e.g. no bit replication when
+// expanding R5G6B5). The scalar functions stay the reference; see
+// test/color_converter_test.cpp.
+
+namespace irr
+{
+namespace video
+{
+namespace ColorConverterSIMD
+{
+
+#if defined(IRR_ARCH_X86)
+
+// ----------------------------------------------------------------
+// SSE2
+// ----------------------------------------------------------------
+
+#define TARGET_SSE2 IRR_TARGET("sse2")
+
+TARGET_SSE2 static inline __m128i sse2_A1R5G5B5toA8R8G8B8(__m128i c)
+{
+	const __m128i a = _mm_and_si128(_mm_srai_epi32(_mm_slli_epi32(c, 16), 31), _mm_set1_epi32((s32)0xFF000000));
+	const __m128i r = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7C00)), 9),
+			_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7000)), 4));
+	const __m128i g = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x03E0)), 6),
+			_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0380)), 1));
+	const __m128i b = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3),
+			_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001C)), 2));
+	return _mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b));
+}
+
+TARGET_SSE2 static inline __m128i sse2_R5G6B5toA8R8G8B8(__m128i c)
+{
+	const __m128i r = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0xF800)), 8);
+	const __m128i g = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x07E0)), 5);
+	const __m128i b = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3);
+	return _mm_or_si128(_mm_or_si128(_mm_set1_epi32((s32)0xFF000000), r), _mm_or_si128(g, b));
+}
+
+TARGET_SSE2 static inline __m128i sse2_A8R8G8B8toA1R5G5B5(__m128i c)
+{
+	const __m128i a = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32((s32)0x80000000)), 16);
+	const __m128i r = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00F80000)), 9);
+	const __m128i g = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000F800)), 6);
+	const __m128i b = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000000F8)), 3);
+	return _mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b));
+}
+
+TARGET_SSE2 static inline __m128i sse2_A8R8G8B8toA1B5G5R5(__m128i c)
+{
+	const __m128i a = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(c, 27), _mm_set1_epi32(1)), 15);
+	const __m128i r = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0xF8)), 7);
+	const __m128i g = _mm_and_si128(_mm_srli_epi32(c, 6), _mm_set1_epi32(0x3E0));
+	const __m128i b = _mm_and_si128(_mm_srli_epi32(c, 19), _mm_set1_epi32(0x1F));
+	return _mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b));
+}
+
+TARGET_SSE2 static inline __m128i sse2_A8R8G8B8toR5G6B5(__m128i c)
+{
+	const __m128i r = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00F80000)), 8);
+	const __m128i g = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000FC00)), 5);
+	const __m128i b = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000000F8)), 3);
+	return _mm_or_si128(r, _mm_or_si128(g, b));
+}
+
+//! packs the low 16 bits of each 32 bit lane, without saturation
+TARGET_SSE2 static inline __m128i sse2_pack32to16(__m128i lo, __m128i hi)
+{
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+// 16 bit to 32 bit, 8 pixels per iteration
+#define SSE2_KERNEL_16TO32(name)                                              \
+	TARGET_SSE2 static s32 sse2_##name(const void *sP, s32 sN, void *dP)      \
+	{                                                                         \
+		const __m128i *sB = (const __m128i *)sP;                              \
+		__m128i *dB = (__m128i *)dP;                                          \
+		const __m128i zero = _mm_setzero_si128();                             \
+		s32 x = 0;                                                            \
+		for (; x + 8 <= sN; x += 8) {                                         \
+			const __m128i c = _mm_loadu_si128(sB++);                          \
+			_mm_storeu_si128(dB++, sse2_##name(_mm_unpacklo_epi16(c, zero))); \
+			_mm_storeu_si128(dB++, sse2_##name(_mm_unpackhi_epi16(c, zero))); \
+		}                                                                     \
+		return x;                                                             \
+	}
+
+// 32 bit to 16 bit, 8 pixels per iteration
+#define SSE2_KERNEL_32TO16(name)                                         \
+	TARGET_SSE2 static s32 sse2_##name(const void *sP, s32 sN, void *dP) \
+	{                                                                    \
+		const __m128i *sB = (const __m128i *)sP;                         \
+		__m128i *dB = (__m128i *)dP;                                     \
+		s32 x = 0;                                                       \
+		for (; x + 8 <= sN; x += 8) {                                    \
+			const __m128i lo = sse2_##name(_mm_loadu_si128(sB++));       \
+			const __m128i hi = sse2_##name(_mm_loadu_si128(sB++));       \
+			_mm_storeu_si128(dB++, sse2_pack32to16(lo, hi));             \
+		}                                                                \
+		return x;                                                        \
+	}
+
+SSE2_KERNEL_16TO32(A1R5G5B5toA8R8G8B8)
+SSE2_KERNEL_16TO32(R5G6B5toA8R8G8B8)
+SSE2_KERNEL_32TO16(A8R8G8B8toA1R5G5B5)
+SSE2_KERNEL_32TO16(A8R8G8B8toA1B5G5R5)
+SSE2_KERNEL_32TO16(A8R8G8B8toR5G6B5)
+
+TARGET_SSE2 static s32 sse2_A1R5G5B5toR5G5B5A1(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const __m128i c = _mm_loadu_si128(sB++);
+		_mm_storeu_si128(dB++, _mm_or_si128(_mm_slli_epi16(c, 1), _mm_srli_epi16(c, 15)));
+	}
+	return x;
+}
+
+TARGET_SSE2 static s32 sse2_A1R5G5B5toR5G6B5(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	const __m128i rg = _mm_set1_epi16(0x7FE0);
+	const __m128i b = _mm_set1_epi16(0x001F);
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const __m128i c = _mm_loadu_si128(sB++);
+		_mm_storeu_si128(dB++, _mm_or_si128(_mm_slli_epi16(_mm_and_si128(c, rg), 1), _mm_and_si128(c, b)));
+	}
+	return x;
+}
+
+TARGET_SSE2 static s32 sse2_R5G6B5toA1R5G5B5(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	const __m128i a = _mm_set1_epi16((s16)0x8000);
+	const __m128i rg = _mm_set1_epi16((s16)0xFFC0);
+	const __m128i b = _mm_set1_epi16(0x001F);
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const __m128i c = _mm_loadu_si128(sB++);
+		const __m128i v = _mm_or_si128(_mm_srli_epi16(_mm_and_si128(c, rg), 1), _mm_and_si128(c, b));
+		_mm_storeu_si128(dB++, _mm_or_si128(a, v));
+	}
+	return x;
+}
+
+TARGET_SSE2 static s32 sse2_A8R8G8B8toR8G8B8A8(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	s32 x = 0;
+	for (; x + 4 <= sN; x += 4) {
+		const __m128i c = _mm_loadu_si128(sB++);
+		_mm_storeu_si128(dB++, _mm_or_si128(_mm_slli_epi32(c, 8), _mm_srli_epi32(c, 24)));
+	}
+	return x;
+}
+
+TARGET_SSE2 static s32 sse2_A8R8G8B8toA8B8G8R8(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	const __m128i ag = _mm_set1_epi32((s32)0xFF00FF00);
+	const __m128i rb = _mm_set1_epi32(0x00FF00FF);
+	s32 x = 0;
+	for (; x + 4 <= sN; x += 4) {
+		const __m128i c = _mm_loadu_si128(sB++);
+		const __m128i v = _mm_and_si128(c, rb);
+		const __m128i swapped = _mm_or_si128(_mm_srli_epi32(v, 16), _mm_slli_epi32(v, 16));
+		_mm_storeu_si128(dB++, _mm_or_si128(_mm_and_si128(c, ag), swapped));
+	}
+	return x;
+}
+
+// ----------------------------------------------------------------
+// SSSE3: byte shuffles for the 24 bit formats
+// ----------------------------------------------------------------
+
+#define TARGET_SSSE3 IRR_TARGET("ssse3")
+
+//! joins four registers holding 12 valid bytes each into 48 contiguous bytes
+TARGET_SSSE3 static inline void ssse3_store12x4(__m128i *dB, __m128i a, __m128i b, __m128i c, __m128i d)
+{
+	_mm_storeu_si128(dB + 0, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+	_mm_storeu_si128(dB + 1, _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+	_mm_storeu_si128(dB + 2, _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+}
+
+//! splits 48 contiguous bytes into four registers with 12 valid bytes each
+TARGET_SSSE3 static inline void ssse3_load12x4(const __m128i *sB, __m128i out[4])
+{
+	const __m128i s0 = _mm_loadu_si128(sB + 0);
+	const __m128i s1 = _mm_loadu_si128(sB + 1);
+	const __m128i s2 = _mm_loadu_si128(sB + 2);
+	out[0] = s0;
+	out[1] = _mm_alignr_epi8(s1, s0, 12);
+	out[2] = _mm_alignr_epi8(s2, s1, 8);
+	out[3] = _mm_srli_si128(s2, 4);
+}
+
+//! [R][G][B] to 0x00RRGGBB, four pixels
+TARGET_SSSE3 static inline __m128i ssse3_expandRGB(__m128i v)
+{
+	const __m128i mask = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+	return _mm_shuffle_epi8(v, mask);
+}
+
+TARGET_SSSE3 static s32 ssse3_A8R8G8B8toR8G8B8(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	const __m128i mask = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(sB + 0), mask);
+		const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(sB + 1), mask);
+		const __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(sB + 2), mask);
+		const __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(sB + 3), mask);
+		ssse3_store12x4(dB, a, b, c, d);
+		sB += 4;
+		dB += 3;
+	}
+	return x;
+}
+
+TARGET_SSSE3 static s32 ssse3_A8R8G8B8toB8G8R8(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(sB + 0), mask);
+		const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(sB + 1), mask);
+		const __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(sB + 2), mask);
+		const __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(sB + 3), mask);
+		ssse3_store12x4(dB, a, b, c, d);
+		sB += 4;
+		dB += 3;
+	}
+	return x;
+}
+
+TARGET_SSSE3 static s32 ssse3_A8R8G8B8toA8B8G8R8(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+	s32 x = 0;
+	for (; x + 4 <= sN; x += 4)
+		_mm_storeu_si128(dB++, _mm_shuffle_epi8(_mm_loadu_si128(sB++), mask));
+	return x;
+}
+
+TARGET_SSSE3 static s32 ssse3_R8G8B8toA8R8G8B8(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	const __m128i alpha = _mm_set1_epi32((s32)0xFF000000);
+	__m128i v[4];
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		ssse3_load12x4(sB, v);
+		for (u32 i = 0; i < 4; ++i)
+			_mm_storeu_si128(dB++, _mm_or_si128(ssse3_expandRGB(v[i]), alpha));
+		sB += 3;
+	}
+	return x;
+}
+
+TARGET_SSSE3 static s32 ssse3_R8G8B8toB8G8R8(const void *sP, s32 sN, void *dP)
+{
+	const __m128i *sB = (const __m128i *)sP;
+	__m128i *dB = (__m128i *)dP;
+	const __m128i mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1);
+	__m128i v[4];
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		ssse3_load12x4(sB, v);
+		ssse3_store12x4(dB, _mm_shuffle_epi8(v[0], mask), _mm_shuffle_epi8(v[1], mask),
+				_mm_shuffle_epi8(v[2], mask), _mm_shuffle_epi8(v[3], mask));
+		sB += 3;
+		dB += 3;
+	}
+	return x;
+}
+
+// 24 bit to 16 bit, going through 0x00RRGGBB
+#define SSSE3_KERNEL_24TO16(name, convert, alpha)                          \
+	TARGET_SSSE3 static s32 ssse3_##name(const void *sP, s32 sN, void *dP) \
+	{                                                                      \
+		const __m128i *sB = (const __m128i *)sP;                           \
+		__m128i *dB = (__m128i *)dP;                                       \
+		const __m128i a = _mm_set1_epi32(alpha);                           \
+		__m128i v[4];                                                      \
+		s32 x = 0;                                                         \
+		for (; x + 16 <= sN; x += 16) {                                    \
+			ssse3_load12x4(sB, v);                                         \
+			for (u32 i = 0; i < 4; ++i)                                    \
+				v[i] = _mm_or_si128(convert(ssse3_expandRGB(v[i])), a);    \
+			_mm_storeu_si128(dB++, sse2_pack32to16(v[0], v[1]));           \
+			_mm_storeu_si128(dB++, sse2_pack32to16(v[2], v[3]));           \
+			sB += 3;                                                       \
+		}                                                                  \
+		return x;                                                          \
+	}
+
+SSSE3_KERNEL_24TO16(R8G8B8toA1R5G5B5, sse2_A8R8G8B8toA1R5G5B5, 0x8000)
+SSSE3_KERNEL_24TO16(R8G8B8toR5G6B5, sse2_A8R8G8B8toR5G6B5, 0)
+
+// ----------------------------------------------------------------
+// AVX2
+// ----------------------------------------------------------------
+
+#define TARGET_AVX2 IRR_TARGET("avx2")
+
+TARGET_AVX2 static inline __m256i avx2_A1R5G5B5toA8R8G8B8(__m256i c)
+{
+	const __m256i a = _mm256_and_si256(_mm256_srai_epi32(_mm256_slli_epi32(c, 16), 31), _mm256_set1_epi32((s32)0xFF000000));
+	const __m256i r = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x7C00)), 9),
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x7000)), 4));
+	const __m256i g = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x03E0)), 6),
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x0380)), 1));
+	const __m256i b = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001F)), 3),
+			_mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001C)), 2));
+	return _mm256_or_si256(_mm256_or_si256(a, r), _mm256_or_si256(g, b));
+}
+
+TARGET_AVX2 static inline __m256i avx2_R5G6B5toA8R8G8B8(__m256i c)
+{
+	const __m256i r = _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0xF800)), 8);
+	const __m256i g = _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x07E0)), 5);
+	const __m256i b = _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001F)), 3);
+	return _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32((s32)0xFF000000), r), _mm256_or_si256(g, b));
+}
+
+TARGET_AVX2 static inline __m256i avx2_A8R8G8B8toA1R5G5B5(__m256i c)
+{
+	const __m256i a = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32((s32)0x80000000)), 16);
+	const __m256i r = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x00F80000)), 9);
+	const __m256i g = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x0000F800)), 6);
+	const __m256i b = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x000000F8)), 3);
+	return _mm256_or_si256(_mm256_or_si256(a, r), _mm256_or_si256(g, b));
+}
+
+TARGET_AVX2 static inline __m256i avx2_A8R8G8B8toR5G6B5(__m256i c)
+{
+	const __m256i r = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x00F80000)), 8);
+	const __m256i g = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x0000FC00)), 5);
+	const __m256i b = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x000000F8)), 3);
+	return _mm256_or_si256(r, _mm256_or_si256(g, b));
+}
+
+// 16 bit to 32 bit, 8 pixels per iteration
+#define AVX2_KERNEL_16TO32(name)                                            \
+	TARGET_AVX2 static s32 avx2_##name(const void *sP, s32 sN, void *dP)    \
+	{                                                                       \
+		const __m128i *sB = (const __m128i *)sP;                            \
+		__m256i *dB = (__m256i *)dP;                                        \
+		s32 x = 0;                                                          \
+		for (; x + 8 <= sN; x += 8) {                                       \
+			const __m256i c = _mm256_cvtepu16_epi32(_mm_loadu_si128(sB++)); \
+			_mm256_storeu_si256(dB++, avx2_##name(c));                      \
+		}                                                                   \
+		return x;                                                           \
+	}
+
+// 32 bit to 16 bit, 16 pixels per iteration
+#define AVX2_KERNEL_32TO16(name)                                               \
+	TARGET_AVX2 static s32 avx2_##name(const void *sP, s32 sN, void *dP)       \
+	{                                                                          \
+		const __m256i *sB = (const __m256i *)sP;                               \
+		__m256i *dB = (__m256i *)dP;                                           \
+		s32 x = 0;                                                             \
+		for (; x + 16 <= sN; x += 16) {                                        \
+			__m256i lo = avx2_##name(_mm256_loadu_si256(sB++));                \
+			__m256i hi = avx2_##name(_mm256_loadu_si256(sB++));                \
+			lo = _mm256_srai_epi32(_mm256_slli_epi32(lo, 16), 16);             \
+			hi = _mm256_srai_epi32(_mm256_slli_epi32(hi, 16), 16);             \
+			/* packs works per 128 bit lane, restore the pixel order */        \
+			const __m256i packed = _mm256_packs_epi32(lo, hi);                 \
+			_mm256_storeu_si256(dB++, _mm256_permute4x64_epi64(packed, 0xD8)); \
+		}                                                                      \
+		return x;                                                              \
+	}
+
+AVX2_KERNEL_16TO32(A1R5G5B5toA8R8G8B8)
+AVX2_KERNEL_16TO32(R5G6B5toA8R8G8B8)
+AVX2_KERNEL_32TO16(A8R8G8B8toA1R5G5B5)
+AVX2_KERNEL_32TO16(A8R8G8B8toR5G6B5)
+
+TARGET_AVX2 static s32 avx2_A8R8G8B8toR8G8B8A8(const void *sP, s32 sN, void *dP)
+{
+	const __m256i *sB = (const __m256i *)sP;
+	__m256i *dB = (__m256i *)dP;
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const __m256i c = _mm256_loadu_si256(sB++);
+		_mm256_storeu_si256(dB++, _mm256_or_si256(_mm256_slli_epi32(c, 8), _mm256_srli_epi32(c, 24)));
+	}
+	return x;
+}
+
+TARGET_AVX2 static s32 avx2_A8R8G8B8toA8B8G8R8(const void *sP, s32 sN, void *dP)
+{
+	const __m256i *sB = (const __m256i *)sP;
+	__m256i *dB = (__m256i *)dP;
+	const __m256i mask = _mm256_setr_epi8(
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+		_mm256_storeu_si256(dB++, _mm256_shuffle_epi8(_mm256_loadu_si256(sB++), mask));
+	return x;
+}
+
+TARGET_AVX2 static s32 avx2_A8R8G8B8toR8G8B8(const void *sP, s32 sN, void *dP)
+{
+	const __m256i *sB = (const __m256i *)sP;
+	u8 *dB = (u8 *)dP;
+	const __m256i mask = _mm256_setr_epi8(
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	// move the 12 valid bytes of the upper lane next to the lower ones
+	const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		__m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256(sB++), mask);
+		v = _mm256_permutevar8x32_epi32(v, compact);
+		_mm_storeu_si128((__m128i *)dB, _mm256_castsi256_si128(v));
+		_mm_storel_epi64((__m128i *)(dB + 16), _mm256_extracti128_si256(v, 1));
+		dB += 24;
+	}
+	return x;
+}
+
+#undef TARGET_SSE2
+#undef TARGET_SSSE3
+#undef TARGET_AVX2
+
+#elif defined(IRR_ARCH_NEON)
+
+// ----------------------------------------------------------------
+// NEON: interleaved loads/stores do the byte shuffling
+// ----------------------------------------------------------------
+
+static s32 neon_A8R8G8B8toR8G8B8(const void *sP, s32 sN, void *dP)
+{
+	const u8 *sB = (const u8 *)sP;
+	u8 *dB = (u8 *)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const uint8x16x4_t c = vld4q_u8(sB);
+		uint8x16x3_t o;
+		o.val[0] = c.val[2];
+		o.val[1] = c.val[1];
+		o.val[2] = c.val[0];
+		vst3q_u8(dB, o);
+		sB += 64;
+		dB += 48;
+	}
+	return x;
+}
+
+static s32 neon_A8R8G8B8toB8G8R8(const void *sP, s32 sN, void *dP)
+{
+	const u8 *sB = (const u8 *)sP;
+	u8 *dB = (u8 *)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const uint8x16x4_t c = vld4q_u8(sB);
+		uint8x16x3_t o;
+		o.val[0] = c.val[0];
+		o.val[1] = c.val[1];
+		o.val[2] = c.val[2];
+		vst3q_u8(dB, o);
+		sB += 64;
+		dB += 48;
+	}
+	return x;
+}
+
+static s32 neon_A8R8G8B8toA8B8G8R8(const void *sP, s32 sN, void *dP)
+{
+	const u8 *sB = (const u8 *)sP;
+	u8 *dB = (u8 *)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		uint8x16x4_t c = vld4q_u8(sB);
+		const uint8x16_t tmp = c.val[0];
+		c.val[0] = c.val[2];
+		c.val[2] = tmp;
+		vst4q_u8(dB, c);
+		sB += 64;
+		dB += 64;
+	}
+	return x;
+}
+
+static s32 neon_A8R8G8B8toR8G8B8A8(const void *sP, s32 sN, void *dP)
+{
+	const u32 *sB = (const u32 *)sP;
+	u32 *dB = (u32 *)dP;
+	s32 x = 0;
+	for (; x + 4 <= sN; x += 4) {
+		const uint32x4_t c = vld1q_u32(sB);
+		vst1q_u32(dB, vorrq_u32(vshlq_n_u32(c, 8), vshrq_n_u32(c, 24)));
+		sB += 4;
+		dB += 4;
+	}
+	return x;
+}
+
+static s32 neon_R8G8B8toA8R8G8B8(const void *sP, s32 sN, void *dP)
+{
+	const u8 *sB = (const u8 *)sP;
+	u8 *dB = (u8 *)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const uint8x16x3_t c = vld3q_u8(sB);
+		uint8x16x4_t o;
+		o.val[0] = c.val[2];
+		o.val[1] = c.val[1];
+		o.val[2] = c.val[0];
+		o.val[3] = vdupq_n_u8(0xFF);
+		vst4q_u8(dB, o);
+		sB += 48;
+		dB += 64;
+	}
+	return x;
+}
+
+static s32 neon_R8G8B8toB8G8R8(const void *sP, s32 sN, void *dP)
+{
+	const u8 *sB = (const u8 *)sP;
+	u8 *dB = (u8 *)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		uint8x16x3_t c = vld3q_u8(sB);
+		const uint8x16_t tmp = c.val[0];
+		c.val[0] = c.val[2];
+		c.val[2] = tmp;
+		vst3q_u8(dB, c);
+		sB += 48;
+		dB += 48;
+	}
+	return x;
+}
+
+static s32 neon_A1R5G5B5toA8R8G8B8(const void *sP, s32 sN, void *dP)
+{
+	const u16 *sB = (const u16 *)sP;
+	u8 *dB = (u8 *)dP;
+	const uint16x8_t m5 = vdupq_n_u16(0x1F);
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const uint16x8_t c = vld1q_u16(sB);
+		const uint16x8_t r = vandq_u16(vshrq_n_u16(c, 10), m5);
+		const uint16x8_t g = vandq_u16(vshrq_n_u16(c, 5), m5);
+		const uint16x8_t b = vandq_u16(c, m5);
+		uint8x8x4_t o;
+		o.val[0] = vmovn_u16(vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2)));
+		o.val[1] = vmovn_u16(vorrq_u16(vshlq_n_u16(g, 3), vshrq_n_u16(g, 2)));
+		o.val[2] = vmovn_u16(vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2)));
+		o.val[3] = vmovn_u16(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(c), 15)));
+		vst4_u8(dB, o);
+		sB += 8;
+		dB += 32;
+	}
+	return x;
+}
+
+static s32 neon_R5G6B5toA8R8G8B8(const void *sP, s32 sN, void *dP)
+{
+	const u16 *sB = (const u16 *)sP;
+	u8 *dB = (u8 *)dP;
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const uint16x8_t c = vld1q_u16(sB);
+		uint8x8x4_t o;
+		o.val[0] = vmovn_u16(vandq_u16(vshlq_n_u16(c, 3), vdupq_n_u16(0xF8)));
+		o.val[1] = vmovn_u16(vandq_u16(vshrq_n_u16(c, 3), vdupq_n_u16(0xFC)));
+		o.val[2] = vmovn_u16(vandq_u16(vshrq_n_u16(c, 8), vdupq_n_u16(0xF8)));
+		o.val[3] = vdup_n_u8(0xFF);
+		vst4_u8(dB, o);
+		sB += 8;
+		dB += 32;
+	}
+	return x;
+}
+
+static s32 neon_A8R8G8B8toA1R5G5B5(const void *sP, s32 sN, void *dP)
+{
+	const u8 *sB = (const u8 *)sP;
+	u16 *dB = (u16 *)dP;
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const uint8x8x4_t c = vld4_u8(sB);
+		const uint16x8_t b = vmovl_u8(vshr_n_u8(c.val[0], 3));
+		const uint16x8_t g = vmovl_u8(vshr_n_u8(c.val[1], 3));
+		const uint16x8_t r = vmovl_u8(vshr_n_u8(c.val[2], 3));
+		const uint16x8_t a = vmovl_u8(vshr_n_u8(c.val[3], 7));
+		uint16x8_t o = vorrq_u16(vshlq_n_u16(a, 15), vshlq_n_u16(r, 10));
+		o = vorrq_u16(o, vorrq_u16(vshlq_n_u16(g, 5), b));
+		vst1q_u16(dB, o);
+		sB += 32;
+		dB += 8;
+	}
+	return x;
+}
+
+static s32 neon_A8R8G8B8toR5G6B5(const void *sP, s32 sN, void *dP)
+{
+	const u8 *sB = (const u8 *)sP;
+	u16 *dB = (u16 *)dP;
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const uint8x8x4_t c = vld4_u8(sB);
+		const uint16x8_t b = vmovl_u8(vshr_n_u8(c.val[0], 3));
+		const uint16x8_t g = vmovl_u8(vshr_n_u8(c.val[1], 2));
+		const uint16x8_t r = vmovl_u8(vshr_n_u8(c.val[2], 3));
+		vst1q_u16(dB, vorrq_u16(vshlq_n_u16(r, 11), vorrq_u16(vshlq_n_u16(g, 5), b)));
+		sB += 32;
+		dB += 8;
+	}
+	return x;
+}
+
+#endif
+
+bool isSupported(CColorConverter::E_SIMD_LEVEL level)
+{
+	switch (level) {
+	case CColorConverter::ESL_SCALAR:
+		return true;
+#if defined(IRR_ARCH_X86)
+	case CColorConverter::ESL_SSE2:
+		return os::CPU::hasSSE2();
+	case CColorConverter::ESL_SSSE3:
+		return os::CPU::hasSSE2() && os::CPU::hasSSSE3();
+	case CColorConverter::ESL_AVX2:
+		return os::CPU::hasSSE2() && os::CPU::hasSSSE3() && os::CPU::hasAVX2();
+#elif defined(IRR_ARCH_NEON)
+	case CColorConverter::ESL_NEON:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+SConvertKernels getKernels(CColorConverter::E_SIMD_LEVEL level)
+{
+	SConvertKernels k;
+	if (!isSupported(level))
+		return k;
+
+#if defined(IRR_ARCH_X86)
+	if (level >= CColorConverter::ESL_SSE2) {
+		k.A1R5G5B5toA8R8G8B8 = sse2_A1R5G5B5toA8R8G8B8;
+		k.A1R5G5B5toR5G5B5A1 = sse2_A1R5G5B5toR5G5B5A1;
+		k.A1R5G5B5toR5G6B5 = sse2_A1R5G5B5toR5G6B5;
+		k.A8R8G8B8toA1R5G5B5 = sse2_A8R8G8B8toA1R5G5B5;
+		k.A8R8G8B8toA1B5G5R5 = sse2_A8R8G8B8toA1B5G5R5;
+		k.A8R8G8B8toR5G6B5 = sse2_A8R8G8B8toR5G6B5;
+		k.A8R8G8B8toR8G8B8A8 = sse2_A8R8G8B8toR8G8B8A8;
+		k.A8R8G8B8toA8B8G8R8 = sse2_A8R8G8B8toA8B8G8R8;
+		k.R5G6B5toA8R8G8B8 = sse2_R5G6B5toA8R8G8B8;
+		k.R5G6B5toA1R5G5B5 = sse2_R5G6B5toA1R5G5B5;
+	}
+	if (level >= CColorConverter::ESL_SSSE3) {
+		k.A8R8G8B8toR8G8B8 = ssse3_A8R8G8B8toR8G8B8;
+		k.A8R8G8B8toB8G8R8 = ssse3_A8R8G8B8toB8G8R8;
+		k.A8R8G8B8toA8B8G8R8 = ssse3_A8R8G8B8toA8B8G8R8;
+		k.R8G8B8toA8R8G8B8 = ssse3_R8G8B8toA8R8G8B8;
+		k.R8G8B8toA1R5G5B5 = ssse3_R8G8B8toA1R5G5B5;
+		k.R8G8B8toB8G8R8 = ssse3_R8G8B8toB8G8R8;
+		k.R8G8B8toR5G6B5 = ssse3_R8G8B8toR5G6B5;
+	}
+	if (level >= CColorConverter::ESL_AVX2) {
+		k.A1R5G5B5toA8R8G8B8 = avx2_A1R5G5B5toA8R8G8B8;
+		k.A8R8G8B8toR8G8B8 = avx2_A8R8G8B8toR8G8B8;
+		k.A8R8G8B8toA1R5G5B5 = avx2_A8R8G8B8toA1R5G5B5;
+		k.A8R8G8B8toR5G6B5 = avx2_A8R8G8B8toR5G6B5;
+		k.A8R8G8B8toR8G8B8A8 = avx2_A8R8G8B8toR8G8B8A8;
+		k.A8R8G8B8toA8B8G8R8 = avx2_A8R8G8B8toA8B8G8R8;
+		k.R5G6B5toA8R8G8B8 = avx2_R5G6B5toA8R8G8B8;
+	}
+#elif defined(IRR_ARCH_NEON)
+	if (level == CColorConverter::ESL_NEON) {
+		k.A1R5G5B5toA8R8G8B8 = neon_A1R5G5B5toA8R8G8B8;
+		k.A8R8G8B8toR8G8B8 = neon_A8R8G8B8toR8G8B8;
+		k.A8R8G8B8toB8G8R8 = neon_A8R8G8B8toB8G8R8;
+		k.A8R8G8B8toA1R5G5B5 = neon_A8R8G8B8toA1R5G5B5;
+		k.A8R8G8B8toR5G6B5 = neon_A8R8G8B8toR5G6B5;
+		k.A8R8G8B8toR8G8B8A8 = neon_A8R8G8B8toR8G8B8A8;
+		k.A8R8G8B8toA8B8G8R8 = neon_A8R8G8B8toA8B8G8R8;
+		k.R8G8B8toA8R8G8B8 = neon_R8G8B8toA8R8G8B8;
+		k.R8G8B8toB8G8R8 = neon_R8G8B8toB8G8R8;
+		k.R5G6B5toA8R8G8B8 = neon_R5G6B5toA8R8G8B8;
+	}
+#endif
+	return k;
+}
+
+} // end namespace ColorConverterSIMD
+} // end namespace video
+} // end namespace irr
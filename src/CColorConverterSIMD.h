@@ -0,0 +1,52 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "CColorConverter.h"
+
+namespace irr
+{
+namespace video
+{
+namespace ColorConverterSIMD
+{
+
+//! Converts the first part of sN pixels and returns how many pixels were done.
+//! The remaining tail is left to the scalar reference code in CColorConverter.
+typedef s32 (*ConvertKernel)(const void *sP, s32 sN, void *dP);
+
+//! Accelerated kernels for one instruction set, null where there is none.
+struct SConvertKernels
+{
+	ConvertKernel A1R5G5B5toA8R8G8B8 = nullptr;
+	ConvertKernel A1R5G5B5toR5G5B5A1 = nullptr;
+	ConvertKernel A1R5G5B5toR5G6B5 = nullptr;
+
+	ConvertKernel A8R8G8B8toR8G8B8 = nullptr;
+	ConvertKernel A8R8G8B8toB8G8R8 = nullptr;
+	ConvertKernel A8R8G8B8toA1R5G5B5 = nullptr;
+	ConvertKernel A8R8G8B8toA1B5G5R5 = nullptr;
+	ConvertKernel A8R8G8B8toR5G6B5 = nullptr;
+	ConvertKernel A8R8G8B8toR8G8B8A8 = nullptr;
+	ConvertKernel A8R8G8B8toA8B8G8R8 = nullptr;
+
+	ConvertKernel R8G8B8toA8R8G8B8 = nullptr;
+	ConvertKernel R8G8B8toA1R5G5B5 = nullptr;
+	ConvertKernel R8G8B8toB8G8R8 = nullptr;
+	ConvertKernel R8G8B8toR5G6B5 = nullptr;
+
+	ConvertKernel R5G6B5toA8R8G8B8 = nullptr;
+	ConvertKernel R5G6B5toA1R5G5B5 = nullptr;
+};
+
+//! Returns true if both the build and the processor support the level.
+bool isSupported(CColorConverter::E_SIMD_LEVEL level);
+
+//! Returns the kernel table of a supported level. Kernels of lower levels
+//! of the same architecture are used where the level adds nothing.
+SConvertKernels getKernels(CColorConverter::E_SIMD_LEVEL level);
+
+} // end namespace ColorConverterSIMD
+} // end namespace video
+} // end namespace irr
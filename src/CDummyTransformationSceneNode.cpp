@@ -29,6 +29,8 @@ const core::aabbox3d<f32> &CDummyTransformationSceneNode::getBoundingBox() const
 //! and rotation.
 core::matrix4 &CDummyTransformationSceneNode::getRelativeTransformationMatrix()
 {
+	// the caller may change it through the reference
+	setRelativeTransformationDirty();
 	return RelativeTransformationMatrix;
 }
 
@@ -273,7 +273,7 @@ void CGUIButton::draw()
 		}
 
 		if (font)
-			font->draw(Text.c_str(), rect,
+			font->draw(Text, rect,
 					getActiveColor(),
 					true, true, &AbsoluteClippingRect);
 	}
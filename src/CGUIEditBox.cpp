@@ -12,6 +12,7 @@
 #include "rect.h"
 #include "os.h"
 #include "Keycodes.h"
+#include <algorithm>
 #include <cwctype> // std::iswspace, std::iswpunct, std::iswalnum
 
 /*
@@ -194,6 +195,7 @@ void CGUIEditBox::setPasswordBox(bool passwordBox, wchar_t passwordChar)
 		setMultiLine(false);
 		setWordWrap(false);
 		BrokenText.clear();
+		BrokenTextSizes.clear();
 	}
 }
 
@@ -483,7 +485,7 @@ bool CGUIEditBox::processKey(const SEvent &event)
 
 	// break the text if it has changed
 	if (textChanged) {
-		breakText();
+		breakChangedText();
 		calculateScrollPos();
 		sendGuiEvent(EGET_EDITBOX_CHANGED);
 	} else {
@@ -617,6 +619,7 @@ bool CGUIEditBox::onKeyControlX(const SEvent &event, s32 &mark_begin, s32 &mark_
 		s = Text.subString(0, realmbgn);
 		s.append(Text.subString(realmend, Text.size() - realmend));
 		Text = s;
+		markTextChanged(realmbgn, realmbgn);
 
 		CursorPos = realmbgn;
 		mark_begin = 0;
@@ -652,6 +655,7 @@ bool CGUIEditBox::onKeyControlV(const SEvent &event, s32 &mark_begin, s32 &mark_
 
 			if (!Max || s.size() <= Max) {
 				Text = s;
+				markTextChanged(CursorPos, CursorPos + inserted_text.size());
 				CursorPos += inserted_text.size();
 			}
 		} else {
@@ -664,6 +668,7 @@ bool CGUIEditBox::onKeyControlV(const SEvent &event, s32 &mark_begin, s32 &mark_
 			if (!Max || s.size() <= Max) {
 				Text = s;
 				CursorPos = realmbgn + inserted_text.size();
+				markTextChanged(realmbgn, CursorPos);
 			}
 		}
 	}
@@ -688,6 +693,7 @@ bool CGUIEditBox::onKeyBackDelete(const SEvent::SKeyInput &input)
 		s = Text.subString(0, realmbgn);
 		s.append(Text.subString(realmend, Text.size() - realmend));
 		Text = s;
+		markTextChanged(realmbgn, realmbgn);
 
 		CursorPos = realmbgn;
 	} else {
@@ -707,6 +713,7 @@ bool CGUIEditBox::onKeyBackDelete(const SEvent::SKeyInput &input)
 		s = Text.subString(0, CursorPos);
 		s.append(Text.subString(endpos, Text.size() - endpos));
 		Text = s;
+		markTextChanged(CursorPos, CursorPos);
 	}
 
 	if (CursorPos > (s32)Text.size())
@@ -787,7 +794,17 @@ void CGUIEditBox::draw()
 				OverrideColor = skin->getColor(EGDC_GRAY_TEXT);
 			}
 
-			for (s32 i = 0; i < lineCount; ++i) {
+			// only the lines touching the clipping area, all lines have the same height
+			s32 firstLine = 0, lastLine = lineCount - 1;
+			if (lineCount > 1) {
+				setTextRect(0);
+				const s32 top = CurrentTextRect.UpperLeftCorner.Y;
+				const s32 height = core::max_(CurrentTextRect.getHeight(), 1);
+				firstLine = core::s32_clamp((localClipRect.UpperLeftCorner.Y - top) / height - 1, 0, lastLine);
+				lastLine = core::s32_clamp((localClipRect.LowerRightCorner.Y - top) / height + 1, 0, lastLine);
+			}
+
+			for (s32 i = firstLine; i <= lastLine; ++i) {
 				setTextRect(i);
 
 				// clipping test - don't draw anything outside the visible area
@@ -807,6 +824,8 @@ void CGUIEditBox::draw()
 						for (u32 q = 0; q < Text.size(); ++q) {
 							BrokenText[0][q] = PasswordChar;
 						}
+						BrokenTextSizes.set_used(1);
+						BrokenTextSizes[0] = font->getDimension(BrokenText[0].c_str());
 					}
 					txtLine = &BrokenText[0];
 					startPos = 0;
@@ -816,7 +835,7 @@ void CGUIEditBox::draw()
 				}
 
 				// draw normal text
-				font->draw(txtLine->c_str(), CurrentTextRect,
+				font->draw(*txtLine, CurrentTextRect,
 						OverrideColorEnabled ? OverrideColor : skin->getColor(EGDC_BUTTON_TEXT),
 						false, true, &localClipRect);
 
@@ -956,8 +975,10 @@ void CGUIEditBox::setMax(u32 max)
 {
 	Max = max;
 
-	if (Text.size() > Max && Max != 0)
+	if (Text.size() > Max && Max != 0) {
 		Text = Text.subString(0, Max);
+		breakText();
+	}
 }
 
 //! Returns maximum amount of characters, previously set by setMax();
@@ -1187,30 +1208,115 @@ s32 CGUIEditBox::getCursorPos(s32 x, s32 y)
 //! Breaks the single text line.
 void CGUIEditBox::breakText()
 {
+	ChangedBegin = -1;
 	if ((!WordWrap && !MultiLine))
 		return;
 
 	BrokenText.clear(); // need to reallocate :/
 	BrokenTextPositions.set_used(0);
+	BrokenTextSizes.set_used(0);
 
 	IGUIFont *font = getActiveFont();
 	if (!font)
 		return;
 
 	LastBreakFont = font;
+	breakTextRange(0, Text.size(), BrokenText, BrokenTextPositions, BrokenTextSizes);
+	BrokenTextLength = Text.size();
+}
+
+//! replaces the elements from first to next of an array by the given ones
+template <class T>
+static void replaceElements(core::array<T> &a, u32 first, u32 next, core::array<T> &with)
+{
+	if (with.size() == next - first) {
+		for (u32 i = 0; i < with.size(); ++i)
+			a[first + i] = std::move(with[i]);
+		return;
+	}
+
+	core::array<T> result;
+	result.reallocate(a.size() - (next - first) + with.size());
+	for (u32 i = 0; i < first; ++i)
+		result.push_back(std::move(a[i]));
+	for (u32 i = 0; i < with.size(); ++i)
+		result.push_back(std::move(with[i]));
+	for (u32 i = next; i < a.size(); ++i)
+		result.push_back(std::move(a[i]));
+	a.swap(result);
+}
+
+//! Breaks only the paragraphs touched since the last break.
+/** A paragraph ends with a line break, so it is broken the same way
+wherever it is in the text. Without multi line there is only one. */
+void CGUIEditBox::breakChangedText()
+{
+	if (!MultiLine || BrokenText.empty() || LastBreakFont != getActiveFont()) {
+		breakText();
+		return;
+	}
+	if (ChangedBegin < 0)
+		return;
+
+	const auto isLineBreak = [](wchar_t c) { return c == L'\r' || c == L'\n'; };
+	const u32 lineCount = BrokenText.size();
+	const s32 delta = (s32)Text.size() - BrokenTextLength;
+
+	// paragraph of the character before the change, which could be a '\r'
+	// becoming part of a "\r\n"
+	u32 first = getLineFromPos(core::max_(0, ChangedBegin - 1));
+	while (first > 0 && !isLineBreak(Text[BrokenTextPositions[first] - 1]))
+		--first;
+
+	// first paragraph after the change, it and the ones below are kept
+	u32 next = getLineFromPos(BrokenTextLength - ChangedTail) + 1;
+	while (next < lineCount && !isLineBreak(Text[BrokenTextPositions[next] - 1 + delta]))
+		++next;
+
+	core::array<core::stringw> lines;
+	core::array<s32> positions;
+	core::array<core::dimension2du> sizes;
+	breakTextRange(BrokenTextPositions[first],
+			next < lineCount ? BrokenTextPositions[next] + delta : Text.size(),
+			lines, positions, sizes);
+
+	// breaking may have removed characters as well
+	const s32 shift = (s32)Text.size() - BrokenTextLength;
+	for (u32 i = next; i < lineCount; ++i)
+		BrokenTextPositions[i] += shift;
+
+	replaceElements(BrokenText, first, next, lines);
+	replaceElements(BrokenTextPositions, first, next, positions);
+	replaceElements(BrokenTextSizes, first, next, sizes);
+	BrokenTextLength = Text.size();
+	ChangedBegin = -1;
+}
+
+//! Breaks the text from begin to end into lines.
+/** The range has to start a line. The last line is only added if the range
+ends with the text, otherwise the range ends with a line break. */
+void CGUIEditBox::breakTextRange(s32 begin, s32 end, core::array<core::stringw> &lines,
+		core::array<s32> &positions, core::array<core::dimension2du> &sizes)
+{
+	IGUIFont *font = LastBreakFont;
+	const auto addLine = [&](const core::stringw &line, s32 start) {
+		lines.push_back(line);
+		positions.push_back(start);
+		sizes.push_back(font->getDimension(line.c_str()));
+	};
 
 	core::stringw line;
 	core::stringw word;
 	core::stringw whitespace;
-	s32 lastLineStart = 0;
-	s32 size = Text.size();
+	s32 lastLineStart = begin;
+	const bool textEnd = end == (s32)Text.size();
 	s32 length = 0;
 	s32 elWidth = RelativeRect.getWidth() - 10;
 	if (VScrollBar)
 		elWidth -= VScrollBarWidth;
 	wchar_t c;
 
-	for (s32 i = 0; i < size; ++i) {
+	for (s32 i = begin; i < end; ++i) {
 		c = Text[i];
 		bool lineBreak = false;
 
@@ -1219,7 +1325,7 @@ void CGUIEditBox::breakText()
 			c = 0;
 			if (Text[i + 1] == L'\n') { // Windows breaks
 				Text.erase(i);
-				--size;
+				--end;
 				if (CursorPos > i)
 					--CursorPos;
 			}
@@ -1232,7 +1338,7 @@ void CGUIEditBox::breakText()
 		if (!MultiLine)
 			lineBreak = false;
 
-		if (c == L' ' || c == 0 || i == (size - 1)) {
+		if (c == L' ' || c == 0 || i == (end - 1)) {
 			// here comes the next whitespace, look if
 			// we can break the last word to the next line
 			// We also break whitespace, otherwise cursor would vanish beside the right border.
@@ -1242,8 +1348,7 @@ void CGUIEditBox::breakText()
 			if (WordWrap && length + worldlgth + whitelgth > elWidth && line.size() > 0) {
 				// break to next line
 				length = worldlgth;
-				BrokenText.push_back(line);
-				BrokenTextPositions.push_back(lastLineStart);
+				addLine(line, lastLineStart);
 				lastLineStart = i - (s32)word.size();
 				line = word;
 			} else {
@@ -1263,8 +1368,7 @@ void CGUIEditBox::breakText()
 			if (lineBreak) {
 				line += whitespace;
 				line += word;
-				BrokenText.push_back(line);
-				BrokenTextPositions.push_back(lastLineStart);
+				addLine(line, lastLineStart);
 				lastLineStart = i + 1;
 				line = L"";
 				word = L"";
@@ -1277,10 +1381,26 @@ void CGUIEditBox::breakText()
 		}
 	}
 
-	line += whitespace;
-	line += word;
-	BrokenText.push_back(line);
-	BrokenTextPositions.push_back(lastLineStart);
+	if (textEnd) {
+		line += whitespace;
+		line += word;
+		addLine(line, lastLineStart);
+	}
+}
+
+//! Remembers that the text from begin was replaced by the characters up to newEnd.
+void CGUIEditBox::markTextChanged(s32 begin, s32 newEnd)
+{
+	// the unchanged end of the text is counted from the back, so that it
+	// stays valid when more is changed in front of it
+	const s32 tail = (s32)Text.size() - newEnd;
+	if (ChangedBegin < 0) {
+		ChangedBegin = begin;
+		ChangedTail = tail;
+	} else {
+		ChangedBegin = core::min_(ChangedBegin, begin);
+		ChangedTail = core::min_(ChangedTail, tail);
+	}
 }
 
 // TODO: that function does interpret VAlign according to line-index (indexed line is placed on top-center-bottom)
@@ -1301,7 +1421,7 @@ void CGUIEditBox::setTextRect(s32 line)
 	// get text dimension
 	const u32 lineCount = (WordWrap || MultiLine) ? BrokenText.size() : 1;
 	if (WordWrap || MultiLine) {
-		d = font->getDimension(BrokenText[line].c_str());
+		d = BrokenTextSizes[line];
 	} else {
 		d = font->getDimension(Text.c_str());
 		d.Height = AbsoluteRect.getHeight();
@@ -1356,13 +1476,9 @@ s32 CGUIEditBox::getLineFromPos(s32 pos)
 	if (!WordWrap && !MultiLine)
 		return 0;
 
-	s32 i = 0;
-	while (i < (s32)BrokenTextPositions.size()) {
-		if (BrokenTextPositions[i] > pos)
-			return i - 1;
-		++i;
-	}
-	return (s32)BrokenTextPositions.size() - 1;
+	// last line starting at or before pos
+	const s32 *positions = BrokenTextPositions.const_pointer();
+	return (s32)(std::upper_bound(positions, positions + BrokenTextPositions.size(), pos) - positions) - 1;
 }
 
 void CGUIEditBox::inputChar(wchar_t c)
@@ -1391,6 +1507,7 @@ void CGUIEditBox::inputString(const core::stringw &str)
 		s.append(Text.subString(realmend, Text.size() - realmend));
 		Text = s;
 		CursorPos = realmbgn + len;
+		markTextChanged(realmbgn, CursorPos);
 	} else if (OverwriteMode) {
 		// check to see if we are at the end of the text
 		if ((u32)CursorPos + len < Text.size()) {
@@ -1415,6 +1532,7 @@ void CGUIEditBox::inputString(const core::stringw &str)
 					s.append(Text.subString(CursorPos + len, Text.size() - CursorPos - len));
 				}
 				Text = s;
+				markTextChanged(CursorPos, CursorPos + len);
 				CursorPos += len;
 			}
 		} else if (Text.size() + len <= Max || Max == 0) {
@@ -1423,21 +1541,20 @@ void CGUIEditBox::inputString(const core::stringw &str)
 			s.append(str);
 			s.append(Text.subString(CursorPos + len, Text.size() - CursorPos - len));
 			Text = s;
+			markTextChanged(CursorPos, CursorPos + len);
 			CursorPos += len;
 		}
 	} else if (Text.size() + len <= Max || Max == 0) {
-		// add new character
-		s = Text.subString(0, CursorPos);
-		s.append(str);
-		s.append(Text.subString(CursorPos, Text.size() - CursorPos));
-		Text = s;
+		// add new character, in place as the text may be long
+		Text.insert(CursorPos, str.c_str(), len);
+		markTextChanged(CursorPos, CursorPos + len);
 		CursorPos += len;
 	}
 
 	BlinkStartTime = os::Timer::getTime();
 	setTextMarkers(0, 0);
 
-	breakText();
+	breakChangedText();
 	calculateScrollPos();
 	sendGuiEvent(EGET_EDITBOX_CHANGED);
 }
@@ -11,6 +11,7 @@
 #include "CGUIButton.h"
 #include "CGUIScrollBar.h"
 #include "CGUIFont.h"
+#include "CGUIFontDistanceField.h"
 #include "CGUISpriteBank.h"
 #include "CGUIImage.h"
 #include "CGUICheckBox.h"
@@ -21,6 +22,7 @@
 #include "CGUIEditBox.h"
 #include "CGUITabControl.h"
 #include "CGUIComboBox.h"
+#include "CGUIRenderCache.h"
 
 #include "IWriteFile.h"
 #ifdef IRR_ENABLE_BUILTIN_FONT
@@ -531,16 +533,21 @@ bool CGUIEnvironment::postEventFromUser(const SEvent &event)
 		}
 
 		// sending input to focus
-		if (Focus && Focus->OnEvent(event))
-			return true;
+		if (Focus) {
+			invalidateRenderCaches(Focus, event);
+			if (Focus->OnEvent(event))
+				return true;
+		}
 
 		// focus could have died in last call
 		if (!Focus && Hovered) {
+			invalidateRenderCaches(Hovered, event);
 			return Hovered->OnEvent(event);
 		}
 
 		break;
 	case EET_KEY_INPUT_EVENT: {
+		invalidateRenderCaches(Focus, event);
 		if (Focus && Focus->OnEvent(event))
 			return true;
 
@@ -558,6 +565,7 @@ bool CGUIEnvironment::postEventFromUser(const SEvent &event)
 		}
 	} break;
 	case EET_STRING_INPUT_EVENT:
+		invalidateRenderCaches(Focus, event);
 		if (Focus && Focus->OnEvent(event))
 			return true;
 		break;
@@ -568,6 +576,22 @@ bool CGUIEnvironment::postEventFromUser(const SEvent &event)
 	return false;
 }
 
+//! makes the render caches around an element which receives an event draw it again
+void CGUIEnvironment::invalidateRenderCaches(IGUIElement *element, const SEvent &event)
+{
+	// Plain mouse moves only change which element is hovered, which the
+	// caches find themselves. Moves with a button down may drag something.
+	if (event.EventType == EET_MOUSE_INPUT_EVENT &&
+			event.MouseInput.Event == EMIE_MOUSE_MOVED && event.MouseInput.ButtonStates == 0)
+		return;
+
+	// the element may change how it looks when handling the event
+	for (; element; element = element->getParent()) {
+		if (element->getType() == EGUIET_RENDER_CACHE)
+			static_cast<IGUIRenderCache *>(element)->invalidate();
+	}
+}
+
 //! returns the current gui skin
 IGUISkin *CGUIEnvironment::getSkin() const
 {
@@ -779,6 +803,16 @@ IGUIComboBox *CGUIEnvironment::addComboBox(const core::rect<s32> &rectangle,
 	return t;
 }
 
+//! Adds an element which keeps the drawing of its children in a texture.
+IGUIRenderCache *CGUIEnvironment::addRenderCache(const core::rect<s32> &rectangle,
+		IGUIElement *parent, s32 id)
+{
+	IGUIRenderCache *t = new CGUIRenderCache(this, parent ? parent : this,
+			id, rectangle);
+	t->drop();
+	return t;
+}
+
 //! returns the font
 IGUIFont *CGUIEnvironment::getFont(const io::path &filename)
 {
@@ -836,6 +870,38 @@ IGUIFont *CGUIEnvironment::getFont(const io::path &filename)
 	return ifont;
 }
 
+//! returns the distance field font made from a bitmap font image
+IGUIFontDistanceField *CGUIEnvironment::getDistanceFieldFont(const io::path &filename)
+{
+	SFont f;
+	f.NamedPath.setPath(filename);
+
+	s32 index = Fonts.binary_search(f);
+	if (index != -1) {
+		if (Fonts[index].Font->getType() != EGFT_DISTANCE_FIELD) {
+			os::Printer::log("Another type of font was loaded from the file", f.NamedPath.getPath(), ELL_ERROR);
+			return 0;
+		}
+		return static_cast<IGUIFontDistanceField *>(Fonts[index].Font);
+	}
+
+	if (!FileSystem->existFile(filename)) {
+		os::Printer::log("Could not load font because the file does not exist", f.NamedPath.getPath(), ELL_ERROR);
+		return 0;
+	}
+
+	CGUIFontDistanceField *font = new CGUIFontDistanceField(this);
+	if (!font->load(f.NamedPath.getPath())) {
+		font->drop();
+		return 0;
+	}
+
+	f.Font = font;
+	Fonts.push_back(f);
+
+	return font;
+}
+
 //! add an externally loaded font
 IGUIFont *CGUIEnvironment::addFont(const io::path &name, IGUIFont *font)
 {
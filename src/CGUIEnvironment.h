@@ -69,6 +69,9 @@ public:
 	//! returns the font
 	IGUIFont *getFont(const io::path &filename) override;
 
+	//! returns the distance field font made from a bitmap font image
+	IGUIFontDistanceField *getDistanceFieldFont(const io::path &filename) override;
+
 	//! add an externally loaded font
 	IGUIFont *addFont(const io::path &name, IGUIFont *font) override;
 
@@ -132,6 +135,10 @@ public:
 	virtual IGUIComboBox *addComboBox(const core::rect<s32> &rectangle,
 			IGUIElement *parent = 0, s32 id = -1) override;
 
+	//! Adds an element which keeps the drawing of its children in a texture.
+	virtual IGUIRenderCache *addRenderCache(const core::rect<s32> &rectangle,
+			IGUIElement *parent = 0, s32 id = -1) override;
+
 	//! sets the focus to an element
 	bool setFocus(IGUIElement *element) override;
 
@@ -170,6 +177,9 @@ private:
 
 	void updateHoveredElement(core::position2d<s32> mousePos);
 
+	//! makes the render caches around an element which receives an event draw it again
+	void invalidateRenderCaches(IGUIElement *element, const SEvent &event);
+
 	void loadBuiltInFont();
 
 	struct SFont
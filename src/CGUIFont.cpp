@@ -135,7 +135,9 @@ bool CGUIFont::loadTexture(video::IImage *image, const io::path &name)
 	}
 	readPositions(tmpImage, lowerRightPositions);
 
+	CharacterTable.clear();
 	WrongCharacter = getAreaFromCharacter(L' ');
+	updateCharacterTable();
 
 	// output warnings
 	if (!lowerRightPositions || !SpriteBank->getSprites().size())
@@ -256,6 +258,9 @@ u32 CGUIFont::getSpriteNoFromChar(const wchar_t *c) const
 
 s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 {
+	if ((u32)c < CharacterTable.size())
+		return CharacterTable[c] & ~INVISIBLE_CHARACTER;
+
 	auto n = CharacterMap.find(c);
 	if (n != CharacterMap.end())
 		return n->second;
@@ -263,9 +268,41 @@ s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 		return WrongCharacter;
 }
 
+bool CGUIFont::isVisible(const wchar_t c) const
+{
+	if ((u32)c < CharacterTable.size())
+		return !(CharacterTable[c] & INVISIBLE_CHARACTER);
+
+	return Invisible.findFirst(c) < 0;
+}
+
+void CGUIFont::updateCharacterTable()
+{
+	// direct lookup up to the highest character of the BMP, which covers
+	// the 32 + n characters of image fonts
+	u32 size = 0;
+	for (const auto &it : CharacterMap) {
+		if ((u32)it.first <= 0xFFFF)
+			size = core::max_(size, (u32)it.first + 1);
+	}
+
+	CharacterTable.set_used(size);
+	for (u32 i = 0; i < size; ++i)
+		CharacterTable[i] = WrongCharacter;
+	for (const auto &it : CharacterMap) {
+		if ((u32)it.first < size)
+			CharacterTable[it.first] = it.second;
+	}
+	for (u32 i = 0; i < Invisible.size(); ++i) {
+		if ((u32)Invisible[i] < size)
+			CharacterTable[Invisible[i]] |= INVISIBLE_CHARACTER;
+	}
+}
+
 void CGUIFont::setInvisibleCharacters(const wchar_t *s)
 {
 	Invisible = s;
+	updateCharacterTable();
 }
 
 //! returns the dimension of text
@@ -304,70 +341,82 @@ core::dimension2d<u32> CGUIFont::getDimension(const wchar_t *text) const
 	return dim;
 }
 
-//! draws some text and clips it to the specified rectangle if wanted
-void CGUIFont::draw(const core::stringw &text, const core::rect<s32> &position,
-		video::SColor color,
-		bool hcenter, bool vcenter, const core::rect<s32> *clip)
+//! measures a text and places its visible characters in one pass
+void CGUIFont::layoutText(const core::stringw &text, STextLayout &layout) const
 {
-	if (!Driver || !SpriteBank)
-		return;
-
-	core::dimension2d<s32> textDimension; // NOTE: don't make this u32 or the >> later on can fail when the dimension width is < position width
-	core::position2d<s32> offset = position.UpperLeftCorner;
-
-	if (hcenter || vcenter || clip)
-		textDimension = getDimension(text.c_str());
-
-	if (hcenter)
-		offset.X += (position.getWidth() - textDimension.Width) >> 1;
-
-	if (vcenter)
-		offset.Y += (position.getHeight() - textDimension.Height) >> 1;
-
-	if (clip) {
-		core::rect<s32> clippedRect(offset, textDimension);
-		clippedRect.clipAgainst(*clip);
-		if (!clippedRect.isValid())
-			return;
-	}
+	layout.Sprites.set_used(0);
+	layout.Offsets.set_used(0);
+	layout.Dimension.Width = 0;
 
-	core::array<u32> indices(text.size());
-	core::array<core::position2di> offsets(text.size());
+	core::position2di offset(0, 0);
 
 	for (u32 i = 0; i < text.size(); i++) {
-		wchar_t c = text[i];
+		const wchar_t c = text[i];
 
 		bool lineBreak = false;
 		if (c == L'\r') { // Mac or Windows breaks
 			lineBreak = true;
 			if (text[i + 1] == L'\n') // Windows breaks
-				c = text[++i];
+				++i;
 		} else if (c == L'\n') { // Unix breaks
 			lineBreak = true;
 		}
 
 		if (lineBreak) {
+			if (layout.Dimension.Width < offset.X)
+				layout.Dimension.Width = offset.X;
 			offset.Y += MaxHeight;
-			offset.X = position.UpperLeftCorner.X;
-
-			if (hcenter) {
-				offset.X += (position.getWidth() - textDimension.Width) >> 1;
-			}
+			offset.X = 0;
 			continue;
 		}
 
-		SFontArea &area = Areas[getAreaFromCharacter(c)];
+		const SFontArea &area = Areas[getAreaFromCharacter(c)];
 
 		offset.X += area.underhang;
-		if (Invisible.findFirst(c) < 0) {
-			indices.push_back(area.spriteno);
-			offsets.push_back(offset);
+		if (isVisible(c)) {
+			layout.Sprites.push_back(area.spriteno);
+			layout.Offsets.push_back(offset);
 		}
 
 		offset.X += area.width + area.overhang + GlobalKerningWidth;
 	}
 
-	SpriteBank->draw2DSpriteBatch(indices, offsets, clip, color);
+	if (layout.Dimension.Width < offset.X)
+		layout.Dimension.Width = offset.X;
+	layout.Dimension.Height = offset.Y + MaxHeight;
+}
+
+//! draws some text and clips it to the specified rectangle if wanted
+void CGUIFont::draw(const core::stringw &text, const core::rect<s32> &position,
+		video::SColor color,
+		bool hcenter, bool vcenter, const core::rect<s32> *clip)
+{
+	if (!Driver || !SpriteBank)
+		return;
+
+	// measuring and placing the characters is one pass, centering and
+	// clipping only move the whole text
+	layoutText(text, Layout);
+
+	core::position2d<s32> offset = position.UpperLeftCorner;
+
+	if (hcenter)
+		offset.X += (position.getWidth() - Layout.Dimension.Width) >> 1;
+
+	if (vcenter)
+		offset.Y += (position.getHeight() - Layout.Dimension.Height) >> 1;
+
+	if (clip) {
+		core::rect<s32> clippedRect(offset, Layout.Dimension);
+		clippedRect.clipAgainst(*clip);
+		if (!clippedRect.isValid())
+			return;
+	}
+
+	for (u32 i = 0; i < Layout.Offsets.size(); ++i)
+		Layout.Offsets[i] += offset;
+
+	SpriteBank->draw2DSpriteBatch(Layout.Sprites, Layout.Offsets, clip, color);
 }
 
 //! Calculates the index of the character in the text which is on a specific position.
@@ -390,6 +439,24 @@ s32 CGUIFont::getCharacterFromPos(const wchar_t *text, s32 pixel_x) const
 	return -1;
 }
 
+//! Calculates the x positions after each character of a text in one pass.
+void CGUIFont::getPrefixWidths(const wchar_t *text, core::array<s32> &widths) const
+{
+	widths.set_used(0);
+	widths.push_back(0);
+
+	s32 x = 0;
+	for (const wchar_t *p = text; *p; ++p) {
+		if (*p == L'\r' || *p == L'\n') {
+			x = 0;
+		} else {
+			const SFontArea &area = Areas[getAreaFromCharacter(*p)];
+			x += area.underhang + area.width + area.overhang + GlobalKerningWidth;
+		}
+		widths.push_back(x);
+	}
+}
+
 IGUISpriteBank *CGUIFont::getSpriteBank() const
 {
 	return SpriteBank;
@@ -50,6 +50,9 @@ public:
 	//! Calculates the index of the character in the text which is on a specific position.
 	s32 getCharacterFromPos(const wchar_t *text, s32 pixel_x) const override;
 
+	//! Calculates the x positions after each character of a text in one pass.
+	void getPrefixWidths(const wchar_t *text, core::array<s32> &widths) const override;
+
 	//! Returns the type of this font
 	EGUI_FONT_TYPE getType() const override { return EGFT_BITMAP; }
 
@@ -79,12 +82,28 @@ private:
 		u32 spriteno;
 	};
 
+	//! Sprites and their positions relative to the upper left corner of a text
+	struct STextLayout
+	{
+		core::array<u32> Sprites;
+		core::array<core::position2di> Offsets;
+		core::dimension2d<s32> Dimension;
+	};
+
+	//! Marks the invisible characters in CharacterTable
+	static constexpr u32 INVISIBLE_CHARACTER = 0x80000000;
+
 	//! load & prepare font from ITexture
 	bool loadTexture(video::IImage *image, const io::path &name);
 
 	void readPositions(video::IImage *texture, s32 &lowerRightPositions);
 
 	s32 getAreaFromCharacter(const wchar_t c) const;
+	bool isVisible(const wchar_t c) const;
+	//! rebuilds CharacterTable from CharacterMap and Invisible
+	void updateCharacterTable();
+	//! measures a text and places its visible characters in one pass
+	void layoutText(const core::stringw &text, STextLayout &layout) const;
 	void setMaxHeight();
 
 	void pushTextureCreationFlags(bool (&flags)[3]);
@@ -92,6 +111,12 @@ private:
 
 	core::array<SFontArea> Areas;
 	std::map<wchar_t, s32> CharacterMap;
+	//! Areas of the characters up to the highest mapped one of the BMP,
+	//! with INVISIBLE_CHARACTER set for the invisible ones.
+	//! Characters above are looked up in CharacterMap.
+	core::array<u32> CharacterTable;
+	//! Reused by draw() to not allocate for each text
+	STextLayout Layout;
 	video::IVideoDriver *Driver;
 	IGUISpriteBank *SpriteBank;
 	IGUIEnvironment *Environment;
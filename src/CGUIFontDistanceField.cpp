@@ -0,0 +1,523 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CGUIFontDistanceField.h"
+
+#include "os.h"
+#include "IGUIEnvironment.h"
+#include "IVideoDriver.h"
+#include "ITexture.h"
+#include "IImage.h"
+#include <cmath>
+#include <vector>
+
+namespace irr
+{
+namespace gui
+{
+
+namespace
+{
+
+const f64 FAR_AWAY = 1e20;
+
+//! Largest width and height of the atlas texture
+const s32 MAX_ATLAS_SIZE = 8192;
+
+//! Squared distances to the nearest zero of f along a line, the lower
+//! envelope of parabolas by Felzenszwalb and Huttenlocher
+void distanceTransform(const f64 *f, f64 *d, s32 n, std::vector<s32> &v, std::vector<f64> &z)
+{
+	v.resize(n);
+	z.resize(n + 1);
+
+	s32 k = 0;
+	v[0] = 0;
+	z[0] = -FAR_AWAY;
+	z[1] = FAR_AWAY;
+	for (s32 q = 1; q < n; ++q) {
+		f64 s;
+		for (;;) {
+			const s32 p = v[k];
+			s = ((f[q] + (f64)q * q) - (f[p] + (f64)p * p)) / (2.0 * (q - p));
+			if (s > z[k] || k == 0)
+				break;
+			--k;
+		}
+		++k;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = FAR_AWAY;
+	}
+
+	k = 0;
+	for (s32 q = 0; q < n; ++q) {
+		while (z[k + 1] < q)
+			++k;
+		d[q] = (f64)(q - v[k]) * (q - v[k]) + f[v[k]];
+	}
+}
+
+//! Squared distances of all pixels to the nearest one which is set in the grid
+void distanceTransform(std::vector<f64> &grid, s32 width, s32 height)
+{
+	std::vector<f64> f(core::max_(width, height)), d(f.size());
+	std::vector<s32> v;
+	std::vector<f64> z;
+
+	for (s32 x = 0; x < width; ++x) {
+		for (s32 y = 0; y < height; ++y)
+			f[y] = grid[y * width + x];
+		distanceTransform(f.data(), d.data(), height, v, z);
+		for (s32 y = 0; y < height; ++y)
+			grid[y * width + x] = d[y];
+	}
+	for (s32 y = 0; y < height; ++y) {
+		distanceTransform(&grid[y * width], d.data(), width, v, z);
+		std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+	}
+}
+
+} // end anonymous namespace
+
+CGUIFontDistanceField::SAtlas::~SAtlas()
+{
+	if (Texture)
+		Texture->drop();
+}
+
+//! constructor
+CGUIFontDistanceField::CGUIFontDistanceField(IGUIEnvironment *env) :
+		Environment(env), Driver(0), LineHeight(0.f),
+		GlobalKerningWidth(0), GlobalKerningHeight(0)
+{
+	if (Environment) {
+		// don't grab environment, to avoid circular references
+		Driver = Environment->getVideoDriver();
+	}
+
+	if (Driver)
+		Driver->grab();
+
+	setInvisibleCharacters(L" ");
+}
+
+//! makes a font of another size sharing the atlas
+CGUIFontDistanceField::CGUIFontDistanceField(const CGUIFontDistanceField &other, f32 height) :
+		Atlas(other.Atlas), Environment(other.Environment), Driver(other.Driver),
+		LineHeight(height), GlobalKerningWidth(other.GlobalKerningWidth),
+		GlobalKerningHeight(other.GlobalKerningHeight), Invisible(other.Invisible)
+{
+	if (Driver)
+		Driver->grab();
+}
+
+//! destructor
+CGUIFontDistanceField::~CGUIFontDistanceField()
+{
+	if (Driver)
+		Driver->drop();
+}
+
+//! loads a bitmap font image and makes the distance field texture of it
+bool CGUIFontDistanceField::load(const io::path &filename)
+{
+	if (!Driver)
+		return false;
+
+	video::IImage *image = Driver->createImageFromFile(filename);
+	if (!image)
+		return false;
+
+	// the alpha channel tells which pixels belong to the characters
+	video::IImage *argb = Driver->createImage(video::ECF_A8R8G8B8, image->getDimension());
+	image->copyTo(argb);
+	image->drop();
+
+	const bool ret = buildAtlas(argb, filename);
+	argb->drop();
+
+	return ret;
+}
+
+bool CGUIFontDistanceField::buildAtlas(video::IImage *image, const io::path &name)
+{
+	// find the characters like CGUIFont does
+	const core::dimension2d<u32> size = image->getDimension();
+	if (size.Width < 3)
+		return false;
+
+	video::SColor colorTopLeft = image->getPixel(0, 0);
+	colorTopLeft.setAlpha(255);
+	image->setPixel(0, 0, colorTopLeft);
+	const video::SColor colorLowerRight = image->getPixel(1, 0);
+	const video::SColor colorBackGround = image->getPixel(2, 0);
+	image->setPixel(1, 0, colorBackGround);
+
+	core::array<core::rect<s32>> rects;
+	u32 lowerRightPositions = 0;
+	for (s32 y = 0; y < (s32)size.Height; ++y) {
+		for (s32 x = 0; x < (s32)size.Width; ++x) {
+			const video::SColor c = image->getPixel(x, y);
+			if (c == colorTopLeft) {
+				rects.push_back(core::rect<s32>(x, y, x, y));
+			} else if (c == colorLowerRight) {
+				if (lowerRightPositions >= rects.size()) {
+					os::Printer::log("Too many lower corner pixels in the font file", name, ELL_ERROR);
+					return false;
+				}
+				rects[lowerRightPositions++].LowerRightCorner = core::position2d<s32>(x, y);
+			} else if (c != colorBackGround) {
+				continue;
+			}
+			image->setPixel(x, y, video::SColor(0));
+		}
+	}
+
+	if (!lowerRightPositions || lowerRightPositions != rects.size()) {
+		os::Printer::log("The corner pixels of the font file do not match", name, ELL_ERROR);
+		return false;
+	}
+
+	auto atlas = std::make_shared<SAtlas>();
+	for (u32 i = 0; i < rects.size(); ++i)
+		atlas->LineHeight = core::max_(atlas->LineHeight, rects[i].getHeight());
+	atlas->Downscale = core::max_(atlas->LineHeight / ATLAS_LINE_HEIGHT, 1);
+
+	const s32 downscale = atlas->Downscale;
+	const s32 padding = SPREAD * downscale;
+
+	// place the characters in rows of a square atlas, with a gap of a
+	// texel against filtering
+	core::array<core::dimension2d<s32>> cells;
+	s32 widestCell = 0;
+	for (u32 i = 0; i < rects.size(); ++i) {
+		cells.push_back(core::dimension2d<s32>(
+				(rects[i].getWidth() + 2 * padding + downscale - 1) / downscale,
+				(rects[i].getHeight() + 2 * padding + downscale - 1) / downscale));
+		widestCell = core::max_(widestCell, cells[i].Width);
+	}
+
+	s32 atlasSize = 64;
+	for (;; atlasSize *= 2) {
+		if (atlasSize > MAX_ATLAS_SIZE) {
+			os::Printer::log("The characters of the font do not fit into a distance field texture", name, ELL_ERROR);
+			return false;
+		}
+		if (widestCell > atlasSize)
+			continue;
+
+		s32 x = 0, y = 0, rowHeight = 0;
+		atlas->Glyphs.set_used(0);
+		for (u32 i = 0; i < cells.size(); ++i) {
+			if (x + cells[i].Width > atlasSize) {
+				x = 0;
+				y += rowHeight + 1;
+				rowHeight = 0;
+			}
+			SGlyph g;
+			g.Source = core::rect<s32>(core::position2d<s32>(x, y), cells[i]);
+			g.Width = rects[i].getWidth();
+			atlas->Glyphs.push_back(g);
+			x += cells[i].Width + 1;
+			rowHeight = core::max_(rowHeight, cells[i].Height);
+		}
+		if (y + rowHeight <= atlasSize)
+			break;
+	}
+
+	video::IImage *field = Driver->createImage(video::ECF_A8R8G8B8,
+			core::dimension2d<u32>(atlasSize, atlasSize));
+	field->fill(video::SColor(0, 255, 255, 255));
+
+	for (u32 i = 0; i < rects.size(); ++i)
+		writeDistanceField(image, rects[i], downscale, field, atlas->Glyphs[i].Source);
+
+	const bool mipMaps = Driver->getTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS);
+	Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, false);
+	atlas->Texture = Driver->addTexture(name + "#distance_field", field);
+	Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, mipMaps);
+	field->drop();
+
+	if (!atlas->Texture)
+		return false;
+	atlas->Texture->grab();
+
+	Atlas = atlas;
+	if (LineHeight <= 0.f)
+		LineHeight = (f32)Atlas->LineHeight;
+	return true;
+}
+
+//! Writes the distance field of the pixels with an alpha of at least 128 into the alpha of the target
+void CGUIFontDistanceField::writeDistanceField(const video::IImage *image, const core::rect<s32> &rect,
+		s32 downscale, video::IImage *target, const core::rect<s32> &targetRect)
+{
+	const s32 padding = SPREAD * downscale;
+	const s32 gridWidth = targetRect.getWidth() * downscale;
+	const s32 gridHeight = targetRect.getHeight() * downscale;
+	const core::position2d<s32> origin = rect.UpperLeftCorner - core::position2d<s32>(padding, padding);
+
+	std::vector<f64> toInside(gridWidth * gridHeight, FAR_AWAY);
+	std::vector<f64> toOutside(gridWidth * gridHeight, 0.0);
+	for (s32 y = rect.UpperLeftCorner.Y; y < rect.LowerRightCorner.Y; ++y) {
+		for (s32 x = rect.UpperLeftCorner.X; x < rect.LowerRightCorner.X; ++x) {
+			const s32 cell = (y - origin.Y) * gridWidth + x - origin.X;
+			if (x - origin.X < gridWidth && y - origin.Y < gridHeight &&
+					image->getPixel(x, y).getAlpha() >= 128) {
+				toInside[cell] = 0.0;
+				toOutside[cell] = FAR_AWAY;
+			}
+		}
+	}
+	distanceTransform(toInside, gridWidth, gridHeight);
+	distanceTransform(toOutside, gridWidth, gridHeight);
+
+	// average the signed distances of the pixels of each texel, the
+	// outline being half a pixel away from the pixel centers
+	for (s32 ty = 0; ty < targetRect.getHeight(); ++ty) {
+		for (s32 tx = 0; tx < targetRect.getWidth(); ++tx) {
+			f64 sum = 0.0;
+			for (s32 y = ty * downscale; y < (ty + 1) * downscale; ++y) {
+				for (s32 x = tx * downscale; x < (tx + 1) * downscale; ++x) {
+					const s32 cell = y * gridWidth + x;
+					if (toInside[cell] > 0.0)
+						sum += std::sqrt(toInside[cell]) - 0.5;
+					else
+						sum -= std::sqrt(toOutside[cell]) - 0.5;
+				}
+			}
+			const f64 distance = sum / (downscale * downscale);
+			const f64 value = core::clamp(0.5 - distance / (2.0 * padding), 0.0, 1.0);
+			target->setPixel(targetRect.UpperLeftCorner.X + tx, targetRect.UpperLeftCorner.Y + ty,
+					video::SColor(core::round32((f32)value * 255.f), 255, 255, 255));
+		}
+	}
+}
+
+const CGUIFontDistanceField::SGlyph &CGUIFontDistanceField::getGlyph(const wchar_t c) const
+{
+	// the characters of image fonts start at the space, which is used
+	// for the missing ones
+	const u32 index = (u32)c - 32;
+	return index < Atlas->Glyphs.size() ? Atlas->Glyphs[index] : Atlas->Glyphs[0];
+}
+
+bool CGUIFontDistanceField::isVisible(const wchar_t c) const
+{
+	return Invisible.findFirst(c) < 0;
+}
+
+//! screen pixels per pixel of the bitmap font
+f32 CGUIFontDistanceField::getScale() const
+{
+	return LineHeight / Atlas->LineHeight;
+}
+
+//! set an Pixel Offset on Drawing ( scale position on width )
+void CGUIFontDistanceField::setKerningWidth(s32 kerning)
+{
+	GlobalKerningWidth = kerning;
+}
+
+//! set an Pixel Offset on Drawing ( scale position on height )
+void CGUIFontDistanceField::setKerningHeight(s32 kerning)
+{
+	GlobalKerningHeight = kerning;
+}
+
+core::vector2di CGUIFontDistanceField::getKerning(const wchar_t thisLetter, const wchar_t previousLetter) const
+{
+	return core::vector2di(GlobalKerningWidth, GlobalKerningHeight);
+}
+
+void CGUIFontDistanceField::setInvisibleCharacters(const wchar_t *s)
+{
+	Invisible = s;
+}
+
+//! Sets the height of a line of text in pixels
+void CGUIFontDistanceField::setLineHeight(f32 height)
+{
+	LineHeight = core::max_(height, 1.f);
+}
+
+//! Returns the height of a line of text in pixels
+f32 CGUIFontDistanceField::getLineHeight() const
+{
+	return LineHeight;
+}
+
+//! Creates a font drawing the same characters at another size
+IGUIFontDistanceField *CGUIFontDistanceField::createSizedFont(f32 height) const
+{
+	return new CGUIFontDistanceField(*this, core::max_(height, 1.f));
+}
+
+//! Returns the texture holding the distance fields of all characters
+video::ITexture *CGUIFontDistanceField::getTexture() const
+{
+	return Atlas ? Atlas->Texture : 0;
+}
+
+//! returns the dimension of text
+core::dimension2d<u32> CGUIFontDistanceField::getDimension(const wchar_t *text) const
+{
+	if (!Atlas)
+		return core::dimension2d<u32>(0, 0);
+
+	const f32 scale = getScale();
+	f32 width = 0.f, lineWidth = 0.f;
+	u32 lines = 1;
+
+	for (const wchar_t *p = text; *p; ++p) {
+		bool lineBreak = false;
+		if (*p == L'\r') { // Mac or Windows breaks
+			lineBreak = true;
+			if (p[1] == L'\n') // Windows breaks
+				++p;
+		} else if (*p == L'\n') { // Unix breaks
+			lineBreak = true;
+		}
+		if (lineBreak) {
+			width = core::max_(width, lineWidth);
+			lineWidth = 0.f;
+			++lines;
+			continue;
+		}
+
+		lineWidth += getGlyph(*p).Width * scale + GlobalKerningWidth;
+	}
+
+	width = core::max_(width, lineWidth);
+	return core::dimension2d<u32>(core::ceil32(width), core::ceil32(lines * LineHeight));
+}
+
+//! places the visible characters of a text, relative to its upper left corner
+void CGUIFontDistanceField::layoutText(const core::stringw &text, STextLayout &layout) const
+{
+	layout.DestRects.set_used(0);
+	layout.SourceRects.set_used(0);
+
+	const f32 scale = getScale();
+	const f32 padding = SPREAD * Atlas->Downscale * scale;
+	const f32 texel = Atlas->Downscale * scale;
+	f32 x = 0.f, width = 0.f;
+	u32 lines = 1;
+
+	for (u32 i = 0; i < text.size(); i++) {
+		const wchar_t c = text[i];
+
+		bool lineBreak = false;
+		if (c == L'\r') { // Mac or Windows breaks
+			lineBreak = true;
+			if (text[i + 1] == L'\n') // Windows breaks
+				++i;
+		} else if (c == L'\n') { // Unix breaks
+			lineBreak = true;
+		}
+
+		if (lineBreak) {
+			width = core::max_(width, x);
+			x = 0.f;
+			++lines;
+			continue;
+		}
+
+		const SGlyph &g = getGlyph(c);
+		if (isVisible(c)) {
+			// round the edges, not the size, so the characters keep their distances
+			const f32 left = x - padding;
+			const f32 top = (lines - 1) * LineHeight - padding;
+			layout.DestRects.push_back(core::rect<s32>(
+					core::round32(left), core::round32(top),
+					core::round32(left + g.Source.getWidth() * texel),
+					core::round32(top + g.Source.getHeight() * texel)));
+			layout.SourceRects.push_back(g.Source);
+		}
+
+		x += g.Width * scale + GlobalKerningWidth;
+	}
+
+	width = core::max_(width, x);
+	layout.Dimension.Width = core::ceil32(width);
+	layout.Dimension.Height = core::ceil32(lines * LineHeight);
+}
+
+//! draws some text and clips it to the specified rectangle if wanted
+void CGUIFontDistanceField::draw(const core::stringw &text, const core::rect<s32> &position,
+		video::SColor color,
+		bool hcenter, bool vcenter, const core::rect<s32> *clip)
+{
+	if (!Driver || !Atlas)
+		return;
+
+	layoutText(text, Layout);
+
+	core::position2d<s32> offset = position.UpperLeftCorner;
+
+	if (hcenter)
+		offset.X += (position.getWidth() - Layout.Dimension.Width) >> 1;
+
+	if (vcenter)
+		offset.Y += (position.getHeight() - Layout.Dimension.Height) >> 1;
+
+	if (clip) {
+		core::rect<s32> clippedRect(offset, Layout.Dimension);
+		clippedRect.clipAgainst(*clip);
+		if (!clippedRect.isValid())
+			return;
+	}
+
+	for (u32 i = 0; i < Layout.DestRects.size(); ++i)
+		Layout.DestRects[i] += offset;
+
+	// The distance changes by 1 / (2 * spread) per pixel of the bitmap
+	// font, the edge is smoothed over one screen pixel.
+	const f32 smoothing = core::min_(1.f / (4.f * SPREAD * Atlas->Downscale * getScale()), 0.5f);
+
+	Driver->draw2DDistanceFieldBatch(Atlas->Texture, Layout.DestRects, Layout.SourceRects,
+			clip, color, smoothing);
+}
+
+//! Calculates the index of the character in the text which is on a specific position.
+s32 CGUIFontDistanceField::getCharacterFromPos(const wchar_t *text, s32 pixel_x) const
+{
+	if (!Atlas)
+		return -1;
+
+	const f32 scale = getScale();
+	f32 x = 0.f;
+	s32 idx = 0;
+
+	while (text[idx]) {
+		x += getGlyph(text[idx]).Width * scale + GlobalKerningWidth;
+
+		if (x >= pixel_x)
+			return idx;
+
+		++idx;
+	}
+
+	return -1;
+}
+
+//! Calculates the x positions after each character of a text in one pass.
+void CGUIFontDistanceField::getPrefixWidths(const wchar_t *text, core::array<s32> &widths) const
+{
+	widths.set_used(0);
+	widths.push_back(0);
+
+	const f32 scale = Atlas ? getScale() : 0.f;
+	f32 x = 0.f;
+	for (const wchar_t *p = text; *p; ++p) {
+		if (*p == L'\r' || *p == L'\n' || !Atlas)
+			x = 0.f;
+		else
+			x += getGlyph(*p).Width * scale + GlobalKerningWidth;
+		widths.push_back(core::ceil32(x));
+	}
+}
+
+} // end namespace gui
+} // end namespace irr
@@ -0,0 +1,142 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IGUIFontDistanceField.h"
+#include "irrString.h"
+#include "irrArray.h"
+#include "path.h"
+#include <memory>
+
+namespace irr
+{
+
+namespace video
+{
+class IVideoDriver;
+class IImage;
+}
+
+namespace gui
+{
+
+class IGUIEnvironment;
+
+class CGUIFontDistanceField : public IGUIFontDistanceField
+{
+public:
+	//! constructor
+	CGUIFontDistanceField(IGUIEnvironment *env);
+
+	//! destructor
+	virtual ~CGUIFontDistanceField();
+
+	//! loads a bitmap font image and makes the distance field texture of it
+	bool load(const io::path &filename);
+
+	//! draws an text and clips it to the specified rectangle if wanted
+	virtual void draw(const core::stringw &text, const core::rect<s32> &position,
+			video::SColor color, bool hcenter = false,
+			bool vcenter = false, const core::rect<s32> *clip = 0) override;
+
+	//! returns the dimension of a text
+	core::dimension2d<u32> getDimension(const wchar_t *text) const override;
+
+	//! Calculates the index of the character in the text which is on a specific position.
+	s32 getCharacterFromPos(const wchar_t *text, s32 pixel_x) const override;
+
+	//! Calculates the x positions after each character of a text in one pass.
+	void getPrefixWidths(const wchar_t *text, core::array<s32> &widths) const override;
+
+	//! set an Pixel Offset on Drawing ( scale position on width )
+	void setKerningWidth(s32 kerning) override;
+	void setKerningHeight(s32 kerning) override;
+
+	//! set an Pixel Offset on Drawing ( scale position on width )
+	core::vector2di getKerning(const wchar_t thisLetter, const wchar_t previousLetter) const override;
+
+	void setInvisibleCharacters(const wchar_t *s) override;
+
+	//! Sets the height of a line of text in pixels
+	void setLineHeight(f32 height) override;
+
+	//! Returns the height of a line of text in pixels
+	f32 getLineHeight() const override;
+
+	//! Creates a font drawing the same characters at another size
+	IGUIFontDistanceField *createSizedFont(f32 height) const override;
+
+	//! Returns the texture holding the distance fields of all characters
+	video::ITexture *getTexture() const override;
+
+	//! Distance in texels of the atlas from the outline to where the distance field ends
+	static constexpr s32 SPREAD = 4;
+
+	//! Lines of bitmap fonts higher than this are scaled down in the atlas
+	static constexpr s32 ATLAS_LINE_HEIGHT = 32;
+
+	//! Writes the distance field of a character into the alpha channel of the target
+	/** The pixels of the image with an alpha of at least 128 are inside.
+	\param rect The character in the image.
+	\param downscale Pixels of the image per texel of the target.
+	\param targetRect Texels of the target, the character scaled down
+	with SPREAD texels around it. The distance is 0.5 on the outline,
+	higher inside and 0 or 1 from SPREAD texels away. */
+	static void writeDistanceField(const video::IImage *image, const core::rect<s32> &rect,
+			s32 downscale, video::IImage *target, const core::rect<s32> &targetRect);
+
+private:
+	//! A character, measured in pixels of the bitmap font image
+	struct SGlyph
+	{
+		//! Outline with the spread around it in the atlas
+		core::rect<s32> Source;
+		s32 Width;
+	};
+
+	//! Shared by the fonts of all sizes made from one image
+	struct SAtlas
+	{
+		~SAtlas();
+
+		//! Characters from 32 on
+		core::array<SGlyph> Glyphs;
+		video::ITexture *Texture = 0;
+		//! Line height of the bitmap font
+		s32 LineHeight = 0;
+		//! Pixels of the bitmap font per texel of the atlas
+		s32 Downscale = 1;
+	};
+
+	//! Quads of a text relative to its upper left corner
+	struct STextLayout
+	{
+		core::array<core::rect<s32>> DestRects;
+		core::array<core::rect<s32>> SourceRects;
+		core::dimension2d<s32> Dimension;
+	};
+
+	//! makes a font of another size sharing the atlas
+	CGUIFontDistanceField(const CGUIFontDistanceField &other, f32 height);
+
+	bool buildAtlas(video::IImage *image, const io::path &name);
+	const SGlyph &getGlyph(const wchar_t c) const;
+	bool isVisible(const wchar_t c) const;
+	//! screen pixels per pixel of the bitmap font
+	f32 getScale() const;
+	void layoutText(const core::stringw &text, STextLayout &layout) const;
+
+	std::shared_ptr<const SAtlas> Atlas;
+	//! Reused by draw() to not allocate for each text
+	STextLayout Layout;
+	IGUIEnvironment *Environment;
+	video::IVideoDriver *Driver;
+	f32 LineHeight;
+	s32 GlobalKerningWidth, GlobalKerningHeight;
+
+	core::stringw Invisible;
+};
+
+} // end namespace gui
+} // end namespace irr
@@ -23,7 +23,7 @@ CGUIListBox::CGUIListBox(IGUIEnvironment *environment, IGUIElement *parent,
 		s32 id, core::rect<s32> rectangle, bool clip,
 		bool drawBack, bool moveOverSelect) :
 		IGUIListBox(environment, parent, id, rectangle),
-		Selected(-1),
+		ItemProvider(0), Selected(-1),
 		ItemHeight(0), ItemHeightOverride(0),
 		TotalItemHeight(0), ItemsIconWidth(0), Font(0), IconBank(0),
 		ScrollBar(0), selectTime(0), LastKeyTime(0), Selecting(false), DrawBack(drawBack),
@@ -67,24 +67,33 @@ CGUIListBox::~CGUIListBox()
 //! returns amount of list items
 u32 CGUIListBox::getItemCount() const
 {
+	if (ItemProvider)
+		return ItemProvider->getItemCount();
+
 	return Items.size();
 }
 
 //! returns string of a list item. the may be a value from 0 to itemCount-1
 const wchar_t *CGUIListBox::getListItem(u32 id) const
 {
-	if (id >= Items.size())
+	if (id >= getItemCount())
 		return 0;
 
+	if (ItemProvider)
+		return ItemProvider->getItemText(id);
+
 	return Items[id].Text.c_str();
 }
 
 //! Returns the icon of an item
 s32 CGUIListBox::getIcon(u32 id) const
 {
-	if (id >= Items.size())
+	if (id >= getItemCount())
 		return -1;
 
+	if (ItemProvider)
+		return ItemProvider->getItemIcon(id);
+
 	return Items[id].Icon;
 }
 
@@ -121,7 +130,7 @@ s32 CGUIListBox::getItemAt(s32 xpos, s32 ypos) const
 		return -1;
 
 	s32 item = ((ypos - AbsoluteRect.UpperLeftCorner.Y - 1) + ScrollBar->getPos()) / ItemHeight;
-	if (item < 0 || item >= (s32)Items.size())
+	if (item < 0 || item >= (s32)getItemCount())
 		return -1;
 
 	return item;
@@ -159,7 +168,7 @@ void CGUIListBox::recalculateItemHeight()
 		}
 	}
 
-	TotalItemHeight = ItemHeight * Items.size();
+	TotalItemHeight = ItemHeight * getItemCount();
 	ScrollBar->setMax(core::max_(0, TotalItemHeight - AbsoluteRect.getHeight()));
 	s32 minItemHeight = ItemHeight > 0 ? ItemHeight : 1;
 	ScrollBar->setSmallStep(minItemHeight);
@@ -171,6 +180,16 @@ void CGUIListBox::recalculateItemHeight()
 		ScrollBar->setVisible(true);
 }
 
+bool CGUIListBox::itemStartsWithKeys(s32 index) const
+{
+	const wchar_t *text = getListItem(index);
+	for (u32 i = 0; i < KeyBuffer.size(); ++i) {
+		if (!text[i] || core::locale_lower(text[i]) != core::locale_lower(KeyBuffer[i]))
+			return false;
+	}
+	return true;
+}
+
 //! returns id of selected item. returns -1 if no item is selected.
 s32 CGUIListBox::getSelected() const
 {
@@ -180,7 +199,7 @@ s32 CGUIListBox::getSelected() const
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIListBox::setSelected(s32 id)
 {
-	if ((u32)id >= Items.size())
+	if ((u32)id >= getItemCount())
 		Selected = -1;
 	else
 		Selected = id;
@@ -196,8 +215,9 @@ void CGUIListBox::setSelected(const wchar_t *item)
 	s32 index = -1;
 
 	if (item) {
-		for (index = 0; index < (s32)Items.size(); ++index) {
-			if (Items[index].Text == item)
+		const s32 count = getItemCount();
+		for (index = 0; index < count; ++index) {
+			if (wcscmp(getListItem(index), item) == 0)
 				break;
 		}
 	}
@@ -229,7 +249,7 @@ bool CGUIListBox::OnEvent(const SEvent &event)
 					Selected = 0;
 					break;
 				case KEY_END:
-					Selected = (s32)Items.size() - 1;
+					Selected = (s32)getItemCount() - 1;
 					break;
 				case KEY_NEXT:
 					Selected += AbsoluteRect.getHeight() / ItemHeight;
@@ -242,8 +262,8 @@ bool CGUIListBox::OnEvent(const SEvent &event)
 				}
 				if (Selected < 0)
 					Selected = 0;
-				if (Selected >= (s32)Items.size())
-					Selected = Items.size() - 1; // will set Selected to -1 for empty listboxes which is correct
+				if (Selected >= (s32)getItemCount())
+					Selected = (s32)getItemCount() - 1; // will set Selected to -1 for empty listboxes which is correct
 
 				recalculateScrollPos();
 
@@ -291,43 +311,39 @@ bool CGUIListBox::OnEvent(const SEvent &event)
 				s32 start = Selected;
 				// dont change selection if the key buffer matches the current item
 				if (Selected > -1 && KeyBuffer.size() > 1) {
-					if (Items[Selected].Text.size() >= KeyBuffer.size() &&
-							KeyBuffer.equals_ignore_case(Items[Selected].Text.subString(0, KeyBuffer.size())))
+					if (itemStartsWithKeys(Selected))
 						return true;
 				}
 
 				s32 current;
-				for (current = start + 1; current < (s32)Items.size(); ++current) {
-					if (Items[current].Text.size() >= KeyBuffer.size()) {
-						if (KeyBuffer.equals_ignore_case(Items[current].Text.subString(0, KeyBuffer.size()))) {
-							if (Parent && Selected != current && !Selecting && !MoveOverSelect) {
-								SEvent e;
-								e.EventType = EET_GUI_EVENT;
-								e.GUIEvent.Caller = this;
-								e.GUIEvent.Element = 0;
-								e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
-								Parent->OnEvent(e);
-							}
-							setSelected(current);
-							return true;
+				const s32 count = getItemCount();
+				for (current = start + 1; current < count; ++current) {
+					if (itemStartsWithKeys(current)) {
+						if (Parent && Selected != current && !Selecting && !MoveOverSelect) {
+							SEvent e;
+							e.EventType = EET_GUI_EVENT;
+							e.GUIEvent.Caller = this;
+							e.GUIEvent.Element = 0;
+							e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
+							Parent->OnEvent(e);
 						}
+						setSelected(current);
+						return true;
 					}
 				}
 				for (current = 0; current <= start; ++current) {
-					if (Items[current].Text.size() >= KeyBuffer.size()) {
-						if (KeyBuffer.equals_ignore_case(Items[current].Text.subString(0, KeyBuffer.size()))) {
-							if (Parent && Selected != current && !Selecting && !MoveOverSelect) {
-								Selected = current;
-								SEvent e;
-								e.EventType = EET_GUI_EVENT;
-								e.GUIEvent.Caller = this;
-								e.GUIEvent.Element = 0;
-								e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
-								Parent->OnEvent(e);
-							}
-							setSelected(current);
-							return true;
+					if (itemStartsWithKeys(current)) {
+						if (Parent && Selected != current && !Selecting && !MoveOverSelect) {
+							Selected = current;
+							SEvent e;
+							e.EventType = EET_GUI_EVENT;
+							e.GUIEvent.Caller = this;
+							e.GUIEvent.Element = 0;
+							e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
+							Parent->OnEvent(e);
 						}
+						setSelected(current);
+						return true;
 					}
 				}
 
@@ -397,7 +413,7 @@ void CGUIListBox::selectNew(s32 ypos, bool onlyHover)
 	s32 oldSelected = Selected;
 
 	Selected = getItemAt(AbsoluteRect.UpperLeftCorner.X, ypos);
-	if (Selected < 0 && !Items.empty())
+	if (Selected < 0 && getItemCount() > 0)
 		Selected = 0;
 
 	recalculateScrollPos();
@@ -460,53 +476,61 @@ void CGUIListBox::draw()
 	if (ScrollBar->isVisible())
 		frameRect.LowerRightCorner.X -= ScrollBar->getRelativePosition().getWidth();
 
-	frameRect.LowerRightCorner.Y = AbsoluteRect.UpperLeftCorner.Y + ItemHeight;
+	// only the rows touching the list box, found from the scroll position
+	const s32 scrollPos = ScrollBar->getPos();
+	s32 first = 0, last = -1;
+	if (ItemHeight > 0) {
+		first = scrollPos > 0 ? (scrollPos - 1) / ItemHeight : 0;
+		last = core::min_((s32)getItemCount() - 1, (scrollPos + AbsoluteRect.getHeight()) / ItemHeight);
+	}
 
-	frameRect.UpperLeftCorner.Y -= ScrollBar->getPos();
-	frameRect.LowerRightCorner.Y -= ScrollBar->getPos();
+	frameRect.UpperLeftCorner.Y = AbsoluteRect.UpperLeftCorner.Y + first * ItemHeight - scrollPos;
+	frameRect.LowerRightCorner.Y = frameRect.UpperLeftCorner.Y + ItemHeight;
 
 	bool hl = (HighlightWhenNotFocused || Environment->hasFocus(this) || Environment->hasFocus(ScrollBar));
 
-	for (s32 i = 0; i < (s32)Items.size(); ++i) {
-		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
-				frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y) {
-			if (i == Selected && hl)
-				skin->draw2DRectangle(this, skin->getColor(EGDC_HIGH_LIGHT), frameRect, &clientClip);
-
-			core::rect<s32> textRect = frameRect;
-			textRect.UpperLeftCorner.X += 3;
-
-			if (Font) {
-				if (IconBank && (Items[i].Icon > -1)) {
-					core::position2di iconPos = textRect.UpperLeftCorner;
-					iconPos.Y += textRect.getHeight() / 2;
-					iconPos.X += ItemsIconWidth / 2;
-
-					if (i == Selected && hl) {
-						IconBank->draw2DSprite((u32)Items[i].Icon, iconPos, &clientClip,
-								hasItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) ? getItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_ICON_HIGHLIGHT),
-								selectTime, os::Timer::getTime(), false, true);
-					} else {
-						IconBank->draw2DSprite((u32)Items[i].Icon, iconPos, &clientClip,
-								hasItemOverrideColor(i, EGUI_LBC_ICON) ? getItemOverrideColor(i, EGUI_LBC_ICON) : getItemDefaultColor(EGUI_LBC_ICON),
-								0, (i == Selected) ? os::Timer::getTime() : 0, false, true);
-					}
-				}
+	for (s32 i = first; i <= last; ++i) {
+		const s32 icon = getIcon(i);
+		if (ItemProvider)
+			recalculateItemWidth(icon); // icons are only known once drawn
+
+		if (i == Selected && hl)
+			skin->draw2DRectangle(this, skin->getColor(EGDC_HIGH_LIGHT), frameRect, &clientClip);
 
-				textRect.UpperLeftCorner.X += ItemsIconWidth + 3;
+		core::rect<s32> textRect = frameRect;
+		textRect.UpperLeftCorner.X += 3;
+
+		if (Font) {
+			if (IconBank && (icon > -1)) {
+				core::position2di iconPos = textRect.UpperLeftCorner;
+				iconPos.Y += textRect.getHeight() / 2;
+				iconPos.X += ItemsIconWidth / 2;
 
 				if (i == Selected && hl) {
-					Font->draw(Items[i].Text.c_str(), textRect,
-							hasItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) ? getItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_TEXT_HIGHLIGHT),
-							false, true, &clientClip);
+					IconBank->draw2DSprite((u32)icon, iconPos, &clientClip,
+							hasItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) ? getItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_ICON_HIGHLIGHT),
+							selectTime, os::Timer::getTime(), false, true);
 				} else {
-					Font->draw(Items[i].Text.c_str(), textRect,
-							hasItemOverrideColor(i, EGUI_LBC_TEXT) ? getItemOverrideColor(i, EGUI_LBC_TEXT) : getItemDefaultColor(EGUI_LBC_TEXT),
-							false, true, &clientClip);
+					IconBank->draw2DSprite((u32)icon, iconPos, &clientClip,
+							hasItemOverrideColor(i, EGUI_LBC_ICON) ? getItemOverrideColor(i, EGUI_LBC_ICON) : getItemDefaultColor(EGUI_LBC_ICON),
+							0, (i == Selected) ? os::Timer::getTime() : 0, false, true);
 				}
+			}
 
-				textRect.UpperLeftCorner.X -= ItemsIconWidth + 3;
+			textRect.UpperLeftCorner.X += ItemsIconWidth + 3;
+
+			DrawText = getListItem(i);
+			if (i == Selected && hl) {
+				Font->draw(DrawText, textRect,
+						hasItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) ? getItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_TEXT_HIGHLIGHT),
+						false, true, &clientClip);
+			} else {
+				Font->draw(DrawText, textRect,
+						hasItemOverrideColor(i, EGUI_LBC_TEXT) ? getItemOverrideColor(i, EGUI_LBC_TEXT) : getItemDefaultColor(EGUI_LBC_TEXT),
+						false, true, &clientClip);
 			}
+
+			textRect.UpperLeftCorner.X -= ItemsIconWidth + 3;
 		}
 
 		frameRect.UpperLeftCorner.Y += ItemHeight;
@@ -519,6 +543,9 @@ void CGUIListBox::draw()
 //! adds an list item with an icon
 u32 CGUIListBox::addItem(const wchar_t *text, s32 icon)
 {
+	if (ItemProvider)
+		return (u32)-1;
+
 	ListItem i;
 	i.Text = text;
 	i.Icon = icon;
@@ -629,6 +656,9 @@ void CGUIListBox::setItem(u32 index, const wchar_t *text, s32 icon)
 //! Return the index on success or -1 on failure.
 s32 CGUIListBox::insertItem(u32 index, const wchar_t *text, s32 icon)
 {
+	if (ItemProvider)
+		return -1;
+
 	ListItem i;
 	i.Text = text;
 	i.Icon = icon;
@@ -652,6 +682,9 @@ void CGUIListBox::swapItems(u32 index1, u32 index2)
 
 void CGUIListBox::setItemOverrideColor(u32 index, video::SColor color)
 {
+	if (index >= Items.size())
+		return;
+
 	for (u32 c = 0; c < EGUI_LBC_COUNT; ++c) {
 		Items[index].OverrideColors[c].Use = true;
 		Items[index].OverrideColors[c].Color = color;
@@ -669,6 +702,9 @@ void CGUIListBox::setItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType,
 
 void CGUIListBox::clearItemOverrideColor(u32 index)
 {
+	if (index >= Items.size())
+		return;
+
 	for (u32 c = 0; c < (u32)EGUI_LBC_COUNT; ++c) {
 		Items[index].OverrideColors[c].Use = false;
 	}
@@ -684,6 +720,11 @@ void CGUIListBox::clearItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType
 
 bool CGUIListBox::hasItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType) const
 {
+	if (ItemProvider) {
+		video::SColor color;
+		return index < getItemCount() && ItemProvider->getItemOverrideColor(index, colorType, color);
+	}
+
 	if (index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT)
 		return false;
 
@@ -692,6 +733,13 @@ bool CGUIListBox::hasItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType)
 
 video::SColor CGUIListBox::getItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType) const
 {
+	if (ItemProvider) {
+		video::SColor color;
+		if (index < getItemCount() && ItemProvider->getItemOverrideColor(index, colorType, color))
+			return color;
+		return video::SColor();
+	}
+
 	if ((u32)index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT)
 		return video::SColor();
 
@@ -737,5 +785,22 @@ IGUIScrollBar *CGUIListBox::getVerticalScrollBar() const
 	return ScrollBar;
 }
 
+//! Shows the items of a provider instead of the own ones
+void CGUIListBox::setItemProvider(IGUIListBoxItemProvider *provider)
+{
+	if (provider == ItemProvider)
+		return;
+
+	clear();
+	ItemProvider = provider;
+	recalculateItemHeight();
+}
+
+//! Returns the provider of the items
+IGUIListBoxItemProvider *CGUIListBox::getItemProvider() const
+{
+	return ItemProvider;
+}
+
 } // end namespace gui
 } // end namespace irr
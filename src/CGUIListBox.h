@@ -124,6 +124,12 @@ public:
 	//! Access the vertical scrollbar
 	IGUIScrollBar *getVerticalScrollBar() const override;
 
+	//! Shows the items of a provider instead of the own ones
+	void setItemProvider(IGUIListBoxItemProvider *provider) override;
+
+	//! Returns the provider of the items
+	IGUIListBoxItemProvider *getItemProvider() const override;
+
 private:
 	struct ListItem
 	{
@@ -140,6 +146,8 @@ private:
 	};
 
 	void recalculateItemHeight();
+	//! whether the text of an item starts with the typed keys, ignoring case
+	bool itemStartsWithKeys(s32 index) const;
 	void selectNew(s32 ypos, bool onlyHover = false);
 	void recalculateScrollPos();
 	void updateScrollBarSize(s32 size);
@@ -151,6 +159,7 @@ private:
 	bool getSerializationLabels(EGUI_LISTBOX_COLOR colorType, core::stringc &useColorLabel, core::stringc &colorLabel) const;
 
 	core::array<ListItem> Items;
+	IGUIListBoxItemProvider *ItemProvider;
 	s32 Selected;
 	s32 ItemHeight;
 	s32 ItemHeightOverride;
@@ -162,6 +171,8 @@ private:
 	u32 selectTime;
 	u32 LastKeyTime;
 	core::stringw KeyBuffer;
+	//! the text of the item being drawn, kept to not allocate every frame
+	core::stringw DrawText;
 	bool Selecting;
 	bool DrawBack;
 	bool MoveOverSelect;
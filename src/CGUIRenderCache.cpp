@@ -0,0 +1,187 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CGUIRenderCache.h"
+
+#include "IGUIEnvironment.h"
+#include "IVideoDriver.h"
+#include "ITexture.h"
+#include "IRenderTarget.h"
+
+#include <string>
+
+namespace irr
+{
+namespace gui
+{
+
+namespace
+{
+//! Number of render caches made, to give each texture its own name
+u32 CacheCount = 0;
+} // end anonymous namespace
+
+//! constructor
+CGUIRenderCache::CGUIRenderCache(IGUIEnvironment *environment, IGUIElement *parent,
+		s32 id, const core::rect<s32> &rectangle) :
+		IGUIRenderCache(environment, parent, id, rectangle),
+		Driver(0), Texture(0), RenderTarget(0), State(0), RenderCount(0), Dirty(true)
+{
+	TextureName = ("GUIRenderCache" + std::to_string(++CacheCount)).c_str();
+
+	// the texture has to be removed from the driver which made it
+	if (Environment) {
+		Driver = Environment->getVideoDriver();
+		if (Driver)
+			Driver->grab();
+	}
+}
+
+//! destructor
+CGUIRenderCache::~CGUIRenderCache()
+{
+	if (Driver) {
+		if (RenderTarget)
+			Driver->removeRenderTarget(RenderTarget);
+		if (Texture)
+			Driver->removeTexture(Texture);
+		Driver->drop();
+	}
+}
+
+//! draws the children into the texture if needed, then the texture
+void CGUIRenderCache::draw()
+{
+	if (!isVisible())
+		return;
+
+	// remember the state even when drawing directly, so that switching
+	// to the texture later does not draw twice
+	const bool changed = updateState();
+
+	if (!Driver || !Driver->queryFeature(video::EVDF_RENDER_TO_TARGET) ||
+			!Driver->queryFeature(video::EVDF_BLEND_SEPARATE)) {
+		// drawn directly, so nothing waits to be drawn again
+		IGUIElement::draw();
+		Dirty = false;
+		return;
+	}
+
+	// the texture holds the visible part of this element
+	const core::recti visible = AbsoluteClippingRect;
+	if (visible.getWidth() <= 0 || visible.getHeight() <= 0)
+		return;
+	const core::dimension2du size(visible.getWidth(), visible.getHeight());
+	// a size the driver could not make a texture of is not tried again
+	if (size != FailedSize && (!Texture || Texture->getOriginalSize() != size)) {
+		if (Texture)
+			Driver->removeTexture(Texture);
+		Texture = Driver->addRenderTargetTexture(size, TextureName, video::ECF_A8R8G8B8);
+		if (!Texture)
+			FailedSize = size;
+		if (!RenderTarget)
+			RenderTarget = Driver->addRenderTarget();
+		if (RenderTarget && Texture)
+			RenderTarget->setTexture(Texture, 0);
+		Dirty = true;
+	}
+
+	if (!Texture || !RenderTarget) {
+		IGUIElement::draw();
+		return;
+	}
+
+	// The texture gets premultiplied alpha: the colors are blended as on
+	// the screen, the alpha channel keeps how much of the screen is covered.
+	// Drawing it with ONE, ONE_MINUS_SRC_ALPHA then gives the same pixels as
+	// drawing the children directly.
+	video::SMaterial &material2D = Driver->getMaterial2D();
+	const bool material2DEnabled = Driver->isMaterial2DEnabled();
+	const f32 blendFactor = material2D.BlendFactor;
+	Driver->enableMaterial2D();
+
+	if (Dirty || changed) {
+		video::IRenderTarget *target = Driver->getCurrentRenderTarget();
+		Driver->setRenderTargetEx(RenderTarget, video::ECBF_COLOR, video::SColor(0, 0, 0, 0));
+		material2D.BlendFactor = video::pack_textureBlendFuncSeparate(
+				video::EBF_SRC_ALPHA, video::EBF_ONE_MINUS_SRC_ALPHA,
+				video::EBF_ONE, video::EBF_ONE_MINUS_SRC_ALPHA);
+		// the children draw at screen coordinates, move them into the texture
+		moveSubtree(-visible.UpperLeftCorner);
+		IGUIElement::draw();
+		moveSubtree(visible.UpperLeftCorner);
+		Driver->setRenderTargetEx(target, video::ECBF_NONE);
+		Dirty = false;
+		++RenderCount;
+	}
+
+	material2D.BlendFactor = video::pack_textureBlendFunc(video::EBF_ONE, video::EBF_ONE_MINUS_SRC_ALPHA);
+	Driver->draw2DImage(Texture, visible.UpperLeftCorner, core::recti(core::position2di(0, 0), size),
+			0, video::SColor(255, 255, 255, 255), true);
+
+	material2D.BlendFactor = blendFactor;
+	Driver->enableMaterial2D(material2DEnabled);
+}
+
+//! Moves this element and its subtree by offset on the screen
+void CGUIRenderCache::moveSubtree(const core::position2di &offset)
+{
+	AbsoluteRect += offset;
+	AbsoluteClippingRect += offset;
+	for (IGUIElement *child : Children)
+		child->updateAbsolutePosition();
+}
+
+//! Makes the next draw() draw the children into the texture again
+void CGUIRenderCache::invalidate()
+{
+	Dirty = true;
+}
+
+//! Returns how often the children were drawn into the texture
+u32 CGUIRenderCache::getRenderCount() const
+{
+	return RenderCount;
+}
+
+//! Returns whether the subtree looks different than at the last call
+bool CGUIRenderCache::updateState()
+{
+	// FNV-1a
+	u64 hash = 14695981039346656037ULL;
+	hashElement(this, hash);
+
+	const bool changed = hash != State;
+	State = hash;
+	return changed;
+}
+
+void CGUIRenderCache::hashElement(const IGUIElement *element, u64 &hash) const
+{
+	auto add = [&hash](u64 value) {
+		hash = (hash ^ value) * 1099511628211ULL;
+	};
+
+	add((u64)(size_t)element);
+	add(element->isVisible());
+	if (!element->isVisible())
+		return;
+
+	const core::rect<s32> r = element->getAbsolutePosition();
+	const core::rect<s32> clip = element->getAbsoluteClippingRect();
+	add(((u64)(u32)r.UpperLeftCorner.X << 32) | (u32)r.UpperLeftCorner.Y);
+	add(((u64)(u32)r.LowerRightCorner.X << 32) | (u32)r.LowerRightCorner.Y);
+	add(((u64)(u32)clip.UpperLeftCorner.X << 32) | (u32)clip.UpperLeftCorner.Y);
+	add(((u64)(u32)clip.LowerRightCorner.X << 32) | (u32)clip.LowerRightCorner.Y);
+	add(element->isEnabled());
+	add(Environment->getFocus() == element);
+	add(Environment->getHovered() == element);
+	for (const wchar_t *c = element->getText(); *c; ++c)
+		add((u64)*c);
+
+	for (const IGUIElement *child : element->getChildren())
+		hashElement(child, hash);
+}
+
+} // end namespace gui
+} // end namespace irr
@@ -0,0 +1,67 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IGUIRenderCache.h"
+#include "path.h"
+
+namespace irr
+{
+namespace video
+{
+class IVideoDriver;
+class ITexture;
+class IRenderTarget;
+}
+
+namespace gui
+{
+
+class CGUIRenderCache : public IGUIRenderCache
+{
+public:
+	//! constructor
+	CGUIRenderCache(IGUIEnvironment *environment, IGUIElement *parent,
+			s32 id, const core::rect<s32> &rectangle);
+
+	//! destructor
+	virtual ~CGUIRenderCache();
+
+	//! draws the children into the texture if needed, then the texture
+	void draw() override;
+
+	//! Makes the next draw() draw the children into the texture again
+	void invalidate() override;
+
+	//! Returns how often the children were drawn into the texture
+	u32 getRenderCount() const override;
+
+	//! Returns whether the subtree looks different than at the last call
+	/** Compares a hash of what IGUIElement knows about the elements. */
+	bool updateState();
+
+	//! Returns whether invalidate() was called since the last drawing into the texture
+	bool isInvalidated() const { return Dirty; }
+
+private:
+	void hashElement(const IGUIElement *element, u64 &hash) const;
+
+	//! Moves this element and its subtree by offset on the screen
+	void moveSubtree(const core::position2di &offset);
+
+	video::IVideoDriver *Driver;
+	video::ITexture *Texture;
+	//! own target, so drawing into a texture set with
+	//! IVideoDriver::setRenderTarget() can go on after drawing the cache
+	video::IRenderTarget *RenderTarget;
+	io::path TextureName;
+	//! Size of the last texture the driver failed to make, drawn directly then
+	core::dimension2du FailedSize;
+	u64 State;
+	u32 RenderCount;
+	bool Dirty;
+};
+
+} // end namespace gui
+} // end namespace irr
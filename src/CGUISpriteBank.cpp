@@ -88,6 +88,7 @@ void CGUISpriteBank::clear()
 	Textures.clear();
 	Sprites.clear();
 	Rectangles.clear();
+	DrawBatches.clear();
 }
 
 //! Add the texture and use it for a single non-animated sprite.
@@ -192,11 +193,12 @@ void CGUISpriteBank::draw2DSpriteBatch(const core::array<u32> &indices,
 
 	if (!getTextureCount())
 		return;
-	core::array<SDrawBatch> drawBatches(getTextureCount());
+	// the arrays keep their memory, so they only grow for longer texts
+	if (DrawBatches.size() < Textures.size())
+		DrawBatches.set_used(Textures.size());
 	for (u32 i = 0; i < Textures.size(); ++i) {
-		drawBatches.push_back(SDrawBatch());
-		drawBatches[i].positions.reallocate(drawCount);
-		drawBatches[i].sourceRects.reallocate(drawCount);
+		DrawBatches[i].positions.set_used(0);
+		DrawBatches[i].sourceRects.set_used(0);
 	}
 
 	for (u32 i = 0; i < drawCount; ++i) {
@@ -208,10 +210,10 @@ void CGUISpriteBank::draw2DSpriteBatch(const core::array<u32> &indices,
 			return;
 
 		const u32 texNum = Sprites[index].Frames[frame].textureNumber;
-		if (texNum >= drawBatches.size()) {
+		if (texNum >= Textures.size()) {
 			continue;
 		}
-		SDrawBatch &currentBatch = drawBatches[texNum];
+		SDrawBatch &currentBatch = DrawBatches[texNum];
 
 		const u32 rn = Sprites[index].Frames[frame].rectNumber;
 		if (rn >= Rectangles.size())
@@ -231,10 +233,10 @@ void CGUISpriteBank::draw2DSpriteBatch(const core::array<u32> &indices,
 		}
 	}
 
-	for (u32 i = 0; i < drawBatches.size(); i++) {
-		if (!drawBatches[i].positions.empty() && !drawBatches[i].sourceRects.empty())
-			Driver->draw2DImageBatch(getTexture(i), drawBatches[i].positions,
-					drawBatches[i].sourceRects, clip, color, true);
+	for (u32 i = 0; i < Textures.size(); i++) {
+		if (!DrawBatches[i].positions.empty() && !DrawBatches[i].sourceRects.empty())
+			Driver->draw2DImageBatch(getTexture(i), DrawBatches[i].positions,
+					DrawBatches[i].sourceRects, clip, color, true);
 	}
 }
 
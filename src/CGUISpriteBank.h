@@ -73,6 +73,8 @@ protected:
 	core::array<SGUISprite> Sprites;
 	core::array<core::rect<s32>> Rectangles;
 	core::array<video::ITexture *> Textures;
+	//! one batch per texture, kept between calls so drawing does not allocate
+	core::array<SDrawBatch> DrawBatches;
 	IGUIEnvironment *Environment;
 	video::IVideoDriver *Driver;
 };
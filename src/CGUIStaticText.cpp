@@ -86,7 +86,7 @@ void CGUIStaticText::draw()
 												  font->getDimension(Text.c_str()).Width;
 				}
 
-				font->draw(Text.c_str(), frameRect,
+				font->draw(Text, frameRect,
 						getActiveColor(),
 						HAlign == EGUIA_CENTER, VAlign == EGUIA_CENTER, (RestrainTextInside ? &AbsoluteClippingRect : NULL));
 			} else {
@@ -108,7 +108,7 @@ void CGUIStaticText::draw()
 											  font->getDimension(BrokenText[i].c_str()).Width;
 					}
 
-					font->draw(BrokenText[i].c_str(), r,
+					font->draw(BrokenText[i], r,
 							getActiveColor(),
 							HAlign == EGUIA_CENTER, false, (RestrainTextInside ? &AbsoluteClippingRect : NULL));
 
@@ -300,18 +300,29 @@ void CGUIStaticText::breakText()
 	// some order and boundaries which change.
 	if (!RightToLeft) {
 		// regular (left-to-right)
+		// Windows breaks become Mac breaks in one pass, so that the text
+		// can be measured once and the widths of the words and whitespace
+		// are differences of the widths of its beginnings.
+		if (Text.find(L"\r\n") >= 0) {
+			s32 j = 0;
+			for (s32 i = 0; i < size; ++i) {
+				Text[j++] = Text[i];
+				if (Text[i] == L'\r' && i + 1 < size && Text[i + 1] == L'\n')
+					++i;
+			}
+			Text = Text.subString(0, j);
+			size = j;
+		}
+
+		core::array<s32> widths;
+		font->getPrefixWidths(Text.c_str(), widths);
+		s32 wordStart = 0;
+
 		for (s32 i = 0; i < size; ++i) {
 			c = Text[i];
 			bool lineBreak = false;
 
-			if (c == L'\r') { // Mac or Windows breaks
-				lineBreak = true;
-				if (Text[i + 1] == L'\n') { // Windows breaks
-					Text.erase(i + 1);
-					--size;
-				}
-				c = '\0';
-			} else if (c == L'\n') { // Unix breaks
+			if (c == L'\r' || c == L'\n') { // Mac, Windows or Unix breaks
 				lineBreak = true;
 				c = '\0';
 			}
@@ -319,6 +330,8 @@ void CGUIStaticText::breakText()
 			bool isWhitespace = (c == L' ' || c == 0);
 			if (!isWhitespace) {
 				// part of a word
+				if (word.empty())
+					wordStart = i;
 				word += c;
 			}
 
@@ -326,8 +339,10 @@ void CGUIStaticText::breakText()
 				if (word.size()) {
 					// here comes the next whitespace, look if
 					// we must break the last word to the next line.
-					const s32 whitelgth = font->getDimension(whitespace.c_str()).Width;
-					const s32 wordlgth = font->getDimension(word.c_str()).Width;
+					// The whitespace is right before the word.
+					const s32 wordEnd = wordStart + word.size();
+					const s32 whitelgth = widths[wordStart] - widths[wordStart - whitespace.size()];
+					const s32 wordlgth = widths[wordEnd] - widths[wordStart];
 
 					if (wordlgth > elWidth) {
 						// This word is too long to fit in the available space, look for
@@ -338,7 +353,7 @@ void CGUIStaticText::breakText()
 							core::stringw first = word.subString(0, where);
 							core::stringw second = word.subString(where, word.size() - where);
 							BrokenText.push_back(line + first + L"-");
-							const s32 secondLength = font->getDimension(second.c_str()).Width;
+							const s32 secondLength = widths[wordEnd] - widths[wordStart + where];
 
 							length = secondLength;
 							line = second;
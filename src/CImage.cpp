@@ -6,10 +6,12 @@
 #include "irrString.h"
 #include "CColorConverter.h"
 #include "CBlit.h"
+#include "CImageResampler.h"
 #include "os.h"
 #include "SoftwareDriver2_helper.h"
 
 #include <cassert>
+#include <vector>
 
 namespace irr
 {
@@ -183,7 +185,7 @@ bool CImage::copyToNoScaling(void *target, u32 width, u32 height, ECOLOR_FORMAT
 }
 
 //! copies this surface into another, scaling it to the target image size
-// note: this is very very slow.
+// note: this picks pixels without filtering, see copyToResampled for better quality.
 void CImage::copyToScaling(void *target, u32 width, u32 height, ECOLOR_FORMAT format, u32 pitch)
 {
 	if (IImage::isCompressedFormat(Format)) {
@@ -201,6 +203,18 @@ void CImage::copyToScaling(void *target, u32 width, u32 height, ECOLOR_FORMAT fo
 	if (copyToNoScaling(target, width, height, format, pitch))
 		return;
 
+	if (Size.Width == width && Size.Height == height) {
+		// format conversion only, convert whole scanlines at once
+		u8 *tgtpos = (u8 *)target;
+		const u8 *srcpos = Data;
+		for (u32 y = 0; y < height; ++y) {
+			CColorConverter::convert_viaFormat(srcpos, Format, width, tgtpos, format);
+			tgtpos += pitch;
+			srcpos += Pitch;
+		}
+		return;
+	}
+
 	// NOTE: Scaling is coded to keep the border pixels intact.
 	// Alternatively we could for example work with first pixel being taken at half step-size.
 	// Then we have one more step here and it would be:
@@ -225,14 +239,28 @@ void CImage::copyToScaling(void *target, u32 width, u32 height, ECOLOR_FORMAT fo
 		sourceYStart = 0.5f; // for rounding to nearest pixel
 	}
 
+	// the source columns are the same for every row
+	std::vector<u32> srcOffsets(width);
+	f32 sx = sourceXStart;
+	for (u32 x = 0; x < width; ++x) {
+		srcOffsets[x] = ((s32)sx) * BytesPerPixel;
+		sx += sourceXStep;
+	}
+
+	// gather each row in the source format, then convert it at once
+	const bool convert = Format != format;
+	std::vector<u8> row(convert ? width * BytesPerPixel : 0);
+
 	s32 yval = 0, syval = 0;
 	f32 sy = sourceYStart;
 	for (u32 y = 0; y < height; ++y) {
-		f32 sx = sourceXStart;
-		for (u32 x = 0; x < width; ++x) {
-			CColorConverter::convert_viaFormat(Data + syval + ((s32)sx) * BytesPerPixel, Format, 1, ((u8 *)target) + yval + (x * bpp), format);
-			sx += sourceXStep;
-		}
+		const u8 *src = Data + syval;
+		u8 *out = convert ? row.data() : ((u8 *)target) + yval;
+		for (u32 x = 0; x < width; ++x)
+			memcpy(out + x * BytesPerPixel, src + srcOffsets[x], BytesPerPixel);
+		if (convert)
+			CColorConverter::convert_viaFormat(out, Format, width, ((u8 *)target) + yval, format);
+
 		sy += sourceYStep;
 		syval = (s32)(sy)*Pitch;
 		yval += pitch;
@@ -240,7 +268,6 @@ void CImage::copyToScaling(void *target, u32 width, u32 height, ECOLOR_FORMAT fo
 }
 
 //! copies this surface into another, scaling it to the target image size
-// note: this is very very slow.
 void CImage::copyToScaling(IImage *target)
 {
 	if (IImage::isCompressedFormat(Format)) {
@@ -291,6 +318,21 @@ void CImage::copyToScalingBoxFilter(IImage *target, s32 bias, bool blend)
 	}
 }
 
+//! copies this surface into another, resampling it with the given filter
+bool CImage::copyToResampled(IImage *target, E_IMAGE_RESAMPLE_FILTER filter, u32 threads)
+{
+	if (!target)
+		return false;
+
+	if (!CImageResampler::resample(Data, Format, Size, Pitch,
+				target->getData(), target->getColorFormat(), target->getDimension(), target->getPitch(),
+				filter, threads)) {
+		os::Printer::log("IImage::copyToResampled doesn't support this color format combination.", ELL_WARNING);
+		return false;
+	}
+	return true;
+}
+
 //! fills the surface with given color
 void CImage::fill(const SColor &color)
 {
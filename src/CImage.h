@@ -58,6 +58,9 @@ public:
 	//! copies this surface into another, scaling it to fit, applying a box filter
 	void copyToScalingBoxFilter(IImage *target, s32 bias = 0, bool blend = false) override;
 
+	//! copies this surface into another, resampling it with the given filter
+	bool copyToResampled(IImage *target, E_IMAGE_RESAMPLE_FILTER filter, u32 threads = 0) override;
+
 	//! fills the surface with given color
 	void fill(const SColor &color) override;
 
@@ -0,0 +1,479 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageCompressor.h"
+#include "CImage.h"
+#include "CColorConverter.h"
+
+#include <cstdlib>
+#include <utility>
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+u16 packRGB565(f32 r, f32 g, f32 b)
+{
+	const u32 r5 = core::s32_clamp(core::round32(r * (31.f / 255.f)), 0, 31);
+	const u32 g6 = core::s32_clamp(core::round32(g * (63.f / 255.f)), 0, 63);
+	const u32 b5 = core::s32_clamp(core::round32(b * (31.f / 255.f)), 0, 31);
+	return (u16)(r5 << 11 | g6 << 5 | b5);
+}
+
+void unpackRGB565(u16 c, s32 *rgb)
+{
+	const s32 r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+//! colors of a block in four color mode, as used by all BC1 to BC3 encoders
+void colorPalette(u16 c0, u16 c1, s32 palette[4][3])
+{
+	unpackRGB565(c0, palette[0]);
+	unpackRGB565(c1, palette[1]);
+	for (u32 i = 0; i < 3; ++i) {
+		palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+		palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+	}
+}
+
+//! picks the closest palette entry for every pixel and returns the squared error
+u32 colorIndices(const s32 rgb[16][3], u16 c0, u16 c1, u32 &indices)
+{
+	s32 palette[4][3];
+	colorPalette(c0, c1, palette);
+
+	u32 error = 0;
+	indices = 0;
+	for (u32 i = 0; i < 16; ++i) {
+		u32 best = 0, bestError = 0xFFFFFFFF;
+		for (u32 k = 0; k < 4; ++k) {
+			const s32 dr = rgb[i][0] - palette[k][0];
+			const s32 dg = rgb[i][1] - palette[k][1];
+			const s32 db = rgb[i][2] - palette[k][2];
+			const u32 e = dr * dr + dg * dg + db * db;
+			if (e < bestError) {
+				bestError = e;
+				best = k;
+			}
+		}
+		error += bestError;
+		indices |= best << (2 * i);
+	}
+	return error;
+}
+
+//! endpoints at the extremes of the principal axis of the block colors
+void principalEndpoints(const s32 rgb[16][3], u16 &c0, u16 &c1)
+{
+	f32 mean[3] = {0.f, 0.f, 0.f};
+	s32 lo[3] = {255, 255, 255}, hi[3] = {0, 0, 0};
+	for (u32 i = 0; i < 16; ++i) {
+		for (u32 c = 0; c < 3; ++c) {
+			mean[c] += rgb[i][c];
+			lo[c] = core::min_(lo[c], rgb[i][c]);
+			hi[c] = core::max_(hi[c], rgb[i][c]);
+		}
+	}
+	for (u32 c = 0; c < 3; ++c)
+		mean[c] /= 16.f;
+
+	f32 cov[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+	for (u32 i = 0; i < 16; ++i) {
+		const f32 r = rgb[i][0] - mean[0], g = rgb[i][1] - mean[1], b = rgb[i][2] - mean[2];
+		cov[0] += r * r;
+		cov[1] += r * g;
+		cov[2] += r * b;
+		cov[3] += g * g;
+		cov[4] += g * b;
+		cov[5] += b * b;
+	}
+
+	// power iteration, starting from the bounding box diagonal
+	f32 axis[3] = {(f32)(hi[0] - lo[0]), (f32)(hi[1] - lo[1]), (f32)(hi[2] - lo[2])};
+	for (u32 iter = 0; iter < 4; ++iter) {
+		const f32 x = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2];
+		const f32 y = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4];
+		const f32 z = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+		const f32 len = core::max_(fabsf(x), fabsf(y), fabsf(z));
+		if (len < 1e-6f)
+			break;
+		axis[0] = x / len;
+		axis[1] = y / len;
+		axis[2] = z / len;
+	}
+
+	u32 minIndex = 0, maxIndex = 0;
+	f32 minDot = 1e30f, maxDot = -1e30f;
+	for (u32 i = 0; i < 16; ++i) {
+		const f32 d = rgb[i][0] * axis[0] + rgb[i][1] * axis[1] + rgb[i][2] * axis[2];
+		if (d < minDot) {
+			minDot = d;
+			minIndex = i;
+		}
+		if (d > maxDot) {
+			maxDot = d;
+			maxIndex = i;
+		}
+	}
+
+	c0 = packRGB565((f32)rgb[maxIndex][0], (f32)rgb[maxIndex][1], (f32)rgb[maxIndex][2]);
+	c1 = packRGB565((f32)rgb[minIndex][0], (f32)rgb[minIndex][1], (f32)rgb[minIndex][2]);
+}
+
+//! least squares endpoints for the given indices, false if they are degenerate
+bool refineEndpoints(const s32 rgb[16][3], u32 indices, u16 &c0, u16 &c1)
+{
+	static const f32 weights[4] = {1.f, 0.f, 2.f / 3.f, 1.f / 3.f};
+
+	f32 aa = 0.f, bb = 0.f, ab = 0.f;
+	f32 x[3] = {0.f, 0.f, 0.f}, y[3] = {0.f, 0.f, 0.f};
+	for (u32 i = 0; i < 16; ++i) {
+		const f32 w = weights[(indices >> (2 * i)) & 3];
+		aa += w * w;
+		bb += (1.f - w) * (1.f - w);
+		ab += w * (1.f - w);
+		for (u32 c = 0; c < 3; ++c) {
+			x[c] += w * rgb[i][c];
+			y[c] += (1.f - w) * rgb[i][c];
+		}
+	}
+
+	const f32 det = aa * bb - ab * ab;
+	if (fabsf(det) < 1e-6f)
+		return false;
+
+	f32 e0[3], e1[3];
+	for (u32 c = 0; c < 3; ++c) {
+		e0[c] = (bb * x[c] - ab * y[c]) / det;
+		e1[c] = (aa * y[c] - ab * x[c]) / det;
+	}
+	c0 = packRGB565(e0[0], e0[1], e0[2]);
+	c1 = packRGB565(e1[0], e1[1], e1[2]);
+	return true;
+}
+
+void writeU16(u8 *out, u16 v)
+{
+	out[0] = (u8)v;
+	out[1] = (u8)(v >> 8);
+}
+
+//! encodes the color half of a block, always in four color mode
+void encodeColorBlock(const u32 *pixels, u8 *block)
+{
+	s32 rgb[16][3];
+	for (u32 i = 0; i < 16; ++i) {
+		rgb[i][0] = (pixels[i] >> 16) & 0xFF;
+		rgb[i][1] = (pixels[i] >> 8) & 0xFF;
+		rgb[i][2] = pixels[i] & 0xFF;
+	}
+
+	u16 c0, c1;
+	principalEndpoints(rgb, c0, c1);
+	u32 indices;
+	u32 error = colorIndices(rgb, c0, c1, indices);
+
+	u16 r0, r1;
+	if (error && refineEndpoints(rgb, indices, r0, r1)) {
+		u32 refinedIndices;
+		const u32 refinedError = colorIndices(rgb, r0, r1, refinedIndices);
+		if (refinedError < error) {
+			c0 = r0;
+			c1 = r1;
+			indices = refinedIndices;
+			error = refinedError;
+		}
+	}
+
+	// four color mode needs c0 > c1, swapping the endpoints flips the low index bit
+	if (c0 < c1) {
+		std::swap(c0, c1);
+		indices ^= 0x55555555;
+	} else if (c0 == c1) {
+		indices = 0;
+	}
+
+	writeU16(block, c0);
+	writeU16(block + 2, c1);
+	block[4] = (u8)indices;
+	block[5] = (u8)(indices >> 8);
+	block[6] = (u8)(indices >> 16);
+	block[7] = (u8)(indices >> 24);
+}
+
+//! encodes interpolated alpha as used by BC3, always in eight value mode
+void encodeAlphaBlock(const u32 *pixels, u8 *block)
+{
+	u32 lo = 255, hi = 0;
+	for (u32 i = 0; i < 16; ++i) {
+		const u32 a = pixels[i] >> 24;
+		lo = core::min_(lo, a);
+		hi = core::max_(hi, a);
+	}
+
+	block[0] = (u8)hi;
+	block[1] = (u8)lo;
+	u64 bits = 0;
+	if (hi != lo) {
+		u32 palette[8];
+		palette[0] = hi;
+		palette[1] = lo;
+		for (u32 k = 2; k < 8; ++k)
+			palette[k] = ((8 - k) * hi + (k - 1) * lo + 3) / 7;
+
+		for (u32 i = 0; i < 16; ++i) {
+			const s32 a = pixels[i] >> 24;
+			u32 best = 0, bestError = 256;
+			for (u32 k = 0; k < 8; ++k) {
+				const u32 e = abs(a - (s32)palette[k]);
+				if (e < bestError) {
+					bestError = e;
+					best = k;
+				}
+			}
+			bits |= (u64)best << (3 * i);
+		}
+	}
+	for (u32 i = 0; i < 6; ++i)
+		block[2 + i] = (u8)(bits >> (8 * i));
+}
+
+void decodeColorBlock(const u8 *block, bool allowTransparent, u32 *pixels)
+{
+	const u16 c0 = block[0] | block[1] << 8;
+	const u16 c1 = block[2] | block[3] << 8;
+	const u32 indices = block[4] | block[5] << 8 | block[6] << 16 | (u32)block[7] << 24;
+
+	u32 colors[4];
+	s32 palette[4][3];
+	colorPalette(c0, c1, palette);
+	if (c0 <= c1 && allowTransparent) {
+		// three color mode with transparent black
+		for (u32 i = 0; i < 3; ++i)
+			palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+	}
+	for (u32 k = 0; k < 4; ++k)
+		colors[k] = 0xFF000000 | palette[k][0] << 16 | palette[k][1] << 8 | palette[k][2];
+	if (c0 <= c1 && allowTransparent)
+		colors[3] = 0;
+
+	for (u32 i = 0; i < 16; ++i)
+		pixels[i] = colors[(indices >> (2 * i)) & 3];
+}
+
+void decodeAlphaBlock(const u8 *block, u32 *pixels)
+{
+	const u32 a0 = block[0], a1 = block[1];
+	u32 palette[8] = {a0, a1};
+	if (a0 > a1) {
+		for (u32 k = 2; k < 8; ++k)
+			palette[k] = ((8 - k) * a0 + (k - 1) * a1 + 3) / 7;
+	} else {
+		for (u32 k = 2; k < 6; ++k)
+			palette[k] = ((6 - k) * a0 + (k - 1) * a1 + 2) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	u64 bits = 0;
+	for (u32 i = 0; i < 6; ++i)
+		bits |= (u64)block[2 + i] << (8 * i);
+	for (u32 i = 0; i < 16; ++i)
+		pixels[i] = (pixels[i] & 0x00FFFFFF) | palette[(bits >> (3 * i)) & 7] << 24;
+}
+
+//! encodes A8R8G8B8 pixels, repeating the edge pixels to fill partial blocks
+void encodeImage(const u32 *pixels, const core::dimension2du &size, ECOLOR_FORMAT format, u8 *out)
+{
+	const u32 blockSize = IImage::getBlockSizeFromFormat(format);
+	u32 block[16];
+	for (u32 by = 0; by < size.Height; by += 4) {
+		for (u32 bx = 0; bx < size.Width; bx += 4) {
+			for (u32 y = 0; y < 4; ++y) {
+				const u32 *row = pixels + core::min_(by + y, size.Height - 1) * size.Width;
+				for (u32 x = 0; x < 4; ++x)
+					block[y * 4 + x] = row[core::min_(bx + x, size.Width - 1)];
+			}
+			if (format == ECF_DXT5)
+				CImageCompressor::encodeBlockDXT5(block, out);
+			else
+				CImageCompressor::encodeBlockDXT1(block, out);
+			out += blockSize;
+		}
+	}
+}
+
+void decodeImage(const u8 *blocks, const core::dimension2du &size, ECOLOR_FORMAT format, u32 *pixels)
+{
+	const u32 blockSize = IImage::getBlockSizeFromFormat(format);
+	u32 block[16];
+	for (u32 by = 0; by < size.Height; by += 4) {
+		for (u32 bx = 0; bx < size.Width; bx += 4) {
+			CImageCompressor::decodeBlock(format, blocks, block);
+			blocks += blockSize;
+			for (u32 y = 0; y < 4 && by + y < size.Height; ++y) {
+				for (u32 x = 0; x < 4 && bx + x < size.Width; ++x)
+					pixels[(by + y) * size.Width + bx + x] = block[y * 4 + x];
+			}
+		}
+	}
+}
+
+//! bytes of all mipmap levels after level 0
+u32 mipChainSize(ECOLOR_FORMAT format, const core::dimension2du &size, u32 levels)
+{
+	u32 total = 0;
+	for (u32 i = 1; i <= levels; ++i) {
+		const core::dimension2du levelSize = IImage::getMipMapsSize(size, i);
+		total += IImage::getDataSizeFromFormat(format, levelSize.Width, levelSize.Height);
+	}
+	return total;
+}
+
+} // end anonymous namespace
+
+bool CImageCompressor::canCompress(ECOLOR_FORMAT format)
+{
+	return format == ECF_DXT1 || format == ECF_DXT5;
+}
+
+bool CImageCompressor::canDecompress(ECOLOR_FORMAT format)
+{
+	return format == ECF_DXT1 || format == ECF_DXT3 || format == ECF_DXT5;
+}
+
+ECOLOR_FORMAT CImageCompressor::chooseFormat(const IImage *image)
+{
+	const core::dimension2du &size = image->getDimension();
+	switch (image->getColorFormat()) {
+	case ECF_A1R5G5B5: {
+		const u16 *p = (const u16 *)image->getData();
+		for (u32 i = 0; i < size.getArea(); ++i) {
+			if (!(p[i] & 0x8000))
+				return ECF_DXT5;
+		}
+		break;
+	}
+	case ECF_A8R8G8B8: {
+		const u32 *p = (const u32 *)image->getData();
+		for (u32 i = 0; i < size.getArea(); ++i) {
+			if ((p[i] >> 24) != 0xFF)
+				return ECF_DXT5;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	return ECF_DXT1;
+}
+
+IImage *CImageCompressor::compress(const IImage *image, ECOLOR_FORMAT format, bool mipMaps)
+{
+	if (!image || !canCompress(format))
+		return 0;
+
+	const ECOLOR_FORMAT srcFormat = image->getColorFormat();
+	const core::dimension2du &size = image->getDimension();
+	if (IImage::isCompressedFormat(srcFormat) || !CColorConverter::canConvertFormat(srcFormat, ECF_A8R8G8B8) ||
+			size.getArea() == 0)
+		return 0;
+
+	CImage *level = new CImage(ECF_A8R8G8B8, size);
+	for (u32 y = 0; y < size.Height; ++y) {
+		CColorConverter::convert_viaFormat((const u8 *)image->getData() + y * image->getPitch(), srcFormat,
+				size.Width, (u8 *)level->getData() + y * level->getPitch(), ECF_A8R8G8B8);
+	}
+
+	u8 *data = new u8[IImage::getDataSizeFromFormat(format, size.Width, size.Height)];
+	encodeImage((const u32 *)level->getData(), size, format, data);
+	IImage *result = new CImage(format, size, data, true, true);
+
+	if (mipMaps && (size.Width > 1 || size.Height > 1)) {
+		const u32 levels = core::u32_log2(core::max_(size.Width, size.Height));
+		u8 *mipData = new u8[mipChainSize(format, size, levels)];
+		u8 *out = mipData;
+		for (u32 i = 1; i <= levels; ++i) {
+			const core::dimension2du levelSize = IImage::getMipMapsSize(size, i);
+			CImage *next = new CImage(ECF_A8R8G8B8, levelSize);
+			level->copyToResampled(next, EIRF_BOX);
+			level->drop();
+			level = next;
+
+			encodeImage((const u32 *)level->getData(), levelSize, format, out);
+			out += IImage::getDataSizeFromFormat(format, levelSize.Width, levelSize.Height);
+		}
+		result->setMipMapsData(mipData, levels);
+	}
+
+	level->drop();
+	return result;
+}
+
+IImage *CImageCompressor::decompress(const IImage *image)
+{
+	if (!image || !canDecompress(image->getColorFormat()))
+		return 0;
+
+	const ECOLOR_FORMAT format = image->getColorFormat();
+	const core::dimension2du &size = image->getDimension();
+	IImage *result = new CImage(ECF_A8R8G8B8, size);
+	decodeImage((const u8 *)image->getData(), size, format, (u32 *)result->getData());
+
+	const u32 levels = image->getMipMapLevelCount();
+	if (levels) {
+		u8 *mipData = new u8[mipChainSize(ECF_A8R8G8B8, size, levels)];
+		u8 *out = mipData;
+		for (u32 i = 1; i <= levels; ++i) {
+			const core::dimension2du levelSize = IImage::getMipMapsSize(size, i);
+			decodeImage((const u8 *)image->getMipMapsData(i), levelSize, format, (u32 *)out);
+			out += IImage::getDataSizeFromFormat(ECF_A8R8G8B8, levelSize.Width, levelSize.Height);
+		}
+		result->setMipMapsData(mipData, levels);
+	}
+	return result;
+}
+
+void CImageCompressor::encodeBlockDXT1(const u32 *pixels, u8 *block)
+{
+	encodeColorBlock(pixels, block);
+}
+
+void CImageCompressor::encodeBlockDXT5(const u32 *pixels, u8 *block)
+{
+	encodeAlphaBlock(pixels, block);
+	encodeColorBlock(pixels, block + 8);
+}
+
+void CImageCompressor::decodeBlock(ECOLOR_FORMAT format, const u8 *block, u32 *pixels)
+{
+	switch (format) {
+	case ECF_DXT1:
+		decodeColorBlock(block, true, pixels);
+		break;
+	case ECF_DXT3:
+		decodeColorBlock(block + 8, false, pixels);
+		for (u32 i = 0; i < 16; ++i) {
+			const u32 a = (block[i / 2] >> ((i & 1) * 4)) & 0xF;
+			pixels[i] = (pixels[i] & 0x00FFFFFF) | (a * 17) << 24;
+		}
+		break;
+	case ECF_DXT5:
+		decodeColorBlock(block + 8, false, pixels);
+		decodeAlphaBlock(block, pixels);
+		break;
+	default:
+		memset(pixels, 0, 16 * sizeof(u32));
+		break;
+	}
+}
+
+} // end namespace video
+} // end namespace irr
@@ -0,0 +1,52 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! CPU encoder and decoder for block compressed images.
+/** Encodes ECF_DXT1 (opaque images) and ECF_DXT5 (images with alpha) from
+any format convertible to ECF_A8R8G8B8, and decodes the DXT formats back,
+which allows falling back to uncompressed textures where the driver lacks
+S3TC support. Blocks are encoded along the principal color axis with one
+least squares refinement, which is fast enough for load time compression. */
+class CImageCompressor
+{
+public:
+	//! Returns true if compress() can produce this format.
+	static bool canCompress(ECOLOR_FORMAT format);
+
+	//! Returns true if decompress() can read this format.
+	static bool canDecompress(ECOLOR_FORMAT format);
+
+	//! Picks the format compress() should use for an image.
+	/** \return ECF_DXT5 if the image has translucent pixels, else ECF_DXT1. */
+	static ECOLOR_FORMAT chooseFormat(const IImage *image);
+
+	//! Creates a compressed copy of an uncompressed image.
+	/** \param mipMaps Also encode a full mipmap chain, see IImage::getMipMapsData.
+	\return New image or 0 if the formats are not supported. */
+	static IImage *compress(const IImage *image, ECOLOR_FORMAT format, bool mipMaps);
+
+	//! Creates an ECF_A8R8G8B8 copy of a compressed image, mipmaps included.
+	/** \return New image or 0 if the format is not supported. */
+	static IImage *decompress(const IImage *image);
+
+	//! Encodes 4x4 A8R8G8B8 pixels into an 8 byte BC1 block.
+	static void encodeBlockDXT1(const u32 *pixels, u8 *block);
+
+	//! Encodes 4x4 A8R8G8B8 pixels into a 16 byte BC3 block.
+	static void encodeBlockDXT5(const u32 *pixels, u8 *block);
+
+	//! Decodes one BC1, BC2 or BC3 block into 4x4 A8R8G8B8 pixels.
+	static void decodeBlock(ECOLOR_FORMAT format, const u8 *block, u32 *pixels);
+};
+
+} // end namespace video
+} // end namespace irr
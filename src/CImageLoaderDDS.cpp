@@ -0,0 +1,205 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageLoaderDDS.h"
+
+#include "IReadFile.h"
+#include "coreutil.h"
+#include "os.h"
+#include "CImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+constexpr u32 makeFourCC(char a, char b, char c, char d)
+{
+	return (u32)(u8)a | (u32)(u8)b << 8 | (u32)(u8)c << 16 | (u32)(u8)d << 24;
+}
+
+constexpr u32 DDS_MAGIC = makeFourCC('D', 'D', 'S', ' ');
+constexpr u32 DDPF_FOURCC = 0x4;
+constexpr u32 DDSD_MIPMAPCOUNT = 0x20000;
+constexpr u32 DDSCAPS2_CUBEMAP = 0x200;
+constexpr u32 DDSCAPS2_VOLUME = 0x200000;
+constexpr u32 D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+constexpr u32 D3D10_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+ECOLOR_FORMAT formatFromFourCC(u32 fourCC)
+{
+	switch (fourCC) {
+	case makeFourCC('D', 'X', 'T', '1'):
+		return ECF_DXT1;
+	case makeFourCC('D', 'X', 'T', '3'):
+		return ECF_DXT3;
+	case makeFourCC('D', 'X', 'T', '5'):
+		return ECF_DXT5;
+	case makeFourCC('A', 'T', 'I', '1'):
+	case makeFourCC('B', 'C', '4', 'U'):
+		return ECF_BC4;
+	case makeFourCC('A', 'T', 'I', '2'):
+	case makeFourCC('B', 'C', '5', 'U'):
+		return ECF_BC5;
+	default:
+		return ECF_UNKNOWN;
+	}
+}
+
+// sRGB variants are loaded as their linear counterparts
+ECOLOR_FORMAT formatFromDXGI(u32 dxgiFormat)
+{
+	switch (dxgiFormat) {
+	case 71: // DXGI_FORMAT_BC1_UNORM
+	case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+		return ECF_DXT1;
+	case 74: // DXGI_FORMAT_BC2_UNORM
+	case 75: // DXGI_FORMAT_BC2_UNORM_SRGB
+		return ECF_DXT3;
+	case 77: // DXGI_FORMAT_BC3_UNORM
+	case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+		return ECF_DXT5;
+	case 80: // DXGI_FORMAT_BC4_UNORM
+		return ECF_BC4;
+	case 83: // DXGI_FORMAT_BC5_UNORM
+		return ECF_BC5;
+	case 98: // DXGI_FORMAT_BC7_UNORM
+	case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+		return ECF_BC7;
+	default:
+		return ECF_UNKNOWN;
+	}
+}
+
+#ifdef __BIG_ENDIAN__
+void byteswapHeader(u32 *words, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+		words[i] = os::Byteswap::byteswap(words[i]);
+}
+#endif
+} // end anonymous namespace
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".dds")
+bool CImageLoaderDDS::isALoadableFileExtension(const io::path &filename) const
+{
+	return core::hasFileExtension(filename, "dds");
+}
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CImageLoaderDDS::isALoadableFileFormat(io::IReadFile *file) const
+{
+	if (!file)
+		return false;
+
+	u32 magic = 0;
+	file->read(&magic, sizeof(magic));
+#ifdef __BIG_ENDIAN__
+	magic = os::Byteswap::byteswap(magic);
+#endif
+	return magic == DDS_MAGIC;
+}
+
+//! creates a surface from the file
+IImage *CImageLoaderDDS::loadImage(io::IReadFile *file) const
+{
+	SDDSHeader header;
+	if (file->read(&header, sizeof(header)) != sizeof(header)) {
+		os::Printer::log("DDS header is truncated", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+#ifdef __BIG_ENDIAN__
+	byteswapHeader((u32 *)&header, sizeof(header) / 4);
+#endif
+
+	if (header.Magic != DDS_MAGIC || header.Size != 124 || header.PixelFormat.Size != 32) {
+		os::Printer::log("Not a valid DDS file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (header.Caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) {
+		os::Printer::log("DDS cube maps and volume textures are not supported", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	ECOLOR_FORMAT format = ECF_UNKNOWN;
+	if (header.PixelFormat.Flags & DDPF_FOURCC) {
+		if (header.PixelFormat.FourCC == makeFourCC('D', 'X', '1', '0')) {
+			SDDSHeaderDXT10 dx10;
+			if (file->read(&dx10, sizeof(dx10)) != sizeof(dx10)) {
+				os::Printer::log("DDS header is truncated", file->getFileName(), ELL_ERROR);
+				return 0;
+			}
+#ifdef __BIG_ENDIAN__
+			byteswapHeader((u32 *)&dx10, sizeof(dx10) / 4);
+#endif
+			if (dx10.ResourceDimension != D3D10_RESOURCE_DIMENSION_TEXTURE2D || dx10.ArraySize != 1 ||
+					(dx10.MiscFlag & D3D10_RESOURCE_MISC_TEXTURECUBE)) {
+				os::Printer::log("DDS texture arrays and cube maps are not supported", file->getFileName(), ELL_ERROR);
+				return 0;
+			}
+			format = formatFromDXGI(dx10.DxgiFormat);
+		} else {
+			format = formatFromFourCC(header.PixelFormat.FourCC);
+		}
+	}
+
+	if (format == ECF_UNKNOWN) {
+		os::Printer::log("Unsupported DDS pixel format, only block compressed data is read", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (header.Width == 0 || header.Height == 0) {
+		os::Printer::log("Image has no pixels in file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+	if (!checkImageDimensions(header.Width, header.Height)) {
+		os::Printer::log("Image dimensions too large in file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const core::dimension2du size(header.Width, header.Height);
+	const u32 dataSize = IImage::getDataSizeFromFormat(format, size.Width, size.Height);
+	u8 *data = new u8[dataSize];
+	if (file->read(data, dataSize) != dataSize) {
+		os::Printer::log("DDS image data is truncated", file->getFileName(), ELL_ERROR);
+		delete[] data;
+		return 0;
+	}
+	IImage *image = new CImage(format, size, data, true, true);
+
+	// Only complete mipmap chains are kept, the drivers can't generate
+	// missing levels of compressed textures.
+	const u32 fileLevels = (header.Flags & DDSD_MIPMAPCOUNT) && header.MipMapCount > 1 ? header.MipMapCount - 1 : 0;
+	const u32 fullChain = core::u32_log2(core::max_(size.Width, size.Height));
+	if (fileLevels >= fullChain && fullChain > 0) {
+		u32 mipSize = 0;
+		for (u32 i = 1; i <= fullChain; ++i) {
+			const core::dimension2du levelSize = image->getMipMapsSize(i);
+			mipSize += IImage::getDataSizeFromFormat(format, levelSize.Width, levelSize.Height);
+		}
+		u8 *mipData = new u8[mipSize];
+		if (file->read(mipData, mipSize) == mipSize) {
+			image->setMipMapsData(mipData, fullChain);
+		} else {
+			os::Printer::log("DDS mipmap data is truncated, mipmaps are skipped", file->getFileName(), ELL_WARNING);
+			delete[] mipData;
+		}
+	} else if (fileLevels) {
+		os::Printer::log("DDS mipmap chain is incomplete, mipmaps are skipped", file->getFileName(), ELL_DEBUG);
+	}
+
+	return image;
+}
+
+//! creates a loader which is able to load dds images
+IImageLoader *createImageLoaderDDS()
+{
+	return new CImageLoaderDDS();
+}
+
+} // end namespace video
+} // end namespace irr
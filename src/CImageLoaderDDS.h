@@ -0,0 +1,78 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IImageLoader.h"
+
+namespace irr
+{
+namespace video
+{
+
+// byte-align structures
+#include "irrpack.h"
+
+struct SDDSPixelFormat
+{
+	u32 Size;
+	u32 Flags;
+	u32 FourCC;
+	u32 RGBBitCount;
+	u32 RBitMask;
+	u32 GBitMask;
+	u32 BBitMask;
+	u32 ABitMask;
+} PACK_STRUCT;
+
+struct SDDSHeader
+{
+	u32 Magic; // "DDS "
+	u32 Size;
+	u32 Flags;
+	u32 Height;
+	u32 Width;
+	u32 PitchOrLinearSize;
+	u32 Depth;
+	u32 MipMapCount;
+	u32 Reserved1[11];
+	SDDSPixelFormat PixelFormat;
+	u32 Caps;
+	u32 Caps2;
+	u32 Caps3;
+	u32 Caps4;
+	u32 Reserved2;
+} PACK_STRUCT;
+
+// follows SDDSHeader if the FourCC is "DX10"
+struct SDDSHeaderDXT10
+{
+	u32 DxgiFormat;
+	u32 ResourceDimension;
+	u32 MiscFlag;
+	u32 ArraySize;
+	u32 MiscFlags2;
+} PACK_STRUCT;
+
+// Default alignment
+#include "irrunpack.h"
+
+/*!
+	Surface Loader for DirectDraw Surfaces holding block compressed 2D textures
+*/
+class CImageLoaderDDS : public IImageLoader
+{
+public:
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".dds")
+	bool isALoadableFileExtension(const io::path &filename) const override;
+
+	//! returns true if the file maybe is able to be loaded by this class
+	bool isALoadableFileFormat(io::IReadFile *file) const override;
+
+	//! creates a surface from the file
+	IImage *loadImage(io::IReadFile *file) const override;
+};
+
+} // end namespace video
+} // end namespace irr
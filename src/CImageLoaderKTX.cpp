@@ -0,0 +1,198 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageLoaderKTX.h"
+
+#include "IReadFile.h"
+#include "coreutil.h"
+#include "os.h"
+#include "CImage.h"
+
+#include <vector>
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+const u8 KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+// sRGB variants are loaded as their linear counterparts
+ECOLOR_FORMAT formatFromVulkan(u32 vkFormat)
+{
+	switch (vkFormat) {
+	case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+	case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+	case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+	case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+		return ECF_DXT1;
+	case 135: // VK_FORMAT_BC2_UNORM_BLOCK
+	case 136: // VK_FORMAT_BC2_SRGB_BLOCK
+		return ECF_DXT3;
+	case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+	case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+		return ECF_DXT5;
+	case 139: // VK_FORMAT_BC4_UNORM_BLOCK
+		return ECF_BC4;
+	case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+		return ECF_BC5;
+	case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+	case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+		return ECF_BC7;
+	case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+	case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+		return ECF_ETC2_RGB;
+	case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+	case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+		return ECF_ETC2_ARGB;
+	case 157: // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+	case 158: // VK_FORMAT_ASTC_4x4_SRGB_BLOCK
+		return ECF_ASTC_4x4;
+	default:
+		return ECF_UNKNOWN;
+	}
+}
+
+//! reads one mipmap level, checking that it has the expected size
+bool readLevel(io::IReadFile *file, const SKTX2LevelIndex &level, u8 *data, u32 dataSize)
+{
+	return level.ByteLength == dataSize &&
+			file->seek((long)level.ByteOffset) &&
+			file->read(data, dataSize) == dataSize;
+}
+} // end anonymous namespace
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".ktx2")
+bool CImageLoaderKTX::isALoadableFileExtension(const io::path &filename) const
+{
+	return core::hasFileExtension(filename, "ktx2");
+}
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CImageLoaderKTX::isALoadableFileFormat(io::IReadFile *file) const
+{
+	if (!file)
+		return false;
+
+	u8 identifier[sizeof(KTX2_IDENTIFIER)];
+	return file->read(identifier, sizeof(identifier)) == sizeof(identifier) &&
+			memcmp(identifier, KTX2_IDENTIFIER, sizeof(identifier)) == 0;
+}
+
+//! creates a surface from the file
+IImage *CImageLoaderKTX::loadImage(io::IReadFile *file) const
+{
+	SKTX2Header header;
+	if (file->read(&header, sizeof(header)) != sizeof(header) ||
+			memcmp(header.Identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+		os::Printer::log("Not a valid KTX2 file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+#ifdef __BIG_ENDIAN__
+	header.VkFormat = os::Byteswap::byteswap(header.VkFormat);
+	header.PixelWidth = os::Byteswap::byteswap(header.PixelWidth);
+	header.PixelHeight = os::Byteswap::byteswap(header.PixelHeight);
+	header.PixelDepth = os::Byteswap::byteswap(header.PixelDepth);
+	header.LayerCount = os::Byteswap::byteswap(header.LayerCount);
+	header.FaceCount = os::Byteswap::byteswap(header.FaceCount);
+	header.LevelCount = os::Byteswap::byteswap(header.LevelCount);
+	header.SupercompressionScheme = os::Byteswap::byteswap(header.SupercompressionScheme);
+#endif
+
+	if (header.SupercompressionScheme != 0) {
+		os::Printer::log("Supercompressed KTX2 files (BasisLZ, Zstandard, zlib) are not supported", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+	if (header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount != 1) {
+		os::Printer::log("KTX2 arrays, cube maps and 3D textures are not supported", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const ECOLOR_FORMAT format = formatFromVulkan(header.VkFormat);
+	if (format == ECF_UNKNOWN) {
+		os::Printer::log("Unsupported KTX2 format, only block compressed data is read", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (header.PixelWidth == 0 || header.PixelHeight == 0) {
+		os::Printer::log("Image has no pixels in file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+	if (!checkImageDimensions(header.PixelWidth, header.PixelHeight)) {
+		os::Printer::log("Image dimensions too large in file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const core::dimension2du size(header.PixelWidth, header.PixelHeight);
+	const u32 fullChain = core::u32_log2(core::max_(size.Width, size.Height));
+	// checked before allocating the level index, as the count comes from the file
+	if (header.LevelCount > fullChain + 1) {
+		os::Printer::log("KTX2 file has more mipmap levels than the image size allows", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const u32 fileLevels = core::max_(header.LevelCount, 1U);
+	std::vector<SKTX2LevelIndex> levels(fileLevels);
+	if (file->read(levels.data(), fileLevels * sizeof(SKTX2LevelIndex)) != fileLevels * sizeof(SKTX2LevelIndex)) {
+		os::Printer::log("KTX2 level index is truncated", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+#ifdef __BIG_ENDIAN__
+	for (auto &level : levels) {
+		level.ByteOffset = os::Byteswap::byteswap(level.ByteOffset);
+		level.ByteLength = os::Byteswap::byteswap(level.ByteLength);
+	}
+#endif
+
+	const u32 dataSize = IImage::getDataSizeFromFormat(format, size.Width, size.Height);
+	u8 *data = new u8[dataSize];
+	if (!readLevel(file, levels[0], data, dataSize)) {
+		os::Printer::log("KTX2 image data is truncated or has the wrong size", file->getFileName(), ELL_ERROR);
+		delete[] data;
+		return 0;
+	}
+	IImage *image = new CImage(format, size, data, true, true);
+
+	// Only complete mipmap chains are kept, the drivers can't generate
+	// missing levels of compressed textures.
+	if (fileLevels > fullChain && fullChain > 0) {
+		u32 mipSize = 0;
+		for (u32 i = 1; i <= fullChain; ++i) {
+			const core::dimension2du levelSize = image->getMipMapsSize(i);
+			mipSize += IImage::getDataSizeFromFormat(format, levelSize.Width, levelSize.Height);
+		}
+
+		u8 *mipData = new u8[mipSize];
+		u8 *out = mipData;
+		bool complete = true;
+		for (u32 i = 1; i <= fullChain && complete; ++i) {
+			const core::dimension2du levelSize = image->getMipMapsSize(i);
+			const u32 levelBytes = IImage::getDataSizeFromFormat(format, levelSize.Width, levelSize.Height);
+			complete = readLevel(file, levels[i], out, levelBytes);
+			out += levelBytes;
+		}
+
+		if (complete) {
+			image->setMipMapsData(mipData, fullChain);
+		} else {
+			os::Printer::log("KTX2 mipmap data is truncated, mipmaps are skipped", file->getFileName(), ELL_WARNING);
+			delete[] mipData;
+		}
+	} else if (fileLevels > 1) {
+		os::Printer::log("KTX2 mipmap chain is incomplete, mipmaps are skipped", file->getFileName(), ELL_DEBUG);
+	}
+
+	return image;
+}
+
+//! creates a loader which is able to load ktx2 images
+IImageLoader *createImageLoaderKTX()
+{
+	return new CImageLoaderKTX();
+}
+
+} // end namespace video
+} // end namespace irr
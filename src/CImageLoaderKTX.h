@@ -0,0 +1,65 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IImageLoader.h"
+
+namespace irr
+{
+namespace video
+{
+
+// byte-align structures
+#include "irrpack.h"
+
+struct SKTX2Header
+{
+	u8 Identifier[12]; // «KTX 20»\r\n\x1A\n
+	u32 VkFormat;
+	u32 TypeSize;
+	u32 PixelWidth;
+	u32 PixelHeight;
+	u32 PixelDepth;
+	u32 LayerCount;
+	u32 FaceCount;
+	u32 LevelCount;
+	u32 SupercompressionScheme;
+	u32 DfdByteOffset;
+	u32 DfdByteLength;
+	u32 KvdByteOffset;
+	u32 KvdByteLength;
+	u64 SgdByteOffset;
+	u64 SgdByteLength;
+} PACK_STRUCT;
+
+// one entry per mipmap level follows the header, starting with level 0
+struct SKTX2LevelIndex
+{
+	u64 ByteOffset;
+	u64 ByteLength;
+	u64 UncompressedByteLength;
+} PACK_STRUCT;
+
+// Default alignment
+#include "irrunpack.h"
+
+/*!
+	Surface Loader for KTX 2.0 files holding block compressed 2D textures
+*/
+class CImageLoaderKTX : public IImageLoader
+{
+public:
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".ktx2")
+	bool isALoadableFileExtension(const io::path &filename) const override;
+
+	//! returns true if the file maybe is able to be loaded by this class
+	bool isALoadableFileFormat(io::IReadFile *file) const override;
+
+	//! creates a surface from the file
+	IImage *loadImage(io::IReadFile *file) const override;
+};
+
+} // end namespace video
+} // end namespace irr
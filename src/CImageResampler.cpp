@@ -0,0 +1,436 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageResampler.h"
+#include "CColorConverter.h"
+#include "SIMD_helper.h"
+#include "irrMath.h"
+#include "os.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+// Filter weights are fixed point s16 so that two taps fit one SSE2
+// multiply-add. Lanczos weights may exceed 1.0, which still fits.
+constexpr s32 WEIGHT_BITS = 14;
+constexpr s32 WEIGHT_ONE = 1 << WEIGHT_BITS;
+constexpr s32 WEIGHT_ROUND = 1 << (WEIGHT_BITS - 1);
+
+// Below this many target pixels per thread, spawning threads does not pay off
+constexpr u32 MIN_PIXELS_PER_THREAD = 64 * 1024;
+
+struct SFilterDesc
+{
+	f64 Support;
+	f64 (*Weight)(f64 x);
+};
+
+f64 boxWeight(f64 x)
+{
+	return (x > -0.5 && x <= 0.5) ? 1.0 : 0.0;
+}
+
+f64 triangleWeight(f64 x)
+{
+	x = fabs(x);
+	return x < 1.0 ? 1.0 - x : 0.0;
+}
+
+f64 sinc(f64 x)
+{
+	if (x == 0.0)
+		return 1.0;
+	x *= core::PI64;
+	return sin(x) / x;
+}
+
+f64 lanczos3Weight(f64 x)
+{
+	return (x > -3.0 && x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+//! Filter taps of all target pixels along one axis
+struct SFilterTaps
+{
+	std::vector<s32> First; //!< first source pixel
+	std::vector<s32> Count; //!< number of source pixels
+	std::vector<s16> Weights; //!< MaxTaps fixed point weights per target pixel
+	s32 MaxTaps = 0;
+
+	const s16 *weights(u32 i) const { return &Weights[(size_t)i * MaxTaps]; }
+};
+
+//! Computes the taps mapping srcSize pixels onto dstSize pixels.
+//! The filter is widened when shrinking so that every source pixel contributes.
+void computeTaps(SFilterTaps &taps, u32 srcSize, u32 dstSize, const SFilterDesc &filter)
+{
+	const f64 scale = (f64)srcSize / dstSize;
+	const f64 filterScale = core::max_(scale, 1.0);
+	const f64 support = filter.Support * filterScale;
+
+	taps.MaxTaps = (s32)ceil(support) * 2 + 1;
+	taps.First.resize(dstSize);
+	taps.Count.resize(dstSize);
+	taps.Weights.assign((size_t)dstSize * taps.MaxTaps, 0);
+
+	std::vector<f64> w(taps.MaxTaps);
+	for (u32 i = 0; i < dstSize; ++i) {
+		const f64 center = (i + 0.5) * scale;
+		s32 first = core::max_((s32)floor(center - support + 0.5), 0);
+		const s32 last = core::min_((s32)floor(center + support + 0.5), (s32)srcSize);
+		s32 count = core::min_(last - first, taps.MaxTaps);
+
+		f64 sum = 0.0;
+		for (s32 k = 0; k < count; ++k) {
+			w[k] = filter.Weight((first + k - center + 0.5) / filterScale);
+			sum += w[k];
+		}
+
+		// drop taps that do not contribute
+		s32 skip = 0;
+		while (count - skip > 1 && w[skip] == 0.0)
+			++skip;
+		while (count - skip > 1 && w[count - 1] == 0.0)
+			--count;
+		first += skip;
+		count -= skip;
+
+		s16 *out = &taps.Weights[(size_t)i * taps.MaxTaps];
+		if (sum == 0.0) {
+			// degenerate, use the closest pixel
+			out[0] = WEIGHT_ONE;
+			count = 1;
+		} else {
+			// quantize, and put the rounding error on the largest weight so
+			// that a constant color stays exactly the same
+			s32 total = 0;
+			s32 largest = 0;
+			for (s32 k = 0; k < count; ++k) {
+				out[k] = (s16)core::round32((f32)(w[k + skip] / sum * WEIGHT_ONE));
+				total += out[k];
+				if (abs(out[k]) > abs(out[largest]))
+					largest = k;
+			}
+			out[largest] += WEIGHT_ONE - total;
+		}
+
+		taps.First[i] = first;
+		taps.Count[i] = count;
+	}
+}
+
+inline u8 clampChannel(s32 acc)
+{
+	return (u8)core::s32_clamp(acc >> WEIGHT_BITS, 0, 255);
+}
+
+//! Filters a row of 4 byte pixels horizontally
+void filterRow(const u8 *src, u8 *dst, const SFilterTaps &taps, u32 dstWidth)
+{
+	for (u32 i = 0; i < dstWidth; ++i) {
+		const u8 *s = src + taps.First[i] * 4;
+		const s16 *w = taps.weights(i);
+		s32 acc[4] = {WEIGHT_ROUND, WEIGHT_ROUND, WEIGHT_ROUND, WEIGHT_ROUND};
+		for (s32 k = 0; k < taps.Count[i]; ++k) {
+			for (u32 c = 0; c < 4; ++c)
+				acc[c] += s[k * 4 + c] * w[k];
+		}
+		for (u32 c = 0; c < 4; ++c)
+			dst[i * 4 + c] = clampChannel(acc[c]);
+	}
+}
+
+//! Filters bytes vertically across count rows
+void filterColumns(const u8 *const *rows, const s16 *w, s32 count, u8 *dst, u32 bytes, u32 start = 0)
+{
+	for (u32 i = start; i < bytes; ++i) {
+		s32 acc = WEIGHT_ROUND;
+		for (s32 k = 0; k < count; ++k)
+			acc += rows[k][i] * w[k];
+		dst[i] = clampChannel(acc);
+	}
+}
+
+#if defined(IRR_ARCH_X86)
+
+#define TARGET_SSE2 IRR_TARGET("sse2")
+
+//! two weights for _mm_madd_epi16, first one in the low half
+TARGET_SSE2 inline __m128i weightPair(s16 w0, s16 w1)
+{
+	return _mm_set1_epi32((s32)(((u32)(u16)w1 << 16) | (u16)w0));
+}
+
+TARGET_SSE2 inline __m128i roundAndPack(__m128i lo, __m128i hi)
+{
+	lo = _mm_srai_epi32(lo, WEIGHT_BITS);
+	hi = _mm_srai_epi32(hi, WEIGHT_BITS);
+	const __m128i v = _mm_packs_epi32(lo, hi);
+	return _mm_packus_epi16(v, v);
+}
+
+TARGET_SSE2 void filterRowSSE2(const u8 *src, u8 *dst, const SFilterTaps &taps, u32 dstWidth)
+{
+	const __m128i zero = _mm_setzero_si128();
+	for (u32 i = 0; i < dstWidth; ++i) {
+		const u8 *s = src + taps.First[i] * 4;
+		const s16 *w = taps.weights(i);
+		const s32 count = taps.Count[i];
+		__m128i acc = _mm_set1_epi32(WEIGHT_ROUND);
+		s32 k = 0;
+		for (; k + 2 <= count; k += 2) {
+			// [b0 g0 r0 a0 b1 g1 r1 a1] -> [b0 b1 g0 g1 r0 r1 a0 a1]
+			const __m128i p = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(s + k * 4)), zero);
+			const __m128i pair = _mm_unpacklo_epi16(p, _mm_srli_si128(p, 8));
+			acc = _mm_add_epi32(acc, _mm_madd_epi16(pair, weightPair(w[k], w[k + 1])));
+		}
+		if (k < count) {
+			s32 pixel;
+			memcpy(&pixel, s + k * 4, 4);
+			const __m128i p = _mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), zero);
+			acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi16(p, zero), weightPair(w[k], 0)));
+		}
+		const s32 out = _mm_cvtsi128_si32(roundAndPack(acc, acc));
+		memcpy(dst + i * 4, &out, 4);
+	}
+}
+
+TARGET_SSE2 void filterColumnsSSE2(const u8 *const *rows, const s16 *w, s32 count, u8 *dst, u32 bytes)
+{
+	const __m128i zero = _mm_setzero_si128();
+	u32 i = 0;
+	for (; i + 8 <= bytes; i += 8) {
+		__m128i lo = _mm_set1_epi32(WEIGHT_ROUND);
+		__m128i hi = lo;
+		s32 k = 0;
+		for (; k + 2 <= count; k += 2) {
+			const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(rows[k] + i)), zero);
+			const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(rows[k + 1] + i)), zero);
+			const __m128i wk = weightPair(w[k], w[k + 1]);
+			lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), wk));
+			hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), wk));
+		}
+		if (k < count) {
+			const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(rows[k] + i)), zero);
+			const __m128i wk = weightPair(w[k], 0);
+			lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), wk));
+			hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), wk));
+		}
+		_mm_storel_epi64((__m128i *)(dst + i), roundAndPack(lo, hi));
+	}
+	filterColumns(rows, w, count, dst, bytes, i);
+}
+
+#undef TARGET_SSE2
+
+#endif
+
+struct SResampleJob
+{
+	const u8 *Src;
+	ECOLOR_FORMAT SrcFormat;
+	core::dimension2du SrcSize;
+	u32 SrcPitch;
+
+	u8 *Dst;
+	ECOLOR_FORMAT DstFormat;
+	core::dimension2du DstSize;
+	u32 DstPitch;
+
+	SFilterTaps HTaps, VTaps;
+	std::vector<u32> SrcOffsets; //!< byte offsets of the nearest source pixels
+	bool UseSSE2 = false;
+
+	void nearestBand(u32 y0, u32 y1) const;
+	void filterBand(u32 y0, u32 y1) const;
+};
+
+void SResampleJob::nearestBand(u32 y0, u32 y1) const
+{
+	const u32 bpp = IImage::getBitsPerPixelFromFormat(SrcFormat) / 8;
+	const f64 scaleY = (f64)SrcSize.Height / DstSize.Height;
+	const bool convert = SrcFormat != DstFormat;
+	std::vector<u8> row(convert ? DstSize.Width * bpp : 0);
+
+	for (u32 y = y0; y < y1; ++y) {
+		const u32 sy = core::min_((u32)((y + 0.5) * scaleY), SrcSize.Height - 1);
+		const u8 *src = Src + (size_t)sy * SrcPitch;
+		u8 *target = Dst + (size_t)y * DstPitch;
+		u8 *out = convert ? row.data() : target;
+
+		switch (bpp) {
+		case 2:
+			for (u32 x = 0; x < DstSize.Width; ++x)
+				memcpy(out + x * 2, src + SrcOffsets[x], 2);
+			break;
+		case 4:
+			for (u32 x = 0; x < DstSize.Width; ++x)
+				memcpy(out + x * 4, src + SrcOffsets[x], 4);
+			break;
+		default:
+			for (u32 x = 0; x < DstSize.Width; ++x)
+				memcpy(out + x * bpp, src + SrcOffsets[x], bpp);
+			break;
+		}
+
+		if (convert)
+			CColorConverter::convert_viaFormat(out, SrcFormat, DstSize.Width, target, DstFormat);
+	}
+}
+
+void SResampleJob::filterBand(u32 y0, u32 y1) const
+{
+	// horizontally filter all source rows this band needs
+	const s32 srcFirst = VTaps.First[y0];
+	s32 srcEnd = srcFirst;
+	for (u32 y = y0; y < y1; ++y)
+		srcEnd = core::max_(srcEnd, VTaps.First[y] + VTaps.Count[y]);
+
+	const u32 rowBytes = DstSize.Width * 4;
+	std::vector<u8> horizontal((size_t)(srcEnd - srcFirst) * rowBytes);
+	std::vector<u8> expanded(SrcFormat != ECF_A8R8G8B8 ? SrcSize.Width * 4 : 0);
+
+	for (s32 sy = srcFirst; sy < srcEnd; ++sy) {
+		const u8 *row = Src + (size_t)sy * SrcPitch;
+		if (!expanded.empty()) {
+			CColorConverter::convert_viaFormat(row, SrcFormat, SrcSize.Width, expanded.data(), ECF_A8R8G8B8);
+			row = expanded.data();
+		}
+		u8 *out = &horizontal[(size_t)(sy - srcFirst) * rowBytes];
+#if defined(IRR_ARCH_X86)
+		if (UseSSE2) {
+			filterRowSSE2(row, out, HTaps, DstSize.Width);
+			continue;
+		}
+#endif
+		filterRow(row, out, HTaps, DstSize.Width);
+	}
+
+	// then vertically into the target rows
+	std::vector<const u8 *> rows(VTaps.MaxTaps);
+	std::vector<u8> packed(DstFormat != ECF_A8R8G8B8 ? rowBytes : 0);
+
+	for (u32 y = y0; y < y1; ++y) {
+		const s32 count = VTaps.Count[y];
+		for (s32 k = 0; k < count; ++k)
+			rows[k] = &horizontal[(size_t)(VTaps.First[y] + k - srcFirst) * rowBytes];
+
+		u8 *target = Dst + (size_t)y * DstPitch;
+		u8 *out = packed.empty() ? target : packed.data();
+#if defined(IRR_ARCH_X86)
+		if (UseSSE2)
+			filterColumnsSSE2(rows.data(), VTaps.weights(y), count, out, rowBytes);
+		else
+#endif
+			filterColumns(rows.data(), VTaps.weights(y), count, out, rowBytes);
+
+		if (!packed.empty())
+			CColorConverter::convert_viaFormat(out, ECF_A8R8G8B8, DstSize.Width, target, DstFormat);
+	}
+}
+
+//! Splits the target rows into bands and runs them on up to threads threads
+template <typename F>
+void runBands(const core::dimension2du &size, u32 threads, F band)
+{
+	if (threads == 0)
+		threads = core::max_(std::thread::hardware_concurrency(), 1U);
+	const u32 bands = core::min_(threads, size.Height,
+			core::max_(size.Width * size.Height / MIN_PIXELS_PER_THREAD, 1U));
+
+	std::vector<std::thread> workers;
+	u32 runHere = bands; // first band that could not be given to a thread
+	for (u32 i = 1; i < bands; ++i) {
+		try {
+			workers.emplace_back(band, size.Height * i / bands, size.Height * (i + 1) / bands);
+		} catch (const std::system_error &) {
+			runHere = i;
+			break;
+		}
+	}
+	band(0, size.Height / bands);
+	for (u32 i = runHere; i < bands; ++i)
+		band(size.Height * i / bands, size.Height * (i + 1) / bands);
+	for (auto &worker : workers)
+		worker.join();
+}
+
+} // end anonymous namespace
+
+bool CImageResampler::resample(const void *src, ECOLOR_FORMAT srcFormat, const core::dimension2du &srcSize, u32 srcPitch,
+		void *dst, ECOLOR_FORMAT dstFormat, const core::dimension2du &dstSize, u32 dstPitch,
+		E_IMAGE_RESAMPLE_FILTER filter, u32 threads)
+{
+	if (!src || !dst || srcSize.getArea() == 0 || dstSize.getArea() == 0)
+		return false;
+	if (IImage::isCompressedFormat(srcFormat) || IImage::isCompressedFormat(dstFormat))
+		return false;
+
+	SResampleJob job;
+	job.Src = (const u8 *)src;
+	job.SrcFormat = srcFormat;
+	job.SrcSize = srcSize;
+	job.SrcPitch = srcPitch ? srcPitch : IImage::getDataSizeFromFormat(srcFormat, srcSize.Width, 1);
+	job.Dst = (u8 *)dst;
+	job.DstFormat = dstFormat;
+	job.DstSize = dstSize;
+	job.DstPitch = dstPitch ? dstPitch : IImage::getDataSizeFromFormat(dstFormat, dstSize.Width, 1);
+
+	if (filter == EIRF_NEAREST) {
+		// any format can be copied as it is
+		const u32 bpp = IImage::getBitsPerPixelFromFormat(srcFormat) / 8;
+		if (bpp == 0 || (srcFormat != dstFormat && !CColorConverter::canConvertFormat(srcFormat, dstFormat)))
+			return false;
+
+		const f64 scaleX = (f64)srcSize.Width / dstSize.Width;
+		job.SrcOffsets.resize(dstSize.Width);
+		for (u32 x = 0; x < dstSize.Width; ++x)
+			job.SrcOffsets[x] = core::min_((u32)((x + 0.5) * scaleX), srcSize.Width - 1) * bpp;
+
+		runBands(dstSize, threads, [&job](u32 y0, u32 y1) {
+			job.nearestBand(y0, y1);
+		});
+		return true;
+	}
+
+	if (!CColorConverter::canConvertFormat(srcFormat, ECF_A8R8G8B8) ||
+			!CColorConverter::canConvertFormat(ECF_A8R8G8B8, dstFormat))
+		return false;
+
+	SFilterDesc desc;
+	switch (filter) {
+	case EIRF_BILINEAR:
+		desc = {1.0, triangleWeight};
+		break;
+	case EIRF_BOX:
+		desc = {0.5, boxWeight};
+		break;
+	case EIRF_LANCZOS3:
+		desc = {3.0, lanczos3Weight};
+		break;
+	default:
+		return false;
+	}
+	computeTaps(job.HTaps, srcSize.Width, dstSize.Width, desc);
+	computeTaps(job.VTaps, srcSize.Height, dstSize.Height, desc);
+	job.UseSSE2 = os::CPU::hasSSE2();
+
+	runBands(dstSize, threads, [&job](u32 y0, u32 y1) {
+		job.filterBand(y0, y1);
+	});
+	return true;
+}
+
+} // end namespace video
+} // end namespace irr
@@ -0,0 +1,30 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Separable image resampler working on whole scanlines.
+/** Filtered resampling works on 8 bit per channel rows: A8R8G8B8 images are
+used as they are, the other formats supported by CColorConverter::convert_viaFormat
+are expanded row by row. Nearest neighbour copies pixels in the source format.
+Destination rows are split into bands that are processed by separate threads. */
+class CImageResampler
+{
+public:
+	//! Resamples the source pixels into the target buffer.
+	/** \param threads Maximum number of threads, 0 for one per CPU core.
+	\return False if the formats are not supported by the filter. */
+	static bool resample(const void *src, ECOLOR_FORMAT srcFormat, const core::dimension2du &srcSize, u32 srcPitch,
+			void *dst, ECOLOR_FORMAT dstFormat, const core::dimension2du &dstSize, u32 dstPitch,
+			E_IMAGE_RESAMPLE_FILTER filter, u32 threads = 0);
+};
+
+} // end namespace video
+} // end namespace irr
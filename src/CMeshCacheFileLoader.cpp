@@ -0,0 +1,467 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMeshCacheFileLoader.h"
+#include "SMeshCacheStructs.h"
+#include "CMeshBuffer.h"
+#include "IMemoryReadFile.h"
+#include "IReadFile.h"
+#include "IVideoDriver.h"
+#include "SMesh.h"
+#include "coreutil.h"
+#include "os.h"
+
+#include <algorithm>
+#include <memory>
+
+#if defined(_IRR_WINDOWS_API_)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif (defined(_IRR_POSIX_API_) || defined(_IRR_OSX_PLATFORM_) || defined(_IRR_ANDROID_PLATFORM_))
+#define IRR_MESH_CACHE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+using namespace meshcache;
+
+namespace
+{
+
+//! The rest of a read file, mapped into memory where possible
+/** Memory files are used in place, files on disk are mapped, anything
+else (e.g. files in archives) is read into a buffer. */
+class CFileMapping
+{
+public:
+	CFileMapping(io::IReadFile *file)
+	{
+		const long offset = file->getPos();
+		if (offset < 0 || file->getSize() < offset)
+			return;
+		Size = file->getSize() - offset;
+
+		if (file->getType() == io::ERFT_MEMORY_READ_FILE) {
+			Data = static_cast<const u8 *>(static_cast<io::IMemoryReadFile *>(file)->getBuffer()) + offset;
+			return;
+		}
+		if (file->getType() == io::ERFT_READ_FILE && map(file->getFileName(), file->getSize()) && Mapping) {
+			Data = static_cast<const u8 *>(Mapping) + offset;
+			return;
+		}
+
+		Copy.reset(new u8[Size]);
+		if (file->read(Copy.get(), Size) == Size)
+			Data = Copy.get();
+	}
+
+	~CFileMapping()
+	{
+		if (!Mapping)
+			return;
+#if defined(_IRR_WINDOWS_API_)
+		UnmapViewOfFile(Mapping);
+#elif defined(IRR_MESH_CACHE_MMAP)
+		munmap(Mapping, MappingSize);
+#endif
+	}
+
+	const u8 *getData() const { return Data; }
+	size_t getSize() const { return Size; }
+
+private:
+	//! Maps the whole file, if it still has the expected size
+	bool map(const io::path &filename, long expectedSize)
+	{
+#if defined(_IRR_WINDOWS_API_)
+#if defined(_IRR_WCHAR_FILESYSTEM)
+		HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER size;
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &size) && size.QuadPart == expectedSize && expectedSize > 0)
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping)
+			return false;
+		// the view keeps the mapping alive
+		Mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		MappingSize = expectedSize;
+		return Mapping != nullptr;
+#elif defined(IRR_MESH_CACHE_MMAP)
+		const int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat info;
+		void *mapping = MAP_FAILED;
+		if (fstat(fd, &info) == 0 && info.st_size == expectedSize && expectedSize > 0)
+			mapping = mmap(nullptr, expectedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (mapping == MAP_FAILED)
+			return false;
+		Mapping = mapping;
+		MappingSize = expectedSize;
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	const u8 *Data = nullptr;
+	size_t Size = 0;
+	void *Mapping = nullptr;
+	size_t MappingSize = 0;
+	std::unique_ptr<u8[]> Copy;
+};
+
+core::aabbox3df readBox(SInput &in)
+{
+	const core::vector3df minEdge = in.get<core::vector3df>();
+	return core::aabbox3df(minEdge, in.get<core::vector3df>());
+}
+
+void readMaterial(SInput &in, video::SMaterial &material, video::IVideoDriver *driver)
+{
+	std::string name;
+	for (u32 i = 0; i < video::MATERIAL_MAX_TEXTURES; ++i) {
+		video::SMaterialLayer &layer = material.TextureLayers[i];
+		if (in.getString(name) && !name.empty() && driver)
+			layer.Texture = driver->getTexture(io::path(name.c_str()));
+		layer.TextureWrapU = in.get<u8>();
+		layer.TextureWrapV = in.get<u8>();
+		layer.TextureWrapW = in.get<u8>();
+		layer.MinFilter = (video::E_TEXTURE_MIN_FILTER)in.get<u8>();
+		layer.MagFilter = (video::E_TEXTURE_MAG_FILTER)in.get<u8>();
+		layer.AnisotropicFilter = in.get<u8>();
+		layer.LODBias = in.get<s8>();
+		if (in.get<u8>())
+			material.setTextureMatrix(i, in.getMatrix());
+	}
+
+	material.MaterialType = (video::E_MATERIAL_TYPE)in.get<s32>();
+	material.ColorParam = in.get<video::SColor>();
+	material.MaterialTypeParam = in.get<f32>();
+	material.Thickness = in.get<f32>();
+	material.BlendFactor = in.get<f32>();
+	material.PolygonOffsetDepthBias = in.get<f32>();
+	material.PolygonOffsetSlopeScale = in.get<f32>();
+	material.ZBuffer = (video::E_COMPARISON_FUNC)in.get<u8>();
+	material.AntiAliasing = (video::E_ANTI_ALIASING_MODE)in.get<u8>();
+	material.ColorMask = (video::E_COLOR_PLANE)in.get<u8>();
+	material.BlendOperation = (video::E_BLEND_OPERATION)in.get<u8>();
+	material.ZWriteEnable = (video::E_ZWRITE)in.get<u8>();
+	const u8 flags = in.get<u8>();
+	material.Wireframe = flags & 1;
+	material.PointCloud = flags & 2;
+	material.BackfaceCulling = flags & 4;
+	material.FrontfaceCulling = flags & 8;
+	material.FogEnable = flags & 16;
+	material.UseMipMaps = flags & 32;
+}
+
+template <class T>
+void readChannel(SInput &in, SkinnedMesh::Channel<T> &channel)
+{
+	channel.interpolate = in.get<u8>();
+	in.getArray(channel.frames);
+}
+
+template <class TIndex>
+bool readIndices(SInput &in, CIndexBuffer<TIndex> *indices, size_t vertexCount)
+{
+	auto &data = indices->Data;
+	if (!in.getArray(data))
+		return false;
+	// the only check of the contents, drivers trust the indices
+	return std::all_of(data.begin(), data.end(), [&](TIndex index) {
+		return index < vertexCount;
+	});
+}
+
+template <class T>
+bool readVertices(SInput &in, CVertexBuffer<T> *vertices, IIndexBuffer *indices)
+{
+	if (!in.getArray(vertices->Data))
+		return false;
+	if (indices->getType() == video::EIT_32BIT)
+		return readIndices(in, static_cast<SIndexBuffer32 *>(indices), vertices->Data.size());
+	return readIndices(in, static_cast<SIndexBuffer *>(indices), vertices->Data.size());
+}
+
+bool readWeights(SInput &in, IVertexBuffer *vertices, irr_ptr<WeightBuffer> &weights)
+{
+	if (!in.get<u8>())
+		return true;
+	weights.reset(new WeightBuffer(0));
+	if (!in.getArray(weights->weights) || weights->getCount() != vertices->getCount())
+		return false;
+	if (in.get<u8>()) {
+		weights->animated_vertices.emplace();
+		if (!in.getArray(*weights->animated_vertices))
+			return false;
+		for (u32 id : *weights->animated_vertices) {
+			if (id >= vertices->getCount())
+				return false;
+		}
+	}
+	return !in.Failed;
+}
+
+} // end anonymous namespace
+
+//! Constructor
+CMeshCacheFileLoader::CMeshCacheFileLoader(scene::ISceneManager *smgr) :
+		SceneManager(smgr)
+{
+}
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CMeshCacheFileLoader::isALoadableFileExtension(const io::path &filename) const
+{
+	return core::hasFileExtension(filename, "meshcache");
+}
+
+IAnimatedMesh *CMeshCacheFileLoader::createMesh(io::IReadFile *file)
+{
+	if (!file)
+		return nullptr;
+
+	CFileMapping mapping(file);
+	if (!mapping.getData())
+		return nullptr;
+
+	SInput in(mapping.getData(), mapping.getSize());
+	c8 magic[sizeof(MAGIC)];
+	if (!in.getBytes(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+		os::Printer::log("Mesh cache: not a mesh cache file", file->getFileName(), ELL_ERROR);
+		return nullptr;
+	}
+
+	// caches of other versions and builds are outdated, not broken
+	bool current = in.get<u32>() == VERSION && in.get<u32>() == BYTE_ORDER_MARK &&
+			in.get<u32>() == std::size(LAYOUT_SIZES);
+	u16 sizes[std::size(LAYOUT_SIZES)];
+	current = current && in.getBytes(sizes, sizeof(sizes)) &&
+			memcmp(sizes, LAYOUT_SIZES, sizeof(sizes)) == 0;
+	if (!current) {
+		os::Printer::log("Mesh cache: file was written by a different version", file->getFileName(), ELL_WARNING);
+		return nullptr;
+	}
+
+	IAnimatedMesh *mesh = readMesh(in);
+	if (!mesh)
+		os::Printer::log("Mesh cache: file is damaged", file->getFileName(), ELL_ERROR);
+	return mesh;
+}
+
+IAnimatedMesh *CMeshCacheFileLoader::readMesh(SInput &in)
+{
+	const u8 kind = in.get<u8>();
+	if (kind != EMK_STATIC && kind != EMK_SKINNED)
+		return nullptr;
+
+	if (kind == EMK_STATIC) {
+		SMesh *mesh = new SMesh();
+		const u32 bufferCount = in.get<u32>();
+		for (u32 i = 0; i < bufferCount && !in.Failed; ++i) {
+			IMeshBuffer *buffer = readMeshBuffer(in, false);
+			if (!buffer)
+				break;
+			mesh->addMeshBuffer(buffer);
+			buffer->drop();
+			mesh->TextureSlots.back() = in.get<u32>();
+		}
+		mesh->BoundingBox = readBox(in);
+		if (in.Failed || mesh->getMeshBufferCount() != bufferCount) {
+			mesh->drop();
+			return nullptr;
+		}
+		return mesh;
+	}
+
+	const u8 format = in.get<u8>();
+	if (format > (u8)SkinnedMesh::SourceFormat::OTHER)
+		return nullptr;
+	SkinnedMesh *mesh = new SkinnedMesh((SkinnedMesh::SourceFormat)format);
+	const u32 bufferCount = in.get<u32>();
+	for (u32 i = 0; i < bufferCount && !in.Failed; ++i) {
+		auto *buffer = static_cast<SSkinMeshBuffer *>(readMeshBuffer(in, true));
+		if (!buffer)
+			break;
+		mesh->LocalBuffers.push_back(buffer);
+		buffer->Transformation = in.getMatrix();
+		mesh->TextureSlots.push_back(in.get<u32>());
+	}
+	mesh->StaticPoseBox = readBox(in);
+	if (in.Failed || mesh->LocalBuffers.size() != bufferCount || !readSkinningData(in, mesh)) {
+		mesh->drop();
+		return nullptr;
+	}
+	return mesh;
+}
+
+IMeshBuffer *CMeshCacheFileLoader::readMeshBuffer(SInput &in, bool skinned)
+{
+	video::SMaterial material;
+	readMaterial(in, material, SceneManager->getVideoDriver());
+	const auto vertexType = (video::E_VERTEX_TYPE)in.get<u8>();
+	const auto primitiveType = (E_PRIMITIVE_TYPE)in.get<u8>();
+	const auto vertexHint = (E_HARDWARE_MAPPING)in.get<u8>();
+	const auto indexHint = (E_HARDWARE_MAPPING)in.get<u8>();
+	const auto indexType = (video::E_INDEX_TYPE)in.get<u8>();
+	const core::aabbox3df box = readBox(in);
+	if (in.Failed || vertexType > video::EVT_TANGENTS || indexType > video::EIT_32BIT)
+		return nullptr;
+	const bool indices32 = indexType == video::EIT_32BIT;
+
+	// the vertices and indices are copied out of the file as a whole
+	IMeshBuffer *buffer;
+	if (skinned) {
+		SSkinMeshBuffer *buf = new SSkinMeshBuffer(vertexType);
+		buf->Material = material;
+		buf->PrimitiveType = primitiveType;
+		buf->BoundingBox = box;
+		buf->BoundingBoxNeedsRecalculated = false;
+		buf->IndexType = indexType;
+		buffer = buf;
+	} else {
+		switch (vertexType) {
+		case video::EVT_STANDARD:
+			buffer = indices32 ? (IMeshBuffer *)new SMeshBuffer32() : new SMeshBuffer();
+			break;
+		case video::EVT_2TCOORDS:
+			buffer = indices32 ? (IMeshBuffer *)new SMeshBufferLightMap32() : new SMeshBufferLightMap();
+			break;
+		default:
+			buffer = indices32 ? (IMeshBuffer *)new SMeshBufferTangents32() : new SMeshBufferTangents();
+			break;
+		}
+		buffer->getMaterial() = material;
+		buffer->setPrimitiveType(primitiveType);
+		buffer->setBoundingBox(box);
+	}
+
+	IVertexBuffer *vertices = buffer->getVertexBuffer();
+	bool ok;
+	switch (vertexType) {
+	case video::EVT_STANDARD:
+		ok = readVertices(in, static_cast<SVertexBuffer *>(vertices), buffer->getIndexBuffer());
+		break;
+	case video::EVT_2TCOORDS:
+		ok = readVertices(in, static_cast<SVertexBufferLightMap *>(vertices), buffer->getIndexBuffer());
+		break;
+	default:
+		ok = readVertices(in, static_cast<SVertexBufferTangents *>(vertices), buffer->getIndexBuffer());
+		break;
+	}
+
+	irr_ptr<WeightBuffer> weights;
+	ok = ok && readWeights(in, vertices, weights);
+	if (ok && weights) {
+		switch (vertexType) {
+		case video::EVT_STANDARD:
+			static_cast<SVertexBuffer *>(vertices)->Weights = std::move(weights);
+			break;
+		case video::EVT_2TCOORDS:
+			static_cast<SVertexBufferLightMap *>(vertices)->Weights = std::move(weights);
+			break;
+		default:
+			static_cast<SVertexBufferTangents *>(vertices)->Weights = std::move(weights);
+			break;
+		}
+	}
+
+	if (!ok) {
+		buffer->drop();
+		return nullptr;
+	}
+	buffer->setHardwareMappingHint(vertexHint, EBT_VERTEX);
+	buffer->setHardwareMappingHint(indexHint, EBT_INDEX);
+	return buffer;
+}
+
+bool CMeshCacheFileLoader::readSkinningData(SInput &in, SkinnedMesh *mesh)
+{
+	const u32 jointCount = in.get<u32>();
+	if (in.Failed || jointCount > 0xffff)
+		return false;
+	for (u32 i = 0; i < jointCount && !in.Failed; ++i) {
+		auto *joint = new SkinnedMesh::SJoint();
+		mesh->AllJoints.push_back(joint);
+		joint->JointID = i;
+
+		if (in.get<u8>()) {
+			joint->Name.emplace();
+			in.getString(*joint->Name);
+		}
+
+		if (in.get<u8>()) {
+			joint->transform = in.getMatrix();
+		} else {
+			core::Transform trs;
+			trs.translation = in.get<core::vector3df>();
+			trs.rotation = in.get<core::quaternion>();
+			trs.scale = in.get<core::vector3df>();
+			joint->transform = trs;
+		}
+
+		in.getArray(joint->AttachedMeshes);
+		readChannel(in, joint->keys.position);
+		readChannel(in, joint->keys.rotation);
+		readChannel(in, joint->keys.scale);
+		joint->LocalBoundingBox = readBox(in);
+		joint->GlobalMatrix = in.getMatrix();
+		if (in.get<u8>())
+			joint->GlobalInversedMatrix = in.getMatrix();
+		const bool hasParent = in.get<u8>();
+		const u16 parent = in.get<u16>();
+		// joints are stored topologically sorted
+		if (hasParent) {
+			if (parent >= i)
+				return false;
+			joint->ParentJointID = parent;
+		}
+		for (u32 id : joint->AttachedMeshes) {
+			if (id >= mesh->LocalBuffers.size())
+				return false;
+		}
+	}
+
+	// weights referring to missing joints would be read out of bounds when skinning
+	for (auto *buffer : mesh->LocalBuffers) {
+		if (const auto *weights = buffer->getWeights()) {
+			for (const auto &vertex : weights->weights) {
+				for (u16 id : vertex.joint_ids) {
+					if (id >= jointCount)
+						return false;
+				}
+			}
+			if (!weights->animated_vertices)
+				return false;
+		}
+	}
+
+	mesh->StaticPartsBox = readBox(in);
+	mesh->EndFrame = in.get<f32>();
+	mesh->FramesPerSecond = in.get<f32>();
+	const u8 flags = in.get<u8>();
+	mesh->HasAnimation = flags & 1;
+	mesh->HasWeights = flags & 2;
+	mesh->PreparedForSkinning = flags & 4;
+	return !in.Failed;
+}
+
+} // end namespace scene
+} // end namespace irr
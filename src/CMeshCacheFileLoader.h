@@ -0,0 +1,54 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IMeshLoader.h"
+#include "ISceneManager.h"
+#include "SkinnedMesh.h"
+
+namespace irr
+{
+namespace video
+{
+class IVideoDriver;
+}
+
+namespace scene
+{
+
+class IMeshBuffer;
+namespace meshcache
+{
+struct SInput;
+}
+
+//! Meshloader for the binary cache format written by CMeshCacheWriter
+/** Files are mapped into memory where possible. The loaded meshes are
+complete, skinned meshes do not need SkinnedMeshBuilder::finalize(). */
+class CMeshCacheFileLoader : public IMeshLoader
+{
+public:
+	//! Constructor
+	CMeshCacheFileLoader(scene::ISceneManager *smgr);
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".meshcache")
+	bool isALoadableFileExtension(const io::path &filename) const override;
+
+	//! creates/loads an animated mesh from the file.
+	//! \return Pointer to the created mesh. Returns 0 if loading failed.
+	//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+	//! See IReferenceCounted::drop() for more information.
+	IAnimatedMesh *createMesh(io::IReadFile *file) override;
+
+private:
+	IAnimatedMesh *readMesh(meshcache::SInput &in);
+	IMeshBuffer *readMeshBuffer(meshcache::SInput &in, bool skinned);
+	bool readSkinningData(meshcache::SInput &in, SkinnedMesh *mesh);
+
+	scene::ISceneManager *SceneManager;
+};
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,212 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMeshCacheWriter.h"
+#include "SMeshCacheStructs.h"
+#include "IMeshBuffer.h"
+#include "IWriteFile.h"
+#include "ITexture.h"
+#include "SkinnedMesh.h"
+#include "coreutil.h"
+#include "os.h"
+
+#include <cstddef>
+
+namespace irr
+{
+namespace scene
+{
+
+using namespace meshcache;
+
+static void writeBox(SOutput &out, const core::aabbox3df &box)
+{
+	out.put(box.MinEdge);
+	out.put(box.MaxEdge);
+}
+
+static void writeMaterial(SOutput &out, const video::SMaterial &material)
+{
+	for (u32 i = 0; i < video::MATERIAL_MAX_TEXTURES; ++i) {
+		const video::SMaterialLayer &layer = material.TextureLayers[i];
+		// textures are looked up by name again when loading
+		if (layer.Texture) {
+			const io::path &name = layer.Texture->getName().getPath();
+			out.putString(name.c_str(), name.size());
+		} else {
+			out.putString("", 0);
+		}
+		out.put<u8>(layer.TextureWrapU);
+		out.put<u8>(layer.TextureWrapV);
+		out.put<u8>(layer.TextureWrapW);
+		out.put<u8>(layer.MinFilter);
+		out.put<u8>(layer.MagFilter);
+		out.put<u8>(layer.AnisotropicFilter);
+		out.put<s8>(layer.LODBias);
+		const core::matrix4 &matrix = material.getTextureMatrix(i);
+		out.put<u8>(!matrix.isIdentity());
+		if (!matrix.isIdentity())
+			out.putMatrix(matrix);
+	}
+
+	out.put<s32>(material.MaterialType);
+	out.put(material.ColorParam);
+	out.put(material.MaterialTypeParam);
+	out.put(material.Thickness);
+	out.put(material.BlendFactor);
+	out.put(material.PolygonOffsetDepthBias);
+	out.put(material.PolygonOffsetSlopeScale);
+	out.put<u8>(material.ZBuffer);
+	out.put<u8>(material.AntiAliasing);
+	out.put<u8>(material.ColorMask);
+	out.put<u8>(material.BlendOperation);
+	out.put<u8>(material.ZWriteEnable);
+	out.put<u8>(material.Wireframe | material.PointCloud << 1 |
+			material.BackfaceCulling << 2 | material.FrontfaceCulling << 3 |
+			material.FogEnable << 4 | material.UseMipMaps << 5);
+}
+
+template <class T>
+static void writeChannel(SOutput &out, const SkinnedMesh::Channel<T> &channel)
+{
+	out.put<u8>(channel.interpolate);
+	out.putArray(channel.frames);
+}
+
+EMESH_WRITER_TYPE CMeshCacheWriter::getType() const
+{
+	return EMWT_MESH_CACHE;
+}
+
+bool CMeshCacheWriter::isAWriteableFileExtension(const io::path &filename) const
+{
+	return core::hasFileExtension(filename, "meshcache");
+}
+
+bool CMeshCacheWriter::writeMesh(io::IWriteFile *file, IMesh *mesh, s32 flags)
+{
+	if (!file || !mesh)
+		return false;
+
+	const auto *skinned = dynamic_cast<const SkinnedMesh *>(mesh);
+
+	SOutput out;
+	out.putBytes(MAGIC, sizeof(MAGIC));
+	out.put(VERSION);
+	out.put(BYTE_ORDER_MARK);
+	out.put<u32>(std::size(LAYOUT_SIZES));
+	out.putBytes(LAYOUT_SIZES, sizeof(LAYOUT_SIZES));
+
+	out.put<u8>(skinned ? EMK_SKINNED : EMK_STATIC);
+	if (skinned)
+		out.put<u8>((u8)skinned->getSourceFormat());
+
+	out.put<u32>(mesh->getMeshBufferCount());
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i) {
+		const IMeshBuffer *buffer = mesh->getMeshBuffer(i);
+		if (!writeMeshBuffer(out, buffer)) {
+			os::Printer::log("Mesh cache: unsupported mesh buffer", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+		if (skinned)
+			out.putMatrix(static_cast<const SSkinMeshBuffer *>(buffer)->Transformation);
+		out.put<u32>(mesh->getTextureSlot(i));
+	}
+	writeBox(out, mesh->getBoundingBox());
+
+	if (skinned)
+		writeSkinningData(out, skinned);
+
+	return file->write(out.Data.data(), out.Data.size()) == out.Data.size();
+}
+
+bool CMeshCacheWriter::writeMeshBuffer(SOutput &out, const IMeshBuffer *buffer)
+{
+	const IVertexBuffer *vertices = buffer->getVertexBuffer();
+	const IIndexBuffer *indices = buffer->getIndexBuffer();
+	const video::E_VERTEX_TYPE vertexType = vertices->getType();
+	if (vertexType != video::EVT_STANDARD && vertexType != video::EVT_2TCOORDS &&
+			vertexType != video::EVT_TANGENTS)
+		return false;
+
+	// Vertices skinned in software may hold an animated pose. They are
+	// written in their static pose, with the mapping hint set by
+	// SkinnedMeshBuilder::finalize(), the loader switches to software
+	// skinning again if needed.
+	const WeightBuffer *weights = vertices->getWeightBuffer();
+	const bool staticPose = weights && weights->static_pose;
+
+	writeMaterial(out, buffer->getMaterial());
+	out.put<u8>(vertexType);
+	out.put<u8>(buffer->getPrimitiveType());
+	out.put<u8>(staticPose ? EHM_STATIC : vertices->MappingHint);
+	out.put<u8>(indices->MappingHint);
+	out.put<u8>(indices->getType());
+	writeBox(out, buffer->getBoundingBox());
+
+	const u32 vertexSize = vertices->getElementSize();
+	out.put<u32>(vertices->getCount());
+	const size_t start = out.Data.size();
+	out.putBytes(vertices->getData(), vertices->getCount() * vertexSize);
+	if (staticPose) {
+		// all vertex types start with the members of S3DVertex
+		for (size_t i = 0; i < weights->animated_vertices->size(); ++i) {
+			u8 *vertex = &out.Data[start + (*weights->animated_vertices)[i] * vertexSize];
+			memcpy(vertex + offsetof(video::S3DVertex, Pos), &weights->static_pose[i].pos, sizeof(core::vector3df));
+			memcpy(vertex + offsetof(video::S3DVertex, Normal), &weights->static_pose[i].normal, sizeof(core::vector3df));
+		}
+	}
+	out.put<u32>(indices->getCount());
+	out.putBytes(indices->getData(), indices->getCount() * indices->getElementSize());
+
+	// the weights are stored normalized, as WeightBuffer::finalize() leaves them
+	out.put<u8>(weights != nullptr);
+	if (weights) {
+		out.putArray(weights->weights);
+		out.put<u8>(weights->animated_vertices.has_value());
+		if (weights->animated_vertices)
+			out.putArray(*weights->animated_vertices);
+	}
+	return true;
+}
+
+void CMeshCacheWriter::writeSkinningData(SOutput &out, const SkinnedMesh *mesh)
+{
+	out.put<u32>(mesh->AllJoints.size());
+	for (const SkinnedMesh::SJoint *joint : mesh->AllJoints) {
+		out.put<u8>(joint->Name.has_value());
+		if (joint->Name)
+			out.putString(joint->Name->c_str(), joint->Name->size());
+
+		if (const auto *matrix = std::get_if<core::matrix4>(&joint->transform)) {
+			out.put<u8>(1);
+			out.putMatrix(*matrix);
+		} else {
+			const auto &trs = std::get<core::Transform>(joint->transform);
+			out.put<u8>(0);
+			out.put(trs.translation);
+			out.put(trs.rotation);
+			out.put(trs.scale);
+		}
+
+		out.putArray(joint->AttachedMeshes);
+		writeChannel(out, joint->keys.position);
+		writeChannel(out, joint->keys.rotation);
+		writeChannel(out, joint->keys.scale);
+		writeBox(out, joint->LocalBoundingBox);
+		out.putMatrix(joint->GlobalMatrix);
+		out.put<u8>(joint->GlobalInversedMatrix.has_value());
+		if (joint->GlobalInversedMatrix)
+			out.putMatrix(*joint->GlobalInversedMatrix);
+		out.put<u8>(joint->ParentJointID.has_value());
+		out.put<u16>(joint->ParentJointID.value_or(0));
+	}
+
+	writeBox(out, mesh->StaticPartsBox);
+	out.put(mesh->EndFrame);
+	out.put(mesh->FramesPerSecond);
+	out.put<u8>(mesh->HasAnimation | mesh->HasWeights << 1 | mesh->PreparedForSkinning << 2);
+}
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,36 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IMeshWriter.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class IMeshBuffer;
+class SkinnedMesh;
+namespace meshcache
+{
+struct SOutput;
+}
+
+//! Writes meshes to the binary cache format read by CMeshCacheFileLoader
+class CMeshCacheWriter : public IMeshWriter
+{
+public:
+	EMESH_WRITER_TYPE getType() const override;
+
+	bool isAWriteableFileExtension(const io::path &filename) const override;
+
+	bool writeMesh(io::IWriteFile *file, IMesh *mesh, s32 flags = 0) override;
+
+private:
+	static bool writeMeshBuffer(meshcache::SOutput &out, const IMeshBuffer *buffer);
+	static void writeSkinningData(meshcache::SOutput &out, const SkinnedMesh *mesh);
+};
+
+} // end namespace scene
+} // end namespace irr
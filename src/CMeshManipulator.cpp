@@ -3,84 +3,22 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CMeshManipulator.h"
+#include "CMeshNormals.h"
+#include "CMeshOptimizer.h"
 #include "SkinnedMesh.h"
 #include "SMesh.h"
 #include "CMeshBuffer.h"
 #include "os.h"
 
 #include <cassert>
+#include <cstring>
+#include <vector>
 
 namespace irr
 {
 namespace scene
 {
 
-static inline core::vector3df getAngleWeight(const core::vector3df &v1,
-		const core::vector3df &v2,
-		const core::vector3df &v3)
-{
-	// Calculate this triangle's weight for each of its three vertices
-	// start by calculating the lengths of its sides
-	const f32 a = v2.getDistanceFromSQ(v3);
-	const f32 asqrt = sqrtf(a);
-	const f32 b = v1.getDistanceFromSQ(v3);
-	const f32 bsqrt = sqrtf(b);
-	const f32 c = v1.getDistanceFromSQ(v2);
-	const f32 csqrt = sqrtf(c);
-
-	// use them to find the angle at each vertex
-	return core::vector3df(
-			acosf((b + c - a) / (2.f * bsqrt * csqrt)),
-			acosf((-b + c + a) / (2.f * asqrt * csqrt)),
-			acosf((b - c + a) / (2.f * bsqrt * asqrt)));
-}
-
-namespace
-{
-template <typename T>
-void recalculateNormalsT(IMeshBuffer *buffer, bool smooth, bool angleWeighted)
-{
-	const u32 vtxcnt = buffer->getVertexCount();
-	const u32 idxcnt = buffer->getIndexCount();
-	const T *idx = reinterpret_cast<T *>(buffer->getIndices());
-
-	if (!smooth) {
-		for (u32 i = 0; i < idxcnt; i += 3) {
-			const core::vector3df &v1 = buffer->getPosition(idx[i + 0]);
-			const core::vector3df &v2 = buffer->getPosition(idx[i + 1]);
-			const core::vector3df &v3 = buffer->getPosition(idx[i + 2]);
-			const core::vector3df normal = core::plane3d<f32>(v1, v2, v3).Normal;
-			buffer->getNormal(idx[i + 0]) = normal;
-			buffer->getNormal(idx[i + 1]) = normal;
-			buffer->getNormal(idx[i + 2]) = normal;
-		}
-	} else {
-		u32 i;
-
-		for (i = 0; i != vtxcnt; ++i)
-			buffer->getNormal(i).set(0.f, 0.f, 0.f);
-
-		for (i = 0; i < idxcnt; i += 3) {
-			const core::vector3df &v1 = buffer->getPosition(idx[i + 0]);
-			const core::vector3df &v2 = buffer->getPosition(idx[i + 1]);
-			const core::vector3df &v3 = buffer->getPosition(idx[i + 2]);
-			const core::vector3df normal = core::plane3d<f32>(v1, v2, v3).Normal;
-
-			core::vector3df weight(1.f, 1.f, 1.f);
-			if (angleWeighted)
-				weight = getAngleWeight(v1, v2, v3);
-
-			buffer->getNormal(idx[i + 0]) += weight.X * normal;
-			buffer->getNormal(idx[i + 1]) += weight.Y * normal;
-			buffer->getNormal(idx[i + 2]) += weight.Z * normal;
-		}
-
-		for (i = 0; i != vtxcnt; ++i)
-			buffer->getNormal(i).normalize();
-	}
-}
-}
-
 //! Recalculates all normals of the mesh buffer.
 /** \param buffer: Mesh buffer on which the operation is performed. */
 void CMeshManipulator::recalculateNormals(IMeshBuffer *buffer, bool smooth, bool angleWeighted) const
@@ -88,10 +26,7 @@ void CMeshManipulator::recalculateNormals(IMeshBuffer *buffer, bool smooth, bool
 	if (!buffer)
 		return;
 
-	if (buffer->getIndexType() == video::EIT_16BIT)
-		recalculateNormalsT<u16>(buffer, smooth, angleWeighted);
-	else
-		recalculateNormalsT<u32>(buffer, smooth, angleWeighted);
+	CMeshNormals::recalculateNormals(buffer, smooth, angleWeighted);
 }
 
 //! Recalculates all normals of the mesh.
@@ -116,6 +51,28 @@ void CMeshManipulator::recalculateNormals(scene::IMesh *mesh, bool smooth, bool
 	}
 }
 
+//! Recalculates tangents and binormals of a mesh buffer with tangent vertices.
+void CMeshManipulator::recalculateTangents(IMeshBuffer *buffer, bool recalculateNormals, bool angleWeighted) const
+{
+	if (!buffer || buffer->getVertexType() != video::EVT_TANGENTS)
+		return;
+
+	if (recalculateNormals)
+		CMeshNormals::recalculateNormals(buffer, true, angleWeighted);
+	CMeshNormals::recalculateTangents(buffer);
+}
+
+//! Recalculates tangents and binormals of all mesh buffers with tangent vertices.
+void CMeshManipulator::recalculateTangents(IMesh *mesh, bool recalculateNormals, bool angleWeighted) const
+{
+	if (!mesh)
+		return;
+
+	const u32 bcount = mesh->getMeshBufferCount();
+	for (u32 b = 0; b < bcount; ++b)
+		recalculateTangents(mesh->getMeshBuffer(b), recalculateNormals, angleWeighted);
+}
+
 template <typename T>
 void copyVertices(const scene::IVertexBuffer *src, scene::CVertexBuffer<T> *dst)
 {
@@ -124,15 +81,33 @@ void copyVertices(const scene::IVertexBuffer *src, scene::CVertexBuffer<T> *dst)
 	dst->Data.assign(data, data + src->getCount());
 }
 
-static void copyIndices(const scene::IIndexBuffer *src, scene::SIndexBuffer *dst)
+template <typename T>
+static void copyIndices(const scene::IIndexBuffer *src, scene::CIndexBuffer<T> *dst)
 {
-	assert(src->getType() == video::EIT_16BIT);
-	auto *data = static_cast<const u16*>(src->getData());
+	assert(dst->getType() == src->getType());
+	auto *data = static_cast<const T*>(src->getData());
 	dst->Data.assign(data, data + src->getCount());
 }
 
+template <typename T, typename TIndex>
+static IMeshBuffer *copyMeshBuffer(const IMeshBuffer *mb)
+{
+	auto *buffer = new CMeshBuffer<T, TIndex>();
+	buffer->Material = mb->getMaterial();
+	copyVertices(mb->getVertexBuffer(), buffer->Vertices);
+	copyIndices(mb->getIndexBuffer(), buffer->Indices);
+	return buffer;
+}
+
+template <typename T>
+static IMeshBuffer *copyMeshBuffer(const IMeshBuffer *mb)
+{
+	if (mb->getIndexType() == video::EIT_32BIT)
+		return copyMeshBuffer<T, u32>(mb);
+	return copyMeshBuffer<T, u16>(mb);
+}
+
 //! Clones a static IMesh into a modifyable SMesh.
-// not yet 32bit
 SMesh *CMeshManipulator::createMeshCopy(scene::IMesh *mesh) const
 {
 	if (!mesh)
@@ -144,32 +119,22 @@ SMesh *CMeshManipulator::createMeshCopy(scene::IMesh *mesh) const
 
 	for (u32 b = 0; b < meshBufferCount; ++b) {
 		const IMeshBuffer *const mb = mesh->getMeshBuffer(b);
+		IMeshBuffer *buffer = 0;
 		switch (mb->getVertexType()) {
-		case video::EVT_STANDARD: {
-			SMeshBuffer *buffer = new SMeshBuffer();
-			buffer->Material = mb->getMaterial();
-			copyVertices(mb->getVertexBuffer(), buffer->Vertices);
-			copyIndices(mb->getIndexBuffer(), buffer->Indices);
-			clone->addMeshBuffer(buffer);
-			buffer->drop();
-		} break;
-		case video::EVT_2TCOORDS: {
-			SMeshBufferLightMap *buffer = new SMeshBufferLightMap();
-			buffer->Material = mb->getMaterial();
-			copyVertices(mb->getVertexBuffer(), buffer->Vertices);
-			copyIndices(mb->getIndexBuffer(), buffer->Indices);
-			clone->addMeshBuffer(buffer);
-			buffer->drop();
-		} break;
-		case video::EVT_TANGENTS: {
-			SMeshBufferTangents *buffer = new SMeshBufferTangents();
-			buffer->Material = mb->getMaterial();
-			copyVertices(mb->getVertexBuffer(), buffer->Vertices);
-			copyIndices(mb->getIndexBuffer(), buffer->Indices);
+		case video::EVT_STANDARD:
+			buffer = copyMeshBuffer<video::S3DVertex>(mb);
+			break;
+		case video::EVT_2TCOORDS:
+			buffer = copyMeshBuffer<video::S3DVertex2TCoords>(mb);
+			break;
+		case video::EVT_TANGENTS:
+			buffer = copyMeshBuffer<video::S3DVertexTangents>(mb);
+			break;
+		} // end switch
+		if (buffer) {
 			clone->addMeshBuffer(buffer);
 			buffer->drop();
-		} break;
-		} // end switch
+		}
 
 	} // end for all mesh buffers
 
@@ -177,5 +142,341 @@ SMesh *CMeshManipulator::createMeshCopy(scene::IMesh *mesh) const
 	return clone;
 }
 
+//! Copies the indices of a triangle list, false if the buffer is none or has invalid indices
+static bool getTriangleIndices(const IMeshBuffer *buffer, std::vector<u32> &indices)
+{
+	if (!buffer || buffer->getPrimitiveType() != EPT_TRIANGLES || buffer->getIndexCount() < 3)
+		return false;
+
+	const IIndexBuffer *ib = buffer->getIndexBuffer();
+	if (ib->getType() == video::EIT_16BIT) {
+		const u16 *data = static_cast<const u16 *>(ib->getData());
+		indices.assign(data, data + ib->getCount());
+	} else {
+		const u32 *data = static_cast<const u32 *>(ib->getData());
+		indices.assign(data, data + ib->getCount());
+	}
+
+	const u32 vertexCount = buffer->getVertexCount();
+	for (u32 index : indices) {
+		if (index >= vertexCount)
+			return false;
+	}
+	return true;
+}
+
+//! Replaces the indices, the engine's index buffers are all CIndexBuffer
+static void setTriangleIndices(IMeshBuffer *buffer, const std::vector<u32> &indices)
+{
+	IIndexBuffer *ib = buffer->getIndexBuffer();
+	if (ib->getType() == video::EIT_16BIT) {
+		auto &data = static_cast<CIndexBuffer<u16> *>(ib)->Data;
+		data.resize(indices.size());
+		std::copy(indices.begin(), indices.end(), data.begin());
+	} else {
+		auto &data = static_cast<CIndexBuffer<u32> *>(ib)->Data;
+		data.resize(indices.size());
+		std::copy(indices.begin(), indices.end(), data.begin());
+	}
+	buffer->setDirty(EBT_INDEX);
+}
+
+//! Reorders the triangles of a mesh buffer for the vertex cache of the GPU.
+void CMeshManipulator::optimizeVertexCache(IMeshBuffer *buffer) const
+{
+	std::vector<u32> indices;
+	if (!getTriangleIndices(buffer, indices))
+		return;
+
+	CMeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), buffer->getVertexCount());
+	setTriangleIndices(buffer, indices);
+}
+
+//! Reorders clusters of triangles of a mesh buffer to reduce overdraw.
+void CMeshManipulator::optimizeOverdraw(IMeshBuffer *buffer, f32 threshold) const
+{
+	std::vector<u32> indices;
+	if (!getTriangleIndices(buffer, indices))
+		return;
+
+	const u32 vertexCount = buffer->getVertexCount();
+	std::vector<core::vector3df> positions(vertexCount);
+	for (u32 i = 0; i < vertexCount; ++i)
+		positions[i] = buffer->getPosition(i);
+
+	CMeshOptimizer::optimizeOverdraw(indices.data(), indices.size(), positions.data(), vertexCount, 16, threshold);
+	setTriangleIndices(buffer, indices);
+}
+
+//! Reorders the vertices of a mesh buffer in the order they are first used.
+void CMeshManipulator::optimizeVertexFetch(IMeshBuffer *buffer) const
+{
+	std::vector<u32> indices;
+	if (!getTriangleIndices(buffer, indices))
+		return;
+
+	const u32 vertexCount = buffer->getVertexCount();
+	std::vector<u32> remap;
+	CMeshOptimizer::createFetchRemap(indices.data(), indices.size(), vertexCount, remap);
+
+	u32 vertexSize = 0;
+	switch (buffer->getVertexType()) {
+	case video::EVT_STANDARD:
+		vertexSize = sizeof(video::S3DVertex);
+		break;
+	case video::EVT_2TCOORDS:
+		vertexSize = sizeof(video::S3DVertex2TCoords);
+		break;
+	case video::EVT_TANGENTS:
+		vertexSize = sizeof(video::S3DVertexTangents);
+		break;
+	}
+	u8 *vertices = static_cast<u8 *>(buffer->getVertices());
+	std::vector<u8> reordered(vertexCount * vertexSize);
+	for (u32 v = 0; v < vertexCount; ++v)
+		memcpy(&reordered[remap[v] * vertexSize], vertices + v * vertexSize, vertexSize);
+	memcpy(vertices, reordered.data(), reordered.size());
+
+	for (u32 &index : indices)
+		index = remap[index];
+	setTriangleIndices(buffer, indices);
+	buffer->setDirty(EBT_VERTEX);
+}
+
+//! Reduces the triangles of a mesh buffer, keeping its vertices as they are.
+f32 CMeshManipulator::simplifyMeshBuffer(IMeshBuffer *buffer, f32 ratio) const
+{
+	std::vector<u32> indices;
+	if (!getTriangleIndices(buffer, indices))
+		return 0.f;
+
+	const u32 vertexCount = buffer->getVertexCount();
+	std::vector<core::vector3df> positions(vertexCount);
+	core::aabbox3df box(buffer->getPosition(0));
+	for (u32 i = 0; i < vertexCount; ++i) {
+		positions[i] = buffer->getPosition(i);
+		box.addInternalPoint(positions[i]);
+	}
+
+	const u32 target = (u32)(indices.size() / 3 * core::clamp(ratio, 0.f, 1.f)) * 3;
+	f32 error = 0.f;
+	indices.resize(CMeshOptimizer::simplify(indices.data(), indices.size(), positions.data(), vertexCount, target, &error));
+	setTriangleIndices(buffer, indices);
+
+	const f32 size = box.getExtent().getLength();
+	return size > 0.f ? error / size : 0.f;
+}
+
+template <typename T>
+static void compactVertices(IMeshBuffer *buffer)
+{
+	std::vector<u32> indices;
+	if (!getTriangleIndices(buffer, indices))
+		return;
+
+	auto &vertices = static_cast<CVertexBuffer<T> *>(buffer->getVertexBuffer())->Data;
+	std::vector<u32> remap;
+	CMeshOptimizer::createFetchRemap(indices.data(), indices.size(), vertices.size(), remap);
+
+	u32 used = 0;
+	std::vector<T> compacted(vertices.size());
+	for (u32 v = 0; v < vertices.size(); ++v)
+		compacted[remap[v]] = vertices[v];
+	for (u32 &index : indices) {
+		index = remap[index];
+		used = core::max_(used, index + 1);
+	}
+	compacted.resize(used);
+	vertices.swap(compacted);
+	setTriangleIndices(buffer, indices);
+	buffer->setDirty(EBT_VERTEX);
+}
+
+//! Creates a copy of a mesh with fewer triangles.
+SMesh *CMeshManipulator::createSimplifiedMesh(IMesh *mesh, f32 ratio, f32 *error) const
+{
+	SMesh *clone = createMeshCopy(mesh);
+	if (!clone)
+		return 0;
+
+	f32 maxError = 0.f;
+	for (u32 b = 0; b < clone->getMeshBufferCount(); ++b) {
+		IMeshBuffer *buffer = clone->getMeshBuffer(b);
+		maxError = core::max_(maxError, simplifyMeshBuffer(buffer, ratio));
+		switch (buffer->getVertexType()) {
+		case video::EVT_STANDARD:
+			compactVertices<video::S3DVertex>(buffer);
+			break;
+		case video::EVT_2TCOORDS:
+			compactVertices<video::S3DVertex2TCoords>(buffer);
+			break;
+		case video::EVT_TANGENTS:
+			compactVertices<video::S3DVertexTangents>(buffer);
+			break;
+		}
+	}
+	if (error)
+		*error = maxError;
+	return clone;
+}
+
+//! Whether a mesh buffer may be merged with others by mergeMeshBuffers()
+static bool isMergeable(const IMeshBuffer *buffer)
+{
+	// skinned buffers are referenced by index from the joints
+	return buffer->getPrimitiveType() == EPT_TRIANGLES && buffer->getIndexCount() > 0 &&
+			!buffer->getVertexBuffer()->getWeightBuffer();
+}
+
+template <typename T>
+static IMeshBuffer *mergeMeshBuffersT(const std::vector<IMeshBuffer *> &group)
+{
+	size_t vertexCount = 0, indexCount = 0;
+	for (const IMeshBuffer *mb : group) {
+		vertexCount += mb->getVertexCount();
+		indexCount += mb->getIndexCount();
+	}
+
+	std::vector<T> vertices;
+	std::vector<u32> indices;
+	vertices.reserve(vertexCount);
+	indices.reserve(indexCount);
+	for (const IMeshBuffer *mb : group) {
+		const u32 offset = vertices.size();
+		auto *data = static_cast<const T *>(mb->getVertices());
+		vertices.insert(vertices.end(), data, data + mb->getVertexCount());
+		const IIndexBuffer *ib = mb->getIndexBuffer();
+		for (u32 i = 0; i < ib->getCount(); ++i)
+			indices.push_back(ib->getIndex(i) + offset);
+	}
+
+	IMeshBuffer *buffer = createMeshBuffer(std::move(vertices), std::move(indices));
+	buffer->getMaterial() = group[0]->getMaterial();
+	buffer->setHardwareMappingHint(group[0]->getVertexBuffer()->MappingHint, EBT_VERTEX);
+	buffer->setHardwareMappingHint(group[0]->getIndexBuffer()->MappingHint, EBT_INDEX);
+	buffer->recalculateBoundingBox();
+	return buffer;
+}
+
+//! Merges mesh buffers which can be drawn together to reduce draw calls.
+u32 CMeshManipulator::mergeMeshBuffers(SMesh *mesh, bool allow32BitIndices, bool ignoreTextureSlots) const
+{
+	if (!mesh)
+		return 0;
+
+	const u64 maxVertices = allow32BitIndices ? 0xFFFFFFFFu : 65536;
+
+	struct SGroup
+	{
+		std::vector<IMeshBuffer *> Buffers;
+		u32 TextureSlot;
+		u64 VertexCount;
+	};
+
+	// every buffer joins the first compatible group, so the order of
+	// first occurrence is kept
+	std::vector<SGroup> groups;
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i) {
+		IMeshBuffer *mb = mesh->MeshBuffers[i];
+		const u32 slot = mesh->TextureSlots[i];
+		size_t g = groups.size();
+		if (isMergeable(mb)) {
+			for (g = 0; g < groups.size(); ++g) {
+				const SGroup &group = groups[g];
+				const IMeshBuffer *first = group.Buffers[0];
+				if ((ignoreTextureSlots || group.TextureSlot == slot) && isMergeable(first) &&
+						first->getVertexType() == mb->getVertexType() &&
+						group.VertexCount + mb->getVertexCount() <= maxVertices &&
+						first->getMaterial() == mb->getMaterial())
+					break;
+			}
+		}
+		if (g == groups.size())
+			groups.push_back({{}, slot, 0});
+		groups[g].Buffers.push_back(mb);
+		groups[g].VertexCount += mb->getVertexCount();
+	}
+
+	const u32 removed = mesh->getMeshBufferCount() - groups.size();
+	if (removed == 0)
+		return 0;
+
+	std::vector<IMeshBuffer *> buffers;
+	std::vector<u32> slots;
+	for (const SGroup &group : groups) {
+		IMeshBuffer *buffer = group.Buffers[0];
+		if (group.Buffers.size() == 1) {
+			buffer->grab();
+		} else {
+			switch (buffer->getVertexType()) {
+			case video::EVT_STANDARD:
+				buffer = mergeMeshBuffersT<video::S3DVertex>(group.Buffers);
+				break;
+			case video::EVT_2TCOORDS:
+				buffer = mergeMeshBuffersT<video::S3DVertex2TCoords>(group.Buffers);
+				break;
+			case video::EVT_TANGENTS:
+				buffer = mergeMeshBuffersT<video::S3DVertexTangents>(group.Buffers);
+				break;
+			}
+		}
+		buffers.push_back(buffer);
+		slots.push_back(group.TextureSlot);
+	}
+
+	for (IMeshBuffer *buffer : mesh->MeshBuffers)
+		buffer->drop();
+	mesh->MeshBuffers = std::move(buffers);
+	mesh->TextureSlots = std::move(slots);
+	return removed;
+}
+
+//! Simulates a FIFO post transform vertex cache on a mesh buffer.
+SVertexCacheStatistics CMeshManipulator::analyzeVertexCache(const IMeshBuffer *buffer, u32 cacheSize) const
+{
+	std::vector<u32> indices;
+	if (!getTriangleIndices(buffer, indices))
+		return SVertexCacheStatistics();
+
+	return CMeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), buffer->getVertexCount(), cacheSize);
+}
+
+//! Splits the triangles of a mesh buffer into small clusters which can be culled on their own.
+u32 CMeshManipulator::buildClusters(IMeshBuffer *buffer, std::vector<SMeshCluster> &clusters,
+		u32 maxVertices, u32 maxTriangles) const
+{
+	clusters.clear();
+	std::vector<u32> indices;
+	if (!getTriangleIndices(buffer, indices))
+		return 0;
+
+	const u32 vertexCount = buffer->getVertexCount();
+	std::vector<core::vector3df> positions(vertexCount);
+	for (u32 i = 0; i < vertexCount; ++i)
+		positions[i] = buffer->getPosition(i);
+
+	CMeshOptimizer::buildClusters(indices.data(), indices.size(), positions.data(), vertexCount,
+			maxVertices, maxTriangles, clusters);
+	setTriangleIndices(buffer, indices);
+	return clusters.size();
+}
+
+//! Creates a compact copy of the vertices of a mesh buffer for drawing.
+bool CMeshManipulator::quantizeVertices(IMeshBuffer *buffer) const
+{
+	if (!buffer || buffer->getVertexType() != video::EVT_STANDARD)
+		return false;
+
+	// skinning works on the positions as they are
+	auto *vertices = static_cast<SVertexBuffer *>(buffer->getVertexBuffer());
+	if (vertices->Weights)
+		return false;
+
+	if (!vertices->Quantized)
+		vertices->Quantized.reset(new QuantizedVertexBuffer());
+	vertices->Quantized->encode(vertices);
+	return true;
+}
+
 } // end namespace scene
 } // end namespace irr
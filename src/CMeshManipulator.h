@@ -29,8 +29,43 @@ public:
 	\param smooth: Whether to use smoothed normals. */
 	void recalculateNormals(IMeshBuffer *buffer, bool smooth = false, bool angleWeighted = false) const override;
 
+	//! Recalculates tangents and binormals of all mesh buffers with tangent vertices.
+	void recalculateTangents(IMesh *mesh, bool recalculateNormals = false, bool angleWeighted = false) const override;
+
+	//! Recalculates tangents and binormals of a mesh buffer with tangent vertices.
+	void recalculateTangents(IMeshBuffer *buffer, bool recalculateNormals = false, bool angleWeighted = false) const override;
+
 	//! Clones a static IMesh into a modifiable SMesh.
 	SMesh *createMeshCopy(scene::IMesh *mesh) const override;
+
+	//! Merges mesh buffers which can be drawn together to reduce draw calls.
+	u32 mergeMeshBuffers(SMesh *mesh, bool allow32BitIndices, bool ignoreTextureSlots = false) const override;
+
+	//! Reorders the triangles of a mesh buffer for the vertex cache of the GPU.
+	void optimizeVertexCache(IMeshBuffer *buffer) const override;
+
+	//! Reorders clusters of triangles of a mesh buffer to reduce overdraw.
+	void optimizeOverdraw(IMeshBuffer *buffer, f32 threshold = 1.05f) const override;
+
+	//! Reorders the vertices of a mesh buffer in the order they are first used.
+	void optimizeVertexFetch(IMeshBuffer *buffer) const override;
+
+	//! Reduces the triangles of a mesh buffer, keeping its vertices as they are.
+	f32 simplifyMeshBuffer(IMeshBuffer *buffer, f32 ratio) const override;
+
+	//! Creates a copy of a mesh with fewer triangles.
+	SMesh *createSimplifiedMesh(IMesh *mesh, f32 ratio, f32 *error = 0) const override;
+
+	//! Simulates a FIFO post transform vertex cache on a mesh buffer.
+	SVertexCacheStatistics analyzeVertexCache(const IMeshBuffer *buffer, u32 cacheSize = 16) const override;
+
+	//! Splits the triangles of a mesh buffer into small clusters which can be culled on their own.
+	u32 buildClusters(IMeshBuffer *buffer, std::vector<SMeshCluster> &clusters,
+			u32 maxVertices = 64, u32 maxTriangles = 124) const override;
+
+	//! Creates a compact copy of the vertices of a mesh buffer for drawing.
+	bool quantizeVertices(IMeshBuffer *buffer) const override;
+	using IMeshManipulator::quantizeVertices;
 };
 
 } // end namespace scene
@@ -0,0 +1,267 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMeshNormals.h"
+#include "IIndexBuffer.h"
+#include "IVertexBuffer.h"
+#include "plane3d.h"
+
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+//! Less work than this is not split between threads
+const u32 MIN_TRIANGLES_PER_THREAD = 16384;
+const u32 MIN_VERTICES_PER_THREAD = 16384;
+
+//! Splits [0, count) into ranges and runs them on the available threads
+template <typename F>
+void parallelFor(u32 count, u32 minPerThread, F range)
+{
+	const u32 chunks = core::min_(core::max_(std::thread::hardware_concurrency(), 1U),
+			core::max_(count / minPerThread, 1U));
+
+	std::vector<std::thread> workers;
+	u32 runHere = chunks; // first chunk that could not be given to a thread
+	for (u32 i = 1; i < chunks; ++i) {
+		try {
+			workers.emplace_back(range, (u32)((u64)count * i / chunks), (u32)((u64)count * (i + 1) / chunks));
+		} catch (const std::system_error &) {
+			runHere = i;
+			break;
+		}
+	}
+	range(0, count / chunks);
+	for (u32 i = runHere; i < chunks; ++i)
+		range((u32)((u64)count * i / chunks), (u32)((u64)count * (i + 1) / chunks));
+	for (auto &worker : workers)
+		worker.join();
+}
+
+//! Triangle corners using each vertex, in triangle order
+struct SVertexCorners
+{
+	//! Corners of vertex i are Corners[Offsets[i]] to Corners[Offsets[i + 1]]
+	std::vector<u32> Offsets;
+	//! triangle * 3 + corner
+	std::vector<u32> Corners;
+};
+
+template <typename TIndex>
+void buildVertexCorners(const TIndex *indices, u32 triangleCount, u32 vertexCount, SVertexCorners &out)
+{
+	out.Offsets.assign(vertexCount + 1, 0);
+	for (u32 i = 0; i < triangleCount * 3; ++i)
+		++out.Offsets[indices[i] + 1];
+	for (u32 i = 0; i < vertexCount; ++i)
+		out.Offsets[i + 1] += out.Offsets[i];
+
+	out.Corners.resize(triangleCount * 3);
+	std::vector<u32> next(out.Offsets.begin(), out.Offsets.end() - 1);
+	for (u32 i = 0; i < triangleCount * 3; ++i)
+		out.Corners[next[indices[i]]++] = i;
+}
+
+inline core::vector3df getAngleWeight(const core::vector3df &v1,
+		const core::vector3df &v2,
+		const core::vector3df &v3)
+{
+	// Calculate this triangle's weight for each of its three vertices
+	// start by calculating the lengths of its sides
+	const f32 a = v2.getDistanceFromSQ(v3);
+	const f32 asqrt = sqrtf(a);
+	const f32 b = v1.getDistanceFromSQ(v3);
+	const f32 bsqrt = sqrtf(b);
+	const f32 c = v1.getDistanceFromSQ(v2);
+	const f32 csqrt = sqrtf(c);
+
+	// use them to find the angle at each vertex
+	return core::vector3df(
+			acosf((b + c - a) / (2.f * bsqrt * csqrt)),
+			acosf((-b + c + a) / (2.f * asqrt * csqrt)),
+			acosf((b - c + a) / (2.f * bsqrt * asqrt)));
+}
+
+template <typename TVertex, typename TIndex>
+void flatNormals(TVertex *v, const TIndex *idx, u32 triangleCount)
+{
+	// later triangles overwrite the shared vertices, so this stays serial
+	for (u32 i = 0; i < triangleCount * 3; i += 3) {
+		const core::vector3df normal = core::plane3d<f32>(v[idx[i]].Pos, v[idx[i + 1]].Pos, v[idx[i + 2]].Pos).Normal;
+		v[idx[i + 0]].Normal = normal;
+		v[idx[i + 1]].Normal = normal;
+		v[idx[i + 2]].Normal = normal;
+	}
+}
+
+template <typename TVertex, typename TIndex>
+void smoothNormals(TVertex *v, u32 vertexCount, const TIndex *idx, u32 triangleCount, bool angleWeighted)
+{
+	std::vector<core::vector3df> faceNormals(triangleCount);
+	std::vector<core::vector3df> weights(angleWeighted ? triangleCount : 0);
+	parallelFor(triangleCount, MIN_TRIANGLES_PER_THREAD, [&](u32 begin, u32 end) {
+		for (u32 t = begin; t < end; ++t) {
+			const core::vector3df &v1 = v[idx[t * 3 + 0]].Pos;
+			const core::vector3df &v2 = v[idx[t * 3 + 1]].Pos;
+			const core::vector3df &v3 = v[idx[t * 3 + 2]].Pos;
+			faceNormals[t] = core::plane3d<f32>(v1, v2, v3).Normal;
+			if (angleWeighted)
+				weights[t] = getAngleWeight(v1, v2, v3);
+		}
+	});
+
+	SVertexCorners corners;
+	buildVertexCorners(idx, triangleCount, vertexCount, corners);
+
+	parallelFor(vertexCount, MIN_VERTICES_PER_THREAD, [&](u32 begin, u32 end) {
+		for (u32 i = begin; i < end; ++i) {
+			core::vector3df normal(0.f, 0.f, 0.f);
+			for (u32 c = corners.Offsets[i]; c < corners.Offsets[i + 1]; ++c) {
+				const u32 corner = corners.Corners[c];
+				const f32 weight = angleWeighted ? weights[corner / 3][corner % 3] : 1.f;
+				normal += weight * faceNormals[corner / 3];
+			}
+			v[i].Normal = normal.normalize();
+		}
+	});
+}
+
+template <typename TVertex>
+void recalculateNormalsT(IMeshBuffer *buffer, bool smooth, bool angleWeighted)
+{
+	auto *v = static_cast<TVertex *>(buffer->getVertices());
+	const u32 vertexCount = buffer->getVertexCount();
+	const u32 triangleCount = buffer->getIndexCount() / 3;
+	const IIndexBuffer *ib = buffer->getIndexBuffer();
+
+	if (ib->getType() == video::EIT_16BIT) {
+		const u16 *idx = static_cast<const u16 *>(ib->getData());
+		if (smooth)
+			smoothNormals(v, vertexCount, idx, triangleCount, angleWeighted);
+		else
+			flatNormals(v, idx, triangleCount);
+	} else {
+		const u32 *idx = static_cast<const u32 *>(ib->getData());
+		if (smooth)
+			smoothNormals(v, vertexCount, idx, triangleCount, angleWeighted);
+		else
+			flatNormals(v, idx, triangleCount);
+	}
+}
+
+//! Tangent of a triangle along increasing U
+struct SFaceTangent
+{
+	//! Unit length, or zero if the texture coordinates are degenerate
+	core::vector3df Tangent;
+	//! Whether the texture coordinates keep the orientation of the triangle
+	bool OrientPreserving;
+};
+
+//! Projects a vector onto the plane of a unit normal
+inline core::vector3df projectOnPlane(const core::vector3df &v, const core::vector3df &normal)
+{
+	return v - normal * normal.dotProduct(v);
+}
+
+template <typename TIndex>
+void tangents(video::S3DVertexTangents *v, u32 vertexCount, const TIndex *idx, u32 triangleCount)
+{
+	std::vector<SFaceTangent> faces(triangleCount);
+	parallelFor(triangleCount, MIN_TRIANGLES_PER_THREAD, [&](u32 begin, u32 end) {
+		for (u32 t = begin; t < end; ++t) {
+			const video::S3DVertexTangents &v0 = v[idx[t * 3 + 0]];
+			const video::S3DVertexTangents &v1 = v[idx[t * 3 + 1]];
+			const video::S3DVertexTangents &v2 = v[idx[t * 3 + 2]];
+			const core::vector3df d1 = v1.Pos - v0.Pos;
+			const core::vector3df d2 = v2.Pos - v0.Pos;
+			const core::vector2df t21 = v1.TCoords - v0.TCoords;
+			const core::vector2df t31 = v2.TCoords - v0.TCoords;
+
+			const f32 signedArea = t21.X * t31.Y - t21.Y * t31.X;
+			core::vector3df tangent = d1 * t31.Y - d2 * t21.Y;
+			const f32 length = tangent.getLength();
+			if (signedArea != 0.f && length > 0.f)
+				tangent *= (signedArea > 0.f ? 1.f : -1.f) / length;
+			else
+				tangent.set(0.f, 0.f, 0.f);
+			faces[t] = {tangent, signedArea > 0.f};
+		}
+	});
+
+	SVertexCorners corners;
+	buildVertexCorners(idx, triangleCount, vertexCount, corners);
+
+	parallelFor(vertexCount, MIN_VERTICES_PER_THREAD, [&](u32 begin, u32 end) {
+		for (u32 i = begin; i < end; ++i) {
+			const core::vector3df normal = core::vector3df(v[i].Normal).normalize();
+			core::vector3df tangent(0.f, 0.f, 0.f);
+			f32 orientation = 0.f;
+			for (u32 c = corners.Offsets[i]; c < corners.Offsets[i + 1]; ++c) {
+				const u32 t = corners.Corners[c] / 3;
+				const u32 k = corners.Corners[c] % 3;
+
+				// angle of the triangle at the vertex, on the tangent plane
+				core::vector3df e1 = projectOnPlane(v[idx[t * 3 + (k + 1) % 3]].Pos - v[i].Pos, normal);
+				core::vector3df e2 = projectOnPlane(v[idx[t * 3 + (k + 2) % 3]].Pos - v[i].Pos, normal);
+				const f32 angle = acosf(core::clamp(e1.normalize().dotProduct(e2.normalize()), -1.f, 1.f));
+
+				tangent += projectOnPlane(faces[t].Tangent, normal).normalize() * angle;
+				orientation += faces[t].OrientPreserving ? angle : -angle;
+			}
+
+			if (tangent.getLengthSQ() == 0.f) {
+				// no usable texture coordinates, any direction on the plane will do
+				tangent = normal.crossProduct(fabsf(normal.Y) < 0.99f ? core::vector3df(0.f, 1.f, 0.f) : core::vector3df(1.f, 0.f, 0.f));
+			}
+			tangent.normalize();
+			v[i].Tangent = tangent;
+			v[i].Binormal = normal.crossProduct(tangent) * (orientation < 0.f ? 1.f : -1.f);
+		}
+	});
+}
+
+} // end anonymous namespace
+
+void CMeshNormals::recalculateNormals(IMeshBuffer *buffer, bool smooth, bool angleWeighted)
+{
+	switch (buffer->getVertexType()) {
+	case video::EVT_STANDARD:
+		recalculateNormalsT<video::S3DVertex>(buffer, smooth, angleWeighted);
+		break;
+	case video::EVT_2TCOORDS:
+		recalculateNormalsT<video::S3DVertex2TCoords>(buffer, smooth, angleWeighted);
+		break;
+	case video::EVT_TANGENTS:
+		recalculateNormalsT<video::S3DVertexTangents>(buffer, smooth, angleWeighted);
+		break;
+	}
+	buffer->setDirty(EBT_VERTEX);
+}
+
+void CMeshNormals::recalculateTangents(IMeshBuffer *buffer)
+{
+	if (buffer->getVertexType() != video::EVT_TANGENTS)
+		return;
+
+	auto *v = static_cast<video::S3DVertexTangents *>(buffer->getVertices());
+	const u32 vertexCount = buffer->getVertexCount();
+	const u32 triangleCount = buffer->getIndexCount() / 3;
+	const IIndexBuffer *ib = buffer->getIndexBuffer();
+	if (ib->getType() == video::EIT_16BIT)
+		tangents(v, vertexCount, static_cast<const u16 *>(ib->getData()), triangleCount);
+	else
+		tangents(v, vertexCount, static_cast<const u32 *>(ib->getData()), triangleCount);
+	buffer->setDirty(EBT_VERTEX);
+}
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,35 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IMeshBuffer.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Normal and tangent calculation working directly on the vertex arrays.
+/** Smooth normals and tangents are gathered per vertex from the triangles
+using it, in triangle order, so the result does not depend on the number
+of threads used for large buffers. */
+class CMeshNormals
+{
+public:
+	//! Recalculates the normals of a triangle list mesh buffer.
+	static void recalculateNormals(IMeshBuffer *buffer, bool smooth, bool angleWeighted);
+
+	//! Recalculates tangents and binormals of a mesh buffer with EVT_TANGENTS vertices.
+	/** Tangents follow MikkTSpace: they point along increasing U and are
+	made orthogonal to the vertex normal, the contribution of each triangle
+	is weighted by its angle at the vertex. The binormal points along
+	decreasing V, like it always did in the engine. Unlike MikkTSpace,
+	vertices are never split, so a vertex shared by triangles with mirrored
+	texture coordinates gets the handedness of the larger part.
+	Buffers of other vertex types are not changed. */
+	static void recalculateTangents(IMeshBuffer *buffer);
+};
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,710 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+// Size of the LRU cache the Forsyth scores are based on. The algorithm works
+// well for any real cache size up to this one.
+constexpr u32 SCORE_CACHE_SIZE = 32;
+// Valences above this share the same score
+constexpr u32 MAX_SCORED_VALENCE = 32;
+
+struct SScoreTables
+{
+	f32 Cache[SCORE_CACHE_SIZE];
+	f32 Valence[MAX_SCORED_VALENCE + 1];
+
+	SScoreTables()
+	{
+		for (u32 i = 0; i < SCORE_CACHE_SIZE; ++i) {
+			// the last triangle's vertices get a fixed score, so that its
+			// neighbours do not win just by sharing an edge
+			if (i < 3)
+				Cache[i] = 0.75f;
+			else
+				Cache[i] = powf(1.f - (f32)(i - 3) / (SCORE_CACHE_SIZE - 3), 1.5f);
+		}
+		// vertices with few triangles left are boosted to get rid of them
+		Valence[0] = 0.f;
+		for (u32 i = 1; i <= MAX_SCORED_VALENCE; ++i)
+			Valence[i] = 2.f / sqrtf((f32)i);
+	}
+};
+
+const SScoreTables &scoreTables()
+{
+	static const SScoreTables tables;
+	return tables;
+}
+
+inline f32 vertexScore(const SScoreTables &tables, s32 cachePos, u32 valence)
+{
+	if (valence == 0)
+		return -1.f; // no triangles left which could use it
+	f32 score = tables.Valence[core::min_(valence, MAX_SCORED_VALENCE)];
+	if (cachePos >= 0)
+		score += tables.Cache[cachePos];
+	return score;
+}
+
+//! FIFO cache simulation by timestamps, a vertex is cached if it was
+//! transformed within the last cacheSize misses
+class CFifoCache
+{
+public:
+	CFifoCache(u32 vertexCount, u32 cacheSize) :
+			Timestamps(vertexCount, 0), Time(cacheSize + 1), CacheSize(cacheSize)
+	{}
+
+	//! returns true if the vertex had to be transformed
+	bool access(u32 vertex)
+	{
+		if (Time - Timestamps[vertex] > CacheSize) {
+			Timestamps[vertex] = Time++;
+			return true;
+		}
+		return false;
+	}
+
+	//! evicts all vertices
+	void reset()
+	{
+		Time += CacheSize + 1;
+	}
+
+private:
+	std::vector<u32> Timestamps;
+	u32 Time;
+	u32 CacheSize;
+};
+
+} // end anonymous namespace
+
+void CMeshOptimizer::optimizeVertexCache(u32 *indices, u32 indexCount, u32 vertexCount)
+{
+	const u32 triCount = indexCount / 3;
+	if (triCount < 2)
+		return;
+	const SScoreTables &tables = scoreTables();
+
+	// triangles using each vertex, the emitted ones are moved behind Valence
+	std::vector<u32> adjacencyStart(vertexCount + 1, 0);
+	for (u32 i = 0; i < triCount * 3; ++i)
+		++adjacencyStart[indices[i] + 1];
+	for (u32 v = 0; v < vertexCount; ++v)
+		adjacencyStart[v + 1] += adjacencyStart[v];
+	std::vector<u32> adjacency(triCount * 3);
+	std::vector<u32> valence(vertexCount, 0);
+	for (u32 t = 0; t < triCount; ++t) {
+		for (u32 k = 0; k < 3; ++k) {
+			const u32 v = indices[t * 3 + k];
+			adjacency[adjacencyStart[v] + valence[v]++] = t;
+		}
+	}
+
+	std::vector<s32> cachePos(vertexCount, -1);
+	std::vector<f32> score(vertexCount);
+	for (u32 v = 0; v < vertexCount; ++v)
+		score[v] = vertexScore(tables, -1, valence[v]);
+
+	std::vector<f32> triScore(triCount);
+	for (u32 t = 0; t < triCount; ++t)
+		triScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+
+	std::vector<bool> emitted(triCount, false);
+	std::vector<u32> result(triCount * 3);
+	u32 cache[SCORE_CACHE_SIZE + 3];
+	u32 cacheUsed = 0;
+	u32 nextUnused = 0; // scan position when the cache has no candidates
+
+	u32 best = 0;
+	for (u32 out = 0; out < triCount; ++out) {
+		if (best == ~0U) {
+			while (emitted[nextUnused])
+				++nextUnused;
+			best = nextUnused;
+		}
+
+		const u32 *tri = indices + best * 3;
+		result[out * 3] = tri[0];
+		result[out * 3 + 1] = tri[1];
+		result[out * 3 + 2] = tri[2];
+		emitted[best] = true;
+
+		// remove the triangle from the lists of its vertices
+		for (u32 k = 0; k < 3; ++k) {
+			const u32 v = tri[k];
+			u32 *list = &adjacency[adjacencyStart[v]];
+			const u32 *end = list + valence[v];
+			u32 *pos = std::find(list, list + valence[v], best);
+			if (pos != end) {
+				std::swap(*pos, list[valence[v] - 1]);
+				--valence[v];
+			}
+		}
+
+		// move the triangle's vertices to the front of the LRU cache
+		u32 newCache[SCORE_CACHE_SIZE + 3];
+		u32 newUsed = 0;
+		for (u32 k = 0; k < 3; ++k) {
+			if (std::find(newCache, newCache + newUsed, tri[k]) == newCache + newUsed)
+				newCache[newUsed++] = tri[k];
+		}
+		for (u32 i = 0; i < cacheUsed; ++i) {
+			if (std::find(newCache, newCache + newUsed, cache[i]) == newCache + newUsed)
+				newCache[newUsed++] = cache[i];
+		}
+		// vertices falling out of the cache still need their score updated
+		for (u32 i = SCORE_CACHE_SIZE; i < newUsed; ++i)
+			cachePos[newCache[i]] = -1;
+		for (u32 i = 0; i < newUsed; ++i) {
+			const u32 v = newCache[i];
+			if (i < SCORE_CACHE_SIZE)
+				cachePos[v] = i;
+			const f32 newScore = vertexScore(tables, cachePos[v], valence[v]);
+			const f32 diff = newScore - score[v];
+			score[v] = newScore;
+			for (u32 j = 0; j < valence[v]; ++j)
+				triScore[adjacency[adjacencyStart[v] + j]] += diff;
+		}
+		cacheUsed = core::min_(newUsed, SCORE_CACHE_SIZE);
+		std::copy(newCache, newCache + cacheUsed, cache);
+
+		// the next triangle is the best one using a cached vertex
+		best = ~0U;
+		f32 bestScore = -1.f;
+		for (u32 i = 0; i < cacheUsed; ++i) {
+			const u32 v = cache[i];
+			for (u32 j = 0; j < valence[v]; ++j) {
+				const u32 t = adjacency[adjacencyStart[v] + j];
+				if (triScore[t] > bestScore) {
+					bestScore = triScore[t];
+					best = t;
+				}
+			}
+		}
+	}
+
+	std::copy(result.begin(), result.end(), indices);
+}
+
+void CMeshOptimizer::optimizeOverdraw(u32 *indices, u32 indexCount, const core::vector3df *positions,
+		u32 vertexCount, u32 cacheSize, f32 threshold)
+{
+	const u32 triCount = indexCount / 3;
+	if (triCount < 2)
+		return;
+
+	// hard boundaries, where all vertices of a triangle miss the cache
+	std::vector<u32> hard;
+	CFifoCache cache(vertexCount, cacheSize);
+	for (u32 t = 0; t < triCount; ++t) {
+		u32 misses = 0;
+		for (u32 k = 0; k < 3; ++k)
+			misses += cache.access(indices[t * 3 + k]);
+		if (misses == 3)
+			hard.push_back(t);
+	}
+	if (hard.empty() || hard[0] != 0)
+		hard.insert(hard.begin(), 0);
+	hard.push_back(triCount);
+
+	// soft boundaries, where a run has reached the ACMR of its hard cluster
+	std::vector<u32> clusters;
+	for (u32 h = 0; h + 1 < hard.size(); ++h) {
+		const u32 start = hard[h], end = hard[h + 1];
+
+		cache.reset();
+		u32 misses = 0;
+		for (u32 t = start; t < end; ++t)
+			for (u32 k = 0; k < 3; ++k)
+				misses += cache.access(indices[t * 3 + k]);
+		const f32 limit = threshold * misses / (end - start);
+
+		cache.reset();
+		clusters.push_back(start);
+		misses = 0;
+		u32 runStart = start;
+		for (u32 t = start; t < end; ++t) {
+			for (u32 k = 0; k < 3; ++k)
+				misses += cache.access(indices[t * 3 + k]);
+			if (t + 1 < end && (f32)misses / (t + 1 - runStart) <= limit) {
+				clusters.push_back(t + 1);
+				runStart = t + 1;
+				misses = 0;
+				cache.reset();
+			}
+		}
+	}
+	clusters.push_back(triCount);
+	const u32 clusterCount = clusters.size() - 1;
+	if (clusterCount < 2)
+		return;
+
+	// sort key: how far the cluster faces away from the mesh center
+	core::vector3df meshCenter;
+	for (u32 i = 0; i < triCount * 3; ++i)
+		meshCenter += positions[indices[i]];
+	meshCenter /= (f32)(triCount * 3);
+
+	std::vector<f32> key(clusterCount);
+	for (u32 c = 0; c < clusterCount; ++c) {
+		core::vector3df normal, center;
+		f32 area = 0.f;
+		for (u32 t = clusters[c]; t < clusters[c + 1]; ++t) {
+			const core::vector3df &v1 = positions[indices[t * 3]];
+			const core::vector3df &v2 = positions[indices[t * 3 + 1]];
+			const core::vector3df &v3 = positions[indices[t * 3 + 2]];
+			// same winding as recalculateNormals
+			const core::vector3df n = (v2 - v1).crossProduct(v3 - v1);
+			const f32 a = n.getLength();
+			normal += n;
+			center += (v1 + v2 + v3) * (a / 3.f);
+			area += a;
+		}
+		if (area > 0.f)
+			center /= area;
+		key[c] = (center - meshCenter).dotProduct(normal.normalize());
+	}
+
+	std::vector<u32> order(clusterCount);
+	for (u32 c = 0; c < clusterCount; ++c)
+		order[c] = c;
+	std::stable_sort(order.begin(), order.end(), [&key](u32 a, u32 b) { return key[a] > key[b]; });
+
+	std::vector<u32> result;
+	result.reserve(triCount * 3);
+	for (u32 c : order)
+		result.insert(result.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+	std::copy(result.begin(), result.end(), indices);
+}
+
+void CMeshOptimizer::createFetchRemap(const u32 *indices, u32 indexCount, u32 vertexCount, std::vector<u32> &remap)
+{
+	remap.assign(vertexCount, ~0U);
+	u32 next = 0;
+	for (u32 i = 0; i < indexCount; ++i) {
+		if (remap[indices[i]] == ~0U)
+			remap[indices[i]] = next++;
+	}
+	for (u32 v = 0; v < vertexCount; ++v) {
+		if (remap[v] == ~0U)
+			remap[v] = next++;
+	}
+}
+
+namespace
+{
+
+//! Symmetric 4x4 matrix summing squared distances to planes
+struct SQuadric
+{
+	f64 A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+	f64 B0 = 0, B1 = 0, B2 = 0;
+	f64 C = 0;
+	//! Number of planes
+	f64 W = 0;
+
+	void addPlane(const core::vector3df &n, f32 d)
+	{
+		A00 += (f64)n.X * n.X;
+		A01 += (f64)n.X * n.Y;
+		A02 += (f64)n.X * n.Z;
+		A11 += (f64)n.Y * n.Y;
+		A12 += (f64)n.Y * n.Z;
+		A22 += (f64)n.Z * n.Z;
+		B0 += (f64)n.X * d;
+		B1 += (f64)n.Y * d;
+		B2 += (f64)n.Z * d;
+		C += (f64)d * d;
+		W += 1;
+	}
+
+	void add(const SQuadric &o)
+	{
+		A00 += o.A00;
+		A01 += o.A01;
+		A02 += o.A02;
+		A11 += o.A11;
+		A12 += o.A12;
+		A22 += o.A22;
+		B0 += o.B0;
+		B1 += o.B1;
+		B2 += o.B2;
+		C += o.C;
+		W += o.W;
+	}
+
+	f64 error(const core::vector3df &p) const
+	{
+		const f64 x = p.X, y = p.Y, z = p.Z;
+		const f64 e = x * x * A00 + y * y * A11 + z * z * A22 +
+				2 * (x * y * A01 + x * z * A02 + y * z * A12) +
+				2 * (x * B0 + y * B1 + z * B2) + C;
+		return core::max_(e, 0.0);
+	}
+};
+
+inline u64 edgeKey(u32 a, u32 b)
+{
+	return ((u64)a << 32) | b;
+}
+
+} // end anonymous namespace
+
+u32 CMeshOptimizer::simplify(u32 *indices, u32 indexCount, const core::vector3df *positions, u32 vertexCount,
+		u32 targetIndexCount, f32 *error)
+{
+	indexCount -= indexCount % 3;
+	f64 maxError = 0;
+
+	// vertices at the same position are welded for the topology
+	std::vector<u32> weld(vertexCount);
+	{
+		std::vector<u32> order(vertexCount);
+		for (u32 v = 0; v < vertexCount; ++v)
+			order[v] = v;
+		std::sort(order.begin(), order.end(), [positions](u32 a, u32 b) {
+			const core::vector3df &pa = positions[a], &pb = positions[b];
+			return pa.X < pb.X || (pa.X == pb.X && (pa.Y < pb.Y || (pa.Y == pb.Y && pa.Z < pb.Z)));
+		});
+		for (u32 i = 0; i < vertexCount; ++i) {
+			const bool same = i > 0 && positions[order[i]].X == positions[order[i - 1]].X &&
+					positions[order[i]].Y == positions[order[i - 1]].Y && positions[order[i]].Z == positions[order[i - 1]].Z;
+			weld[order[i]] = same ? weld[order[i - 1]] : order[i];
+		}
+	}
+
+	// only vertices with a position of their own inside a closed surface may be removed
+	std::vector<bool> locked(vertexCount, false);
+	for (u32 v = 0; v < vertexCount; ++v) {
+		if (weld[v] != v)
+			locked[v] = locked[weld[v]] = true;
+	}
+	{
+		std::vector<u64> edges;
+		edges.reserve(indexCount);
+		for (u32 i = 0; i < indexCount; i += 3) {
+			for (u32 k = 0; k < 3; ++k)
+				edges.push_back(edgeKey(weld[indices[i + k]], weld[indices[i + (k + 1) % 3]]));
+		}
+		std::sort(edges.begin(), edges.end());
+		for (size_t i = 0; i < edges.size();) {
+			size_t end = i + 1;
+			while (end < edges.size() && edges[end] == edges[i])
+				++end;
+			const u32 a = (u32)(edges[i] >> 32), b = (u32)edges[i];
+			const u64 reverse = edgeKey(b, a);
+			const auto range = std::equal_range(edges.begin(), edges.end(), reverse);
+			if (end - i != 1 || range.second - range.first != 1)
+				locked[a] = locked[b] = true;
+			i = end;
+		}
+	}
+
+	std::vector<SQuadric> quadrics(vertexCount);
+	for (u32 i = 0; i < indexCount; i += 3) {
+		const core::vector3df &p0 = positions[indices[i]];
+		core::vector3df n = (positions[indices[i + 1]] - p0).crossProduct(positions[indices[i + 2]] - p0);
+		if (n.getLengthSQ() == 0.f)
+			continue;
+		n.normalize();
+		const f32 d = -n.dotProduct(p0);
+		for (u32 k = 0; k < 3; ++k)
+			quadrics[weld[indices[i + k]]].addPlane(n, d);
+	}
+
+	std::vector<u32> adjacencyStart(vertexCount + 1), adjacency;
+	std::vector<u32> target(vertexCount), candidates;
+	std::vector<f64> cost(vertexCount);
+	std::vector<u32> collapseTo(vertexCount);
+	std::vector<bool> touched(vertexCount);
+
+	// each pass collapses independent edges, cheapest first
+	while (indexCount > targetIndexCount) {
+		std::fill(adjacencyStart.begin(), adjacencyStart.end(), 0);
+		for (u32 i = 0; i < indexCount; ++i)
+			++adjacencyStart[indices[i] + 1];
+		for (u32 v = 0; v < vertexCount; ++v)
+			adjacencyStart[v + 1] += adjacencyStart[v];
+		adjacency.resize(indexCount);
+		{
+			std::vector<u32> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+			for (u32 i = 0; i < indexCount; ++i)
+				adjacency[fill[indices[i]]++] = i / 3;
+		}
+
+		std::fill(target.begin(), target.end(), ~0U);
+		for (u32 i = 0; i < indexCount; i += 3) {
+			for (u32 k = 0; k < 6; ++k) {
+				const u32 a = indices[i + k % 3], b = indices[i + (k + 1 + k / 3) % 3];
+				if (locked[a] || a == b)
+					continue;
+				const f64 c = quadrics[a].error(positions[b]);
+				if (target[a] == ~0U || c < cost[a]) {
+					target[a] = b;
+					cost[a] = c;
+				}
+			}
+		}
+		candidates.clear();
+		for (u32 v = 0; v < vertexCount; ++v) {
+			if (target[v] != ~0U)
+				candidates.push_back(v);
+		}
+		if (candidates.empty())
+			break;
+		std::sort(candidates.begin(), candidates.end(), [&cost](u32 a, u32 b) { return cost[a] < cost[b]; });
+
+		for (u32 v = 0; v < vertexCount; ++v)
+			collapseTo[v] = v;
+		std::fill(touched.begin(), touched.end(), false);
+
+		// collapsing a quarter of the candidates keeps the choice of edges good
+		const u32 triangleCount = indexCount / 3, targetTriangles = targetIndexCount / 3;
+		u32 removed = 0, collapses = 0;
+		const u32 maxCollapses = core::max_((u32)candidates.size() / 4, 1U);
+		for (u32 a : candidates) {
+			if (triangleCount - removed <= targetTriangles || collapses >= maxCollapses)
+				break;
+			const u32 b = target[a];
+			if (touched[a] || touched[b])
+				continue;
+
+			// reject collapses which would flip a triangle, or which would
+			// pull triangles from the other side of a seam onto b
+			bool flips = false;
+			u32 degenerate = 0;
+			for (u32 j = adjacencyStart[a]; j < adjacencyStart[a + 1] && !flips; ++j) {
+				const u32 *tri = indices + adjacency[j] * 3;
+				if (weld[tri[0]] == weld[b] || weld[tri[1]] == weld[b] || weld[tri[2]] == weld[b]) {
+					flips = (weld[tri[0]] == weld[b] && tri[0] != b) || (weld[tri[1]] == weld[b] && tri[1] != b) ||
+							(weld[tri[2]] == weld[b] && tri[2] != b);
+					++degenerate;
+					continue;
+				}
+				core::vector3df p[3], q[3];
+				for (u32 k = 0; k < 3; ++k) {
+					p[k] = positions[tri[k]];
+					q[k] = tri[k] == a ? positions[b] : p[k];
+				}
+				const core::vector3df before = (p[1] - p[0]).crossProduct(p[2] - p[0]);
+				const core::vector3df after = (q[1] - q[0]).crossProduct(q[2] - q[0]);
+				flips = before.dotProduct(after) <= 0.f;
+			}
+			if (flips)
+				continue;
+
+			collapseTo[a] = b;
+			quadrics[weld[b]].add(quadrics[a]);
+			// the mean over the planes is roughly a squared distance
+			maxError = core::max_(maxError, cost[a] / core::max_(quadrics[a].W, 1.0));
+			removed += degenerate;
+			++collapses;
+			// neighbours keep their triangles for the flip tests of this pass
+			for (u32 j = adjacencyStart[a]; j < adjacencyStart[a + 1]; ++j) {
+				const u32 *tri = indices + adjacency[j] * 3;
+				touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+			}
+		}
+		if (!collapses)
+			break;
+
+		// apply the collapses and drop the degenerated triangles
+		u32 out = 0;
+		for (u32 i = 0; i < indexCount; i += 3) {
+			const u32 a = collapseTo[indices[i]], b = collapseTo[indices[i + 1]], c = collapseTo[indices[i + 2]];
+			if (weld[a] == weld[b] || weld[a] == weld[c] || weld[b] == weld[c])
+				continue;
+			indices[out++] = a;
+			indices[out++] = b;
+			indices[out++] = c;
+		}
+		indexCount = out;
+	}
+
+	if (error)
+		*error = (f32)sqrt(maxError);
+	return indexCount;
+}
+
+SVertexCacheStatistics CMeshOptimizer::analyzeVertexCache(const u32 *indices, u32 indexCount, u32 vertexCount, u32 cacheSize)
+{
+	SVertexCacheStatistics stats;
+	const u32 triCount = indexCount / 3;
+	if (!triCount || !cacheSize)
+		return stats;
+
+	CFifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> used(vertexCount, false);
+	u32 usedCount = 0;
+	for (u32 i = 0; i < triCount * 3; ++i) {
+		stats.Transformed += cache.access(indices[i]);
+		if (!used[indices[i]]) {
+			used[indices[i]] = true;
+			++usedCount;
+		}
+	}
+	stats.ACMR = (f32)stats.Transformed / triCount;
+	stats.ATVR = (f32)stats.Transformed / usedCount;
+	return stats;
+}
+
+namespace
+{
+
+//! Bounding sphere and normal cone of the triangles of a cluster
+void setClusterBounds(SMeshCluster &cluster, const u32 *indices, const core::vector3df *positions)
+{
+	core::aabbox3df box(positions[indices[0]]);
+	for (u32 i = 1; i < cluster.IndexCount; ++i)
+		box.addInternalPoint(positions[indices[i]]);
+	cluster.Center = box.getCenter();
+	f32 radiusSQ = 0.f;
+	for (u32 i = 0; i < cluster.IndexCount; ++i)
+		radiusSQ = core::max_(radiusSQ, positions[indices[i]].getDistanceFromSQ(cluster.Center));
+	cluster.Radius = sqrtf(radiusSQ);
+
+	// same winding as recalculateNormals
+	std::vector<core::vector3df> normals;
+	core::vector3df axis(0.f, 0.f, 0.f);
+	for (u32 i = 0; i < cluster.IndexCount; i += 3) {
+		const core::vector3df &p0 = positions[indices[i]];
+		core::vector3df n = (positions[indices[i + 1]] - p0).crossProduct(positions[indices[i + 2]] - p0);
+		if (n.getLengthSQ() == 0.f)
+			continue;
+		normals.push_back(n.normalize());
+		axis += normals.back();
+	}
+	cluster.ConeAxis = axis.normalize();
+	cluster.ConeCutoff = 1.f;
+	if (normals.empty())
+		return;
+	f32 minDot = 1.f;
+	for (const core::vector3df &n : normals)
+		minDot = core::min_(minDot, n.dotProduct(cluster.ConeAxis));
+	// a cone this wide can hardly ever be culled
+	if (minDot > 0.1f)
+		cluster.ConeCutoff = sqrtf(1.f - minDot * minDot);
+}
+
+} // end anonymous namespace
+
+u32 CMeshOptimizer::buildClusters(u32 *indices, u32 indexCount, const core::vector3df *positions, u32 vertexCount,
+		u32 maxVertices, u32 maxTriangles, std::vector<SMeshCluster> &clusters)
+{
+	clusters.clear();
+	const u32 triCount = indexCount / 3;
+	maxVertices = core::max_(maxVertices, 3U);
+	maxTriangles = core::max_(maxTriangles, 1U);
+
+	// triangles of each vertex
+	std::vector<u32> adjacencyStart(vertexCount + 1, 0);
+	for (u32 i = 0; i < triCount * 3; ++i)
+		++adjacencyStart[indices[i] + 1];
+	for (u32 v = 0; v < vertexCount; ++v)
+		adjacencyStart[v + 1] += adjacencyStart[v];
+	std::vector<u32> adjacency(triCount * 3);
+	{
+		std::vector<u32> next(adjacencyStart.begin(), adjacencyStart.end() - 1);
+		for (u32 i = 0; i < triCount * 3; ++i)
+			adjacency[next[indices[i]]++] = i / 3;
+	}
+
+	std::vector<bool> used(triCount, false);
+	// cluster each vertex was last added to
+	std::vector<u32> vertexCluster(vertexCount, ~0U);
+	std::vector<u32> output;
+	output.reserve(triCount * 3);
+	std::vector<u32> clusterVertices, candidates;
+
+	u32 seed = 0;
+	while (true) {
+		while (seed < triCount && used[seed])
+			++seed;
+		if (seed == triCount)
+			break;
+
+		const u32 id = clusters.size();
+		const u32 firstIndex = output.size();
+		clusterVertices.clear();
+		candidates.clear();
+		core::vector3df sum(0.f, 0.f, 0.f);
+
+		const auto newVertices = [&](u32 t) {
+			u32 count = 0;
+			for (u32 k = 0; k < 3; ++k)
+				count += vertexCluster[indices[t * 3 + k]] != id;
+			return count;
+		};
+
+		u32 next = seed;
+		while (true) {
+			used[next] = true;
+			output.insert(output.end(), indices + next * 3, indices + next * 3 + 3);
+			for (u32 k = 0; k < 3; ++k) {
+				const u32 v = indices[next * 3 + k];
+				if (vertexCluster[v] == id)
+					continue;
+				vertexCluster[v] = id;
+				clusterVertices.push_back(v);
+				sum += positions[v];
+				for (u32 j = adjacencyStart[v]; j < adjacencyStart[v + 1]; ++j) {
+					if (!used[adjacency[j]])
+						candidates.push_back(adjacency[j]);
+				}
+			}
+			if ((output.size() - firstIndex) / 3 >= maxTriangles)
+				break;
+
+			// the neighbour adding the fewest vertices, then the closest one
+			const core::vector3df center = sum / (f32)clusterVertices.size();
+			next = ~0U;
+			u32 bestNew = 4;
+			f32 bestDistance = 0.f;
+			u32 kept = 0;
+			for (u32 t : candidates) {
+				if (used[t])
+					continue;
+				candidates[kept++] = t;
+				const u32 added = newVertices(t);
+				if (clusterVertices.size() + added > maxVertices || added > bestNew)
+					continue;
+				const core::vector3df centroid = (positions[indices[t * 3]] +
+						positions[indices[t * 3 + 1]] + positions[indices[t * 3 + 2]]) / 3.f;
+				const f32 distance = centroid.getDistanceFromSQ(center);
+				if (added < bestNew || distance < bestDistance) {
+					next = t;
+					bestNew = added;
+					bestDistance = distance;
+				}
+			}
+			candidates.resize(kept);
+			if (next == ~0U)
+				break;
+		}
+
+		SMeshCluster cluster;
+		cluster.FirstIndex = firstIndex;
+		cluster.IndexCount = output.size() - firstIndex;
+		setClusterBounds(cluster, output.data() + firstIndex, positions);
+		clusters.push_back(cluster);
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+	return clusters.size();
+}
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,61 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IMeshManipulator.h"
+#include <vector>
+
+namespace irr
+{
+namespace scene
+{
+
+//! Reordering of triangle lists for the GPU vertex cache and for overdraw.
+/** Works on plain 32 bit triangle lists, CMeshManipulator converts the
+mesh buffers. */
+class CMeshOptimizer
+{
+public:
+	//! Reorders the triangles with Tom Forsyth's linear speed vertex cache optimisation.
+	static void optimizeVertexCache(u32 *indices, u32 indexCount, u32 vertexCount);
+
+	//! Splits the triangle order into clusters and sorts them by facing.
+	/** Cuts are only made where the vertex cache would restart anyway or where the
+	cluster's ACMR stays below threshold times the ACMR of the surrounding run.
+	Clusters facing away from the mesh center are drawn first, as they are
+	likely to occlude the others. */
+	static void optimizeOverdraw(u32 *indices, u32 indexCount, const core::vector3df *positions,
+			u32 vertexCount, u32 cacheSize, f32 threshold);
+
+	//! Numbers the vertices in order of first use.
+	/** Vertices which are not referenced keep their order behind the used ones.
+	\param remap Receives the new index of every vertex. */
+	static void createFetchRemap(const u32 *indices, u32 indexCount, u32 vertexCount, std::vector<u32> &remap);
+
+	//! Removes triangles by quadric error metric edge collapses.
+	/** Each collapse moves a vertex onto a neighbour, so vertices are only
+	dropped from the triangles and never changed. Vertices sharing their
+	position with another vertex (UV seams, hard edges) and vertices on open
+	or non-manifold edges are never removed.
+	\param targetIndexCount Stop once no more than this many indices are left.
+	\param error Receives the square root of the largest collapse error,
+	roughly the largest distance of the result to the input.
+	\return The new number of indices. */
+	static u32 simplify(u32 *indices, u32 indexCount, const core::vector3df *positions, u32 vertexCount,
+			u32 targetIndexCount, f32 *error);
+
+	//! Simulates a FIFO post transform cache of the given size.
+	static SVertexCacheStatistics analyzeVertexCache(const u32 *indices, u32 indexCount, u32 vertexCount, u32 cacheSize);
+
+	//! Reorders the triangles into clusters of neighbouring triangles.
+	/** Each cluster starts at the first triangle left and grows over the
+	neighbour adding the fewest vertices, ties go to the one closest to the
+	cluster's center.
+	\return The number of clusters. */
+	static u32 buildClusters(u32 *indices, u32 indexCount, const core::vector3df *positions, u32 vertexCount,
+			u32 maxVertices, u32 maxTriangles, std::vector<SMeshCluster> &clusters);
+};
+
+} // end namespace scene
+} // end namespace irr
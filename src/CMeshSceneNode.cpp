@@ -6,6 +6,7 @@
 #include "IVideoDriver.h"
 #include "ISceneManager.h"
 #include "IMeshCache.h"
+#include "ICameraSceneNode.h"
 #include "IMeshBuffer.h"
 #include "IMaterialRenderer.h"
 #include "IFileSystem.h"
@@ -20,7 +21,7 @@ CMeshSceneNode::CMeshSceneNode(IMesh *mesh, ISceneNode *parent, ISceneManager *m
 		const core::vector3df &position, const core::vector3df &rotation,
 		const core::vector3df &scale) :
 		IMeshSceneNode(parent, mgr, id, position, rotation, scale),
-		Mesh(0),
+		Mesh(0), CurrentLODLevel(0),
 		PassCount(0), SharedMaterials(false)
 {
 	setMesh(mesh);
@@ -29,6 +30,8 @@ CMeshSceneNode::CMeshSceneNode(IMesh *mesh, ISceneNode *parent, ISceneManager *m
 //! destructor
 CMeshSceneNode::~CMeshSceneNode()
 {
+	for (IMesh *level : LODLevels)
+		level->drop();
 	if (Mesh)
 		Mesh->drop();
 }
@@ -44,6 +47,7 @@ void CMeshSceneNode::OnRegisterSceneNode()
 
 		video::IVideoDriver *driver = SceneManager->getVideoDriver();
 
+		CurrentLODLevel = selectLODLevel();
 		PassCount = 0;
 		int transparentCount = 0;
 		int solidCount = 0;
@@ -90,10 +94,13 @@ void CMeshSceneNode::render()
 	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
 	Box = Mesh->getBoundingBox();
 
-	for (u32 i = 0; i < Mesh->getMeshBufferCount(); ++i) {
-		scene::IMeshBuffer *mb = Mesh->getMeshBuffer(i);
+	// the detail levels use the materials of the mesh
+	IMesh *lod = CurrentLODLevel ? LODLevels[CurrentLODLevel - 1] : Mesh;
+	const u32 bufferCount = core::min_(lod->getMeshBufferCount(), Mesh->getMeshBufferCount());
+	for (u32 i = 0; i < bufferCount; ++i) {
+		scene::IMeshBuffer *mb = lod->getMeshBuffer(i);
 		if (mb) {
-			const auto &material = SharedMaterials ? mb->getMaterial() : Materials[i];
+			const auto &material = SharedMaterials ? Mesh->getMeshBuffer(i)->getMaterial() : Materials[i];
 
 			const bool transparent = driver->needsTransparentRenderPass(material);
 
@@ -189,6 +196,10 @@ u32 CMeshSceneNode::getMaterialCount() const
 void CMeshSceneNode::setMesh(IMesh *mesh)
 {
 	if (mesh) {
+		// the detail levels were made from the former mesh
+		if (mesh != Mesh)
+			setLODLevels({}, {});
+
 		mesh->grab();
 		if (Mesh)
 			Mesh->drop();
@@ -233,6 +244,51 @@ bool CMeshSceneNode::isSharedMaterials() const
 	return SharedMaterials;
 }
 
+//! Sets meshes with less detail, drawn when the node is small on screen.
+void CMeshSceneNode::setLODLevels(const std::vector<IMesh *> &levels, const std::vector<f32> &screenSizes)
+{
+	// levels without a mesh or without a screen size are left out
+	std::vector<IMesh *> kept;
+	std::vector<f32> keptSizes;
+	for (size_t i = 0; i < levels.size() && i < screenSizes.size(); ++i) {
+		if (!levels[i])
+			continue;
+		levels[i]->grab();
+		kept.push_back(levels[i]);
+		keptSizes.push_back(screenSizes[i]);
+	}
+	for (IMesh *level : LODLevels)
+		level->drop();
+
+	LODLevels.swap(kept);
+	LODScreenSizes.swap(keptSizes);
+	CurrentLODLevel = 0;
+}
+
+u32 CMeshSceneNode::selectLODLevel() const
+{
+	const ICameraSceneNode *camera = SceneManager->getActiveCamera();
+	if (LODLevels.empty() || !camera)
+		return 0;
+
+	const core::aabbox3df box = getTransformedBoundingBox();
+	const f32 radius = box.getExtent().getLength() * 0.5f;
+	// the projection scales y by the cotangent of half the field of view,
+	// or by 2 / view height for orthogonal cameras
+	f32 size = radius * camera->getProjectionMatrix()[5];
+	if (!camera->isOrthogonal()) {
+		const f32 distance = camera->getAbsolutePosition().getDistanceFrom(box.getCenter());
+		if (distance <= radius)
+			return 0;
+		size /= distance;
+	}
+
+	u32 level = 0;
+	while (level < LODLevels.size() && size < LODScreenSizes[level])
+		++level;
+	return level;
+}
+
 //! Creates a clone of this scene node and its children.
 ISceneNode *CMeshSceneNode::clone(ISceneNode *newParent, ISceneManager *newManager)
 {
@@ -247,6 +303,7 @@ ISceneNode *CMeshSceneNode::clone(ISceneNode *newParent, ISceneManager *newManag
 	nb->cloneMembers(this, newManager);
 	nb->SharedMaterials = SharedMaterials;
 	nb->Materials = Materials;
+	nb->setLODLevels(LODLevels, LODScreenSizes);
 
 	if (newParent)
 		nb->drop();
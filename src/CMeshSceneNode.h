@@ -63,6 +63,15 @@ public:
 	\return Whether the materials are shared. */
 	bool isSharedMaterials() const override;
 
+	//! Sets meshes with less detail, drawn when the node is small on screen.
+	void setLODLevels(const std::vector<IMesh *> &levels, const std::vector<f32> &screenSizes) override;
+
+	//! Get the number of detail levels, including the mesh itself.
+	u32 getLODLevelCount() const override { return LODLevels.size() + 1; }
+
+	//! Get the detail level selected for the last frame, 0 is the mesh itself.
+	u32 getCurrentLODLevel() const override { return CurrentLODLevel; }
+
 	//! Creates a clone of this scene node and its children.
 	ISceneNode *clone(ISceneNode *newParent = 0, ISceneManager *newManager = 0) override;
 
@@ -74,11 +83,18 @@ public:
 protected:
 	void copyMaterials();
 
+	//! Picks the detail level from the projected size of the bounding sphere
+	u32 selectLODLevel() const;
+
 	std::vector<video::SMaterial> Materials;
 	core::aabbox3d<f32> Box{{0, 0, 0}};
 
 	IMesh *Mesh;
 
+	std::vector<IMesh *> LODLevels;
+	std::vector<f32> LODScreenSizes;
+	u32 CurrentLODLevel;
+
 	s32 PassCount;
 	bool SharedMaterials;
 };
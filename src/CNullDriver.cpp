@@ -19,6 +19,7 @@
 #include "CColorConverter.h"
 #include "IReferenceCounted.h"
 #include "IRenderTarget.h"
+#include "CImageCompressor.h"
 
 #include <cassert>
 
@@ -39,6 +40,12 @@ IImageLoader *createImageLoaderTGA();
 //! creates a loader which is able to load png images
 IImageLoader *createImageLoaderPNG();
 
+//! creates a loader which is able to load dds images
+IImageLoader *createImageLoaderDDS();
+
+//! creates a loader which is able to load ktx2 images
+IImageLoader *createImageLoaderKTX();
+
 //! creates a writer which is able to save jpg images
 IImageWriter *createImageWriterJPG();
 
@@ -70,6 +77,8 @@ CNullDriver::CNullDriver(io::IFileSystem *io, const core::dimension2d<u32> &scre
 	SurfaceLoader.push_back(video::createImageLoaderPNG());
 	SurfaceLoader.push_back(video::createImageLoaderJPG());
 	SurfaceLoader.push_back(video::createImageLoaderBMP());
+	SurfaceLoader.push_back(video::createImageLoaderDDS());
+	SurfaceLoader.push_back(video::createImageLoaderKTX());
 
 	SurfaceWriter.push_back(video::createImageWriterJPG());
 	SurfaceWriter.push_back(video::createImageWriterPNG());
@@ -467,6 +476,8 @@ video::ITexture *CNullDriver::loadTextureFromFile(io::IReadFile *file, const io:
 	if (!image)
 		return nullptr;
 
+	image = prepareCompression(image, file->getFileName());
+
 	if (checkImage(image)) {
 		std::vector tmp { image };
 		texture = createDeviceDependentTexture(hashName.size() ? hashName : file->getFileName(), ETT_2D, tmp);
@@ -479,6 +490,48 @@ video::ITexture *CNullDriver::loadTextureFromFile(io::IReadFile *file, const io:
 	return texture;
 }
 
+//! compresses or decompresses a loaded image to suit the driver
+IImage *CNullDriver::prepareCompression(IImage *image, const io::path &name)
+{
+	const ECOLOR_FORMAT format = image->getColorFormat();
+	IImage *result = nullptr;
+
+	if (IImage::isCompressedFormat(format)) {
+		if (queryTextureFormat(format))
+			return image;
+		// fall back to uncompressed data where the driver lacks the format
+		if (CImageCompressor::canDecompress(format))
+			result = CImageCompressor::decompress(image);
+		if (result)
+			os::Printer::log("Decompressed texture, format not supported by driver", name, ELL_INFORMATION);
+	} else if (getTextureCreationFlag(ETCF_COMPRESS_ON_LOAD)) {
+		const ECOLOR_FORMAT target = CImageCompressor::chooseFormat(image);
+		if (target == ECF_UNKNOWN || !queryTextureFormat(target))
+			return image;
+		result = CImageCompressor::compress(image, target, getTextureCreationFlag(ETCF_CREATE_MIP_MAPS));
+		if (result) {
+			// compare against the 32 bit texture the driver would have created otherwise
+			const core::dimension2du &size = image->getDimension();
+			u32 uncompressed = IImage::getDataSizeFromFormat(ECF_A8R8G8B8, size.Width, size.Height);
+			u32 compressed = result->getImageDataSizeInBytes();
+			for (u32 i = 1; i <= result->getMipMapLevelCount(); ++i) {
+				const core::dimension2du mipSize = result->getMipMapsSize(i);
+				uncompressed += IImage::getDataSizeFromFormat(ECF_A8R8G8B8, mipSize.Width, mipSize.Height);
+				compressed += IImage::getDataSizeFromFormat(target, mipSize.Width, mipSize.Height);
+			}
+			char tmp[128];
+			snprintf_irr(tmp, sizeof(tmp), "Compressed texture to %s, saved %u of %u bytes",
+					ColorFormatName(target), uncompressed - compressed, uncompressed);
+			os::Printer::log(tmp, name, ELL_INFORMATION);
+		}
+	}
+
+	if (!result)
+		return image;
+	image->drop();
+	return result;
+}
+
 //! adds a surface, not loaded or created by the Irrlicht Engine
 void CNullDriver::addTexture(video::ITexture *texture)
 {
@@ -639,6 +692,21 @@ void CNullDriver::draw2DImageBatch(const video::ITexture *texture,
 	}
 }
 
+//! Draws a set of 2d images from a signed distance field texture.
+void CNullDriver::draw2DDistanceFieldBatch(const video::ITexture *texture,
+		const core::array<core::rect<s32>> &destRects,
+		const core::array<core::rect<s32>> &sourceRects,
+		const core::rect<s32> *clipRect,
+		SColor color, f32 smoothing)
+{
+	// without a shader the blurred outline is the best there is
+	const u32 drawCount = core::min_<u32>(destRects.size(), sourceRects.size());
+	const video::SColor colors[4] = {color, color, color, color};
+
+	for (u32 i = 0; i < drawCount; ++i)
+		draw2DImage(texture, destRects[i], sourceRects[i], clipRect, colors, true);
+}
+
 //! Draws a part of the texture into the rectangle.
 void CNullDriver::draw2DImage(const video::ITexture *texture, const core::rect<s32> &destRect,
 		const core::rect<s32> &sourceRect, const core::rect<s32> *clipRect,
@@ -942,8 +1010,8 @@ void CNullDriver::getFog(SColor &color, E_FOG_TYPE &fogType, f32 &start, f32 &en
 	rangeFog = RangeFog;
 }
 
-void CNullDriver::drawBuffers(const scene::IVertexBuffer *vb,
-		const scene::IIndexBuffer *ib, u32 primCount,
+void CNullDriver::drawBufferRange(const scene::IVertexBuffer *vb,
+		const scene::IIndexBuffer *ib, u32 firstIndex, u32 primCount,
 		scene::E_PRIMITIVE_TYPE pType)
 {
 	if (!vb || !ib)
@@ -952,7 +1020,8 @@ void CNullDriver::drawBuffers(const scene::IVertexBuffer *vb,
 	// subclass is supposed to override this if it supports hw buffers
 	assert(!vb->Link && !ib->Link);
 
-	drawVertexPrimitiveList(vb->getData(), vb->getCount(), ib->getData(),
+	const u8 *indexList = static_cast<const u8 *>(ib->getData()) + firstIndex * ib->getElementSize();
+	drawVertexPrimitiveList(vb->getData(), vb->getCount(), indexList,
 		primCount, vb->getType(), pType, ib->getType());
 }
 
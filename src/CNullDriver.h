@@ -159,6 +159,14 @@ public:
 			SColor color = SColor(255, 255, 255, 255),
 			bool useAlphaChannelOfTexture = false) override;
 
+	//! Draws a set of 2d images from a signed distance field texture.
+	virtual void draw2DDistanceFieldBatch(const video::ITexture *texture,
+			const core::array<core::rect<s32>> &destRects,
+			const core::array<core::rect<s32>> &sourceRects,
+			const core::rect<s32> *clipRect = 0,
+			SColor color = SColor(255, 255, 255, 255),
+			f32 smoothing = 0.1f) override;
+
 	//! Draws a 2d image, using a color (if color is other then Color(255,255,255,255)) and the alpha channel of the texture if wanted.
 	virtual void draw2DImage(const video::ITexture *texture, const core::position2d<s32> &destPos,
 			const core::rect<s32> &sourceRect, const core::rect<s32> *clipRect = 0,
@@ -195,7 +203,7 @@ public:
 	const core::dimension2d<u32> &getScreenSize() const override;
 
 	//! get current render target
-	IRenderTarget *getCurrentRenderTarget() const;
+	IRenderTarget *getCurrentRenderTarget() const override;
 
 	//! get render target size
 	const core::dimension2d<u32> &getCurrentRenderTargetSize() const override;
@@ -268,9 +276,16 @@ public:
 			mb->getPrimitiveCount(), mb->getPrimitiveType());
 	}
 
-	// Note: this should handle hw buffers
-	virtual void drawBuffers(const scene::IVertexBuffer *vb,
+	void drawBuffers(const scene::IVertexBuffer *vb,
 		const scene::IIndexBuffer *ib, u32 primCount,
+		scene::E_PRIMITIVE_TYPE pType = scene::EPT_TRIANGLES) override
+	{
+		drawBufferRange(vb, ib, 0, primCount, pType);
+	}
+
+	// Note: this should handle hw buffers
+	virtual void drawBufferRange(const scene::IVertexBuffer *vb,
+		const scene::IIndexBuffer *ib, u32 firstIndex, u32 primCount,
 		scene::E_PRIMITIVE_TYPE pType = scene::EPT_TRIANGLES) override;
 
 	//! Draws the normals of a mesh buffer
@@ -488,6 +503,9 @@ public:
 	//! Enable the 2d override material
 	void enableMaterial2D(bool enable = true) override;
 
+	//! Check whether the 2d override material is enabled
+	bool isMaterial2DEnabled() const override { return OverrideMaterial2DEnabled; }
+
 	//! Only used by the engine internally.
 	void setAllowZWriteOnTransparent(bool flag) override
 	{
@@ -504,6 +522,10 @@ protected:
 	//! opens the file and loads it into the surface
 	ITexture *loadTextureFromFile(io::IReadFile *file, const io::path &hashName = "");
 
+	//! compresses or decompresses a loaded image to a format the driver supports
+	/** Drops the image and returns a replacement if it had to be converted. */
+	IImage *prepareCompression(IImage *image, const io::path &name);
+
 	//! adds a surface, not loaded or created by the Irrlicht Engine
 	void addTexture(ITexture *surface);
 
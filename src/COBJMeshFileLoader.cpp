@@ -9,8 +9,13 @@
 #include "CMeshBuffer.h"
 #include "IReadFile.h"
 #include "coreutil.h"
+#include "fast_atof.h"
 #include "os.h"
 
+#include <system_error>
+#include <thread>
+#include <vector>
+
 namespace irr
 {
 
@@ -27,6 +32,9 @@ namespace scene
 #define _IRR_DEBUG_OBJ_LOADER_
 #endif
 
+// Below this many bytes per thread, parsing in parallel does not pay off
+static constexpr long MIN_BYTES_PER_THREAD = 1 << 20;
+
 //! Constructor
 COBJMeshFileLoader::COBJMeshFileLoader(scene::ISceneManager *smgr) :
 		SceneManager(smgr)
@@ -57,15 +65,8 @@ IAnimatedMesh *COBJMeshFileLoader::createMesh(io::IReadFile *file)
 	if (!filesize)
 		return 0;
 
-	const u32 WORD_BUFFER_LENGTH = 512;
-
-	core::array<core::vector3df> vertexBuffer(1000);
-	core::array<core::vector3df> normalsBuffer(1000);
-	core::array<core::vector2df> textureCoordBuffer(1000);
-
 	SObjMtl *currMtl = new SObjMtl();
 	Materials.push_back(currMtl);
-	u32 smoothingGroup = 0;
 
 	const io::path fullName = file->getFileName();
 
@@ -74,90 +75,79 @@ IAnimatedMesh *COBJMeshFileLoader::createMesh(io::IReadFile *file)
 	file->read((void *)buf, filesize);
 	const c8 *const bufEnd = buf + filesize;
 
-	// Process obj information
-	const c8 *bufPtr = buf;
+	// Split the file at line breaks and parse the pieces in parallel
+	const u32 chunkCount = core::clamp((u32)(filesize / MIN_BYTES_PER_THREAD), 1U,
+			core::max_(std::thread::hardware_concurrency(), 1U));
+	std::vector<SObjChunk> chunks(chunkCount);
+	std::vector<const c8 *> chunkStart(chunkCount + 1, bufEnd);
+	chunkStart[0] = buf;
+	for (u32 i = 1; i < chunkCount; ++i) {
+		const c8 *ptr = core::max_<const c8 *>(buf + (size_t)filesize * i / chunkCount, chunkStart[i - 1]);
+		while (ptr != bufEnd && *ptr != '\n')
+			++ptr;
+		chunkStart[i] = ptr == bufEnd ? bufEnd : ptr + 1;
+	}
+
+	std::vector<std::thread> workers;
+	u32 runHere = chunkCount; // first chunk that could not be given to a thread
+	for (u32 i = 1; i < chunkCount; ++i) {
+		try {
+			workers.emplace_back([this, &chunks, &chunkStart, i] {
+				parseChunk(chunkStart[i], chunkStart[i + 1], chunks[i]);
+			});
+		} catch (const std::system_error &) {
+			runHere = i;
+			break;
+		}
+	}
+	parseChunk(chunkStart[0], chunkStart[1], chunks[0]);
+	for (u32 i = runHere; i < chunkCount; ++i)
+		parseChunk(chunkStart[i], chunkStart[i + 1], chunks[i]);
+	for (auto &worker : workers)
+		worker.join();
+
+	// Faces may reference vertex data of any earlier chunk, so merge it first
+	std::vector<core::vector3df> vertexBuffer, normalsBuffer;
+	std::vector<core::vector2df> textureCoordBuffer;
+	std::vector<s32> posBase(chunkCount), normalBase(chunkCount), tcoordBase(chunkCount);
+	for (u32 i = 0; i < chunkCount; ++i) {
+		posBase[i] = vertexBuffer.size();
+		normalBase[i] = normalsBuffer.size();
+		tcoordBase[i] = textureCoordBuffer.size();
+		const SObjChunk &chunk = chunks[i];
+		vertexBuffer.insert(vertexBuffer.end(), chunk.Positions.const_pointer(), chunk.Positions.const_pointer() + chunk.Positions.size());
+		normalsBuffer.insert(normalsBuffer.end(), chunk.Normals.const_pointer(), chunk.Normals.const_pointer() + chunk.Normals.size());
+		textureCoordBuffer.insert(textureCoordBuffer.end(), chunk.TCoords.const_pointer(), chunk.TCoords.const_pointer() + chunk.TCoords.size());
+	}
+	const s32 vbsize = vertexBuffer.size(), vtsize = textureCoordBuffer.size(), vnsize = normalsBuffer.size();
+
+	// Apply faces and material changes in file order
 	core::stringc grpName, mtlName;
 	bool mtlChanged = false;
-	[[maybe_unused]] u32 lineNr = 1; // only counts non-empty lines, still useful in debugging to locate errors
 	core::array<int> faceCorners;
 	faceCorners.reallocate(32); // should be large enough
-	const core::stringc TAG_OFF = "off";
 	u32 degeneratedFaces = 0;
 
-	while (bufPtr != bufEnd) {
-		switch (bufPtr[0]) {
-		case 'm': // mtllib (material)
-			break; // not supported
-
-		case 'v': // v, vn, vt
-			switch (bufPtr[1]) {
-			case ' ': // vertex
-			{
-				core::vector3df vec;
-				bufPtr = readVec3(bufPtr, vec, bufEnd);
-				vertexBuffer.push_back(vec);
-			} break;
-
-			case 'n': // normal
-			{
-				core::vector3df vec;
-				bufPtr = readVec3(bufPtr, vec, bufEnd);
-				normalsBuffer.push_back(vec);
-			} break;
-
-			case 't': // texcoord
-			{
-				core::vector2df vec;
-				bufPtr = readUV(bufPtr, vec, bufEnd);
-				textureCoordBuffer.push_back(vec);
-			} break;
-			}
-			break;
-
-		case 'g': // group name
-		{
-			c8 grp[WORD_BUFFER_LENGTH];
-			bufPtr = goAndCopyNextWord(grp, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-#ifdef _IRR_DEBUG_OBJ_LOADER_
-			os::Printer::log("Loaded group start", grp, ELL_DEBUG);
-#endif
-			grpName = ('\0' != grp[0]) ? grp : "default";
-			mtlChanged = true;
-		} break;
-
-		case 's': // smoothing can be a group or off (equiv. to 0)
-		{
-			c8 smooth[WORD_BUFFER_LENGTH];
-			bufPtr = goAndCopyNextWord(smooth, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
+	for (u32 ci = 0; ci < chunkCount; ++ci) {
+		const SObjChunk &chunk = chunks[ci];
+		for (u32 s = 0; s < chunk.Statements.size(); ++s) {
+			const SObjStatement &statement = chunk.Statements[s];
+			if (statement.Type == SObjStatement::GROUP) {
+				grpName = chunk.Names[statement.First];
 #ifdef _IRR_DEBUG_OBJ_LOADER_
-			os::Printer::log("Loaded smoothing group start", smooth, ELL_DEBUG);
+				os::Printer::log("Loaded group start", grpName.c_str(), ELL_DEBUG);
 #endif
-			if (TAG_OFF == smooth)
-				smoothingGroup = 0;
-			else
-				smoothingGroup = strtoul(smooth, nullptr, 10);
-
-			(void)smoothingGroup; // disable unused variable warnings
-		} break;
-
-		case 'u': // usemtl
-			// get name of material
-			{
-				c8 matName[WORD_BUFFER_LENGTH];
-				bufPtr = goAndCopyNextWord(matName, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
+				mtlChanged = true;
+				continue;
+			} else if (statement.Type == SObjStatement::MATERIAL) {
+				mtlName = chunk.Names[statement.First];
 #ifdef _IRR_DEBUG_OBJ_LOADER_
-				os::Printer::log("Loaded material start", matName, ELL_DEBUG);
+				os::Printer::log("Loaded material start", mtlName.c_str(), ELL_DEBUG);
 #endif
-				mtlName = matName;
 				mtlChanged = true;
+				continue;
 			}
-			break;
 
-		case 'f': // face
-		{
-			c8 vertexWord[WORD_BUFFER_LENGTH]; // for retrieving vertex data
-			video::S3DVertex v;
-			// Assign vertex color from currently active material's diffuse color
 			if (mtlChanged) {
 				// retrieve the material
 				SObjMtl *useMtl = findMtl(mtlName, grpName);
@@ -166,80 +156,70 @@ IAnimatedMesh *COBJMeshFileLoader::createMesh(io::IReadFile *file)
 					currMtl = useMtl;
 				mtlChanged = false;
 			}
-			if (currMtl)
-				v.Color = video::SColorf(0.8f, 0.8f, 0.8f, 1.0f).toSColor();
-
-			// get all vertices data in this face (current line of obj file)
-			const core::stringc wordBuffer = copyLine(bufPtr, bufEnd);
-			const c8 *linePtr = wordBuffer.c_str();
-			const c8 *const endPtr = linePtr + wordBuffer.size();
 
 			faceCorners.set_used(0); // fast clear
 
-			// read in all vertices
 			auto &Vertices = currMtl->Meshbuffer->Vertices->Data;
-			linePtr = goNextWord(linePtr, endPtr);
-			while (0 != linePtr[0]) {
-				// Array to communicate with retrieveVertexIndices()
-				// sends the buffer sizes and gets the actual indices
-				// if index not set returns -1
-				s32 Idx[3];
-				Idx[0] = Idx[1] = Idx[2] = -1;
-
-				// read in next vertex's data
-				u32 wlength = copyWord(vertexWord, linePtr, WORD_BUFFER_LENGTH, endPtr);
-				// this function will also convert obj's 1-based index to c++'s 0-based index
-				retrieveVertexIndices(vertexWord, Idx, vertexWord + wlength + 1, vertexBuffer.size(), textureCoordBuffer.size(), normalsBuffer.size());
-				if (Idx[0] >= 0 && Idx[0] < (s32)vertexBuffer.size())
-					v.Pos = vertexBuffer[Idx[0]];
-				else {
-					os::Printer::log("Invalid vertex index in this line", wordBuffer.c_str(), ELL_ERROR);
+			const s32 *idx = chunk.Corners.const_pointer() + statement.First * 3;
+			for (u32 i = 0; i < statement.CornerCount; ++i, idx += 3) {
+				// convert obj's 1-based or relative indices to 0-based ones
+				SObjVertexKey key;
+				key.Pos = idx[0] < 0 ? idx[0] + posBase[ci] + statement.PosCount : idx[0] - 1;
+				key.TCoord = idx[1] < 0 ? idx[1] + tcoordBase[ci] + statement.TCoordCount : idx[1] - 1;
+				key.Normal = idx[2] < 0 ? idx[2] + normalBase[ci] + statement.NormalCount : idx[2] - 1;
+
+				if (key.Pos < 0 || key.Pos >= vbsize) {
+					os::Printer::log("Invalid vertex index in this line", copyLine(statement.Line, bufEnd).c_str(), ELL_ERROR);
 					delete[] buf;
 					cleanUp();
 					return 0;
 				}
-				if (Idx[1] >= 0 && Idx[1] < (s32)textureCoordBuffer.size())
-					v.TCoords = textureCoordBuffer[Idx[1]];
-				else
-					v.TCoords.set(0.0f, 0.0f);
-				if (Idx[2] >= 0 && Idx[2] < (s32)normalsBuffer.size())
-					v.Normal = normalsBuffer[Idx[2]];
-				else {
-					v.Normal.set(0.0f, 0.0f, 0.0f);
+				if (key.TCoord >= vtsize)
+					key.TCoord = -1;
+				if (key.Normal < 0 || key.Normal >= vnsize) {
+					key.Normal = -1;
 					currMtl->RecalculateNormals = true;
 				}
 
-				int vertLocation;
-				auto n = currMtl->VertMap.find(v);
+				auto n = currMtl->VertMap.find(key);
 				if (n != currMtl->VertMap.end()) {
-					vertLocation = n->second;
-				} else {
-					Vertices.push_back(v);
-					vertLocation = Vertices.size() - 1;
-					currMtl->VertMap.emplace(v, vertLocation);
+					faceCorners.push_back(n->second);
+					continue;
 				}
 
-				faceCorners.push_back(vertLocation);
+				video::S3DVertex v;
+				v.Pos = vertexBuffer[key.Pos];
+				if (key.TCoord >= 0)
+					v.TCoords = textureCoordBuffer[key.TCoord];
+				else
+					v.TCoords.set(0.0f, 0.0f);
+				if (key.Normal >= 0)
+					v.Normal = normalsBuffer[key.Normal];
+				else
+					v.Normal.set(0.0f, 0.0f, 0.0f);
+				// Assign vertex color from currently active material's diffuse color
+				v.Color = video::SColorf(0.8f, 0.8f, 0.8f, 1.0f).toSColor();
 
-				// go to next vertex
-				linePtr = goNextWord(linePtr, endPtr);
+				Vertices.push_back(v);
+				faceCorners.push_back(Vertices.size() - 1);
+				currMtl->VertMap.emplace(key, Vertices.size() - 1);
 			}
 
 			if (faceCorners.size() < 3) {
-				os::Printer::log("Too few vertices in this line", wordBuffer.c_str(), ELL_ERROR);
+				os::Printer::log("Too few vertices in this line", copyLine(statement.Line, bufEnd).c_str(), ELL_ERROR);
 				delete[] buf;
 				cleanUp();
 				return 0;
 			}
 
 			// triangulate the face
-			auto &Indices = currMtl->Meshbuffer->Indices->Data;
+			auto &Indices = currMtl->Indices;
 			const int c = faceCorners[0];
 			for (u32 i = 1; i < faceCorners.size() - 1; ++i) {
 				// Add a triangle
 				const int a = faceCorners[i + 1];
 				const int b = faceCorners[i];
-				if (a != b && a != c && b != c) { // ignore degenerated faces. We can get them when we merge vertices above in the VertMap.
+				if (a != b && a != c && b != c) { // ignore degenerated faces. We can get them when faces repeat a corner.
 					Indices.push_back(a);
 					Indices.push_back(b);
 					Indices.push_back(c);
@@ -247,16 +227,8 @@ IAnimatedMesh *COBJMeshFileLoader::createMesh(io::IReadFile *file)
 					++degeneratedFaces;
 				}
 			}
-		} break;
-
-		case '#': // comment
-		default:
-			break;
-		} // end switch(bufPtr[0])
-		// eat up rest of line
-		bufPtr = goNextLine(bufPtr, bufEnd);
-		++lineNr;
-	} // end while(bufPtr && (bufPtr-buf<filesize))
+		}
+	}
 
 	if (degeneratedFaces > 0) {
 		core::stringc log(degeneratedFaces);
@@ -269,12 +241,16 @@ IAnimatedMesh *COBJMeshFileLoader::createMesh(io::IReadFile *file)
 
 	// Combine all the groups (meshbuffers) into the mesh
 	for (u32 m = 0; m < Materials.size(); ++m) {
-		if (Materials[m]->Meshbuffer->getIndexCount() > 0) {
-			Materials[m]->Meshbuffer->recalculateBoundingBox();
-			if (Materials[m]->RecalculateNormals)
-				SceneManager->getMeshManipulator()->recalculateNormals(Materials[m]->Meshbuffer);
-			mesh->addMeshBuffer(Materials[m]->Meshbuffer);
-		}
+		SObjMtl *mtl = Materials[m];
+		if (mtl->Indices.empty())
+			continue;
+		IMeshBuffer *buffer = createMeshBuffer(std::move(mtl->Meshbuffer->Vertices->Data), std::move(mtl->Indices));
+		buffer->getMaterial() = mtl->Meshbuffer->Material;
+		buffer->recalculateBoundingBox();
+		if (mtl->RecalculateNormals)
+			SceneManager->getMeshManipulator()->recalculateNormals(buffer);
+		mesh->addMeshBuffer(buffer);
+		buffer->drop();
 	}
 
 	// Clean up the allocate obj file contents
@@ -292,6 +268,88 @@ IAnimatedMesh *COBJMeshFileLoader::createMesh(io::IReadFile *file)
 	return mesh;
 }
 
+void COBJMeshFileLoader::parseChunk(const c8 *bufPtr, const c8 *const bufEnd, SObjChunk &chunk)
+{
+	const u32 WORD_BUFFER_LENGTH = 512;
+
+	bufPtr = goFirstWord(bufPtr, bufEnd);
+	while (bufPtr != bufEnd) {
+		switch (bufPtr[0]) {
+		case 'm': // mtllib (material)
+			break; // not supported
+
+		case 'v': // v, vn, vt
+			switch (bufPtr[1]) {
+			case ' ': // vertex
+			{
+				core::vector3df vec;
+				bufPtr = readVec3(bufPtr, vec, bufEnd);
+				chunk.Positions.push_back(vec);
+			} break;
+
+			case 'n': // normal
+			{
+				core::vector3df vec;
+				bufPtr = readVec3(bufPtr, vec, bufEnd);
+				chunk.Normals.push_back(vec);
+			} break;
+
+			case 't': // texcoord
+			{
+				core::vector2df vec;
+				bufPtr = readUV(bufPtr, vec, bufEnd);
+				chunk.TCoords.push_back(vec);
+			} break;
+			}
+			break;
+
+		case 'g': // group name
+		case 'u': // usemtl
+		{
+			SObjStatement statement = {bufPtr[0] == 'g' ? SObjStatement::GROUP : SObjStatement::MATERIAL,
+					chunk.Names.size(), 0, 0, 0, 0, bufPtr};
+			c8 name[WORD_BUFFER_LENGTH];
+			bufPtr = goAndCopyNextWord(name, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
+			if (statement.Type == SObjStatement::GROUP && '\0' == name[0])
+				chunk.Names.push_back("default");
+			else
+				chunk.Names.push_back(name);
+			chunk.Statements.push_back(statement);
+		} break;
+
+		case 'f': // face
+		{
+			const c8 *lineEnd = bufPtr;
+			while (lineEnd != bufEnd && *lineEnd != '\n' && *lineEnd != '\r')
+				++lineEnd;
+
+			SObjStatement statement = {SObjStatement::FACE, chunk.Corners.size() / 3, 0,
+					chunk.Positions.size(), chunk.TCoords.size(), chunk.Normals.size(), bufPtr};
+			// read in all vertices
+			const c8 *linePtr = goNextWord(bufPtr, lineEnd);
+			while (linePtr != lineEnd) {
+				s32 idx[3] = {0, 0, 0};
+				linePtr = readCorner(linePtr, idx, lineEnd);
+				chunk.Corners.push_back(idx[0]);
+				chunk.Corners.push_back(idx[1]);
+				chunk.Corners.push_back(idx[2]);
+				++statement.CornerCount;
+				linePtr = goFirstWord(linePtr, lineEnd);
+			}
+			chunk.Statements.push_back(statement);
+			bufPtr = lineEnd;
+		} break;
+
+		case 's': // smoothing groups are not supported
+		case '#': // comment
+		default:
+			break;
+		} // end switch(bufPtr[0])
+		// eat up rest of line
+		bufPtr = goNextLine(bufPtr, bufEnd);
+	}
+}
+
 //! Read RGB color
 const c8 *COBJMeshFileLoader::readColor(const c8 *bufPtr, video::SColor &color, const c8 *const bufEnd)
 {
@@ -307,31 +365,32 @@ const c8 *COBJMeshFileLoader::readColor(const c8 *bufPtr, video::SColor &color,
 	return bufPtr;
 }
 
+//! Read the next word of the line as float, 0 if there is none
+const c8 *COBJMeshFileLoader::readFloat(const c8 *bufPtr, f32 &value, const c8 *const bufEnd)
+{
+	bufPtr = goNextWord(bufPtr, bufEnd, false);
+	value = 0.f;
+	if (bufPtr != bufEnd && !core::isspace(*bufPtr))
+		core::fast_atof_move(bufPtr, value);
+	return bufPtr;
+}
+
 //! Read 3d vector of floats
 const c8 *COBJMeshFileLoader::readVec3(const c8 *bufPtr, core::vector3df &vec, const c8 *const bufEnd)
 {
-	const u32 WORD_BUFFER_LENGTH = 256;
-	c8 wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.X = -my_atof(wordBuffer); // change handedness
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Y = my_atof(wordBuffer);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Z = my_atof(wordBuffer);
+	bufPtr = readFloat(bufPtr, vec.X, bufEnd);
+	vec.X = -vec.X; // change handedness
+	bufPtr = readFloat(bufPtr, vec.Y, bufEnd);
+	bufPtr = readFloat(bufPtr, vec.Z, bufEnd);
 	return bufPtr;
 }
 
 //! Read 2d vector of floats
 const c8 *COBJMeshFileLoader::readUV(const c8 *bufPtr, core::vector2df &vec, const c8 *const bufEnd)
 {
-	const u32 WORD_BUFFER_LENGTH = 256;
-	c8 wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.X = my_atof(wordBuffer);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Y = 1 - my_atof(wordBuffer); // change handedness
+	bufPtr = readFloat(bufPtr, vec.X, bufEnd);
+	bufPtr = readFloat(bufPtr, vec.Y, bufEnd);
+	vec.Y = 1 - vec.Y; // change handedness
 	return bufPtr;
 }
 
@@ -457,65 +516,25 @@ const c8 *COBJMeshFileLoader::goAndCopyNextWord(c8 *outBuf, const c8 *inBuf, u32
 	return inBuf;
 }
 
-bool COBJMeshFileLoader::retrieveVertexIndices(c8 *vertexData, s32 *idx, const c8 *bufEnd, u32 vbsize, u32 vtsize, u32 vnsize)
+const c8 *COBJMeshFileLoader::readCorner(const c8 *bufPtr, s32 *idx, const c8 *const lineEnd)
 {
-	const u32 BUFFER_LENGTH = 16;
-	c8 word[BUFFER_LENGTH];
-	const c8 *p = goFirstWord(vertexData, bufEnd);
 	u32 idxType = 0; // 0 = posIdx, 1 = texcoordIdx, 2 = normalIdx
 
-	u32 i = 0;
-	while (p != bufEnd) {
-		if (i >= BUFFER_LENGTH) {
-			return false;
-		}
-		if ((core::isdigit(*p)) || (*p == '-')) {
-			// build up the number
-			word[i++] = *p;
-		} else if (*p == '/' || *p == ' ' || *p == '\0') {
-			// number is completed. Convert and store it
-			word[i] = '\0';
-			// if no number was found index will become 0 and later on -1 by decrement
-			idx[idxType] = strtoul(word, nullptr, 10);
-			if (idx[idxType] < 0) {
-				switch (idxType) {
-				case 0:
-					idx[idxType] += vbsize;
-					break;
-				case 1:
-					idx[idxType] += vtsize;
-					break;
-				case 2:
-					idx[idxType] += vnsize;
-					break;
-				}
-			} else
-				idx[idxType] -= 1;
-
-			// reset the word
-			word[0] = '\0';
-			i = 0;
-
+	while (bufPtr != lineEnd && !core::isspace(*bufPtr)) {
+		if (*bufPtr == '/') {
 			// go to the next kind of index type
-			if (*p == '/') {
-				if (++idxType > 2) {
-					// error checking, shouldn't reach here unless file is wrong
-					idxType = 0;
-				}
-			} else {
-				// set all missing values to disable (=-1)
-				while (++idxType < 3)
-					idx[idxType] = -1;
-				++p;
-				break; // while
+			if (++idxType > 2) {
+				// error checking, shouldn't reach here unless file is wrong
+				idxType = 0;
 			}
+			++bufPtr;
+		} else if (core::isdigit(*bufPtr) || *bufPtr == '-') {
+			idx[idxType] = core::strtol10(bufPtr, &bufPtr);
+		} else {
+			++bufPtr;
 		}
-
-		// go to the next char
-		++p;
 	}
-
-	return true;
+	return bufPtr;
 }
 
 void COBJMeshFileLoader::cleanUp()
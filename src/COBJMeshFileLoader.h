@@ -4,7 +4,7 @@
 
 #pragma once
 
-#include <map>
+#include <unordered_map>
 #include "IMeshLoader.h"
 #include "ISceneManager.h"
 #include "irrString.h"
@@ -36,6 +36,64 @@ public:
 	IAnimatedMesh *createMesh(io::IReadFile *file) override;
 
 private:
+	//! 0-based position, texture coordinate and normal index of a face corner
+	/** Unused or invalid texture coordinate and normal indices are -1. */
+	struct SObjVertexKey
+	{
+		s32 Pos;
+		s32 TCoord;
+		s32 Normal;
+
+		bool operator==(const SObjVertexKey &other) const
+		{
+			return Pos == other.Pos && TCoord == other.TCoord && Normal == other.Normal;
+		}
+	};
+
+	struct SObjVertexKeyHash
+	{
+		size_t operator()(const SObjVertexKey &key) const
+		{
+			return (size_t)((u64)(u32)key.Pos * 0x9E3779B97F4A7C15ULL ^
+					(u64)(u32)key.TCoord * 0xC2B2AE3D27D4EB4FULL ^
+					(u64)(u32)key.Normal * 0x165667B19E3779F9ULL);
+		}
+	};
+
+	//! A line which has to be applied in file order once all chunks are parsed
+	struct SObjStatement
+	{
+		enum E_TYPE : u8
+		{
+			FACE,
+			GROUP,
+			MATERIAL
+		};
+
+		E_TYPE Type;
+		//! First corner in SObjChunk::Corners for faces, index into SObjChunk::Names else
+		u32 First;
+		u32 CornerCount;
+		//! Elements read by the chunk before this line, for relative indices
+		u32 PosCount;
+		u32 TCoordCount;
+		u32 NormalCount;
+		//! Start of the line, for error messages
+		const c8 *Line;
+	};
+
+	//! Everything read from a range of lines of the file
+	struct SObjChunk
+	{
+		core::array<core::vector3df> Positions;
+		core::array<core::vector3df> Normals;
+		core::array<core::vector2df> TCoords;
+		//! Indices as written in the file, three per corner, 0 if missing
+		core::array<s32> Corners;
+		core::array<core::stringc> Names;
+		core::array<SObjStatement> Statements;
+	};
+
 	struct SObjMtl
 	{
 		SObjMtl() :
@@ -54,8 +112,11 @@ private:
 			Meshbuffer->Material = o.Meshbuffer->Material;
 		}
 
-		std::map<video::S3DVertex, int> VertMap;
+		std::unordered_map<SObjVertexKey, u32, SObjVertexKeyHash> VertMap;
+		//! Collects the vertices and the material
 		scene::SMeshBuffer *Meshbuffer;
+		//! Triangle indices, the index type is chosen once all are known
+		std::vector<u32> Indices;
 		core::stringc Name;
 		core::stringc Group;
 		f32 Bumpiness;
@@ -82,6 +143,8 @@ private:
 
 	//! Read RGB color
 	const c8 *readColor(const c8 *bufPtr, video::SColor &color, const c8 *const pBufEnd);
+	//! Read the next word of the line as float, 0 if there is none
+	const c8 *readFloat(const c8 *bufPtr, f32 &value, const c8 *const pBufEnd);
 	//! Read 3d vector of floats
 	const c8 *readVec3(const c8 *bufPtr, core::vector3df &vec, const c8 *const pBufEnd);
 	//! Read 2d vector of floats
@@ -89,10 +152,13 @@ private:
 	//! Read boolean value represented as 'on' or 'off'
 	const c8 *readBool(const c8 *bufPtr, bool &tf, const c8 *const bufEnd);
 
-	// reads and convert to integer the vertex indices in a line of obj file's face statement
-	// -1 for the index if it doesn't exist
-	// indices are changed to 0-based index instead of 1-based from the obj file
-	bool retrieveVertexIndices(c8 *vertexData, s32 *idx, const c8 *bufEnd, u32 vbsize, u32 vtsize, u32 vnsize);
+	// reads the vertex data and statements of all lines starting in the range,
+	// the range has to start at the beginning of a line
+	void parseChunk(const c8 *bufPtr, const c8 *const bufEnd, SObjChunk &chunk);
+
+	// reads the position, texture coordinate and normal index of a face corner
+	// as written in the file, 0 for the index if it doesn't exist
+	const c8 *readCorner(const c8 *bufPtr, s32 *idx, const c8 *const lineEnd);
 
 	void cleanUp();
 
@@ -65,6 +65,12 @@ public:
 		if (!InternalFormat)
 			return;
 
+		// Compressed mipmaps can't be generated, they have to come with the images
+		if (IImage::isCompressedFormat(ColorFormat)) {
+			for (const IImage *image : srcImages)
+				HasMipMaps = HasMipMaps && image->getMipMapLevelCount() > 0;
+		}
+
 		char lbuf[128];
 		snprintf_irr(lbuf, sizeof(lbuf),
 			"COpenGLCoreTexture: Type = %d Size = %dx%d (%dx%d) ColorFormat = %s (%s)%s -> %#06x %#06x %#06x%s",
@@ -116,7 +122,13 @@ public:
 				uploadTexture(i, 0, (*tmpImages)[i]->getData());
 		}
 
-		if (HasMipMaps) {
+		if (HasMipMaps && IImage::isCompressedFormat(ColorFormat)) {
+			for (size_t i = 0; i < tmpImages->size(); ++i) {
+				const IImage *image = (*tmpImages)[i];
+				for (u32 level = 1; level <= image->getMipMapLevelCount(); ++level)
+					uploadTexture(i, level, image->getMipMapsData(level));
+			}
+		} else if (HasMipMaps) {
 			regenerateMipMapLevels();
 		}
 
@@ -395,6 +407,10 @@ public:
 		if (!HasMipMaps || (Size.Width <= 1 && Size.Height <= 1))
 			return;
 
+		// glGenerateMipmap doesn't work on compressed formats
+		if (IImage::isCompressedFormat(ColorFormat))
+			return;
+
 		auto &cache = Driver->getCacheHandler()->getTextureCache();
 		const COpenGLCoreTexture *prevTexture = cache.get(0);
 		cache.set(0, this);
@@ -482,8 +498,15 @@ protected:
 			return;
 		}
 
-		if (IImage::isCompressedFormat(image->getColorFormat())) {
+		const bool compressed = IImage::isCompressedFormat(image->getColorFormat());
+		if (compressed) {
 			KeepImage = false;
+
+			if (Type == ETT_2D_ARRAY) {
+				os::Printer::log("getImageValues: Compressed texture arrays are not supported", ColorFormatName(ColorFormat), ELL_ERROR);
+				InternalFormat = 0;
+				return;
+			}
 		}
 
 		OriginalSize = image->getDimension();
@@ -510,6 +533,15 @@ protected:
 
 		Size = Size.getOptimalSize(!Driver->queryFeature(EVDF_TEXTURE_NPOT), needSquare, true, Driver->MaxTextureSize);
 
+		// compressed data can't be rescaled
+		if (compressed && Size != OriginalSize) {
+			char buf[64];
+			snprintf_irr(buf, sizeof(buf), "%dx%d -> %dx%d", OriginalSize.Width, OriginalSize.Height, Size.Width, Size.Height);
+			os::Printer::log("getImageValues: Compressed texture would need resizing", buf, ELL_ERROR);
+			InternalFormat = 0;
+			return;
+		}
+
 		Pitch = Size.Width * IImage::getBitsPerPixelFromFormat(ColorFormat) / 8;
 	}
 
@@ -390,6 +390,7 @@ bool COpenGLDriver::updateHardwareBuffer(SHWBufferLink *_link)
 		success = updateIndexHardwareBuffer(link);
 		break;
 	case scene::HWBuffer::Type::WEIGHT:
+	case scene::HWBuffer::Type::QUANTIZED_VERTEX:
 	default:
 		IRR_CODE_UNREACHABLE();
 	}
@@ -432,8 +433,8 @@ void COpenGLDriver::deleteHardwareBuffer(SHWBufferLink *_link)
 	CNullDriver::deleteHardwareBuffer(_link);
 }
 
-void COpenGLDriver::drawBuffers(const scene::IVertexBuffer *vb,
-	const scene::IIndexBuffer *ib, u32 PrimitiveCount,
+void COpenGLDriver::drawBufferRange(const scene::IVertexBuffer *vb,
+	const scene::IIndexBuffer *ib, u32 firstIndex, u32 PrimitiveCount,
 	scene::E_PRIMITIVE_TYPE PrimitiveType)
 {
 	if (!vb || !ib)
@@ -449,11 +450,13 @@ void COpenGLDriver::drawBuffers(const scene::IVertexBuffer *vb,
 		vertices = 0;
 	}
 
-	const void *indexList = ib->getData();
+	// with a bound buffer, the pointer is an offset into it
+	const size_t indexOffset = (size_t)firstIndex * ib->getElementSize();
+	const void *indexList = static_cast<const u8 *>(ib->getData()) + indexOffset;
 	if (hwidx) {
 		updateHardwareBuffer(hwidx);
 		extGlBindBuffer(GL_ELEMENT_ARRAY_BUFFER, hwidx->vbo_ID);
-		indexList = 0;
+		indexList = reinterpret_cast<const void *>(indexOffset);
 	}
 
 	drawVertexPrimitiveList(vertices, vb->getCount(), indexList,
@@ -2098,6 +2101,9 @@ void COpenGLDriver::setRenderStates2DMode(bool alpha, bool texture, bool alphaCh
 
 	if (alphaChannel || alpha) {
 		CacheHandler->setBlend(true);
+		// a blend factor of the 2d material was set by setBasicRenderStates()
+		if (!IR(currentMaterial.BlendFactor))
+			CacheHandler->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		CacheHandler->setAlphaTest(true);
 		CacheHandler->setAlphaFunc(GL_GREATER, 0.f);
 	} else {
@@ -2849,6 +2855,43 @@ bool COpenGLDriver::getColorFormatParameters(ECOLOR_FORMAT format, GLint &intern
 			pixelType = GL_FLOAT;
 		}
 		break;
+	// compressed formats only need the internal format
+	case ECF_DXT1:
+		supported = queryOpenGLFeature(COpenGLExtensionHandler::IRR_EXT_texture_compression_s3tc);
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		break;
+	case ECF_DXT3:
+		supported = queryOpenGLFeature(COpenGLExtensionHandler::IRR_EXT_texture_compression_s3tc);
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+		break;
+	case ECF_DXT5:
+		supported = queryOpenGLFeature(COpenGLExtensionHandler::IRR_EXT_texture_compression_s3tc);
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		break;
+	case ECF_BC4:
+		supported = Version >= 300 || queryOpenGLFeature(COpenGLExtensionHandler::IRR_ARB_texture_compression_rgtc);
+		internalFormat = GL_COMPRESSED_RED_RGTC1;
+		break;
+	case ECF_BC5:
+		supported = Version >= 300 || queryOpenGLFeature(COpenGLExtensionHandler::IRR_ARB_texture_compression_rgtc);
+		internalFormat = GL_COMPRESSED_RG_RGTC2;
+		break;
+	case ECF_BC7:
+		supported = Version >= 420 || queryOpenGLFeature(COpenGLExtensionHandler::IRR_ARB_texture_compression_bptc);
+		internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+		break;
+	case ECF_ETC2_RGB:
+		supported = Version >= 430 || queryOpenGLFeature(COpenGLExtensionHandler::IRR_ARB_ES3_compatibility);
+		internalFormat = GL_COMPRESSED_RGB8_ETC2;
+		break;
+	case ECF_ETC2_ARGB:
+		supported = Version >= 430 || queryOpenGLFeature(COpenGLExtensionHandler::IRR_ARB_ES3_compatibility);
+		internalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC;
+		break;
+	case ECF_ASTC_4x4:
+		supported = queryOpenGLFeature(COpenGLExtensionHandler::IRR_KHR_texture_compression_astc_ldr);
+		internalFormat = GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+		break;
 	default:
 		break;
 	}
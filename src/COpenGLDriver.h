@@ -66,8 +66,8 @@ public:
 	//! Delete hardware buffer (only some drivers can)
 	void deleteHardwareBuffer(SHWBufferLink *HWBuffer) override;
 
-	void drawBuffers(const scene::IVertexBuffer *vb,
-		const scene::IIndexBuffer *ib, u32 primCount,
+	void drawBufferRange(const scene::IVertexBuffer *vb,
+		const scene::IIndexBuffer *ib, u32 firstIndex, u32 primCount,
 		scene::E_PRIMITIVE_TYPE pType = scene::EPT_TRIANGLES) override;
 
 	//! Create occlusion query.
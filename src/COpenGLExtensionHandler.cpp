@@ -538,6 +538,8 @@ bool COpenGLExtensionHandler::queryFeature(E_VIDEO_DRIVER_FEATURE feature) const
 		return (Version >= 302) || FeatureAvailable[IRR_ARB_texture_multisample];
 	case EVDF_RENDER_TO_FLOAT_TEXTURE:
 		return Version >= 300 || FeatureAvailable[IRR_ARB_color_buffer_float];
+	case EVDF_32BIT_INDICES:
+		return true;
 
 	default:
 		return false;
@@ -7,6 +7,7 @@
 
 #include "CSceneManager.h"
 #include "IVideoDriver.h"
+#include "BoundingBoxes.h"
 #include "IFileSystem.h"
 #include "CMeshCache.h"
 #include "IGUIEnvironment.h"
@@ -20,12 +21,17 @@
 #include "CXMeshFileLoader.h"
 #include "COBJMeshFileLoader.h"
 #include "CB3DMeshFileLoader.h"
+#include "CMeshCacheFileLoader.h"
+#include "CMeshCacheWriter.h"
 #include "CBillboardSceneNode.h"
 #include "AnimatedMeshSceneNode.h"
 #include "CCameraSceneNode.h"
 #include "CMeshSceneNode.h"
+#include "CStaticBatchSceneNode.h"
+#include "CClusteredMeshSceneNode.h"
 #include "CDummyTransformationSceneNode.h"
 #include "CEmptySceneNode.h"
+#include "CTransformHierarchy.h"
 
 #include "CSceneCollisionManager.h"
 
@@ -70,6 +76,7 @@ CSceneManager::CSceneManager(video::IVideoDriver *driver,
 	MeshLoaderList.push_back(new CXMeshFileLoader(this));
 	MeshLoaderList.push_back(new COBJMeshFileLoader(this));
 	MeshLoaderList.push_back(new CB3DMeshFileLoader(this));
+	MeshLoaderList.push_back(new CMeshCacheFileLoader(this));
 }
 
 //! destructor
@@ -177,6 +184,38 @@ IMeshSceneNode *CSceneManager::addMeshSceneNode(IMesh *mesh, ISceneNode *parent,
 	return node;
 }
 
+//! adds a scene node drawing static mesh scene nodes merged into few mesh buffers
+IMeshSceneNode *CSceneManager::addStaticBatchSceneNode(const std::vector<IMeshSceneNode *> &nodes,
+		ISceneNode *parent, s32 id)
+{
+	if (!parent)
+		parent = this;
+
+	const bool allow32BitIndices = Driver && Driver->queryFeature(video::EVDF_32BIT_INDICES);
+	IMeshSceneNode *node = new CStaticBatchSceneNode(nodes, allow32BitIndices, parent, this, id);
+	node->drop();
+
+	return node;
+}
+
+//! adds a scene node for rendering a dense static mesh, culled in small clusters
+IMeshSceneNode *CSceneManager::addClusteredMeshSceneNode(IMesh *mesh, ISceneNode *parent, s32 id,
+		const core::vector3df &position, const core::vector3df &rotation,
+		const core::vector3df &scale, u32 maxVertices, u32 maxTriangles)
+{
+	if (!mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	IMeshSceneNode *node = new CClusteredMeshSceneNode(mesh, maxVertices, maxTriangles,
+			parent, this, id, position, rotation, scale);
+	node->drop();
+
+	return node;
+}
+
 //! adds a scene node for rendering an animated mesh model
 AnimatedMeshSceneNode *CSceneManager::addAnimatedMeshSceneNode(IAnimatedMesh *mesh, ISceneNode *parent, s32 id,
 		const core::vector3df &position, const core::vector3df &rotation,
@@ -321,7 +360,7 @@ bool CSceneManager::isCulled(const ISceneNode *node) const
 	// can be seen by a bounding box ?
 	if (!result && (node->getAutomaticCulling() & scene::EAC_BOX)) {
 		core::aabbox3d<f32> tbox = node->getBoundingBox();
-		node->getAbsoluteTransformation().transformBoxEx(tbox);
+		core::transformBoxes(node->getAbsoluteTransformation(), &tbox, &tbox, 1);
 		result = !(tbox.intersectsWithBox(cam->getViewFrustum()->getBoundingBox()));
 	}
 
@@ -469,6 +508,9 @@ void CSceneManager::drawAll()
 	// do animations and other stuff.
 	OnAnimate(os::Timer::getTime());
 
+	if (TransformHierarchy)
+		TransformHierarchy->update(this);
+
 	/*!
 		First Scene Node for prerendering should be the active camera
 		consistent Camera is needed for culling
@@ -589,6 +631,16 @@ IMeshLoader *CSceneManager::getMeshLoader(u32 index) const
 		return 0;
 }
 
+//! Creates a mesh writer of the given type
+IMeshWriter *CSceneManager::createMeshWriter(EMESH_WRITER_TYPE type)
+{
+	switch (type) {
+	case EMWT_MESH_CACHE:
+		return new CMeshCacheWriter();
+	}
+	return 0;
+}
+
 //! Returns a pointer to the scene collision manager.
 ISceneCollisionManager *CSceneManager::getSceneCollisionManager()
 {
@@ -728,6 +780,29 @@ void CSceneManager::removeAll()
 		Driver->setMaterial(video::SMaterial());
 }
 
+void CSceneManager::setTransformHierarchyEnabled(bool enable, u32 threads)
+{
+	if (TransformHierarchy) {
+		TransformHierarchy->clear(this);
+		TransformHierarchy.reset();
+	}
+	if (enable) {
+		TransformHierarchy = std::make_unique<CTransformHierarchy>(threads);
+		TransformHierarchy->update(this);
+	}
+}
+
+bool CSceneManager::isTransformHierarchyEnabled() const
+{
+	return TransformHierarchy != nullptr;
+}
+
+void CSceneManager::OnTransformHierarchyChanged()
+{
+	if (TransformHierarchy)
+		TransformHierarchy->invalidate();
+}
+
 //! Clears the whole scene. All scene nodes are removed.
 void CSceneManager::clear()
 {
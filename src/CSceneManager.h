@@ -12,6 +12,8 @@
 #include "irrArray.h"
 #include "IMeshLoader.h"
 
+#include <memory>
+
 namespace irr
 {
 namespace io
@@ -23,6 +25,7 @@ namespace scene
 class IMeshCache;
 
 class SkinnedMesh;
+class CTransformHierarchy;
 
 /*!
 	The Scene Manager manages scene nodes, mesh resources, cameras and all the other stuff.
@@ -60,6 +63,17 @@ public:
 			const core::vector3df &scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero = false) override;
 
+	//! adds a scene node drawing static mesh scene nodes merged into few mesh buffers
+	IMeshSceneNode *addStaticBatchSceneNode(const std::vector<IMeshSceneNode *> &nodes,
+			ISceneNode *parent = 0, s32 id = -1) override;
+
+	//! adds a scene node for rendering a dense static mesh, culled in small clusters
+	IMeshSceneNode *addClusteredMeshSceneNode(IMesh *mesh, ISceneNode *parent = 0, s32 id = -1,
+			const core::vector3df &position = core::vector3df(0, 0, 0),
+			const core::vector3df &rotation = core::vector3df(0, 0, 0),
+			const core::vector3df &scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			u32 maxVertices = 64, u32 maxTriangles = 124) override;
+
 	//! renders the node.
 	void render() override;
 
@@ -126,6 +140,9 @@ public:
 	//! Retrieve the given mesh loader
 	IMeshLoader *getMeshLoader(u32 index) const override;
 
+	//! Creates a mesh writer of the given type
+	IMeshWriter *createMeshWriter(EMESH_WRITER_TYPE type) override;
+
 	//! Returns a pointer to the scene collision manager.
 	ISceneCollisionManager *getSceneCollisionManager() override;
 
@@ -183,6 +200,15 @@ public:
 	//! returns if node is culled
 	bool isCulled(const ISceneNode *node) const override;
 
+	//! Sets whether the absolute transformations are updated in one pass over flat arrays
+	void setTransformHierarchyEnabled(bool enable, u32 threads = 1) override;
+
+	//! Returns whether the absolute transformations are updated in one pass
+	bool isTransformHierarchyEnabled() const override;
+
+protected:
+	void OnTransformHierarchyChanged() override;
+
 private:
 	// load and create a mesh which we know already isn't in the cache and put it in there
 	IAnimatedMesh *getUncachedMesh(io::IReadFile *file, const io::path &filename, const io::path &cachename);
@@ -268,6 +294,9 @@ private:
 	//! Global debug render state
 	u16 DebugDataMask = 0, DebugDataBits = 0;
 
+	//! Set if the absolute transformations are updated in one pass
+	std::unique_ptr<CTransformHierarchy> TransformHierarchy;
+
 	E_SCENE_NODE_RENDER_PASS CurrentRenderPass;
 };
 
@@ -0,0 +1,268 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CStaticBatchSceneNode.h"
+#include "CMeshBuffer.h"
+#include "ICameraSceneNode.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "SViewFrustum.h"
+#include "os.h"
+
+#include <type_traits>
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+//! Mesh buffers of the source nodes which are merged into one
+struct SBatchGroup
+{
+	video::SMaterial Material;
+	video::E_VERTEX_TYPE VertexType;
+	std::vector<video::S3DVertex> Standard;
+	std::vector<video::S3DVertex2TCoords> TwoTCoords;
+	std::vector<video::S3DVertexTangents> Tangents;
+	std::vector<u32> Indices;
+	std::vector<CStaticBatchSceneNode::SPart> Parts;
+	u32 VertexCount = 0;
+};
+
+template <class T>
+void appendVertices(std::vector<T> &dst, const IMeshBuffer *mb,
+		const core::matrix4 &world, const core::matrix4 &normalMatrix)
+{
+	const auto *src = static_cast<const T *>(mb->getVertices());
+	const size_t first = dst.size();
+	dst.insert(dst.end(), src, src + mb->getVertexCount());
+	T *v = dst.data() + first;
+	const u32 count = mb->getVertexCount();
+	world.transformVectArray(&v->Pos, &v->Pos, count, sizeof(T));
+	normalMatrix.rotateAndScaleVectArray(&v->Normal, &v->Normal, count, sizeof(T));
+	if constexpr (std::is_same_v<T, video::S3DVertexTangents>) {
+		world.rotateAndScaleVectArray(&v->Tangent, &v->Tangent, count, sizeof(T));
+		world.rotateAndScaleVectArray(&v->Binormal, &v->Binormal, count, sizeof(T));
+	}
+	for (u32 i = 0; i < count; ++i) {
+		v[i].Normal.normalize();
+		if constexpr (std::is_same_v<T, video::S3DVertexTangents>) {
+			v[i].Tangent.normalize();
+			v[i].Binormal.normalize();
+		}
+	}
+}
+
+//! Whether all of a node can be drawn by the batch
+/** The node is hidden once merged, which would also hide its children and
+the mesh buffers which cannot be merged: lines, points and skinned ones. */
+bool canMerge(const IMeshSceneNode *node, const IMesh *mesh)
+{
+	if (!node->getChildren().empty())
+		return false;
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i) {
+		const IMeshBuffer *mb = mesh->getMeshBuffer(i);
+		if (mb->getPrimitiveType() != EPT_TRIANGLES || mb->getVertexBuffer()->getWeightBuffer())
+			return false;
+	}
+	return true;
+}
+
+//! Whether a box is completely on the outer side of one of the planes
+bool isOutside(const SViewFrustum &frustum, const core::aabbox3df &box)
+{
+	for (u32 i = 0; i < SViewFrustum::VF_PLANE_COUNT; ++i) {
+		const core::plane3df &plane = frustum.planes[i];
+		// the corner furthest on the inner side
+		const core::vector3df corner(
+				plane.Normal.X >= 0.f ? box.MinEdge.X : box.MaxEdge.X,
+				plane.Normal.Y >= 0.f ? box.MinEdge.Y : box.MaxEdge.Y,
+				plane.Normal.Z >= 0.f ? box.MinEdge.Z : box.MaxEdge.Z);
+		if (plane.classifyPointRelation(corner) == core::ISREL3D_FRONT)
+			return true;
+	}
+	return false;
+}
+
+} // end anonymous namespace
+
+//! constructor
+CStaticBatchSceneNode::CStaticBatchSceneNode(const std::vector<IMeshSceneNode *> &nodes,
+		bool allow32BitIndices, ISceneNode *parent, ISceneManager *mgr, s32 id) :
+		CMeshSceneNode(0, parent, mgr, id),
+		VisibleParts(0)
+{
+	SMesh *batch = createBatch(nodes, allow32BitIndices, Parts);
+	setMesh(batch);
+	batch->drop();
+}
+
+SMesh *CStaticBatchSceneNode::createBatch(const std::vector<IMeshSceneNode *> &nodes,
+		bool allow32BitIndices, std::vector<std::vector<SPart>> &parts)
+{
+	const u64 maxVertices = allow32BitIndices ? 0xFFFFFFFFu : 65536;
+
+	std::vector<SBatchGroup> groups;
+	std::vector<IMeshSceneNode *> merged;
+	for (IMeshSceneNode *node : nodes) {
+		IMesh *mesh = node ? node->getMesh() : 0;
+		if (!mesh)
+			continue;
+		if (!canMerge(node, mesh)) {
+			os::Printer::log("Static batch: left out a node with children, lines, points or skinned mesh buffers",
+					ELL_WARNING);
+			continue;
+		}
+		merged.push_back(node);
+
+		node->updateAbsolutePosition();
+		const core::matrix4 &world = node->getAbsoluteTransformation();
+		core::matrix4 normalMatrix;
+		world.getInverse(normalMatrix);
+		normalMatrix = normalMatrix.getTransposed();
+
+		for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i) {
+			const IMeshBuffer *mb = mesh->getMeshBuffer(i);
+			if (mb->getIndexCount() == 0)
+				continue;
+
+			// the node may override the materials of the mesh
+			const video::SMaterial &material = node->getMaterial(i);
+			size_t g = 0;
+			for (; g < groups.size(); ++g) {
+				const SBatchGroup &group = groups[g];
+				if (group.VertexType == mb->getVertexType() &&
+						group.VertexCount + mb->getVertexCount() <= maxVertices &&
+						group.Material == material)
+					break;
+			}
+			if (g == groups.size()) {
+				groups.emplace_back();
+				groups.back().Material = material;
+				groups.back().VertexType = mb->getVertexType();
+			}
+			SBatchGroup &group = groups[g];
+
+			switch (mb->getVertexType()) {
+			case video::EVT_STANDARD:
+				appendVertices(group.Standard, mb, world, normalMatrix);
+				break;
+			case video::EVT_2TCOORDS:
+				appendVertices(group.TwoTCoords, mb, world, normalMatrix);
+				break;
+			case video::EVT_TANGENTS:
+				appendVertices(group.Tangents, mb, world, normalMatrix);
+				break;
+			}
+
+			SPart part{(u32)group.Indices.size(), mb->getIndexCount(), mb->getBoundingBox()};
+			world.transformBoxEx(part.Box);
+			group.Parts.push_back(part);
+
+			const IIndexBuffer *ib = mb->getIndexBuffer();
+			for (u32 j = 0; j < ib->getCount(); ++j)
+				group.Indices.push_back(ib->getIndex(j) + group.VertexCount);
+			group.VertexCount += mb->getVertexCount();
+		}
+	}
+
+	SMesh *batch = new SMesh();
+	for (SBatchGroup &group : groups) {
+		IMeshBuffer *buffer = 0;
+		switch (group.VertexType) {
+		case video::EVT_STANDARD:
+			buffer = createMeshBuffer(std::move(group.Standard), std::move(group.Indices));
+			break;
+		case video::EVT_2TCOORDS:
+			buffer = createMeshBuffer(std::move(group.TwoTCoords), std::move(group.Indices));
+			break;
+		case video::EVT_TANGENTS:
+			buffer = createMeshBuffer(std::move(group.Tangents), std::move(group.Indices));
+			break;
+		}
+		buffer->getMaterial() = group.Material;
+		buffer->setHardwareMappingHint(EHM_STATIC);
+		buffer->recalculateBoundingBox();
+		batch->addMeshBuffer(buffer);
+		buffer->drop();
+		parts.push_back(std::move(group.Parts));
+	}
+	batch->recalculateBoundingBox();
+
+	for (IMeshSceneNode *node : merged)
+		node->setVisible(false);
+	return batch;
+}
+
+void CStaticBatchSceneNode::OnRegisterSceneNode()
+{
+	VisibleParts = 0;
+	CMeshSceneNode::OnRegisterSceneNode();
+}
+
+//! renders the visible parts
+void CStaticBatchSceneNode::render()
+{
+	video::IVideoDriver *driver = SceneManager->getVideoDriver();
+
+	if (!Mesh || !driver)
+		return;
+
+	const bool isTransparentPass =
+			SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	// the parts are culled in the space of the node
+	const ICameraSceneNode *camera = SceneManager->getActiveCamera();
+	SViewFrustum frustum;
+	if (camera) {
+		frustum = *camera->getViewFrustum();
+		core::matrix4 invTrans(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE);
+		frustum.transform(invTrans);
+	}
+
+	for (u32 i = 0; i < Mesh->getMeshBufferCount(); ++i) {
+		const IMeshBuffer *mb = Mesh->getMeshBuffer(i);
+		const video::SMaterial &material = SharedMaterials ? mb->getMaterial() : Materials[i];
+		if (driver->needsTransparentRenderPass(material) != isTransparentPass)
+			continue;
+
+		driver->setMaterial(material);
+
+		// neighbouring visible parts are drawn together
+		u32 first = 0, count = 0;
+		for (const SPart &part : Parts[i]) {
+			if (camera && isOutside(frustum, part.Box))
+				continue;
+			++VisibleParts;
+			if (count && first + count == part.FirstIndex) {
+				count += part.IndexCount;
+				continue;
+			}
+			if (count)
+				driver->drawBufferRange(mb->getVertexBuffer(), mb->getIndexBuffer(), first, count / 3);
+			first = part.FirstIndex;
+			count = part.IndexCount;
+		}
+		if (count)
+			driver->drawBufferRange(mb->getVertexBuffer(), mb->getIndexBuffer(), first, count / 3);
+	}
+
+	if (DebugDataVisible & scene::EDS_BBOX_BUFFERS) {
+		video::SMaterial m;
+		m.AntiAliasing = video::EAAM_OFF;
+		m.ZBuffer = video::ECFN_DISABLED;
+		driver->setMaterial(m);
+		for (const auto &bufferParts : Parts) {
+			for (const SPart &part : bufferParts)
+				driver->draw3DBox(part.Box, video::SColor(255, 190, 128, 128));
+		}
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
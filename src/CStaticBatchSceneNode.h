@@ -0,0 +1,60 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "CMeshSceneNode.h"
+#include "SMesh.h"
+
+#include <vector>
+
+namespace irr
+{
+namespace scene
+{
+
+//! Draws static mesh scene nodes merged into few large mesh buffers
+/** The vertices of the nodes are transformed into world space and joined
+per material. Each node keeps its range of indices and bounding box, so
+parts outside of the view frustum are skipped, neighbouring visible parts
+are drawn with one call. */
+class CStaticBatchSceneNode : public CMeshSceneNode
+{
+public:
+	//! Part of a merged mesh buffer coming from one buffer of a source node
+	struct SPart
+	{
+		u32 FirstIndex;
+		u32 IndexCount;
+		//! World space bounding box
+		core::aabbox3df Box;
+	};
+
+	//! constructor, hides the nodes it merges
+	/** Nodes with children or with mesh buffers which cannot be merged are
+	left out and stay visible. */
+	CStaticBatchSceneNode(const std::vector<IMeshSceneNode *> &nodes, bool allow32BitIndices,
+			ISceneNode *parent, ISceneManager *mgr, s32 id);
+
+	//! renders the visible parts
+	void render() override;
+
+	//! Get the parts of a merged mesh buffer
+	const std::vector<SPart> &getParts(u32 buffer) const { return Parts[buffer]; }
+
+	//! Number of parts drawn by the last render() calls of this frame
+	u32 getVisiblePartCount() const { return VisibleParts; }
+
+	void OnRegisterSceneNode() override;
+
+private:
+	static SMesh *createBatch(const std::vector<IMeshSceneNode *> &nodes, bool allow32BitIndices,
+			std::vector<std::vector<SPart>> &parts);
+
+	//! Parts of each mesh buffer, sorted by their first index
+	std::vector<std::vector<SPart>> Parts;
+	u32 VisibleParts;
+};
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,180 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTransformHierarchy.h"
+
+#include <system_error>
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+//! Levels with less nodes than this per thread are updated on the calling thread
+const u32 MIN_NODES_PER_THREAD = 4096;
+
+} // end anonymous namespace
+
+CTransformHierarchy::CTransformHierarchy(u32 threads)
+{
+	if (!threads)
+		threads = core::max_(std::thread::hardware_concurrency(), 1U);
+
+	for (u32 part = 1; part < threads; ++part) {
+		try {
+			Workers.emplace_back(&CTransformHierarchy::work, this, part);
+		} catch (const std::system_error &) {
+			break; // the levels are split between the threads which started
+		}
+	}
+}
+
+CTransformHierarchy::~CTransformHierarchy()
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Stopping = true;
+	}
+	LevelReady.notify_all();
+	for (auto &worker : Workers)
+		worker.join();
+}
+
+void CTransformHierarchy::rebuild(ISceneNode *root)
+{
+	Nodes.clear();
+	Parents.clear();
+	LevelStarts.clear();
+
+	Nodes.push_back(root);
+	Parents.push_back(-1);
+	u32 levelStart = 0;
+	while (levelStart < Nodes.size()) {
+		LevelStarts.push_back(levelStart);
+		const u32 levelEnd = (u32)Nodes.size();
+		for (u32 i = levelStart; i < levelEnd; ++i) {
+			for (auto *child : Nodes[i]->getChildren()) {
+				Nodes.push_back(child);
+				Parents.push_back((s32)i);
+			}
+		}
+		levelStart = levelEnd;
+	}
+	LevelStarts.push_back((u32)Nodes.size());
+
+	Absolute.resize(Nodes.size());
+	Relative.resize(Nodes.size());
+	RelativeDirty.assign(Nodes.size(), 0);
+	Dirty.resize(Nodes.size());
+	for (u32 i = 0; i < Nodes.size(); ++i)
+		Nodes[i]->TransformDirty = &RelativeDirty[i];
+	Changed = false;
+	UpdateAll = true;
+}
+
+void CTransformHierarchy::update(ISceneNode *root)
+{
+	if (Changed)
+		rebuild(root);
+
+	for (u32 level = 0; level + 1 < LevelStarts.size(); ++level) {
+		const u32 begin = LevelStarts[level];
+		const u32 end = LevelStarts[level + 1];
+		if (!Workers.empty() && end - begin >= 2 * MIN_NODES_PER_THREAD)
+			updateLevel(begin, end);
+		else
+			updateRange(begin, end);
+	}
+	UpdateAll = false;
+}
+
+void CTransformHierarchy::getPart(u32 part, u32 &begin, u32 &end) const
+{
+	const u64 count = LevelEnd - LevelBegin;
+	const u64 parts = Workers.size() + 1;
+	begin = LevelBegin + (u32)(count * part / parts);
+	end = LevelBegin + (u32)(count * (part + 1) / parts);
+}
+
+void CTransformHierarchy::updateLevel(u32 begin, u32 end)
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		LevelBegin = begin;
+		LevelEnd = end;
+		++LevelNumber;
+		Pending = (u32)Workers.size();
+	}
+	LevelReady.notify_all();
+
+	u32 partBegin, partEnd;
+	getPart(0, partBegin, partEnd);
+	updateRange(partBegin, partEnd);
+
+	// the next level reads the results of this one
+	std::unique_lock<std::mutex> lock(Mutex);
+	LevelDone.wait(lock, [this] { return Pending == 0; });
+}
+
+void CTransformHierarchy::work(u32 part)
+{
+	u32 done = 0;
+	std::unique_lock<std::mutex> lock(Mutex);
+	for (;;) {
+		LevelReady.wait(lock, [this, done] { return Stopping || LevelNumber != done; });
+		if (Stopping)
+			return;
+		done = LevelNumber;
+
+		u32 begin, end;
+		getPart(part, begin, end);
+		lock.unlock();
+		updateRange(begin, end);
+		lock.lock();
+
+		if (--Pending == 0)
+			LevelDone.notify_one();
+	}
+}
+
+void CTransformHierarchy::updateRange(u32 begin, u32 end)
+{
+	for (u32 i = begin; i < end; ++i) {
+		const s32 parent = Parents[i];
+		const bool dirty = UpdateAll || RelativeDirty[i] || (parent >= 0 && Dirty[parent]);
+		Dirty[i] = dirty;
+		if (!dirty)
+			continue;
+
+		// clean nodes are not touched, as reading them is slower than the product
+		ISceneNode *node = Nodes[i];
+		if (UpdateAll || RelativeDirty[i]) {
+			RelativeDirty[i] = 0;
+			Relative[i] = node->getRelativeTransformation();
+		}
+		if (parent >= 0)
+			Absolute[i].setbyproduct_nocheck(Absolute[parent], Relative[i]);
+		else
+			Absolute[i] = Relative[i];
+		node->AbsoluteTransformation = Absolute[i];
+	}
+}
+
+void CTransformHierarchy::clear(ISceneNode *root)
+{
+	ISceneNode::leaveTransformHierarchy(root);
+	Nodes.clear();
+	Parents.clear();
+	Absolute.clear();
+	Relative.clear();
+	RelativeDirty.clear();
+	Dirty.clear();
+	LevelStarts.clear();
+	Changed = true;
+}
+
+} // end namespace scene
+} // end namespace irr
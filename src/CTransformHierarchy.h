@@ -0,0 +1,97 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "ISceneNode.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace irr
+{
+namespace scene
+{
+
+//! Absolute transformations of a scene graph, updated in one pass over flat arrays.
+/** The nodes are stored level by level, so every parent comes before its
+children and the nodes of one level do not depend on each other. Each
+node points to its flag in RelativeDirty, which it sets when its relative
+transformation changes. An update only reads these flags for the other
+nodes, and multiplies the flagged nodes and the nodes below them. The
+relative transformations are kept too and only asked from flagged nodes,
+so moving a parent does not recalculate the matrices of its children.
+The results are written back to the nodes, as many of them read their
+AbsoluteTransformation member directly.
+Large levels are split between the calling thread and workers, which are
+started once and wait for the next level between updates. */
+class CTransformHierarchy
+{
+public:
+	//! \param threads Number of threads updating large levels, including
+	//! the calling one, 0 for one per CPU core.
+	CTransformHierarchy(u32 threads);
+
+	//! Stops the workers
+	~CTransformHierarchy();
+
+	//! Makes the next update rebuild the arrays from the scene graph
+	void invalidate() { Changed = true; }
+
+	//! Updates the absolute transformations of root and all nodes below it
+	void update(ISceneNode *root);
+
+	//! Takes all nodes out of the hierarchy
+	void clear(ISceneNode *root);
+
+private:
+	void rebuild(ISceneNode *root);
+	void updateRange(u32 begin, u32 end);
+
+	//! Updates a level on the calling thread and the workers
+	void updateLevel(u32 begin, u32 end);
+
+	//! Waits for levels and updates its part of them, until stopped
+	void work(u32 part);
+
+	//! Range of part i of the level given to the workers, part 0 is the calling thread's
+	void getPart(u32 part, u32 &begin, u32 &end) const;
+
+	//! Nodes level by level, the root first
+	std::vector<ISceneNode *> Nodes;
+	//! Index of the parent of each node, -1 for the root
+	std::vector<s32> Parents;
+	std::vector<core::matrix4> Absolute;
+	//! Relative transformation of each node, from when it was flagged last
+	std::vector<core::matrix4> Relative;
+	//! Set by the nodes when their relative transformation changed
+	std::vector<u8> RelativeDirty;
+	//! Whether the absolute transformation of a node changed in this update
+	std::vector<u8> Dirty;
+	//! Level i holds the nodes from LevelStarts[i] to LevelStarts[i + 1]
+	std::vector<u32> LevelStarts;
+
+	std::vector<std::thread> Workers;
+	std::mutex Mutex;
+	//! Signals the workers a new level or stopping
+	std::condition_variable LevelReady;
+	//! Signals the calling thread that all workers finished the level
+	std::condition_variable LevelDone;
+	//! The level being updated
+	u32 LevelBegin = 0;
+	u32 LevelEnd = 0;
+	//! Counts the levels given to the workers, so each takes every level once
+	u32 LevelNumber = 0;
+	//! Workers which did not finish the current level yet
+	u32 Pending = 0;
+	bool Stopping = false;
+
+	bool Changed = true;
+	//! Set after rebuilding, to multiply all nodes once
+	bool UpdateAll = true;
+};
+
+} // end namespace scene
+} // end namespace irr
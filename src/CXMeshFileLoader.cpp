@@ -10,6 +10,7 @@
 #include "ISceneManager.h"
 #include "IVideoDriver.h"
 #include "IReadFile.h"
+#include "fast_atof.h"
 
 #ifdef _DEBUG
 #define _XREADER_DEBUG
@@ -215,16 +216,20 @@ bool CXMeshFileLoader::load(io::IReadFile *file)
 			memset(vCountArray, 0, mesh->Buffers.size() * sizeof(u32));
 			for (i = 0; i < mesh->FaceMaterialIndices.size(); ++i)
 				++vCountArray[mesh->FaceMaterialIndices[i]];
+			std::vector<std::vector<u32>> bufferIndices(mesh->Buffers.size());
 			for (i = 0; i != mesh->Buffers.size(); ++i)
-				mesh->Buffers[i]->Indices->Data.reserve(vCountArray[i]);
+				bufferIndices[i].reserve(vCountArray[i] * 3);
 			delete[] vCountArray;
 			// create indices per buffer
 			for (i = 0; i < mesh->FaceMaterialIndices.size(); ++i) {
-				scene::SSkinMeshBuffer *buffer = mesh->Buffers[mesh->FaceMaterialIndices[i]];
+				auto &indices = bufferIndices[mesh->FaceMaterialIndices[i]];
 				for (u32 id = i * 3 + 0; id != i * 3 + 3; ++id) {
-					buffer->Indices->Data.push_back(verticesLinkIndex[mesh->Indices[id]]);
+					indices.push_back(verticesLinkIndex[mesh->Indices[id]]);
 				}
 			}
+			// the index type depends on the vertex count of each buffer
+			for (i = 0; i != mesh->Buffers.size(); ++i)
+				mesh->Buffers[i]->setIndices(std::move(bufferIndices[i]));
 		}
 
 		for (const auto &weight : mesh->Weights) {
@@ -324,14 +329,14 @@ bool CXMeshFileLoader::parseFile()
 //! Parses the next Data object in the file
 bool CXMeshFileLoader::parseDataObject()
 {
-	core::stringc objectName = getNextToken();
+	std::string_view objectName = getNextToken();
 
 	if (objectName.size() == 0)
 		return false;
 
 		// parse specific object
 #ifdef _XREADER_DEBUG
-	os::Printer::log("debug DataObject", objectName.c_str(), ELL_DEBUG);
+	os::Printer::log("debug DataObject", std::string(objectName).c_str(), ELL_DEBUG);
 #endif
 
 	if (objectName == "template")
@@ -359,7 +364,7 @@ bool CXMeshFileLoader::parseDataObject()
 		return true;
 	}
 
-	os::Printer::log("Unknown data object in animation of .x file", objectName.c_str(), ELL_WARNING);
+	os::Printer::log("Unknown data object in animation of .x file", std::string(objectName).c_str(), ELL_WARNING);
 
 	return parseUnknownDataObject();
 }
@@ -385,7 +390,7 @@ bool CXMeshFileLoader::parseDataObjectTemplate()
 
 	// read and ignore data members
 	while (true) {
-		core::stringc s = getNextToken();
+		std::string_view s = getNextToken();
 
 		if (s == "}")
 			break;
@@ -447,10 +452,10 @@ bool CXMeshFileLoader::parseDataObjectFrame(SkinnedMesh::SJoint *Parent)
 	// read tokens until closing brace is reached.
 
 	while (true) {
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in frame:", objectName.c_str(), ELL_DEBUG);
+		os::Printer::log("debug DataObject in frame:", std::string(objectName).c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName.size() == 0) {
@@ -483,7 +488,7 @@ bool CXMeshFileLoader::parseDataObjectFrame(SkinnedMesh::SJoint *Parent)
 			if (!parseDataObjectMesh(*mesh))
 				return false;
 		} else {
-			os::Printer::log("Unknown data object in frame in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in frame in x file", std::string(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -611,7 +616,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 	// here, other data objects may follow
 
 	while (true) {
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 		if (objectName.size() == 0) {
 			os::Printer::log("Unexpected ending found in Mesh in x file.", ELL_WARNING);
@@ -622,7 +627,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in mesh", objectName.c_str(), ELL_DEBUG);
+		os::Printer::log("debug DataObject in mesh", std::string(objectName).c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName == "MeshNormals") {
@@ -823,7 +828,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			if (!parseDataObjectSkinWeights(mesh))
 				return false;
 		} else {
-			os::Printer::log("Unknown data object in mesh in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in mesh in x file", std::string(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1146,7 +1151,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 	// read following data objects
 
 	while (true) {
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 		if (objectName.size() == 0) {
 			os::Printer::log("Unexpected ending found in Mesh Material list in .x file.", ELL_WARNING);
@@ -1166,7 +1171,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 		} else if (objectName == ";") {
 			// ignore
 		} else {
-			os::Printer::log("Unknown data object in material list in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in material list in x file", std::string(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1190,7 +1195,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 	os::Printer::log("Reading animationset ", AnimationName, ELL_DEBUG);
 
 	while (true) {
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 		if (objectName.size() == 0) {
 			os::Printer::log("Unexpected ending found in Animation set in x file.", ELL_WARNING);
@@ -1202,7 +1207,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 			if (!parseDataObjectAnimation())
 				return false;
 		} else {
-			os::Printer::log("Unknown data object in animation set in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation set in x file", std::string(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1258,7 +1263,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 	core::stringc FrameName;
 
 	while (true) {
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 		if (objectName.size() == 0) {
 			os::Printer::log("Unexpected ending found in Animation in x file.", ELL_WARNING);
@@ -1275,7 +1280,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 				return false;
 		} else if (objectName == "{") {
 			// read frame name
-			FrameName = getNextToken();
+			FrameName = std::string(getNextToken());
 
 			if (!checkForClosingBrace()) {
 				os::Printer::log("Unexpected ending found in Animation in x file.", ELL_WARNING);
@@ -1283,7 +1288,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 				SET_ERR_AND_RETURN();
 			}
 		} else {
-			os::Printer::log("Unknown data object in animation in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation in x file", std::string(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				SET_ERR_AND_RETURN();
 		}
@@ -1485,7 +1490,7 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 {
 	// find opening delimiter
 	while (true) {
-		core::stringc t = getNextToken();
+		std::string_view t = getNextToken();
 
 		if (t.size() == 0)
 			return false;
@@ -1499,7 +1504,7 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 	// parse until closing delimiter
 
 	while (counter) {
-		core::stringc t = getNextToken();
+		std::string_view t = getNextToken();
 
 		if (t.size() == 0)
 			return false;
@@ -1554,10 +1559,10 @@ bool CXMeshFileLoader::checkForTwoFollowingSemicolons()
 //! if there is one
 bool CXMeshFileLoader::readHeadOfDataObject(core::stringc *outname)
 {
-	core::stringc nameOrBrace = getNextToken();
+	std::string_view nameOrBrace = getNextToken();
 	if (nameOrBrace != "{") {
 		if (outname)
-			(*outname) = nameOrBrace;
+			(*outname) = std::string(nameOrBrace);
 
 		if (getNextToken() != "{")
 			return false;
@@ -1567,9 +1572,9 @@ bool CXMeshFileLoader::readHeadOfDataObject(core::stringc *outname)
 }
 
 //! returns next parseable token. Returns empty string if no token there
-core::stringc CXMeshFileLoader::getNextToken()
+std::string_view CXMeshFileLoader::getNextToken()
 {
-	core::stringc s;
+	std::string_view s;
 
 	// process binary-formatted file
 	if (BinaryFormat) {
@@ -1584,13 +1589,13 @@ core::stringc CXMeshFileLoader::getNextToken()
 		case 1:
 			// name token
 			len = readBinDWord();
-			s = core::stringc(P, len);
+			s = std::string_view(P, len);
 			P += len;
 			return s;
 		case 2:
 			// string token
 			len = readBinDWord();
-			s = core::stringc(P, len);
+			s = std::string_view(P, len);
 			P += (len + 2);
 			return s;
 		case 3:
@@ -1668,18 +1673,18 @@ core::stringc CXMeshFileLoader::getNextToken()
 		if (P >= End)
 			return s;
 
-		while ((P < End) && !core::isspace(P[0])) {
-			// either keep token delimiters when already holding a token, or return if first valid char
-			if (P[0] == ';' || P[0] == '}' || P[0] == '{' || P[0] == ',') {
-				if (!s.size()) {
-					s.append(P[0]);
-					++P;
-				}
-				break; // stop for delimiter
-			}
-			s.append(P[0]);
+		const c8 *start = P;
+		// delimiters are tokens of their own
+		if (P[0] == ';' || P[0] == '}' || P[0] == '{' || P[0] == ',') {
 			++P;
+			return std::string_view(start, 1);
 		}
+
+		while ((P < End) && !core::isspace(P[0]) &&
+				P[0] != ';' && P[0] != '}' && P[0] != '{' && P[0] != ',')
+			++P;
+
+		s = std::string_view(start, P - start);
 	}
 	return s;
 }
@@ -1730,7 +1735,7 @@ void CXMeshFileLoader::findNextNoneWhiteSpace()
 bool CXMeshFileLoader::getNextTokenAsString(core::stringc &out)
 {
 	if (BinaryFormat) {
-		out = getNextToken();
+		out = std::string(getNextToken());
 		return true;
 	}
 	findNextNoneWhiteSpace();
@@ -1742,10 +1747,10 @@ bool CXMeshFileLoader::getNextTokenAsString(core::stringc &out)
 		return false;
 	++P;
 
-	while (P < End && P[0] != '"') {
-		out.append(P[0]);
+	const c8 *start = P;
+	while (P < End && P[0] != '"')
 		++P;
-	}
+	out.append(core::stringc(start, (u32)(P - start)));
 
 	if (P[1] != ';' || P[0] != '"')
 		return false;
@@ -1810,10 +1815,12 @@ u32 CXMeshFileLoader::readInt()
 		return readBinDWord();
 	} else {
 		findNextNoneWhiteSpaceNumber();
-		char *end = nullptr;
-		u32 itmp = strtoul(P, &end, 10);
-		P = end;
-		return itmp;
+		// like strtoul: the whole u32 range, negative numbers wrap around
+		const bool negative = (*P == '-');
+		if (negative || *P == '+')
+			++P;
+		const u32 value = core::strtoul10(P, &P);
+		return negative ? 0U - value : value;
 	}
 }
 
@@ -1851,9 +1858,8 @@ f32 CXMeshFileLoader::readFloat()
 		}
 	}
 	findNextNoneWhiteSpaceNumber();
-	char *end = nullptr;
-	f32 ftmp = (f32)strtod(P, &end);
-	P = end;
+	f32 ftmp;
+	P = core::fast_atof_move(P, ftmp);
 	return ftmp;
 }
 
@@ -8,6 +8,8 @@
 #include "irrString.h"
 #include "SkinnedMesh.h"
 
+#include <string_view>
+
 namespace irr
 {
 namespace io
@@ -127,7 +129,8 @@ private:
 	void findNextNoneWhiteSpaceNumber();
 
 	//! returns next parseable token. Returns empty string if no token there
-	core::stringc getNextToken();
+	/** The token points into the file buffer and stays valid while it is loaded. */
+	std::string_view getNextToken();
 
 	//! reads header of dataobject including the opening brace.
 	//! returns false if error happened, and writes name of object
@@ -15,6 +15,7 @@
 
 #include "HWBuffer.h"
 #include "WeightBuffer.h"
+#include "QuantizedVertexBuffer.h"
 #include "MaterialRenderer.h"
 #include "FixedPipelineRenderer.h"
 #include "Renderer2D.h"
@@ -67,6 +68,18 @@ static const VertexType vtStandard = {
 		},
 };
 
+// positions and normals are normalized integers, see QuantizedVertexBuffer
+static const VertexType vtQuantized = {
+		sizeof(scene::QuantizedVertexBuffer::Vertex),
+		{
+				{EVA_POSITION, 3, GL_UNSIGNED_SHORT, VertexAttribute::Mode::Normalized, offsetof(scene::QuantizedVertexBuffer::Vertex, pos)},
+				{EVA_NORMAL, 3, GL_BYTE, VertexAttribute::Mode::Normalized, offsetof(scene::QuantizedVertexBuffer::Vertex, normal)},
+				{EVA_COLOR, 4, GL_UNSIGNED_BYTE, VertexAttribute::Mode::Normalized, offsetof(scene::QuantizedVertexBuffer::Vertex, color)},
+				{EVA_TCOORD0, 2, GL_HALF_FLOAT, VertexAttribute::Mode::Regular, offsetof(scene::QuantizedVertexBuffer::Vertex, tcoords)},
+				{EVA_AUX, 1, GL_UNSIGNED_SHORT, VertexAttribute::Mode::Integer, offsetof(scene::QuantizedVertexBuffer::Vertex, aux)},
+		},
+};
+
 // FIXME: this is actually UB because these vertex classes are not "standard-layout"
 // they violate the following requirement:
 // - only one class in the hierarchy has non-static data members
@@ -155,6 +168,7 @@ COpenGL3DriverBase::COpenGL3DriverBase(const SIrrlichtCreationParameters &params
 		CNullDriver(io, params.WindowSize), COpenGL3ExtensionHandler(), CacheHandler(0),
 		Params(params), ResetRenderStates(true), LockRenderStateMode(false), AntiAlias(params.AntiAlias),
 		MaterialRenderer2DActive(0), MaterialRenderer2DTexture(0), MaterialRenderer2DNoTexture(0),
+		MaterialRenderer2DDistanceField(0),
 		CurrentRenderMode(ERM_NONE), Transformation3DChanged(true),
 		OGLES2ShaderPath(params.OGLES2ShaderPath),
 		ContextManager(contextManager), EnableErrorTest(params.DriverDebug)
@@ -189,6 +203,7 @@ COpenGL3DriverBase::~COpenGL3DriverBase()
 
 	delete MaterialRenderer2DTexture;
 	delete MaterialRenderer2DNoTexture;
+	delete MaterialRenderer2DDistanceField;
 	delete CacheHandler;
 
 	if (ContextManager) {
@@ -447,6 +462,15 @@ void COpenGL3DriverBase::createMaterialRenderers()
 	MaterialRenderer2DNoTexture = new COpenGL3Renderer2D(vs2DData, fs2DData, this, false);
 	delete[] vs2DData;
 	delete[] fs2DData;
+	vs2DData = 0;
+	fs2DData = 0;
+
+	// distance field fonts fall back to drawing images without it
+	loadShaderData(io::path("Renderer2D.vsh"), io::path("Renderer2D_distanceField.fsh"), &vs2DData, &fs2DData);
+	if (vs2DData && fs2DData)
+		MaterialRenderer2DDistanceField = new COpenGL3Renderer2DDistanceField(vs2DData, fs2DData, this);
+	delete[] vs2DData;
+	delete[] fs2DData;
 }
 
 bool COpenGL3DriverBase::setMaterialTexture(u32 layerIdx, const video::ITexture *texture)
@@ -574,8 +598,8 @@ void COpenGL3DriverBase::deleteHardwareBuffer(SHWBufferLink *HWBuffer)
 	CNullDriver::deleteHardwareBuffer(HWBuffer);
 }
 
-void COpenGL3DriverBase::drawBuffers(const scene::IVertexBuffer *vb,
-	const scene::IIndexBuffer *ib, u32 PrimitiveCount,
+void COpenGL3DriverBase::drawBufferRange(const scene::IVertexBuffer *vb,
+	const scene::IIndexBuffer *ib, u32 firstIndex, u32 PrimitiveCount,
 	scene::E_PRIMITIVE_TYPE PrimitiveType)
 {
 	if (!vb || !ib)
@@ -589,7 +613,15 @@ void COpenGL3DriverBase::drawBuffers(const scene::IVertexBuffer *vb,
 		assert(hw_weights->Vbo.exists());
 	}
 
-	auto *hwvert = static_cast<SHWBufferLink_opengl *>(getBufferLink(vb));
+	// the compact copy needs half float attributes and cannot be skinned
+	const scene::QuantizedVertexBuffer *quantized = vb->getQuantizedBuffer();
+	if (quantized && (hw_weights || Version.Major < 3 || !quantized->isCurrent(vb)))
+		quantized = nullptr;
+	const scene::HWBuffer *vertexSource = vb;
+	if (quantized)
+		vertexSource = quantized;
+
+	auto *hwvert = static_cast<SHWBufferLink_opengl *>(getBufferLink(vertexSource));
 	auto *hwidx = static_cast<SHWBufferLink_opengl *>(getBufferLink(ib));
 	updateHardwareBuffer(hwvert);
 	updateHardwareBuffer(hwidx);
@@ -607,22 +639,37 @@ void COpenGL3DriverBase::drawBuffers(const scene::IVertexBuffer *vb,
 		GL.BindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
-	const void *vertices = vb->getData();
+	const void *vertices = vertexSource->getData();
 	if (hwvert) {
 		assert(hwvert->Vbo.exists());
 		GL.BindBuffer(GL_ARRAY_BUFFER, hwvert->Vbo.getName());
 		vertices = nullptr;
 	}
 
-	const void *indexList = ib->getData();
+	// with a bound buffer, the pointer is an offset into it
+	const size_t indexOffset = (size_t)firstIndex * ib->getElementSize();
+	const void *indexList = static_cast<const u8 *>(ib->getData()) + indexOffset;
 	if (hwidx) {
 		assert(hwidx->Vbo.exists());
 		GL.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, hwidx->Vbo.getName());
-		indexList = nullptr;
+		indexList = reinterpret_cast<const void *>(indexOffset);
 	}
 
-	drawVertexPrimitiveList(vertices, vb->getCount(), indexList,
-		PrimitiveCount, vb->getType(), PrimitiveType, ib->getType());
+	if (quantized) {
+		// the positions are relative to a cube around the vertices
+		const core::matrix4 world = Matrices[ETS_WORLD];
+		setTransform(ETS_WORLD, world * quantized->getDequantizationMatrix());
+		if (PrimitiveCount && vb->getCount() && checkPrimitiveCount(PrimitiveCount)) {
+			CNullDriver::drawVertexPrimitiveList(vertices, vb->getCount(), indexList,
+				PrimitiveCount, vb->getType(), PrimitiveType, ib->getType());
+			setRenderStates3DMode();
+			drawGeneric(vertices, indexList, PrimitiveCount, vtQuantized, PrimitiveType, ib->getType());
+		}
+		setTransform(ETS_WORLD, world);
+	} else {
+		drawVertexPrimitiveList(vertices, vb->getCount(), indexList,
+			PrimitiveCount, vb->getType(), PrimitiveType, ib->getType());
+	}
 
 	if (hw_weights) {
 		GL.DisableVertexAttribArray(EVA_WEIGHTS);
@@ -681,7 +728,7 @@ void COpenGL3DriverBase::drawVertexPrimitiveList(const void *vertices, u32 verte
 
 	setRenderStates3DMode();
 
-	drawGeneric(vertices, indexList, primitiveCount, vType, pType, iType);
+	drawGeneric(vertices, indexList, primitiveCount, getVertexTypeDescription(vType), pType, iType);
 }
 
 //! draws a vertex primitive list in 2d
@@ -706,7 +753,7 @@ void COpenGL3DriverBase::draw2DVertexPrimitiveList(const void *vertices, u32 ver
 		Material.MaterialType == EMT_TRANSPARENT_ALPHA_CHANNEL
 	);
 
-	drawGeneric(vertices, indexList, primitiveCount, vType, pType, iType);
+	drawGeneric(vertices, indexList, primitiveCount, getVertexTypeDescription(vType), pType, iType);
 }
 
 void COpenGL3DriverBase::draw2DImage(const video::ITexture *texture, const core::position2d<s32> &destPos,
@@ -836,6 +883,46 @@ void COpenGL3DriverBase::draw2DImageBatch(const video::ITexture *texture,
 
 	setRenderStates2DMode(color.getAlpha() < 255, true, useAlphaChannelOfTexture);
 
+	drawQuadBatch2D(texture, &positions, 0, sourceRects, clipRect, color);
+}
+
+void COpenGL3DriverBase::draw2DDistanceFieldBatch(const video::ITexture *texture,
+		const core::array<core::rect<s32>> &destRects,
+		const core::array<core::rect<s32>> &sourceRects,
+		const core::rect<s32> *clipRect,
+		SColor color, f32 smoothing)
+{
+	if (!texture)
+		return;
+
+	if (!MaterialRenderer2DDistanceField || LockRenderStateMode) {
+		CNullDriver::draw2DDistanceFieldBatch(texture, destRects, sourceRects, clipRect, color, smoothing);
+		return;
+	}
+
+	chooseMaterial2D();
+	if (!setMaterialTexture(0, texture))
+		return;
+
+	setRenderStates2DMode(true, true, true, MaterialRenderer2DDistanceField);
+	MaterialRenderer2DDistanceField->setSmoothing(smoothing);
+
+	// the distance has to be interpolated between the texels
+	SMaterial filtered = OverrideMaterial2DEnabled ? OverrideMaterial2D : InitMaterial2D;
+	filtered.UseMipMaps = false;
+	filtered.TextureLayers[0].MinFilter = ETMINF_LINEAR_MIPMAP_NEAREST;
+	filtered.TextureLayers[0].MagFilter = ETMAGF_LINEAR;
+	setTextureRenderStates(filtered, false);
+
+	drawQuadBatch2D(texture, 0, &destRects, sourceRects, clipRect, color);
+}
+
+void COpenGL3DriverBase::drawQuadBatch2D(const video::ITexture *texture,
+		const core::array<core::position2d<s32>> *positions,
+		const core::array<core::rect<s32>> *destRects,
+		const core::array<core::rect<s32>> &sourceRects,
+		const core::rect<s32> *clipRect, SColor color)
+{
 	const core::dimension2d<u32> &renderTargetSize = getCurrentRenderTargetSize();
 
 	if (clipRect) {
@@ -847,10 +934,11 @@ void COpenGL3DriverBase::draw2DImageBatch(const video::ITexture *texture,
 				clipRect->getWidth(), clipRect->getHeight());
 	}
 
-	const u32 drawCount = core::min_<u32>(positions.size(), sourceRects.size());
+	const u32 drawCount = core::min_<u32>(positions ? positions->size() : destRects->size(), sourceRects.size());
 	assert(6 * drawCount * sizeof(u16) <= QuadIndexVBO.getSize()); // FIXME split the batch? or let it crash?
 
-	std::vector<S3DVertex> vtx;
+	std::vector<S3DVertex> &vtx = BatchVertices;
+	vtx.clear();
 	vtx.reserve(drawCount * 4);
 
 	// texcoords need to be flipped horizontally for RTTs
@@ -860,10 +948,7 @@ void COpenGL3DriverBase::draw2DImageBatch(const video::ITexture *texture,
 	const f32 invH = 1.f / static_cast<f32>(ss.Height);
 
 	for (u32 i = 0; i < drawCount; i++) {
-		const core::position2d<s32> targetPos = positions[i];
-		const core::rect<s32> sourceRect = sourceRects[i];
-
-		// now draw it.
+		const core::rect<s32> &sourceRect = sourceRects[i];
 
 		const core::rect<f32> tcoords(
 			sourceRect.UpperLeftCorner.X * invW,
@@ -871,7 +956,8 @@ void COpenGL3DriverBase::draw2DImageBatch(const video::ITexture *texture,
 			sourceRect.LowerRightCorner.X * invW,
 			(isRTT ? sourceRect.UpperLeftCorner.Y : sourceRect.LowerRightCorner.Y) * invH);
 
-		const core::rect<s32> poss(targetPos, sourceRect.getSize());
+		const core::rect<s32> poss = positions ?
+				core::rect<s32>((*positions)[i], sourceRect.getSize()) : (*destRects)[i];
 
 		f32 left  = (f32)poss.UpperLeftCorner.X;
 		f32 right = (f32)poss.LowerRightCorner.X;
@@ -989,9 +1075,8 @@ void COpenGL3DriverBase::drawElements(GLenum primitiveType, const VertexType &ve
 
 void COpenGL3DriverBase::drawGeneric(const void *vertices, const void *indexList,
 		u32 primitiveCount,
-		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+		const VertexType &vTypeDesc, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
 {
-	auto &vTypeDesc = getVertexTypeDescription(vType);
 	beginDraw(vTypeDesc, reinterpret_cast<uintptr_t>(vertices));
 	GLenum indexSize = 0;
 
@@ -1457,12 +1542,12 @@ GLint COpenGL3DriverBase::getTextureWrapMode(u8 clamp) const
 }
 
 //! sets the needed renderstates
-void COpenGL3DriverBase::setRenderStates2DMode(bool alpha, bool texture, bool alphaChannel)
+void COpenGL3DriverBase::setRenderStates2DMode(bool alpha, bool texture, bool alphaChannel, COpenGL3Renderer2D *renderer)
 {
 	if (LockRenderStateMode)
 		return;
 
-	COpenGL3Renderer2D *nextActiveRenderer = texture ? MaterialRenderer2DTexture : MaterialRenderer2DNoTexture;
+	COpenGL3Renderer2D *nextActiveRenderer = renderer ? renderer : texture ? MaterialRenderer2DTexture : MaterialRenderer2DNoTexture;
 
 	if (CurrentRenderMode != ERM_2D) {
 		// unset last 3d material
@@ -1487,7 +1572,9 @@ void COpenGL3DriverBase::setRenderStates2DMode(bool alpha, bool texture, bool al
 
 	if (alphaChannel || alpha) {
 		CacheHandler->setBlend(true);
-		CacheHandler->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		// a blend factor of the 2d material was set by setBasicRenderStates()
+		if (!IR(Material.BlendFactor))
+			CacheHandler->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		CacheHandler->setBlendEquation(GL_FUNC_ADD);
 	} else
 		CacheHandler->setBlend(false);
@@ -23,6 +23,7 @@ namespace video
 struct VertexType;
 
 class COpenGL3Renderer2D;
+class COpenGL3Renderer2DDistanceField;
 
 class COpenGL3DriverBase : public CNullDriver, public IMaterialRendererServices, public COpenGL3ExtensionHandler
 {
@@ -61,8 +62,8 @@ public:
 	//! Delete hardware buffer (only some drivers can)
 	void deleteHardwareBuffer(SHWBufferLink *HWBuffer) override;
 
-	void drawBuffers(const scene::IVertexBuffer *vb,
-		const scene::IIndexBuffer *ib, u32 primCount,
+	void drawBufferRange(const scene::IVertexBuffer *vb,
+		const scene::IIndexBuffer *ib, u32 firstIndex, u32 primCount,
 		scene::E_PRIMITIVE_TYPE pType = scene::EPT_TRIANGLES) override;
 
 	IRenderTarget *addRenderTarget() override;
@@ -109,6 +110,12 @@ public:
 			SColor color,
 			bool useAlphaChannelOfTexture) override;
 
+	void draw2DDistanceFieldBatch(const video::ITexture *texture,
+			const core::array<core::rect<s32>> &destRects,
+			const core::array<core::rect<s32>> &sourceRects,
+			const core::rect<s32> *clipRect,
+			SColor color, f32 smoothing) override;
+
 	//! draw an 2d rectangle
 	virtual void draw2DRectangle(SColor color, const core::rect<s32> &pos,
 			const core::rect<s32> *clip = 0) override;
@@ -263,7 +270,8 @@ protected:
 	void setRenderStates3DMode();
 
 	//! sets the needed renderstates
-	void setRenderStates2DMode(bool alpha, bool texture, bool alphaChannel);
+	/** \param renderer Used instead of the default one for textured or untextured drawing */
+	void setRenderStates2DMode(bool alpha, bool texture, bool alphaChannel, COpenGL3Renderer2D *renderer = 0);
 
 	//! Prevent setRenderStateMode calls to do anything.
 	// hack to allow drawing meshbuffers in 2D mode.
@@ -302,7 +310,7 @@ protected:
 	void drawElements(GLenum primitiveType, const VertexType &vertexType, const void *vertices, int vertexCount, const u16 *indices, int indexCount);
 
 	void drawGeneric(const void *vertices, const void *indexList, u32 primitiveCount,
-		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType);
+		const VertexType &vTypeDesc, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType);
 
 	void beginDraw(const VertexType &vertexType, uintptr_t verticesBase);
 	void endDraw(const VertexType &vertexType);
@@ -332,6 +340,8 @@ private:
 	COpenGL3Renderer2D *MaterialRenderer2DActive;
 	COpenGL3Renderer2D *MaterialRenderer2DTexture;
 	COpenGL3Renderer2D *MaterialRenderer2DNoTexture;
+	//! 0 if its shader is missing
+	COpenGL3Renderer2DDistanceField *MaterialRenderer2DDistanceField;
 
 	core::matrix4 Matrices[ETS_COUNT];
 
@@ -357,6 +367,16 @@ private:
 
 	OGLBufferObject QuadIndexVBO = OGLBufferObject(OGLBufferObject::TARGET_VBO);
 	void initQuadsIndices(u32 max_vertex_count = 65536);
+	//! vertices of drawQuadBatch2D(), kept so that drawing text does not allocate
+	std::vector<S3DVertex> BatchVertices;
+	//! Draws the batches of draw2DImageBatch() and draw2DDistanceFieldBatch()
+	/** The quads are at positions with the size of their source rects, or
+	at destRects if positions is 0. The 2d render states must be set. */
+	void drawQuadBatch2D(const video::ITexture *texture,
+			const core::array<core::position2d<s32>> *positions,
+			const core::array<core::rect<s32>> *destRects,
+			const core::array<core::rect<s32>> &sourceRects,
+			const core::rect<s32> *clipRect, SColor color);
 
 	u16 MaxJointTransforms = 0;
 	void initMaxJointTransforms();
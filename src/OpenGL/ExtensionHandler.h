@@ -80,6 +80,8 @@ public:
 			return Texture2DArraySupported;
 		case EVDF_RENDER_TO_FLOAT_TEXTURE:
 			return RenderToFloatTextureSupported;
+		case EVDF_32BIT_INDICES:
+			return Index32BitSupported;
 		default:
 			return false;
 		};
@@ -100,13 +102,13 @@ public:
 	inline void irrGlCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border,
 			GLsizei imageSize, const void *data)
 	{
-		os::Printer::log("Compressed textures aren't supported", ELL_ERROR);
+		GL.CompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
 	}
 
 	inline void irrGlCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
 			GLenum format, GLsizei imageSize, const void *data)
 	{
-		os::Printer::log("Compressed textures aren't supported", ELL_ERROR);
+		GL.CompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
 	}
 
 	inline void irrGlUseProgram(GLuint prog)
@@ -183,6 +185,7 @@ public:
 	bool Texture2DArraySupported = false;
 	bool KHRDebugSupported = false;
 	bool RenderToFloatTextureSupported = false;
+	bool Index32BitSupported = false;
 	u32 MaxLabelLength = 0;
 };
 
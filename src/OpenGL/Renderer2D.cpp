@@ -85,5 +85,16 @@ bool COpenGL3Renderer2D::OnRender(IMaterialRendererServices *service, E_VERTEX_T
 	return true;
 }
 
+COpenGL3Renderer2DDistanceField::COpenGL3Renderer2DDistanceField(const c8 *vertexShaderProgram, const c8 *pixelShaderProgram, COpenGL3DriverBase *driver) :
+		COpenGL3Renderer2D(vertexShaderProgram, pixelShaderProgram, driver, true)
+{
+	SmoothingID = getPixelShaderConstantID("uSmoothing");
+}
+
+void COpenGL3Renderer2DDistanceField::setSmoothing(f32 smoothing)
+{
+	setPixelShaderConstant(SmoothingID, &smoothing, 1);
+}
+
 }
 }
@@ -29,5 +29,18 @@ protected:
 	s32 TextureUsageID;
 };
 
+//! Fills the shapes of a signed distance field texture with the vertex color
+class COpenGL3Renderer2DDistanceField : public COpenGL3Renderer2D
+{
+public:
+	COpenGL3Renderer2DDistanceField(const c8 *vertexShaderProgram, const c8 *pixelShaderProgram, COpenGL3DriverBase *driver);
+
+	//! Sets half the width of the antialiased edge, needs the program to be active
+	void setSmoothing(f32 smoothing);
+
+protected:
+	s32 SmoothingID;
+};
+
 }
 }
@@ -63,6 +63,23 @@ void COpenGL3Driver::initFeatures()
 	TextureFormats[ECF_D32] = {GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT}; // WARNING: may not be renderable (?!)
 	TextureFormats[ECF_D24S8] = {GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8};
 
+	// Compressed formats, only the internal format matters for these
+	if (queryExtension("GL_EXT_texture_compression_s3tc")) {
+		TextureFormats[ECF_DXT1] = {GL.COMPRESSED_RGBA_S3TC_DXT1, GL_RGBA, GL_UNSIGNED_BYTE};
+		TextureFormats[ECF_DXT3] = {GL.COMPRESSED_RGBA_S3TC_DXT3, GL_RGBA, GL_UNSIGNED_BYTE};
+		TextureFormats[ECF_DXT5] = {GL.COMPRESSED_RGBA_S3TC_DXT5, GL_RGBA, GL_UNSIGNED_BYTE};
+	}
+	TextureFormats[ECF_BC4] = {GL.COMPRESSED_RED_RGTC1, GL_RED, GL_UNSIGNED_BYTE};
+	TextureFormats[ECF_BC5] = {GL.COMPRESSED_RG_RGTC2, GL_RG, GL_UNSIGNED_BYTE};
+	if (isVersionAtLeast(4, 2) || queryExtension("GL_ARB_texture_compression_bptc"))
+		TextureFormats[ECF_BC7] = {GL.COMPRESSED_RGBA_BPTC_UNORM, GL_RGBA, GL_UNSIGNED_BYTE};
+	if (isVersionAtLeast(4, 3) || queryExtension("GL_ARB_ES3_compatibility")) {
+		TextureFormats[ECF_ETC2_RGB] = {GL.COMPRESSED_RGB8_ETC2, GL_RGB, GL_UNSIGNED_BYTE};
+		TextureFormats[ECF_ETC2_ARGB] = {GL.COMPRESSED_RGBA8_ETC2_EAC, GL_RGBA, GL_UNSIGNED_BYTE};
+	}
+	if (queryExtension("GL_KHR_texture_compression_astc_ldr"))
+		TextureFormats[ECF_ASTC_4x4] = {GL.COMPRESSED_RGBA_ASTC_4x4, GL_RGBA, GL_UNSIGNED_BYTE};
+
 	AnisotropicFilterSupported = isVersionAtLeast(4, 6) || queryExtension("GL_ARB_texture_filter_anisotropic") || queryExtension("GL_EXT_texture_filter_anisotropic");
 	LODBiasSupported = true;
 	BlendMinMaxSupported = true;
@@ -72,6 +89,7 @@ void COpenGL3Driver::initFeatures()
 	if (KHRDebugSupported)
 		MaxLabelLength = GetInteger(GL.MAX_LABEL_LENGTH);
 	RenderToFloatTextureSupported = true;
+	Index32BitSupported = true;
 
 	// COGLESCoreExtensionHandler::Feature
 	static_assert(MATERIAL_MAX_TEXTURES <= 16, "Only up to 16 textures are guaranteed");
@@ -116,6 +116,25 @@ void COpenGLES2Driver::initFeatures()
 		}
 	}
 
+	// Compressed formats, only the internal format matters for these
+	if (queryExtension("GL_EXT_texture_compression_s3tc") || queryExtension("GL_WEBGL_compressed_texture_s3tc")) {
+		TextureFormats[ECF_DXT1] = {GL.COMPRESSED_RGBA_S3TC_DXT1, GL_RGBA, GL_UNSIGNED_BYTE};
+		TextureFormats[ECF_DXT3] = {GL.COMPRESSED_RGBA_S3TC_DXT3, GL_RGBA, GL_UNSIGNED_BYTE};
+		TextureFormats[ECF_DXT5] = {GL.COMPRESSED_RGBA_S3TC_DXT5, GL_RGBA, GL_UNSIGNED_BYTE};
+	}
+	if (queryExtension("GL_EXT_texture_compression_rgtc")) {
+		TextureFormats[ECF_BC4] = {GL.COMPRESSED_RED_RGTC1, GL_RGBA, GL_UNSIGNED_BYTE};
+		TextureFormats[ECF_BC5] = {GL.COMPRESSED_RG_RGTC2, GL_RGBA, GL_UNSIGNED_BYTE};
+	}
+	if (queryExtension("GL_EXT_texture_compression_bptc"))
+		TextureFormats[ECF_BC7] = {GL.COMPRESSED_RGBA_BPTC_UNORM, GL_RGBA, GL_UNSIGNED_BYTE};
+	if (Version.Major >= 3) {
+		TextureFormats[ECF_ETC2_RGB] = {GL.COMPRESSED_RGB8_ETC2, GL_RGB, GL_UNSIGNED_BYTE};
+		TextureFormats[ECF_ETC2_ARGB] = {GL.COMPRESSED_RGBA8_ETC2_EAC, GL_RGBA, GL_UNSIGNED_BYTE};
+	}
+	if (isVersionAtLeast(3, 2) || queryExtension("GL_KHR_texture_compression_astc_ldr"))
+		TextureFormats[ECF_ASTC_4x4] = {GL.COMPRESSED_RGBA_ASTC_4x4, GL_RGBA, GL_UNSIGNED_BYTE};
+
 	const bool MRTSupported = Version.Major >= 3 || queryExtension("GL_EXT_draw_buffers");
 	LODBiasSupported = queryExtension("GL_EXT_texture_lod_bias");
 	AnisotropicFilterSupported = queryExtension("GL_EXT_texture_filter_anisotropic");
@@ -131,6 +150,7 @@ void COpenGLES2Driver::initFeatures()
 			MaxLabelLength = GetInteger(GL.MAX_LABEL_LENGTH);
 	}
 	RenderToFloatTextureSupported = isVersionAtLeast(3, 2)|| queryExtension("GL_EXT_color_buffer_float");
+	Index32BitSupported = Version.Major >= 3 || FeatureAvailable[IRR_GL_OES_element_index_uint];
 
 	// COGLESCoreExtensionHandler::Feature
 	static_assert(MATERIAL_MAX_TEXTURES <= 8, "Only up to 8 textures are guaranteed");
@@ -0,0 +1,131 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "QuantizedVertexBuffer.h"
+#include "IVertexBuffer.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace irr
+{
+
+namespace scene
+{
+
+void QuantizedVertexBuffer::encode(const IVertexBuffer *vbuf)
+{
+	assert(vbuf->getType() == video::EVT_STANDARD);
+	const auto *src = static_cast<const video::S3DVertex *>(vbuf->getData());
+	const u32 count = vbuf->getCount();
+
+	core::aabbox3df box(count ? src[0].Pos : core::vector3df());
+	for (u32 i = 1; i < count; ++i)
+		box.addInternalPoint(src[i].Pos);
+	// a cube keeps the dequantization a uniform scale, which does not
+	// disturb shaders transforming normals by the world matrix
+	const core::vector3df extent = box.getExtent();
+	origin = box.MinEdge;
+	size = core::max_(extent.X, extent.Y, extent.Z);
+	const f32 scale = size > 0.f ? 65535.f / size : 0.f;
+
+	vertices.resize(count);
+	for (u32 i = 0; i < count; ++i) {
+		const video::S3DVertex &v = src[i];
+		Vertex &q = vertices[i];
+
+		const core::vector3df pos = (v.Pos - origin) * scale;
+		q.pos[0] = (u16)core::clamp(core::round32(pos.X), 0, 65535);
+		q.pos[1] = (u16)core::clamp(core::round32(pos.Y), 0, 65535);
+		q.pos[2] = (u16)core::clamp(core::round32(pos.Z), 0, 65535);
+		q.aux = v.Aux;
+
+		core::vector3df normal = v.Normal;
+		normal.normalize();
+		q.normal[0] = (s8)core::round32(normal.X * 127.f);
+		q.normal[1] = (s8)core::round32(normal.Y * 127.f);
+		q.normal[2] = (s8)core::round32(normal.Z * 127.f);
+		q.normal[3] = 0;
+
+		q.color = v.Color;
+		q.tcoords[0] = toHalf(v.TCoords.X);
+		q.tcoords[1] = toHalf(v.TCoords.Y);
+	}
+
+	SourceChangedID = vbuf->getChangedID();
+	SourceCount = count;
+	setDirty();
+}
+
+bool QuantizedVertexBuffer::isCurrent(const IVertexBuffer *vbuf) const
+{
+	return vbuf->getChangedID() == SourceChangedID && vbuf->getCount() == SourceCount;
+}
+
+core::matrix4 QuantizedVertexBuffer::getDequantizationMatrix() const
+{
+	core::matrix4 mat;
+	mat.setScale(size);
+	mat.setTranslation(origin);
+	return mat;
+}
+
+video::S3DVertex QuantizedVertexBuffer::decode(u32 i) const
+{
+	const Vertex &q = vertices[i];
+	const f32 scale = size / 65535.f;
+	const core::vector3df pos(q.pos[0] * scale, q.pos[1] * scale, q.pos[2] * scale);
+	// signed normalized integers as specified since OpenGL 4.2 and OpenGL ES 3.0
+	const core::vector3df normal(core::max_(q.normal[0] / 127.f, -1.f),
+			core::max_(q.normal[1] / 127.f, -1.f), core::max_(q.normal[2] / 127.f, -1.f));
+	return video::S3DVertex(origin + pos, normal, q.color,
+			core::vector2df(fromHalf(q.tcoords[0]), fromHalf(q.tcoords[1])), q.aux);
+}
+
+u16 QuantizedVertexBuffer::toHalf(f32 value)
+{
+	u32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const u16 sign = (bits >> 16) & 0x8000;
+	const u32 abs = bits & 0x7fffffff;
+
+	if (abs > 0x7f800000) // NaN
+		return sign | 0x7e00;
+	if (abs >= 0x477ff000) // rounds to infinity
+		return sign | 0x7c00;
+	if (abs < 0x38800000) // zero or subnormal, in steps of 2^-24
+		return sign | (u16)std::nearbyint(std::fabs(value) * 16777216.f);
+
+	// rebias the exponent and round to nearest even, a carry correctly
+	// moves into the exponent
+	u32 half = ((abs >> 13) - (112 << 10));
+	const u32 rest = abs & 0x1fff;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+		++half;
+	return sign | (u16)half;
+}
+
+f32 QuantizedVertexBuffer::fromHalf(u16 value)
+{
+	const u32 sign = (u32)(value & 0x8000) << 16;
+	const u32 exponent = (value >> 10) & 0x1f;
+	const u32 mantissa = value & 0x3ff;
+
+	if (exponent == 0) {
+		const f32 result = std::ldexp((f32)mantissa, -24);
+		return sign ? -result : result;
+	}
+
+	u32 bits;
+	if (exponent == 31)
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	else
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	f32 result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,33 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+// Architecture and compiler glue for the hand-written SIMD code paths.
+// x86 kernels are compiled per function for the instruction set they need
+// (IRR_TARGET) and selected at runtime through os::CPU, so the library
+// itself keeps building for the baseline architecture.
+// NEON is part of the aarch64 baseline and selected at compile time.
+
+#if defined(__BIG_ENDIAN__)
+// all kernels assume little endian memory layout
+#elif defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IRR_ARCH_X86
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define IRR_ARCH_NEON
+#endif
+
+#if defined(IRR_ARCH_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#elif defined(IRR_ARCH_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define IRR_TARGET(x) __attribute__((target(x)))
+#else
+#define IRR_TARGET(x)
+#endif
@@ -0,0 +1,158 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Binary mesh cache, written by CMeshCacheWriter and read by CMeshCacheFileLoader.
+// The format stores vertices, indices, weights and key frames in the memory
+// layout of the engine so they can be copied out as a whole. It is meant as a
+// cache for one build of the engine: the header records byte order and
+// structure sizes, files from a different build are rejected.
+
+#pragma once
+
+#include "irrTypes.h"
+#include "S3DVertex.h"
+#include "SkinnedMesh.h"
+#include "WeightBuffer.h"
+#include "matrix4.h"
+
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace irr
+{
+namespace scene
+{
+
+namespace meshcache
+{
+
+constexpr c8 MAGIC[8] = {'I', 'R', 'R', 'M', 'C', 'A', 'C', 'H'};
+//! Incremented whenever the layout of the file changes
+constexpr u32 VERSION = 2;
+constexpr u32 BYTE_ORDER_MARK = 0x01020304;
+
+//! Structures which are stored as they are in memory
+constexpr u16 LAYOUT_SIZES[] = {
+	sizeof(video::S3DVertex),
+	sizeof(video::S3DVertex2TCoords),
+	sizeof(video::S3DVertexTangents),
+	sizeof(WeightBuffer::VertexWeights),
+	sizeof(SkinnedMesh::Channel<core::vector3df>::Frame),
+	sizeof(SkinnedMesh::Channel<core::quaternion>::Frame),
+};
+
+enum E_MESH_KIND : u8
+{
+	EMK_STATIC = 0,
+	EMK_SKINNED = 1,
+};
+
+//! Appends values to a byte buffer
+struct SOutput
+{
+	std::vector<u8> Data;
+
+	void putBytes(const void *data, size_t size)
+	{
+		const u8 *bytes = static_cast<const u8 *>(data);
+		Data.insert(Data.end(), bytes, bytes + size);
+	}
+
+	template <class T>
+	void put(const T &value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		putBytes(&value, sizeof(T));
+	}
+
+	template <class T>
+	void putArray(const std::vector<T> &values)
+	{
+		put<u32>(values.size());
+		putBytes(values.data(), values.size() * sizeof(T));
+	}
+
+	void putMatrix(const core::matrix4 &matrix)
+	{
+		putBytes(matrix.pointer(), 16 * sizeof(f32));
+	}
+
+	void putString(const c8 *str, size_t length)
+	{
+		put<u32>(length);
+		putBytes(str, length);
+	}
+};
+
+//! Reads values from memory, failing instead of reading past the end
+struct SInput
+{
+	const u8 *Pos;
+	const u8 *End;
+	bool Failed = false;
+
+	SInput(const u8 *data, size_t size) :
+			Pos(data), End(data + size) {}
+
+	bool getBytes(void *dst, size_t size)
+	{
+		if (Failed || (size_t)(End - Pos) < size) {
+			Failed = true;
+			return false;
+		}
+		if (size)
+			memcpy(dst, Pos, size);
+		Pos += size;
+		return true;
+	}
+
+	template <class T>
+	T get()
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		T value{};
+		getBytes(&value, sizeof(T));
+		return value;
+	}
+
+	template <class T>
+	bool getArray(std::vector<T> &values)
+	{
+		const u32 count = get<u32>();
+		if (Failed || (size_t)(End - Pos) / sizeof(T) < count) {
+			Failed = true;
+			return false;
+		}
+		values.resize(count);
+		return getBytes(values.data(), count * sizeof(T));
+	}
+
+	core::matrix4 getMatrix()
+	{
+		f32 m[16] = {};
+		getBytes(m, sizeof(m));
+		core::matrix4 matrix(core::matrix4::EM4CONST_NOTHING);
+		matrix.setM(m);
+		return matrix;
+	}
+
+	bool getString(std::string &str)
+	{
+		const u32 length = get<u32>();
+		if (Failed || (size_t)(End - Pos) < length) {
+			Failed = true;
+			return false;
+		}
+		str.assign(reinterpret_cast<const c8 *>(Pos), length);
+		Pos += length;
+		return true;
+	}
+};
+
+} // end namespace meshcache
+
+} // end namespace scene
+} // end namespace irr
@@ -5,6 +5,8 @@
 #include "SkinnedMesh.h"
 #include "EHardwareBufferFlags.h"
 #include "SSkinMeshBuffer.h"
+#include "BoundingBoxes.h"
+#include "CMeshNormals.h"
 #include "Transform.h"
 #include "aabbox3d.h"
 #include "matrix4.h"
@@ -84,11 +86,12 @@ core::aabbox3df SkinnedMesh::calculateBoundingBox(
 	assert(global_transforms.size() == AllJoints.size());
 	core::aabbox3df result = StaticPartsBox;
 	// skeletal animation
-	for (u16 i = 0; i < AllJoints.size(); ++i) {
-		auto box = AllJoints[i]->LocalBoundingBox;
-		global_transforms[i].transformBoxEx(box);
+	JointBoxes.clear();
+	for (const auto *joint : AllJoints)
+		JointBoxes.push_back(joint->LocalBoundingBox);
+	core::transformBoxes(global_transforms.data(), JointBoxes.data(), JointBoxes.data(), JointBoxes.size());
+	for (const auto &box : JointBoxes)
 		result.addInternalBox(box);
-	}
 	// rigid animation
 	for (u16 i = 0; i < AllJoints.size(); ++i) {
 		for (u32 j : AllJoints[i]->AttachedMeshes) {
@@ -269,12 +272,25 @@ void SkinnedMesh::calculateStaticBoundingBox()
 	std::vector<bool> animated;
 	for (u16 mb = 0; mb < getMeshBufferCount(); mb++) {
 		auto *buf = LocalBuffers[mb];
+		const auto *weights = buf->getWeights();
+		if (!weights || weights->animated_vertices.value().empty()) {
+			// no vertex is animated, all of them count
+			if (!buf->getVertexCount())
+				continue;
+			const core::aabbox3df box = core::getBoundingBox(&buf->getVertex(0)->Pos,
+					buf->getVertexCount(), buf->getVertexBuffer()->getElementSize());
+			if (!first) {
+				StaticPartsBox.addInternalBox(box);
+			} else {
+				StaticPartsBox = box;
+				first = false;
+			}
+			continue;
+		}
 		animated.clear();
 		animated.resize(buf->getVertexCount(), false);
-		if (const auto *weights = buf->getWeights()) {
-			for (u32 vert_id : weights->animated_vertices.value()) {
-				animated[vert_id] = true;
-			}
+		for (u32 vert_id : weights->animated_vertices.value()) {
+			animated[vert_id] = true;
 		}
 		for (u32 v = 0; v < buf->getVertexCount(); v++) {
 			if (animated[v])
@@ -502,85 +518,10 @@ void SkinnedMesh::convertMeshToTangents()
 	for (u32 b = 0; b < LocalBuffers.size(); ++b) {
 		if (LocalBuffers[b]) {
 			LocalBuffers[b]->convertToTangents();
-
-			const s32 idxCnt = LocalBuffers[b]->getIndexCount();
-
-			u16 *idx = LocalBuffers[b]->getIndices();
-			video::S3DVertexTangents *v =
-					(video::S3DVertexTangents *)LocalBuffers[b]->getVertices();
-
-			for (s32 i = 0; i < idxCnt; i += 3) {
-				calculateTangents(
-						v[idx[i + 0]].Normal,
-						v[idx[i + 0]].Tangent,
-						v[idx[i + 0]].Binormal,
-						v[idx[i + 0]].Pos,
-						v[idx[i + 1]].Pos,
-						v[idx[i + 2]].Pos,
-						v[idx[i + 0]].TCoords,
-						v[idx[i + 1]].TCoords,
-						v[idx[i + 2]].TCoords);
-
-				calculateTangents(
-						v[idx[i + 1]].Normal,
-						v[idx[i + 1]].Tangent,
-						v[idx[i + 1]].Binormal,
-						v[idx[i + 1]].Pos,
-						v[idx[i + 2]].Pos,
-						v[idx[i + 0]].Pos,
-						v[idx[i + 1]].TCoords,
-						v[idx[i + 2]].TCoords,
-						v[idx[i + 0]].TCoords);
-
-				calculateTangents(
-						v[idx[i + 2]].Normal,
-						v[idx[i + 2]].Tangent,
-						v[idx[i + 2]].Binormal,
-						v[idx[i + 2]].Pos,
-						v[idx[i + 0]].Pos,
-						v[idx[i + 1]].Pos,
-						v[idx[i + 2]].TCoords,
-						v[idx[i + 0]].TCoords,
-						v[idx[i + 1]].TCoords);
-			}
+			CMeshNormals::recalculateTangents(LocalBuffers[b]);
 		}
 	}
 }
 
-void SkinnedMesh::calculateTangents(
-		core::vector3df &normal,
-		core::vector3df &tangent,
-		core::vector3df &binormal,
-		const core::vector3df &vt1, const core::vector3df &vt2, const core::vector3df &vt3, // vertices
-		const core::vector2df &tc1, const core::vector2df &tc2, const core::vector2df &tc3) // texture coords
-{
-	core::vector3df v1 = vt1 - vt2;
-	core::vector3df v2 = vt3 - vt1;
-	normal = v2.crossProduct(v1);
-	normal.normalize();
-
-	// binormal
-
-	f32 deltaX1 = tc1.X - tc2.X;
-	f32 deltaX2 = tc3.X - tc1.X;
-	binormal = (v1 * deltaX2) - (v2 * deltaX1);
-	binormal.normalize();
-
-	// tangent
-
-	f32 deltaY1 = tc1.Y - tc2.Y;
-	f32 deltaY2 = tc3.Y - tc1.Y;
-	tangent = (v1 * deltaY2) - (v2 * deltaY1);
-	tangent.normalize();
-
-	// adjust
-
-	core::vector3df txb = tangent.crossProduct(binormal);
-	if (txb.dotProduct(normal) < 0.0f) {
-		tangent *= -1.0f;
-		binormal *= -1.0f;
-	}
-}
-
 } // end namespace scene
 } // end namespace irr
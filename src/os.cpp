@@ -5,6 +5,7 @@
 #include "os.h"
 #include "irrString.h"
 #include "irrMath.h"
+#include "SIMD_helper.h"
 
 #if defined(_IRR_COMPILE_WITH_SDL_DEVICE_)
 #ifdef _IRR_USE_SDL3_
@@ -277,6 +278,87 @@ u32 Timer::getRealTime()
 
 namespace os
 {
+// ------------------------------------------------------
+// processor feature detection
+
+#if defined(IRR_ARCH_X86) && defined(_MSC_VER)
+namespace
+{
+struct SCPUInfo
+{
+	bool SSE2 = false, SSSE3 = false, AVX2 = false;
+
+	SCPUInfo()
+	{
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+		__cpuid(info, 1);
+		SSE2 = (info[3] & (1 << 26)) != 0;
+		SSSE3 = (info[2] & (1 << 9)) != 0;
+		// AVX state must be enabled by the OS (OSXSAVE + XCR0)
+		const bool osAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+				(_xgetbv(0) & 6) == 6;
+		if (osAVX && maxLeaf >= 7) {
+			__cpuidex(info, 7, 0);
+			AVX2 = (info[1] & (1 << 5)) != 0;
+		}
+	}
+};
+
+const SCPUInfo &getCPUInfo()
+{
+	static const SCPUInfo info;
+	return info;
+}
+}
+
+bool CPU::hasSSE2()
+{
+	return getCPUInfo().SSE2;
+}
+
+bool CPU::hasSSSE3()
+{
+	return getCPUInfo().SSSE3;
+}
+
+bool CPU::hasAVX2()
+{
+	return getCPUInfo().AVX2;
+}
+#elif defined(IRR_ARCH_X86)
+bool CPU::hasSSE2()
+{
+	return __builtin_cpu_supports("sse2");
+}
+
+bool CPU::hasSSSE3()
+{
+	return __builtin_cpu_supports("ssse3");
+}
+
+bool CPU::hasAVX2()
+{
+	return __builtin_cpu_supports("avx2");
+}
+#else
+bool CPU::hasSSE2()
+{
+	return false;
+}
+
+bool CPU::hasSSSE3()
+{
+	return false;
+}
+
+bool CPU::hasAVX2()
+{
+	return false;
+}
+#endif
+
 // The platform independent implementation of the printer
 ILogger *Printer::Logger = 0;
 
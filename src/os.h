@@ -43,6 +43,17 @@ public:
 	static ILogger *Logger;
 };
 
+class CPU
+{
+public:
+	//! returns true if the processor supports the given x86 instruction set
+	//! extension, and the OS saves the required register state.
+	//! Always false on other architectures.
+	static bool hasSSE2();
+	static bool hasSSSE3();
+	static bool hasAVX2();
+};
+
 class Timer
 {
 public:
@@ -0,0 +1,199 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <irrlicht.h>
+#include <BoundingBoxes.h>
+#include <S3DVertex.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that the bulk bounding box functions give exactly the bits of the
+// scalar aabbox3d::addInternalPoint() and matrix4::transformBoxEx(), then
+// times both.
+// Pass "--bench" to time larger arrays.
+
+static bool sameBits(const core::aabbox3df &a, const core::aabbox3df &b)
+{
+	return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static core::aabbox3df scalarBox(const video::S3DVertex *vertices, u32 count)
+{
+	core::aabbox3df box(vertices[0].Pos);
+	for (u32 i = 1; i < count; ++i)
+		box.addInternalPoint(vertices[i].Pos);
+	return box;
+}
+
+static std::vector<video::S3DVertex> randomVertices(std::mt19937 &rng, u32 count)
+{
+	std::uniform_real_distribution<f32> coord(-1000.f, 1000.f);
+	std::vector<video::S3DVertex> vertices(count);
+	for (auto &v : vertices)
+		v.Pos.set(coord(rng), coord(rng), coord(rng));
+	return vertices;
+}
+
+static void testBoundingBox()
+{
+	std::mt19937 rng(3);
+	for (u32 count : {1U, 2U, 3U, 7U, 1000U}) {
+		const auto vertices = randomVertices(rng, count);
+		check(sameBits(core::getBoundingBox(&vertices[0].Pos, count, sizeof(video::S3DVertex)), scalarBox(vertices.data(), count)),
+				"box of vertices differs");
+
+		// packed positions, the last one must not be read past
+		std::vector<core::vector3df> positions;
+		for (const auto &v : vertices)
+			positions.push_back(v.Pos);
+		check(sameBits(core::getBoundingBox(positions.data(), count), scalarBox(vertices.data(), count)),
+				"box of packed positions differs");
+	}
+
+	// signed zeros and NaN keep the bits of the scalar comparisons
+	const f32 nan = std::numeric_limits<f32>::quiet_NaN();
+	const std::vector<std::vector<core::vector3df>> special = {
+			{{0.f, -0.f, 0.f}, {-0.f, 0.f, -0.f}, {0.f, 0.f, 0.f}},
+			{{-0.f, -0.f, -0.f}, {0.f, 0.f, 0.f}},
+			{{1.f, 2.f, 3.f}, {nan, -5.f, 5.f}, {-1.f, nan, 0.f}},
+			{{nan, nan, nan}, {1.f, 1.f, 1.f}},
+	};
+	for (const auto &positions : special) {
+		core::aabbox3df expected(positions[0]);
+		for (size_t i = 1; i < positions.size(); ++i)
+			expected.addInternalPoint(positions[i]);
+		check(sameBits(core::getBoundingBox(positions.data(), positions.size()), expected), "box of special values differs");
+	}
+
+	check(sameBits(core::getBoundingBox(nullptr, 0), core::aabbox3df{{0.f, 0.f, 0.f}}), "empty box not at the origin");
+
+#ifdef __linux__
+	// Pos after a color with a stride of 16: the last position ends the
+	// array, right before a page which must not be read
+	struct SColoredPosition
+	{
+		u32 Color;
+		core::vector3df Pos;
+	};
+	const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	u8 *pages = (u8 *)mmap(nullptr, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	check(pages != MAP_FAILED && mprotect(pages + page, page, PROT_NONE) == 0, "guard page not set up");
+	const u32 count = 5;
+	auto *colored = (SColoredPosition *)(pages + page) - count;
+	for (u32 i = 0; i < count; ++i)
+		colored[i] = {0, core::vector3df((f32)i, -(f32)i, 1.f)};
+	const core::aabbox3df box = core::getBoundingBox(&colored[0].Pos, count, sizeof(SColoredPosition));
+	check(box.MinEdge == core::vector3df(0.f, -4.f, 1.f) && box.MaxEdge == core::vector3df(4.f, 0.f, 1.f),
+			"box of positions after a color differs");
+	munmap(pages, 2 * page);
+#endif
+}
+
+static core::matrix4 randomMatrix(std::mt19937 &rng)
+{
+	std::uniform_real_distribution<f32> angle(-180.f, 180.f), scale(-3.f, 3.f), offset(-100.f, 100.f);
+	core::matrix4 m;
+	m.setRotationDegrees(core::vector3df(angle(rng), angle(rng), angle(rng)));
+	m.setTranslation(core::vector3df(offset(rng), offset(rng), offset(rng)));
+	core::matrix4 s;
+	s.setScale(core::vector3df(scale(rng), scale(rng), 0.f)); // also a zero column
+	return m * s;
+}
+
+static std::vector<core::aabbox3df> randomBoxes(std::mt19937 &rng, u32 count)
+{
+	std::uniform_real_distribution<f32> coord(-50.f, 50.f);
+	std::vector<core::aabbox3df> boxes;
+	for (u32 i = 0; i < count; ++i) {
+		core::aabbox3df box(core::vector3df(coord(rng), coord(rng), coord(rng)));
+		box.addInternalPoint(core::vector3df(coord(rng), coord(rng), coord(rng)));
+		boxes.push_back(box);
+	}
+	// flat and signed zero boxes
+	boxes.push_back(core::aabbox3df(core::vector3df(-0.f, 0.f, -0.f), core::vector3df(0.f, 0.f, 0.f)));
+	return boxes;
+}
+
+static void testTransformBoxes()
+{
+	std::mt19937 rng(4);
+	const u32 count = 500;
+	std::vector<core::matrix4> matrices;
+	for (u32 i = 0; i <= count; ++i)
+		matrices.push_back(randomMatrix(rng));
+	const std::vector<core::aabbox3df> boxes = randomBoxes(rng, count);
+
+	std::vector<core::aabbox3df> out = boxes;
+	core::transformBoxes(matrices.data(), boxes.data(), out.data(), boxes.size());
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		core::aabbox3df expected = boxes[i];
+		matrices[i].transformBoxEx(expected);
+		check(sameBits(out[i], expected), "box transformed by its matrix differs");
+	}
+
+	std::vector<core::aabbox3df> inPlace = boxes;
+	core::transformBoxes(matrices[0], inPlace.data(), inPlace.data(), inPlace.size());
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		core::aabbox3df expected = boxes[i];
+		matrices[0].transformBoxEx(expected);
+		check(sameBits(inPlace[i], expected), "box transformed in place differs");
+	}
+}
+
+static void benchmark(bool large)
+{
+	std::mt19937 rng(5);
+	const u32 vertexCount = large ? 4000000 : 200000;
+	const u32 boxCount = large ? 400000 : 20000;
+	const u32 repeats = large ? 20 : 5;
+	const auto vertices = randomVertices(rng, vertexCount);
+	std::vector<core::matrix4> matrices;
+	for (u32 i = 0; i < boxCount; ++i)
+		matrices.push_back(randomMatrix(rng));
+	const std::vector<core::aabbox3df> boxes = randomBoxes(rng, boxCount - 1);
+	std::vector<core::aabbox3df> out = boxes;
+
+	volatile f32 sink = 0.f;
+	std::printf("%u vertices, %u boxes\n", vertexCount, boxCount);
+	std::printf("%-24s %8.3f ms\n", "bounding box, scalar", measure(repeats, [&] {
+		sink = sink + scalarBox(vertices.data(), vertexCount).MaxEdge.X;
+	}));
+	std::printf("%-24s %8.3f ms\n", "bounding box, bulk", measure(repeats, [&] {
+		sink = sink + core::getBoundingBox(&vertices[0].Pos, vertexCount, sizeof(video::S3DVertex)).MaxEdge.X;
+	}));
+	std::printf("%-24s %8.3f ms\n", "transform boxes, scalar", measure(repeats, [&] {
+		for (size_t i = 0; i < boxes.size(); ++i) {
+			out[i] = boxes[i];
+			matrices[i].transformBoxEx(out[i]);
+		}
+		sink = sink + out[0].MaxEdge.X;
+	}));
+	std::printf("%-24s %8.3f ms\n", "transform boxes, bulk", measure(repeats, [&] {
+		core::transformBoxes(matrices.data(), boxes.data(), out.data(), boxes.size());
+		sink = sink + out[0].MaxEdge.X;
+	}));
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	testBoundingBox();
+	testTransformBoxes();
+	std::printf("All bounding box checks passed\n");
+
+	benchmark(large);
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,196 @@
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+#include "CColorConverter.h"
+#include "test_utils.h"
+
+using namespace irr;
+using video::CColorConverter;
+
+// Verifies the accelerated CColorConverter routines against the scalar
+// reference for every supported instruction set, then reports throughput.
+// Pass "--bench" to time larger buffers.
+
+typedef void (*ConvertFunc)(const void *sP, s32 sN, void *dP);
+
+struct ConversionDesc
+{
+	std::string name;
+	ConvertFunc func;
+	u32 srcBytes, dstBytes;
+};
+
+static const video::ECOLOR_FORMAT formats[] = {
+	video::ECF_A1R5G5B5,
+	video::ECF_R5G6B5,
+	video::ECF_A8R8G8B8,
+	video::ECF_R8G8B8,
+};
+
+static const char *const formatNames[] = {"A1R5G5B5", "R5G6B5", "A8R8G8B8", "R8G8B8"};
+
+static video::ECOLOR_FORMAT viaSrc, viaDst;
+
+static void convertVia(const void *sP, s32 sN, void *dP)
+{
+	CColorConverter::convert_viaFormat(sP, viaSrc, sN, dP, viaDst);
+}
+
+#define CONVERSION(name, s, d) {#name, CColorConverter::convert_##name, s, d}
+
+// conversions not reachable through convert_viaFormat, used by the drivers
+static const ConversionDesc directConversions[] = {
+	CONVERSION(A1R5G5B5toR5G5B5A1, 2, 2),
+	CONVERSION(A1R5G5B5toB8G8R8, 2, 3),
+	CONVERSION(A8R8G8B8toB8G8R8, 4, 3),
+	CONVERSION(A8R8G8B8toA1B5G5R5, 4, 2),
+	CONVERSION(A8R8G8B8toR8G8B8A8, 4, 4),
+	CONVERSION(A8R8G8B8toA8B8G8R8, 4, 4),
+	CONVERSION(R8G8B8toB8G8R8, 3, 3),
+	CONVERSION(R5G6B5toB8G8R8, 2, 3),
+};
+
+static const char *levelName(CColorConverter::E_SIMD_LEVEL level)
+{
+	switch (level) {
+	case CColorConverter::ESL_SCALAR:
+		return "scalar";
+	case CColorConverter::ESL_SSE2:
+		return "SSE2";
+	case CColorConverter::ESL_SSSE3:
+		return "SSSE3";
+	case CColorConverter::ESL_AVX2:
+		return "AVX2";
+	case CColorConverter::ESL_NEON:
+		return "NEON";
+	}
+	return "?";
+}
+
+template <typename F>
+static void forEachConversion(F &&callback)
+{
+	for (u32 s = 0; s < 4; ++s) {
+		for (u32 d = 0; d < 4; ++d) {
+			if (!CColorConverter::canConvertFormat(formats[s], formats[d]))
+				throw std::logic_error("canConvertFormat rejects a basic format pair");
+			viaSrc = formats[s];
+			viaDst = formats[d];
+			ConversionDesc desc{std::string(formatNames[s]) + "to" + formatNames[d], convertVia,
+					video::IImage::getBitsPerPixelFromFormat(formats[s]) / 8,
+					video::IImage::getBitsPerPixelFromFormat(formats[d]) / 8};
+			callback(desc);
+		}
+	}
+	for (const auto &desc : directConversions)
+		callback(desc);
+}
+
+static void fillRandom(std::vector<u8> &buf, std::mt19937 &rng)
+{
+	for (auto &b : buf)
+		b = (u8)rng();
+}
+
+//! runs one conversion with guard bytes around the destination
+static std::vector<u8> runGuarded(const ConversionDesc &desc, const std::vector<u8> &src,
+		u32 offset, s32 count)
+{
+	const u32 guard = 64;
+	std::vector<u8> dst(guard + (offset + count) * desc.dstBytes + guard, 0xCD);
+	desc.func(src.data() + offset * desc.srcBytes, count, dst.data() + guard + offset * desc.dstBytes);
+	for (u32 i = 0; i < guard; ++i) {
+		if (dst[i] != 0xCD || dst[dst.size() - 1 - i] != 0xCD)
+			throw std::runtime_error(desc.name + ": write outside of destination");
+	}
+	return dst;
+}
+
+static void verifyLevel(CColorConverter::E_SIMD_LEVEL level)
+{
+	std::mt19937 rng(1234);
+	std::vector<s32> counts;
+	for (s32 n = 0; n <= 80; ++n)
+		counts.push_back(n);
+	counts.push_back(1023);
+	counts.push_back(4099);
+
+	forEachConversion([&](const ConversionDesc &desc) {
+		for (s32 count : counts) {
+			for (u32 offset = 0; offset < 4; ++offset) {
+				std::vector<u8> src((offset + count) * desc.srcBytes + 16);
+				fillRandom(src, rng);
+
+				CColorConverter::setSIMDLevel(CColorConverter::ESL_SCALAR);
+				const auto expected = runGuarded(desc, src, offset, count);
+				CColorConverter::setSIMDLevel(level);
+				const auto actual = runGuarded(desc, src, offset, count);
+
+				if (expected != actual) {
+					throw std::runtime_error(desc.name + " (" + levelName(level) +
+							") differs from scalar for " + std::to_string(count) + " pixels");
+				}
+			}
+		}
+	});
+}
+
+static double throughput(const ConversionDesc &desc, const std::vector<u8> &src, std::vector<u8> &dst,
+		s32 count, u32 repeats)
+{
+	const double ms = measure(repeats, [&] { desc.func(src.data(), count, dst.data()); });
+	return count / ms * 1e-3;
+}
+
+static void benchmark(CColorConverter::E_SIMD_LEVEL best, bool large)
+{
+	const s32 count = large ? 4096 * 4096 : 512 * 512;
+	const u32 repeats = large ? 8 : 4;
+	std::mt19937 rng(42);
+
+	std::printf("%-22s %12s %12s %8s\n", "conversion", "scalar MP/s", (std::string(levelName(best)) + " MP/s").c_str(), "speedup");
+	forEachConversion([&](const ConversionDesc &desc) {
+		std::vector<u8> src(count * desc.srcBytes);
+		std::vector<u8> dst(count * desc.dstBytes);
+		fillRandom(src, rng);
+
+		CColorConverter::setSIMDLevel(CColorConverter::ESL_SCALAR);
+		const double scalar = throughput(desc, src, dst, count, repeats);
+		CColorConverter::setSIMDLevel(best);
+		const double simd = throughput(desc, src, dst, count, repeats);
+		std::printf("%-22s %12.1f %12.1f %7.2fx\n", desc.name.c_str(), scalar, simd, simd / scalar);
+	});
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+	const CColorConverter::E_SIMD_LEVEL best = CColorConverter::getBestSIMDLevel();
+	if (CColorConverter::getSIMDLevel() != best)
+		throw std::logic_error("Converter does not start with the best SIMD level");
+
+	const CColorConverter::E_SIMD_LEVEL levels[] = {
+		CColorConverter::ESL_SSE2,
+		CColorConverter::ESL_SSSE3,
+		CColorConverter::ESL_AVX2,
+		CColorConverter::ESL_NEON,
+	};
+	for (auto level : levels) {
+		if (!CColorConverter::setSIMDLevel(level)) {
+			std::printf("%s: not supported, skipped\n", levelName(level));
+			continue;
+		}
+		verifyLevel(level);
+		std::printf("%s: matches scalar reference\n", levelName(level));
+	}
+
+	benchmark(best, large);
+	CColorConverter::setSIMDLevel(best);
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,104 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <irrlicht.h>
+#include <IGUIEnvironment.h>
+#include <IGUIButton.h>
+#include <IGUICheckBox.h>
+#include <IGUIComboBox.h>
+#include <IGUIEditBox.h>
+#include <IGUIListBox.h>
+#include <IGUIStaticText.h>
+#include <IVideoDriver.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Counts the heap allocations of drawing a text heavy GUI, which should
+// not allocate once the scratch buffers of the fonts and sprite banks have
+// grown. Prints the allocations and the time per frame.
+// Pass "--bench" for more frames.
+
+static std::atomic<size_t> Allocations{0};
+
+void *operator new(size_t size)
+{
+	++Allocations;
+	if (void *p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+static void createGUI(gui::IGUIEnvironment *env)
+{
+	wchar_t text[128];
+	for (s32 i = 0; i < 40; ++i) {
+		swprintf(text, 128, L"Static text number %d, long enough to be wrapped into a few lines", i);
+		gui::IGUIStaticText *st = env->addStaticText(text,
+				core::recti((i % 4) * 160, (i / 4) * 24, (i % 4) * 160 + 150, (i / 4) * 24 + 22), i % 2 == 0);
+		st->setWordWrap(i % 3 == 0);
+	}
+	for (s32 i = 0; i < 20; ++i) {
+		swprintf(text, 128, L"Button %d", i);
+		env->addButton(core::recti((i % 5) * 80, 250 + (i / 5) * 24, (i % 5) * 80 + 75, 270 + (i / 5) * 24), 0, -1, text);
+	}
+	gui::IGUIListBox *list = env->addListBox(core::recti(400, 250, 640, 400));
+	for (s32 i = 0; i < 200; ++i) {
+		swprintf(text, 128, L"List item %d", i);
+		list->addItem(text);
+	}
+	gui::IGUIEditBox *edit = env->addEditBox(L"An edit box\nwith some lines\nof text", core::recti(0, 350, 390, 470));
+	edit->setMultiLine(true);
+	edit->setWordWrap(true);
+	env->addCheckBox(true, core::recti(400, 410, 600, 430), 0, -1, L"A check box");
+	gui::IGUIComboBox *combo = env->addComboBox(core::recti(400, 440, 600, 460));
+	combo->addItem(L"First choice");
+	combo->addItem(L"Second choice");
+}
+
+static void drawFrame(IrrlichtDevice *device)
+{
+	device->getVideoDriver()->beginScene();
+	device->getGUIEnvironment()->drawAll();
+	device->getVideoDriver()->endScene();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool bench = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	createGUI(device->getGUIEnvironment());
+
+	// let the scratch buffers grow
+	drawFrame(device);
+	drawFrame(device);
+
+	const u32 frames = bench ? 10000 : 200;
+	const size_t before = Allocations;
+	const double frameTime = measure(frames, [&] { drawFrame(device); });
+	const double perFrame = double(Allocations - before) / frames;
+	std::printf("%.2f allocations, %.4f ms per frame\n", perFrame, frameTime);
+
+	check(perFrame == 0, "drawing the GUI allocates");
+	std::printf("All draw allocation checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <irrlicht.h>
+#include <CGUIEditBox.h>
+#include <IGUIEnvironment.h>
+#include <IVideoDriver.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that editing a multi line edit box, which breaks only the
+// paragraphs touched, gives the same lines as breaking the whole text, then
+// times typing into a 1 MB document.
+// Pass "--bench" to type more characters.
+
+class CTestEditBox : public gui::CGUIEditBox
+{
+public:
+	using CGUIEditBox::CGUIEditBox;
+	using CGUIEditBox::breakText;
+
+	void setCursor(s32 pos) { CursorPos = pos; }
+
+	//! The clipboard needs a display, which the null device has not
+	void dropOperator()
+	{
+		if (Operator)
+			Operator->drop();
+		Operator = 0;
+	}
+
+	u32 getLineCount() const { return BrokenText.size(); }
+
+	//! Whether the current lines are the ones of breaking the whole text
+	bool hasFullBreak()
+	{
+		const core::array<core::stringw> lines = BrokenText;
+		const core::array<s32> positions = BrokenTextPositions;
+		const core::array<core::dimension2du> sizes = BrokenTextSizes;
+		breakText();
+		return lines == BrokenText && positions == BrokenTextPositions && sizes == BrokenTextSizes;
+	}
+};
+
+static void sendKey(gui::IGUIElement *box, EKEY_CODE key, wchar_t c = 0, bool shift = false, bool control = false)
+{
+	SEvent event;
+	event.EventType = EET_KEY_INPUT_EVENT;
+	event.KeyInput.Key = key;
+	event.KeyInput.Char = c;
+	event.KeyInput.PressedDown = true;
+	event.KeyInput.Shift = shift;
+	event.KeyInput.Control = control;
+	box->OnEvent(event);
+}
+
+static void sendString(gui::IGUIElement *box, core::stringw str)
+{
+	SEvent event;
+	event.EventType = EET_STRING_INPUT_EVENT;
+	event.StringInput.Str = &str;
+	box->OnEvent(event);
+}
+
+//! Paragraphs of words with all kinds of line breaks
+static core::stringw createDocument(std::mt19937 &rng, u32 size)
+{
+	const wchar_t *words[] = {L"lorem", L"ipsum", L"dolor", L"sit", L"amet,", L"consectetur",
+			L"adipiscing", L"elit.", L"a", L"verylongwordwhichdoesnotfitintoasinglelineofthebox"};
+	const wchar_t *breaks[] = {L"\n", L"\n\n", L"\r\n", L"\r"};
+	core::stringw text;
+	while (text.size() < size) {
+		const u32 paragraph = 50 + rng() % 500;
+		for (u32 start = text.size(); text.size() - start < paragraph;) {
+			text += words[rng() % 10];
+			text += L" ";
+		}
+		text += breaks[rng() % 4];
+	}
+	return text;
+}
+
+static void testEdits(CTestEditBox *box)
+{
+	std::mt19937 rng(6);
+	box->setText(createDocument(rng, 20000).c_str());
+	check(box->getLineCount() > 100, "text not broken into lines");
+	check(box->hasFullBreak(), "lines differ after setting the text");
+
+	for (u32 step = 0; step < 2000; ++step) {
+		const u32 size = core::stringw(box->getText()).size();
+		box->setCursor(rng() % (size + 1));
+		switch (rng() % 8) {
+		case 0:
+			sendKey(box, KEY_RETURN);
+			break;
+		case 1:
+			sendKey(box, KEY_BACK);
+			break;
+		case 2:
+			sendKey(box, KEY_DELETE);
+			break;
+		case 3:
+			// mark some text and type over it
+			for (u32 i = rng() % 200; i > 0; --i)
+				sendKey(box, KEY_RIGHT, 0, true);
+			sendKey(box, KEY_KEY_X, L'x');
+			break;
+		case 4:
+			sendString(box, L"pasted\r\ntext\rwith\n\nbreaks ");
+			break;
+		case 5:
+			// could join with a '\r' before or a '\n' after
+			sendString(box, (rng() % 2) ? L"\n" : L"\r");
+			break;
+		case 6:
+			sendKey(box, KEY_DELETE, 0, false, true);
+			break;
+		default:
+			sendKey(box, KEY_SPACE, L' ');
+			break;
+		}
+		check(box->hasFullBreak(), "lines differ from breaking the whole text after an edit");
+	}
+}
+
+static void benchmark(IrrlichtDevice *device, CTestEditBox *box, bool bench)
+{
+	std::mt19937 rng(7);
+	const core::stringw document = createDocument(rng, 1 << 20);
+	const u32 keys = bench ? 1000 : 50;
+
+	const double breakTime = measure(1, [&] { box->setText(document.c_str()); });
+	std::printf("%u characters, %u lines, broken in %.3f ms\n", document.size(), box->getLineCount(), breakTime);
+
+	for (bool full : {true, false}) {
+		box->setText(document.c_str());
+		box->setCursor(document.size() / 2);
+		u32 key = 0;
+		const double perKey = measure(keys, [&] {
+			if (key % 20 == 19)
+				sendKey(box, KEY_RETURN);
+			else
+				sendKey(box, KEY_KEY_A, L'a' + key % 26);
+			++key;
+			if (full)
+				box->breakText();
+		});
+		std::printf("typing, %s %8.3f ms per key\n", full ? "whole text broken:" : "paragraph broken: ", perKey);
+	}
+	check(box->hasFullBreak(), "lines differ after typing");
+
+	const double perFrame = measure(10, [&] {
+		device->getVideoDriver()->beginScene();
+		device->getGUIEnvironment()->drawAll();
+		device->getVideoDriver()->endScene();
+	});
+	std::printf("drawing %.3f ms per frame\n", perFrame);
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool bench = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	gui::IGUIEnvironment *env = device->getGUIEnvironment();
+	auto *box = new CTestEditBox(L"", true, env, env->getRootGUIElement(), -1, core::recti(10, 10, 310, 410));
+	box->drop();
+	box->dropOperator();
+	box->setMultiLine(true);
+	box->setWordWrap(true);
+	env->setFocus(box);
+
+	testEdits(box);
+	std::printf("All edit box checks passed\n");
+	benchmark(device, box, bench);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
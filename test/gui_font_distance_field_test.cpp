@@ -0,0 +1,205 @@
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <irrlicht.h>
+#include <IGUIEnvironment.h>
+#include <IGUIFontDistanceField.h>
+#include <IVideoDriver.h>
+#include <IFileSystem.h>
+#include "CGUIFontDistanceField.h"
+#include "test_utils.h"
+
+using namespace irr;
+
+// Compares the distance fields of discs with the real distances to their
+// outlines, at full size and scaled down. Then loads a distance field font
+// from a bitmap font image and checks its measurements at two sizes.
+// Prints the time of making the texture of the font.
+
+//! A disc of radius r around the center of an image of the given size
+static video::IImage *createDisc(video::IVideoDriver *driver, s32 size, f32 r)
+{
+	video::IImage *image = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(size, size));
+	const f32 c = size * 0.5f;
+	for (s32 y = 0; y < size; ++y) {
+		for (s32 x = 0; x < size; ++x) {
+			const f32 dx = x + 0.5f - c, dy = y + 0.5f - c;
+			image->setPixel(x, y, dx * dx + dy * dy < r * r ? 0xFFFFFFFF : 0);
+		}
+	}
+	return image;
+}
+
+static void testField(video::IVideoDriver *driver, s32 downscale)
+{
+	const s32 spread = gui::CGUIFontDistanceField::SPREAD;
+	const s32 size = 40 * downscale;
+	const f32 r = 10.f * downscale;
+	video::IImage *disc = createDisc(driver, size, r);
+	const core::recti rect(5 * downscale, 5 * downscale, 35 * downscale, 35 * downscale);
+
+	video::IImage *field = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(64, 64));
+	field->fill(0);
+	const s32 texels = 30 + 2 * spread;
+	gui::CGUIFontDistanceField::writeDistanceField(disc, rect, downscale, field, core::recti(2, 2, 2 + texels, 2 + texels));
+
+	check(field->getPixel(0, 0).getAlpha() == 0 && field->getPixel(2 + texels, 2).getAlpha() == 0,
+			"written outside of the target rectangle");
+
+	f32 errorSum = 0.f, maxError = 0.f;
+	const f32 origin = (f32)(5 - spread) * downscale;
+	for (s32 ty = 0; ty < texels; ++ty) {
+		for (s32 tx = 0; tx < texels; ++tx) {
+			// texel center in pixels of the disc image
+			const f32 x = origin + (tx + 0.5f) * downscale - size * 0.5f;
+			const f32 y = origin + (ty + 0.5f) * downscale - size * 0.5f;
+			const f32 distance = std::sqrt(x * x + y * y) - r;
+			const f32 expected = core::clamp(0.5f - distance / (2.f * spread * downscale), 0.f, 1.f);
+			const f32 value = field->getPixel(2 + tx, 2 + ty).getAlpha() / 255.f;
+			const f32 error = fabsf(value - expected);
+			errorSum += error;
+			maxError = core::max_(maxError, error);
+		}
+	}
+	std::printf("downscale %d: mean error %.4f, max error %.4f\n", downscale, errorSum / (texels * texels), maxError);
+	check(errorSum / (texels * texels) < 0.02f, "distances differ on average");
+	check(maxError < 0.1f, "distances differ");
+	check(field->getPixel(2 + texels / 2, 2 + texels / 2).getAlpha() == 255, "center not inside");
+
+	field->drop();
+	disc->drop();
+}
+
+//! Writes a bitmap font image of a space, a bar, a disc and a ring, 64 pixels high
+static void writeFontImage(video::IVideoDriver *driver, const io::path &filename)
+{
+	const s32 widths[] = {16, 20, 40, 30};
+	const s32 height = 64;
+	video::IImage *image = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(120, height + 1));
+	image->fill(0xFF000000);
+
+	s32 x = 0;
+	for (s32 i = 0; i < 4; ++i) {
+		const s32 w = widths[i];
+		for (s32 py = 0; py < height; ++py) {
+			for (s32 px = 0; px < w; ++px) {
+				const f32 dx = px + 0.5f - w * 0.5f, dy = py + 0.5f - 32.f;
+				const f32 d = std::sqrt(dx * dx + dy * dy);
+				const bool inside = (i == 1 && px >= 6 && px < 14 && py >= 8 && py < 56) ||
+						(i == 2 && d < 18.f) || (i == 3 && d < 14.f && d > 8.f);
+				if (inside)
+					image->setPixel(x + px, py, 0xFFFFFFFF);
+			}
+		}
+		image->setPixel(x, 0, 0xFFFF0000);
+		image->setPixel(x + w, height, 0xFF0000FF);
+		x += w + 2;
+	}
+	// the colors of the corners and the background
+	image->setPixel(1, 0, 0xFF0000FF);
+	image->setPixel(2, 0, 0xFF000000);
+
+	check(driver->writeImageToFile(image, filename), "could not write the font image");
+	image->drop();
+}
+
+//! Writes a bitmap font image of one filled character of the given size
+static void writeWideFontImage(video::IVideoDriver *driver, const io::path &filename, s32 width, s32 height)
+{
+	video::IImage *image = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(width + 1, height + 1));
+	image->fill(0xFFFFFFFF);
+	image->setPixel(0, 0, 0xFFFF0000);
+	image->setPixel(width, height, 0xFF0000FF);
+	image->setPixel(1, 0, 0xFF0000FF);
+	image->setPixel(2, 0, 0xFF000000);
+	check(driver->writeImageToFile(image, filename), "could not write the font image");
+	image->drop();
+}
+
+//! Characters wider than the smallest atlas make it larger, too large ones fail
+static void testWideCharacters(IrrlichtDevice *device)
+{
+	video::IVideoDriver *driver = device->getVideoDriver();
+	gui::IGUIEnvironment *env = device->getGUIEnvironment();
+	const io::path wide = "gui_font_distance_field_test_wide.png";
+	writeWideFontImage(driver, wide, 200, 16);
+	gui::IGUIFontDistanceField *font = env->getDistanceFieldFont(wide);
+	check(font && font->getTexture(), "font with a wide character not loaded");
+	check(font->getTexture()->getOriginalSize().Width >= 200 + 2 * gui::CGUIFontDistanceField::SPREAD,
+			"wide character cropped");
+
+	const io::path tooWide = "gui_font_distance_field_test_too_wide.png";
+	writeWideFontImage(driver, tooWide, 17000, 32);
+	check(!env->getDistanceFieldFont(tooWide), "font wider than the largest atlas loaded");
+
+	remove(wide.c_str());
+	remove(tooWide.c_str());
+}
+
+static void testFont(IrrlichtDevice *device)
+{
+	video::IVideoDriver *driver = device->getVideoDriver();
+	gui::IGUIEnvironment *env = device->getGUIEnvironment();
+	const io::path filename = "gui_font_distance_field_test.png";
+	writeFontImage(driver, filename);
+
+	gui::IGUIFontDistanceField *font = nullptr;
+	const double buildTime = measure(1, [&] { font = env->getDistanceFieldFont(filename); });
+	check(font, "font not loaded");
+	std::printf("distance field texture made in %.2f ms\n", buildTime);
+
+	check(font->getType() == gui::EGFT_DISTANCE_FIELD, "wrong font type");
+	check(font->getTexture(), "no texture");
+	check(env->getDistanceFieldFont(filename) == font && env->getFont(filename) == font, "font not kept");
+	check(font->getLineHeight() == 64.f, "line height not the one of the image");
+
+	// "!" is the bar, '"' the disc, unknown characters are spaces
+	check(font->getDimension(L"!\"") == core::dimension2du(60, 64), "wrong dimension");
+	check(font->getDimension(L"!\n\"\"") == core::dimension2du(80, 128), "wrong dimension of two lines");
+	check(font->getDimension(L"x") == core::dimension2du(16, 64), "unknown character not a space");
+	check(font->getCharacterFromPos(L"!\"#", 50) == 1, "wrong character at a position");
+
+	gui::IGUIFontDistanceField *small = font->createSizedFont(32.f);
+	check(small->getTexture() == font->getTexture(), "texture not shared");
+	check(small->getDimension(L"!\"#") == core::dimension2du(45, 32), "wrong dimension at half the size");
+	core::array<s32> widths;
+	small->getPrefixWidths(L"!\"#", widths);
+	check(widths.size() == 4 && widths[1] == 10 && widths[2] == 30 && widths[3] == 45, "wrong prefix widths");
+	font->setLineHeight(16.f);
+	check(font->getDimension(L"\"") == core::dimension2du(10, 16), "wrong dimension after setting the size");
+	check(small->getLineHeight() == 32.f, "size of the other font changed");
+
+	// the null driver draws images, which must not fail
+	driver->beginScene();
+	small->draw(L"!\"#\n#\"!", core::recti(0, 0, 200, 100), video::SColor(255, 255, 255, 255), true, true);
+	const core::recti clip(10, 10, 20, 20);
+	font->draw(L"!\"#", core::recti(0, 0, 200, 100), video::SColor(255, 255, 255, 255), false, false, &clip);
+	driver->endScene();
+	small->drop();
+
+	// a bitmap font stored under the name is not turned into a distance field font
+	const io::path other = "gui_font_distance_field_test_bitmap.png";
+	writeFontImage(driver, other);
+	check(env->getFont(other) != 0, "bitmap font not loaded");
+	check(env->getDistanceFieldFont(other) == 0, "bitmap font returned as distance field font");
+
+	remove(filename.c_str());
+	remove(other.c_str());
+}
+
+int main(int argc, char *argv[])
+try {
+	IrrlichtDevice *device = createNullDevice();
+
+	testField(device->getVideoDriver(), 1);
+	testField(device->getVideoDriver(), 2);
+	testFont(device);
+	testWideCharacters(device);
+	std::printf("All distance field font checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,172 @@
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <irrlicht.h>
+#include <IGUIEnvironment.h>
+#include <IGUIFont.h>
+#include <IGUIStaticText.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that the character table of the bitmap font measures like the
+// character map, that the widths of the beginnings of a text match measuring
+// each beginning, and that static text wraps as it did when measuring each
+// word. Prints the time of wrapping a long text.
+// Pass "--bench" for a longer text.
+
+//! Words, whitespace runs and line breaks of mapped and unmapped characters
+static core::stringw createText(std::mt19937 &rng, u32 size)
+{
+	const wchar_t *parts[] = {L"lorem", L"ipsum", L"Dolor", L"sit", L"amet,", L"été",
+			L"中文", L"\U0001F600", L"x", L"verylongwordwhichdoesnotfitintoasinglelineofthetext",
+			L" ", L" ", L" ", L"  ", L"   ", L"\n", L"\r", L"\r\n", L"\n\n"};
+	core::stringw text;
+	while (text.size() < size)
+		text += parts[rng() % (sizeof(parts) / sizeof(*parts))];
+	return text;
+}
+
+static void testMeasuring(gui::IGUIFont *font)
+{
+	check(font->getType() == gui::EGFT_BITMAP, "built-in font is no bitmap font");
+	check(font->getDimension(L"A").Width > 0, "no width of a mapped character");
+	check(font->getDimension(L"中") == font->getDimension(L" "), "unmapped BMP character not measured as space");
+	check(font->getDimension(L"\U0001F600") == font->getDimension(L" "), "unmapped character not measured as space");
+
+	std::mt19937 rng(43);
+	core::array<s32> widths, defaultWidths;
+	for (u32 n = 0; n < 200; ++n) {
+		const core::stringw text = createText(rng, rng() % 100);
+		font->getPrefixWidths(text.c_str(), widths);
+		check(widths.size() == text.size() + 1, "not one width per character");
+
+		font->gui::IGUIFont::getPrefixWidths(text.c_str(), defaultWidths);
+		check(widths == defaultWidths, "widths differ from adding up single characters");
+
+		u32 lineStart = 0;
+		for (u32 i = 0; i <= text.size(); ++i) {
+			if (i > 0 && (text[i - 1] == L'\r' || text[i - 1] == L'\n'))
+				lineStart = i;
+			const core::stringw line = text.subString(lineStart, i - lineStart);
+			check(widths[i] == (s32)font->getDimension(line.c_str()).Width, "width differs from measuring the beginning");
+		}
+	}
+
+	// getCharacterFromPos on single lines
+	for (u32 n = 0; n < 50; ++n) {
+		core::stringw text = createText(rng, 50);
+		text.replace(L'\r', L' ');
+		text.replace(L'\n', L' ');
+		font->getPrefixWidths(text.c_str(), widths);
+		for (s32 x = -5; x < widths.getLast() + 10; x += 3) {
+			s32 expected = -1;
+			for (u32 i = 0; i < text.size() && expected < 0; ++i) {
+				if (widths[i + 1] >= x)
+					expected = i;
+			}
+			check(font->getCharacterFromPos(text.c_str(), x) == expected, "wrong character at a position");
+		}
+	}
+}
+
+//! Breaks a text like static text did by measuring each word and whitespace
+static core::array<core::stringw> breakText(gui::IGUIFont *font, core::stringw text, s32 elWidth)
+{
+	text.replace(L"\r\n", L"\r");
+	core::array<core::stringw> lines;
+	core::stringw line, word, whitespace;
+	s32 length = 0;
+	const s32 size = text.size();
+	for (s32 i = 0; i < size; ++i) {
+		wchar_t c = text[i];
+		const bool lineBreak = c == L'\r' || c == L'\n';
+		if (lineBreak)
+			c = 0;
+		const bool isWhitespace = c == L' ' || c == 0;
+		if (!isWhitespace)
+			word += c;
+
+		if (isWhitespace || i == size - 1) {
+			if (word.size()) {
+				const s32 whitelgth = font->getDimension(whitespace.c_str()).Width;
+				const s32 wordlgth = font->getDimension(word.c_str()).Width;
+				if (wordlgth > elWidth || (length && length + wordlgth + whitelgth > elWidth)) {
+					if (length || wordlgth <= elWidth)
+						lines.push_back(line);
+					length = wordlgth;
+					line = word;
+				} else {
+					line += whitespace;
+					line += word;
+					length += whitelgth + wordlgth;
+				}
+				word = L"";
+				whitespace = L"";
+			}
+			if (isWhitespace)
+				whitespace += c;
+			if (lineBreak) {
+				line += whitespace;
+				line += word;
+				lines.push_back(line);
+				line = L"";
+				word = L"";
+				whitespace = L"";
+				length = 0;
+			}
+		}
+	}
+	line += whitespace;
+	line += word;
+	lines.push_back(line);
+	return lines;
+}
+
+static void testWrapping(gui::IGUIEnvironment *env, gui::IGUIFont *font, bool bench)
+{
+	gui::IGUIStaticText *text = env->addStaticText(L"", core::recti(10, 10, 210, 410));
+	text->setWordWrap(true);
+	const s32 lineHeight = font->getDimension(L"A").Height + font->getKerning(L'A').Y;
+
+	std::mt19937 rng(44);
+	for (u32 n = 0; n < 200; ++n) {
+		const core::stringw str = createText(rng, rng() % 1000);
+		text->setText(str.c_str());
+		const core::array<core::stringw> lines = breakText(font, str, 200);
+		s32 widest = 0;
+		for (u32 i = 0; i < lines.size(); ++i)
+			widest = core::max_(widest, (s32)font->getDimension(lines[i].c_str()).Width);
+		check(text->getTextHeight() == lineHeight * (s32)lines.size(), "different number of lines");
+		check(text->getTextWidth() == widest, "different widest line");
+	}
+
+	const core::stringw str = createText(rng, bench ? 1 << 22 : 1 << 18);
+	const double wrapTime = measure(1, [&] { text->setText(str.c_str()); });
+	std::printf("%u characters wrapped into %d lines in %.3f ms\n", str.size(),
+			text->getTextHeight() / lineHeight, wrapTime);
+
+	std::printf("measuring each word: %.3f ms\n", measure(1, [&] { breakText(font, str, 200); }));
+	text->remove();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool bench = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	gui::IGUIEnvironment *env = device->getGUIEnvironment();
+	gui::IGUIFont *font = env->getBuiltInFont();
+	check(font != 0, "no built-in font");
+
+	testMeasuring(font);
+	testWrapping(env, font, bench);
+	std::printf("All font checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <irrlicht.h>
+#include <IGUIEnvironment.h>
+#include <IGUIElement.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that finding the element at a point, which skips subtrees not
+// containing it and optionally uses a grid of the children, finds the same
+// elements as asking every element, also after changing the tree. Then
+// times hover updates on a tree of 10000 elements.
+// Pass "--bench" for more points and mouse moves.
+
+//! Asks every visible element, as getElementFromPoint() did
+static gui::IGUIElement *findElement(gui::IGUIElement *element, const core::position2di &point)
+{
+	if (!element->isVisible())
+		return 0;
+	const auto &children = element->getChildren();
+	for (auto it = children.rbegin(); it != children.rend(); ++it) {
+		if (gui::IGUIElement *target = findElement(*it, point))
+			return target;
+	}
+	return element->isPointInside(point) ? element : 0;
+}
+
+static gui::IGUIElement *addElement(gui::IGUIEnvironment *env, gui::IGUIElement *parent, const core::recti &rect)
+{
+	auto *e = new gui::IGUIElement(gui::EGUIET_ELEMENT, env, parent, -1, rect);
+	e->drop();
+	return e;
+}
+
+//! 100 panels with 99 children each, some of them reaching outside their panel
+static void createTree(gui::IGUIEnvironment *env, std::mt19937 &rng)
+{
+	gui::IGUIElement *root = env->getRootGUIElement();
+	for (s32 p = 0; p < 100; ++p) {
+		const core::recti rect((p % 10) * 64, (p / 10) * 48, (p % 10) * 64 + 60, (p / 10) * 48 + 44);
+		gui::IGUIElement *panel = addElement(env, root, rect);
+		for (s32 c = 0; c < 99; ++c) {
+			const s32 x = (c % 11) * 6, y = (c / 11) * 5;
+			gui::IGUIElement *e = addElement(env, panel, core::recti(x, y, x + 5 + rng() % 4, y + 4 + rng() % 3));
+			if (rng() % 50 == 0) {
+				// reaches into the next panel
+				e->setNotClipped(true);
+				e->setRelativePosition(core::recti(x, y, x + 90, y + 30));
+			}
+			if (rng() % 40 == 0)
+				e->setVisible(false);
+		}
+	}
+}
+
+static void compare(gui::IGUIEnvironment *env, std::mt19937 &rng, u32 points, const char *message)
+{
+	gui::IGUIElement *root = env->getRootGUIElement();
+	for (u32 i = 0; i < points; ++i) {
+		const core::position2di point(s32(rng() % 700) - 30, s32(rng() % 540) - 30);
+		check(root->getElementFromPoint(point) == findElement(root, point), message);
+	}
+}
+
+static void testTree(gui::IGUIEnvironment *env, bool bench)
+{
+	const u32 points = bench ? 5000 : 50;
+	std::mt19937 rng(45);
+	createTree(env, rng);
+	gui::IGUIElement *root = env->getRootGUIElement();
+	const auto &panels = root->getChildren();
+
+	compare(env, rng, points, "different element without a grid");
+	root->setHitTestGridEnabled(true);
+	for (auto panel : panels)
+		panel->setHitTestGridEnabled(rng() % 2);
+	check(root->isHitTestGridEnabled(), "grid not enabled");
+	compare(env, rng, points, "different element with grids");
+
+	// change the layout and the order
+	for (u32 step = 0; step < 40; ++step) {
+		auto it = panels.begin();
+		std::advance(it, rng() % panels.size());
+		gui::IGUIElement *panel = *it;
+		switch (step % 5) {
+		case 0:
+			panel->move(core::position2di(s32(rng() % 41) - 20, s32(rng() % 41) - 20));
+			break;
+		case 1:
+			root->bringToFront(panel);
+			break;
+		case 2:
+			root->sendToBack(panel);
+			break;
+		case 3: {
+			// move a child of a panel
+			if (panel->getChildren().empty())
+				break;
+			auto child = panel->getChildren().begin();
+			std::advance(child, rng() % panel->getChildren().size());
+			(*child)->setRelativePosition(core::recti(0, 0, 70, 50));
+			break;
+		}
+		default:
+			if (rng() % 2)
+				panel->remove();
+			else
+				addElement(env, root, core::recti(100, 100, 300, 250));
+			break;
+		}
+		compare(env, rng, points, "different element after changing the tree");
+	}
+	root->setHitTestGridEnabled(false);
+	compare(env, rng, points, "different element after removing the grid");
+}
+
+static void benchmark(IrrlichtDevice *device, bool bench)
+{
+	gui::IGUIEnvironment *env = device->getGUIEnvironment();
+	gui::IGUIElement *root = env->getRootGUIElement();
+	root->removeAllChildren();
+	std::mt19937 rng(46);
+	createTree(env, rng);
+
+	u32 count = 0;
+	std::vector<gui::IGUIElement *> stack{root};
+	while (!stack.empty()) {
+		gui::IGUIElement *e = stack.back();
+		stack.pop_back();
+		++count;
+		stack.insert(stack.end(), e->getChildren().begin(), e->getChildren().end());
+	}
+
+	const u32 moves = bench ? 1000000 : 500;
+	std::vector<core::position2di> points;
+	for (u32 i = 0; i < moves; ++i)
+		points.emplace_back(rng() % 640, rng() % 480);
+
+	size_t sum = 0;
+	const double askTime = measure(1, [&] {
+		for (const auto &p : points)
+			sum += (size_t)findElement(root, p);
+	});
+	std::printf("%u elements, asking each element: %8.3f us per point\n", count, askTime * 1e3 / moves);
+
+	for (bool grid : {false, true}) {
+		root->setHitTestGridEnabled(grid);
+		SEvent event;
+		event.EventType = EET_MOUSE_INPUT_EVENT;
+		event.MouseInput.Event = EMIE_MOUSE_MOVED;
+		event.MouseInput.Wheel = 0.f;
+		event.MouseInput.ButtonStates = 0;
+		event.MouseInput.Shift = false;
+		event.MouseInput.Control = false;
+		const double hoverTime = measure(1, [&] {
+			for (const auto &p : points) {
+				event.MouseInput.X = p.X;
+				event.MouseInput.Y = p.Y;
+				env->postEventFromUser(event);
+			}
+		});
+		std::printf("hover updates, %s %8.3f us per mouse move\n", grid ? "with grid:   " : "subtree rects:",
+				hoverTime * 1e3 / moves);
+	}
+	check(sum != 0, "no elements found");
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool bench = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	testTree(device->getGUIEnvironment(), bench);
+	std::printf("All hit test checks passed\n");
+	benchmark(device, bench);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,169 @@
+#include <cstdio>
+#include <cwchar>
+#include <stdexcept>
+#include <irrlicht.h>
+#include <IGUIEnvironment.h>
+#include <IGUIListBox.h>
+#include <IGUIScrollBar.h>
+#include <IVideoDriver.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that a list box draws only the visible rows, and that a list box
+// with an item provider asks only for the items it draws or searches.
+// Prints the draw time of a list with very many items.
+// Pass "--bench" for more items.
+
+//! Numbered items, which counts the texts asked for
+class CNumberedItems : public gui::IGUIListBoxItemProvider
+{
+public:
+	CNumberedItems(u32 count) :
+			Count(count) {}
+
+	u32 getItemCount() const override { return Count; }
+
+	const wchar_t *getItemText(u32 index) const override
+	{
+		++Asked;
+		MinAsked = core::min_(MinAsked, index);
+		MaxAsked = core::max_(MaxAsked, index);
+		swprintf(Text, 32, L"Item %07u", index);
+		return Text;
+	}
+
+	bool getItemOverrideColor(u32 index, gui::EGUI_LISTBOX_COLOR colorType, video::SColor &color) const override
+	{
+		if (index % 2)
+			return false;
+		color = video::SColor(255, 255, 0, 0);
+		return true;
+	}
+
+	void resetCounters()
+	{
+		Asked = 0;
+		MinAsked = 0xffffffff;
+		MaxAsked = 0;
+	}
+
+	u32 Count;
+	mutable u32 Asked = 0, MinAsked = 0xffffffff, MaxAsked = 0;
+
+private:
+	mutable wchar_t Text[32];
+};
+
+static void drawFrame(IrrlichtDevice *device)
+{
+	device->getVideoDriver()->beginScene();
+	device->getGUIEnvironment()->drawAll();
+	device->getVideoDriver()->endScene();
+}
+
+static void pressKey(gui::IGUIListBox *list, EKEY_CODE key, wchar_t c = 0)
+{
+	SEvent event;
+	event.EventType = EET_KEY_INPUT_EVENT;
+	event.KeyInput.Key = key;
+	event.KeyInput.Char = c;
+	event.KeyInput.PressedDown = true;
+	event.KeyInput.Shift = false;
+	event.KeyInput.Control = false;
+	list->OnEvent(event);
+}
+
+static void testProvider(IrrlichtDevice *device, u32 count)
+{
+	gui::IGUIListBox *list = device->getGUIEnvironment()->addListBox(core::recti(10, 10, 210, 410));
+	list->setItemHeight(20);
+	const u32 visibleRows = 400 / 20 + 1;
+
+	CNumberedItems items(count);
+	list->setItemProvider(&items);
+	check(list->getItemProvider() == &items, "provider not set");
+	check(list->getItemCount() == count, "wrong item count");
+	check(wcscmp(list->getListItem(1234), L"Item 0001234") == 0, "wrong item text");
+	check(list->getListItem(count) == 0, "text of an item past the end");
+	check(list->addItem(L"own item") == (u32)-1 && list->insertItem(0, L"own item", -1) == -1,
+			"items added to a list with a provider");
+	check(list->hasItemOverrideColor(2, gui::EGUI_LBC_TEXT) && !list->hasItemOverrideColor(3, gui::EGUI_LBC_TEXT),
+			"override colors not from the provider");
+
+	items.resetCounters();
+	drawFrame(device);
+	check(items.Asked > 0 && items.Asked <= visibleRows + 1, "items drawn which are not visible");
+	check(items.MinAsked == 0, "first item not drawn");
+
+	// scrolled to the middle
+	list->setSelected(count / 2);
+	check(list->getVerticalScrollBar()->getPos() > 0, "not scrolled to the selected item");
+	items.resetCounters();
+	drawFrame(device);
+	check(items.Asked <= visibleRows + 1, "items drawn which are not visible");
+	check(items.MinAsked <= count / 2 && items.MaxAsked >= count / 2 && items.MaxAsked - items.MinAsked < visibleRows + 1,
+			"selected item not drawn");
+	const s32 hit = list->getItemAt(20, 10 + (count / 2) * 20 - list->getVerticalScrollBar()->getPos() + 5);
+	check(hit == (s32)count / 2, "wrong item at a position");
+
+	pressKey(list, KEY_END);
+	check(list->getSelected() == (s32)count - 1, "end key did not select the last item");
+	items.resetCounters();
+	drawFrame(device);
+	check(items.MaxAsked == count - 1, "last item not drawn");
+
+	// typing searches the items from the selection on
+	list->setSelected(0);
+	pressKey(list, KEY_KEY_I, L'i');
+	check(list->getSelected() == 1, "typed key did not select the next matching item");
+
+	// own items again
+	list->setItemProvider(0);
+	check(list->getItemCount() == 0 && list->getSelected() == -1, "provider items left after removing it");
+	check(list->addItem(L"own item") == 0, "no own items after removing the provider");
+	list->remove();
+}
+
+static void testOwnItems(IrrlichtDevice *device, u32 count, bool bench)
+{
+	gui::IGUIListBox *list = device->getGUIEnvironment()->addListBox(core::recti(10, 10, 210, 410));
+	list->setItemHeight(20);
+	wchar_t text[32];
+	for (u32 i = 0; i < count; ++i) {
+		swprintf(text, 32, L"Item %07u", i);
+		list->addItem(text);
+	}
+
+	list->setSelected(count - 1);
+	check(list->getItemAt(20, 405) == (s32)count - 1, "last item not at the bottom");
+	list->setSelected(L"Item 0000007");
+	check(list->getSelected() == 7, "item not found by its text");
+
+	const u32 frames = bench ? 1000 : 100;
+	u32 frame = 0;
+	const double perFrame = measure(frames, [&] {
+		list->setSelected((frame++ * 7919) % count);
+		drawFrame(device);
+	});
+	std::printf("%u items: %.3f ms per frame\n", count, perFrame);
+	list->remove();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool bench = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	const u32 count = bench ? 1000000 : 100000;
+	testProvider(device, count);
+	testOwnItems(device, count, bench);
+	std::printf("All list box checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,166 @@
+#include <cstdio>
+#include <stdexcept>
+#include <irrlicht.h>
+#include <IGUIEnvironment.h>
+#include <IGUIButton.h>
+#include <IGUIStaticText.h>
+#include <IVideoDriver.h>
+#include "CGUIRenderCache.h"
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks when a render cache finds its children changed or is invalidated
+// by input, and that drivers without render targets draw the children
+// directly. Prints the time of drawing a panel compared to checking it for
+// changes, which is what a cached panel costs per frame besides one image.
+// Pass "--bench" for more frames.
+
+//! Counts how often it is drawn
+class CCountingElement : public gui::IGUIElement
+{
+public:
+	CCountingElement(gui::IGUIEnvironment *env, gui::IGUIElement *parent, const core::recti &rect) :
+			IGUIElement(gui::EGUIET_ELEMENT, env, parent, -1, rect) {}
+
+	void draw() override
+	{
+		if (isVisible())
+			++Draws;
+		IGUIElement::draw();
+	}
+
+	u32 Draws = 0;
+};
+
+static void drawFrame(IrrlichtDevice *device)
+{
+	device->getVideoDriver()->beginScene();
+	device->getGUIEnvironment()->drawAll();
+	device->getVideoDriver()->endScene();
+}
+
+static void postMouse(gui::IGUIEnvironment *env, EMOUSE_INPUT_EVENT type, s32 x, s32 y, u32 buttons = 0)
+{
+	SEvent event;
+	event.EventType = EET_MOUSE_INPUT_EVENT;
+	event.MouseInput.Event = type;
+	event.MouseInput.X = x;
+	event.MouseInput.Y = y;
+	event.MouseInput.Wheel = 0.f;
+	event.MouseInput.ButtonStates = buttons;
+	event.MouseInput.Shift = false;
+	event.MouseInput.Control = false;
+	env->postEventFromUser(event);
+}
+
+static void testChanges(IrrlichtDevice *device)
+{
+	gui::IGUIEnvironment *env = device->getGUIEnvironment();
+	gui::IGUIRenderCache *cache = env->addRenderCache(core::recti(100, 100, 400, 300));
+	check(cache && cache->getType() == gui::EGUIET_RENDER_CACHE, "no render cache");
+	auto *internal = static_cast<gui::CGUIRenderCache *>(cache);
+
+	auto *counter = new CCountingElement(env, cache, core::recti(0, 0, 50, 50));
+	counter->drop();
+	gui::IGUIStaticText *text = env->addStaticText(L"text", core::recti(60, 0, 200, 20), false, true, cache);
+	gui::IGUIButton *button = env->addButton(core::recti(60, 40, 200, 70), cache, -1, L"button");
+
+	// the null driver has no render targets
+	drawFrame(device);
+	drawFrame(device);
+	check(counter->Draws == 2, "children not drawn directly without render targets");
+	check(cache->getRenderCount() == 0, "drawn into a texture without render targets");
+
+	check(!internal->updateState(), "changed without a change");
+	text->setText(L"other text");
+	check(internal->updateState() && !internal->updateState(), "text change not found");
+	text->setRelativePosition(core::recti(60, 0, 210, 20));
+	check(internal->updateState(), "position change not found");
+	cache->setRelativePosition(core::recti(110, 100, 410, 300));
+	check(internal->updateState(), "position change of the cache not found");
+	button->setEnabled(false);
+	check(internal->updateState(), "enabled change not found");
+	button->setEnabled(true);
+	counter->setVisible(false);
+	check(internal->updateState(), "visibility change not found");
+	counter->setVisible(true);
+	internal->updateState();
+	env->setFocus(button);
+	check(internal->updateState(), "focus change not found");
+
+	// input to the children, the focused one gets all of it
+	env->removeFocus(button);
+	drawFrame(device);
+	check(!internal->isInvalidated(), "invalidated after drawing");
+	postMouse(env, EMIE_MOUSE_MOVED, 500, 400);
+	check(!internal->isInvalidated(), "invalidated by input to other elements");
+	// hovering is found by comparing, plain moves do not invalidate
+	postMouse(env, EMIE_MOUSE_MOVED, 180, 150);
+	check(env->getHovered() == button, "button not hovered");
+	check(!internal->isInvalidated(), "invalidated by a mouse move");
+	check(internal->updateState(), "hover change not found");
+	postMouse(env, EMIE_LMOUSE_PRESSED_DOWN, 180, 150);
+	check(env->getFocus() == button, "button not focused");
+	check(internal->isInvalidated(), "not invalidated by a click on a child");
+	drawFrame(device);
+	postMouse(env, EMIE_MOUSE_MOVED, 190, 150, EMBSM_LEFT);
+	check(internal->isInvalidated(), "not invalidated by dragging in a child");
+	drawFrame(device);
+
+	// the focused child gets the moves, but only a press elsewhere may change it
+	postMouse(env, EMIE_MOUSE_MOVED, 500, 400);
+	check(!internal->isInvalidated(), "invalidated by a mouse move outside");
+	postMouse(env, EMIE_LMOUSE_LEFT_UP, 500, 400);
+	check(internal->isInvalidated(), "focused child not invalidated by a button event");
+	env->removeFocus(env->getFocus());
+	drawFrame(device);
+	cache->invalidate();
+	check(internal->isInvalidated(), "not invalidated");
+
+	// elements outside do not count
+	env->addStaticText(L"outside", core::recti(0, 0, 50, 20));
+	check(!internal->updateState(), "change of another element found");
+	cache->remove();
+}
+
+static void benchmark(IrrlichtDevice *device, bool bench)
+{
+	gui::IGUIEnvironment *env = device->getGUIEnvironment();
+	gui::IGUIRenderCache *cache = env->addRenderCache(core::recti(0, 0, 640, 480));
+	wchar_t label[32];
+	for (s32 i = 0; i < 200; ++i) {
+		const core::recti rect((i % 4) * 160, (i / 4) * 9, (i % 4) * 160 + 150, (i / 4) * 9 + 9);
+		swprintf(label, 32, L"Label number %d", i);
+		if (i % 2)
+			env->addStaticText(label, rect, true, true, cache);
+		else
+			env->addButton(rect, cache, -1, label);
+	}
+
+	const u32 frames = bench ? 10000 : 500;
+	std::printf("200 elements drawn directly:  %.4f ms per frame\n",
+			measure(frames, [&] { drawFrame(device); }));
+
+	auto *internal = static_cast<gui::CGUIRenderCache *>(cache);
+	std::printf("200 elements checked for changes: %.4f ms per frame\n",
+			measure(frames, [&] { internal->updateState(); }));
+	cache->remove();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool bench = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	testChanges(device);
+	std::printf("All render cache checks passed\n");
+	benchmark(device, bench);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
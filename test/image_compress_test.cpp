@@ -0,0 +1,278 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+#include <IVideoDriver.h>
+#include <IFileSystem.h>
+#include "CImageCompressor.h"
+#include "CImageLoaderDDS.h"
+#include "CImageLoaderKTX.h"
+#include "test_utils.h"
+
+using namespace irr;
+using video::CImageCompressor;
+
+// Checks the DXT encoder and decoder of CImageCompressor and the DDS and
+// KTX2 loaders, feeding them files built in memory.
+
+//! smooth gradient, up to 63x63 pixels
+static video::IImage *createGradient(video::IVideoDriver *driver, const core::dimension2du &size, bool alpha)
+{
+	video::IImage *img = driver->createImage(video::ECF_A8R8G8B8, size);
+	for (u32 y = 0; y < size.Height; ++y) {
+		for (u32 x = 0; x < size.Width; ++x) {
+			const u32 a = alpha ? x * 4 : 255;
+			img->setPixel(x, y, video::SColor(a, x * 4, y * 3, (x + y) * 2));
+		}
+	}
+	return img;
+}
+
+//! largest difference of a color channel between two A8R8G8B8 images
+static u32 maxError(video::IImage *a, video::IImage *b)
+{
+	const u8 *pa = (const u8 *)a->getData(), *pb = (const u8 *)b->getData();
+	u32 err = 0;
+	for (u32 i = 0; i < a->getImageDataSizeInBytes(); ++i)
+		err = core::max_(err, (u32)std::abs(pa[i] - pb[i]));
+	return err;
+}
+
+static void testRoundTrip(video::IVideoDriver *driver)
+{
+	// sizes that are no multiple of the block size are padded by the encoder
+	const core::dimension2du sizes[] = {{1, 1}, {3, 7}, {30, 22}, {63, 63}};
+	for (const auto &size : sizes) {
+		for (bool alpha : {false, true}) {
+			video::IImage *src = createGradient(driver, size, alpha);
+			const video::ECOLOR_FORMAT format = CImageCompressor::chooseFormat(src);
+			if (format != (alpha ? video::ECF_DXT5 : video::ECF_DXT1))
+				throw std::runtime_error("chooseFormat picked the wrong format");
+
+			video::IImage *compressed = CImageCompressor::compress(src, format, false);
+			if (!compressed || compressed->getColorFormat() != format || compressed->getDimension() != size)
+				throw std::runtime_error("compress failed");
+			if (compressed->getImageDataSizeInBytes() != video::IImage::getDataSizeFromFormat(format, size.Width, size.Height))
+				throw std::runtime_error("compressed data has the wrong size");
+
+			video::IImage *decoded = CImageCompressor::decompress(compressed);
+			if (!decoded || decoded->getColorFormat() != video::ECF_A8R8G8B8 || decoded->getDimension() != size)
+				throw std::runtime_error("decompress failed");
+			// a smooth gradient fits the block endpoints well
+			if (maxError(src, decoded) > 24)
+				throw std::runtime_error("compression error too large");
+
+			decoded->drop();
+			compressed->drop();
+			src->drop();
+		}
+	}
+}
+
+//! single colors must survive up to the precision of R5G6B5
+static void testSolidBlocks()
+{
+	const u32 colors[] = {0xff000000, 0xffffffff, 0xff808080, 0xffff0000, 0xff12ab34};
+	for (u32 color : colors) {
+		u32 pixels[16], decoded[16];
+		u8 block[16];
+		for (u32 &p : pixels)
+			p = color;
+		CImageCompressor::encodeBlockDXT1(pixels, block);
+		CImageCompressor::decodeBlock(video::ECF_DXT1, block, decoded);
+		for (u32 i = 0; i < 16; ++i) {
+			const video::SColor a(pixels[i]), b(decoded[i]);
+			if (b.getAlpha() != 255 || std::abs((s32)a.getRed() - (s32)b.getRed()) > 4 ||
+					std::abs((s32)a.getGreen() - (s32)b.getGreen()) > 2 || std::abs((s32)a.getBlue() - (s32)b.getBlue()) > 4)
+				throw std::runtime_error("solid DXT1 block changed color");
+		}
+
+		for (u32 &p : pixels)
+			p = (color & 0x00ffffff) | 0x40000000;
+		CImageCompressor::encodeBlockDXT5(pixels, block);
+		CImageCompressor::decodeBlock(video::ECF_DXT5, block, decoded);
+		for (u32 i = 0; i < 16; ++i) {
+			if (video::SColor(decoded[i]).getAlpha() != 0x40)
+				throw std::runtime_error("solid DXT5 block changed alpha");
+		}
+	}
+}
+
+static void testMipMaps(video::IVideoDriver *driver)
+{
+	video::IImage *src = createGradient(driver, {40, 12}, false);
+	video::IImage *compressed = CImageCompressor::compress(src, video::ECF_DXT1, true);
+	// 40x12 -> 20x6 -> 10x3 -> 5x1 -> 2x1 -> 1x1
+	if (compressed->getMipMapLevelCount() != 5)
+		throw std::runtime_error("wrong number of mipmap levels");
+	const u8 *last = (const u8 *)compressed->getMipMapsData(5);
+	if (!last || compressed->getMipMapsData(6))
+		throw std::runtime_error("wrong mipmap data pointers");
+	if ((const u8 *)compressed->getMipMapsData(1) + 5 * 2 * 8 + 3 * 1 * 8 + 2 * 1 * 8 + 8 != last)
+		throw std::runtime_error("wrong mipmap data layout");
+
+	video::IImage *decoded = CImageCompressor::decompress(compressed);
+	if (decoded->getMipMapLevelCount() != 5)
+		throw std::runtime_error("decompress lost the mipmaps");
+
+	decoded->drop();
+	compressed->drop();
+	src->drop();
+}
+
+//! all mipmap levels of an image in one block, as the containers store them
+static std::vector<u8> allLevels(video::IImage *image)
+{
+	std::vector<u8> data((u8 *)image->getData(), (u8 *)image->getData() + image->getImageDataSizeInBytes());
+	for (u32 i = 1; i <= image->getMipMapLevelCount(); ++i) {
+		const core::dimension2du size = image->getMipMapsSize(i);
+		const u8 *level = (const u8 *)image->getMipMapsData(i);
+		data.insert(data.end(), level, level + video::IImage::getDataSizeFromFormat(image->getColorFormat(), size.Width, size.Height));
+	}
+	return data;
+}
+
+static void checkLoaded(video::IImage *loaded, video::IImage *expected, u32 levels, const char *what)
+{
+	if (!loaded)
+		throw std::runtime_error(std::string(what) + ": not loaded");
+	if (loaded->getColorFormat() != expected->getColorFormat() || loaded->getDimension() != expected->getDimension())
+		throw std::runtime_error(std::string(what) + ": wrong format or size");
+	if (loaded->getMipMapLevelCount() != levels)
+		throw std::runtime_error(std::string(what) + ": wrong number of mipmap levels");
+	const std::vector<u8> a = allLevels(loaded), b = allLevels(expected);
+	if (a.size() < b.size() && levels)
+		throw std::runtime_error(std::string(what) + ": mipmaps missing");
+	if (memcmp(a.data(), b.data(), a.size()) != 0)
+		throw std::runtime_error(std::string(what) + ": data differs");
+	loaded->drop();
+}
+
+static video::IImage *loadFromMemory(IrrlichtDevice *device, const std::vector<u8> &file, const char *name)
+{
+	io::IReadFile *memFile = device->getFileSystem()->createMemoryReadFile(file.data(), file.size(), name);
+	video::IImage *image = device->getVideoDriver()->createImageFromFile(memFile);
+	memFile->drop();
+	return image;
+}
+
+static std::vector<u8> makeDDS(video::IImage *image, u32 mipMapCount)
+{
+	video::SDDSHeader header = {};
+	header.Magic = 0x20534444; // "DDS "
+	header.Size = 124;
+	header.Flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000 | (mipMapCount ? 0x20000 : 0);
+	header.Width = image->getDimension().Width;
+	header.Height = image->getDimension().Height;
+	header.MipMapCount = mipMapCount;
+	header.PixelFormat.Size = 32;
+	header.PixelFormat.Flags = 0x4; // DDPF_FOURCC
+	header.PixelFormat.FourCC = image->getColorFormat() == video::ECF_DXT1 ? 0x31545844 : 0x35545844;
+	header.Caps = 0x1000;
+
+	std::vector<u8> file((u8 *)&header, (u8 *)&header + sizeof(header));
+	const std::vector<u8> data = allLevels(image);
+	file.insert(file.end(), data.begin(), data.end());
+	return file;
+}
+
+static std::vector<u8> makeKTX2(video::IImage *image, u32 levels)
+{
+	video::SKTX2Header header = {};
+	const u8 identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+	memcpy(header.Identifier, identifier, sizeof(identifier));
+	header.VkFormat = image->getColorFormat() == video::ECF_DXT1 ? 133 : 137;
+	header.TypeSize = 1;
+	header.PixelWidth = image->getDimension().Width;
+	header.PixelHeight = image->getDimension().Height;
+	header.FaceCount = 1;
+	header.LevelCount = levels;
+
+	// the level index lists the largest level first, the data is stored the other way round
+	std::vector<video::SKTX2LevelIndex> index(levels);
+	std::vector<u8> data;
+	const u32 dataStart = sizeof(header) + levels * sizeof(video::SKTX2LevelIndex);
+	for (u32 i = levels; i-- > 0;) {
+		const core::dimension2du size = image->getMipMapsSize(i);
+		const u32 bytes = video::IImage::getDataSizeFromFormat(image->getColorFormat(), size.Width, size.Height);
+		const u8 *level = (const u8 *)image->getMipMapsData(i);
+		index[i] = {dataStart + (u64)data.size(), bytes, bytes};
+		data.insert(data.end(), level, level + bytes);
+	}
+
+	std::vector<u8> file((u8 *)&header, (u8 *)&header + sizeof(header));
+	file.insert(file.end(), (u8 *)index.data(), (u8 *)(index.data() + levels));
+	file.insert(file.end(), data.begin(), data.end());
+	return file;
+}
+
+static void testContainers(IrrlichtDevice *device)
+{
+	video::IVideoDriver *driver = device->getVideoDriver();
+	video::IImage *src = createGradient(driver, {16, 8}, true);
+	for (auto format : {video::ECF_DXT1, video::ECF_DXT5}) {
+		video::IImage *compressed = CImageCompressor::compress(src, format, true);
+		const u32 levels = compressed->getMipMapLevelCount();
+
+		checkLoaded(loadFromMemory(device, makeDDS(compressed, levels + 1), "mem.dds"), compressed, levels, "DDS");
+		checkLoaded(loadFromMemory(device, makeKTX2(compressed, levels + 1), "mem.ktx2"), compressed, levels, "KTX2");
+		// incomplete chains are dropped
+		checkLoaded(loadFromMemory(device, makeDDS(compressed, 2), "mem.dds"), compressed, 0, "DDS without mipmaps");
+		checkLoaded(loadFromMemory(device, makeKTX2(compressed, 1), "mem.ktx2"), compressed, 0, "KTX2 without mipmaps");
+
+		// truncated files are rejected
+		std::vector<u8> truncated = makeKTX2(compressed, 1);
+		truncated.resize(truncated.size() - 1);
+		video::IImage *broken = loadFromMemory(device, truncated, "mem.ktx2");
+		if (broken)
+			throw std::runtime_error("truncated KTX2 file loaded");
+
+		// so are level counts and sizes which the image does not allow
+		std::vector<u8> manyLevels = makeKTX2(compressed, 1);
+		((video::SKTX2Header *)manyLevels.data())->LevelCount = 0x10000000;
+		if (loadFromMemory(device, manyLevels, "mem.ktx2"))
+			throw std::runtime_error("KTX2 file with too many levels loaded");
+		std::vector<u8> empty = makeKTX2(compressed, 1);
+		((video::SKTX2Header *)empty.data())->PixelHeight = 0;
+		if (loadFromMemory(device, empty, "mem.ktx2"))
+			throw std::runtime_error("KTX2 file without pixels loaded");
+		empty = makeDDS(compressed, 0);
+		((video::SDDSHeader *)empty.data())->Width = 0;
+		if (loadFromMemory(device, empty, "mem.dds"))
+			throw std::runtime_error("DDS file without pixels loaded");
+
+		// the null driver only takes A8R8G8B8, so this goes through decompress
+		const std::vector<u8> dds = makeDDS(compressed, levels + 1);
+		io::IReadFile *memFile = device->getFileSystem()->createMemoryReadFile(dds.data(), dds.size(),
+				format == video::ECF_DXT1 ? "dxt1.dds" : "dxt5.dds");
+		video::ITexture *texture = driver->getTexture(memFile);
+		memFile->drop();
+		if (!texture || texture->getSize() != src->getDimension())
+			throw std::runtime_error("compressed texture not loaded");
+		driver->removeTexture(texture);
+
+		compressed->drop();
+	}
+	src->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	IrrlichtDevice *device = createNullDevice();
+	auto *driver = device->getVideoDriver();
+
+	testSolidBlocks();
+	testRoundTrip(driver);
+	testMipMaps(driver);
+	testContainers(device);
+	std::printf("All compression checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,231 @@
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <irrlicht.h>
+#include <IVideoDriver.h>
+#include "CColorConverter.h"
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks IImage::copyToResampled and the scanline based copyToScaling
+// (against the old per pixel loop, hence the internal CColorConverter),
+// then times them against the old copy functions.
+// Pass "--bench" to time larger images.
+
+static const video::ECOLOR_FORMAT formats[] = {
+	video::ECF_A1R5G5B5,
+	video::ECF_R5G6B5,
+	video::ECF_A8R8G8B8,
+	video::ECF_R8G8B8,
+};
+
+static const video::E_IMAGE_RESAMPLE_FILTER filters[] = {
+	video::EIRF_NEAREST,
+	video::EIRF_BILINEAR,
+	video::EIRF_BOX,
+	video::EIRF_LANCZOS3,
+};
+
+static const char *const filterNames[] = {"nearest", "bilinear", "box", "lanczos3"};
+
+static video::IImage *createRandom(video::IVideoDriver *driver, video::ECOLOR_FORMAT format,
+		const core::dimension2du &size, std::mt19937 &rng)
+{
+	video::IImage *img = driver->createImage(format, size);
+	u8 *data = (u8 *)img->getData();
+	for (u32 i = 0; i < img->getImageDataSizeInBytes(); ++i)
+		data[i] = (u8)rng();
+	return img;
+}
+
+static bool sameData(video::IImage *a, video::IImage *b)
+{
+	return a->getImageDataSizeInBytes() == b->getImageDataSizeInBytes() &&
+			memcmp(a->getData(), b->getData(), a->getImageDataSizeInBytes()) == 0;
+}
+
+//! resampling a single color must give that color for every filter
+static void testConstantColor(video::IVideoDriver *driver)
+{
+	const video::SColor color(255, 200, 120, 40);
+	const core::dimension2du sizes[] = {{1, 1}, {7, 3}, {31, 17}, {64, 64}, {129, 250}};
+	for (auto srcFormat : formats) {
+		video::IImage *src = driver->createImage(srcFormat, {36, 23});
+		src->fill(color);
+		for (auto dstFormat : formats) {
+			const u32 bpp = video::IImage::getBitsPerPixelFromFormat(dstFormat) / 8;
+			// nearest converts directly, the filters go through A8R8G8B8
+			u8 direct[4], filtered[4];
+			u32 argb;
+			video::CColorConverter::convert_viaFormat(src->getData(), srcFormat, 1, direct, dstFormat);
+			video::CColorConverter::convert_viaFormat(src->getData(), srcFormat, 1, &argb, video::ECF_A8R8G8B8);
+			video::CColorConverter::convert_viaFormat(&argb, video::ECF_A8R8G8B8, 1, filtered, dstFormat);
+
+			for (const auto &size : sizes) {
+				video::IImage *dst = driver->createImage(dstFormat, size);
+				for (u32 f = 0; f < 4; ++f) {
+					memset(dst->getData(), 0, dst->getImageDataSizeInBytes());
+					if (!src->copyToResampled(dst, filters[f]))
+						throw std::runtime_error(std::string(filterNames[f]) + ": format rejected");
+					const u8 *expected = filters[f] == video::EIRF_NEAREST ? direct : filtered;
+					const u8 *data = (const u8 *)dst->getData();
+					for (u32 i = 0; i < size.getArea(); ++i) {
+						if (memcmp(data + i * bpp, expected, bpp) != 0)
+							throw std::runtime_error(std::string(filterNames[f]) + ": constant color changed");
+					}
+				}
+				dst->drop();
+			}
+		}
+		src->drop();
+	}
+}
+
+//! nearest neighbour enlarging by an integer factor repeats every pixel
+static void testNearestUpscale(video::IVideoDriver *driver)
+{
+	std::mt19937 rng(7);
+	video::IImage *src = createRandom(driver, video::ECF_A8R8G8B8, {13, 9}, rng);
+	video::IImage *dst = driver->createImage(video::ECF_A8R8G8B8, {26, 27});
+	if (!src->copyToResampled(dst, video::EIRF_NEAREST))
+		throw std::runtime_error("nearest: format rejected");
+	for (u32 y = 0; y < 27; ++y) {
+		for (u32 x = 0; x < 26; ++x) {
+			if (dst->getPixel(x, y) != src->getPixel(x / 2, y / 3))
+				throw std::runtime_error("nearest: wrong pixel in integer upscale");
+		}
+	}
+	dst->drop();
+	src->drop();
+}
+
+//! splitting the work into bands must not change the result
+static void testThreadsMatch(video::IVideoDriver *driver)
+{
+	std::mt19937 rng(11);
+	video::IImage *src = createRandom(driver, video::ECF_R8G8B8, {613, 401}, rng);
+	const core::dimension2du sizes[] = {{1024, 777}, {300, 200}, {97, 1000}};
+	for (const auto &size : sizes) {
+		video::IImage *single = driver->createImage(video::ECF_A8R8G8B8, size);
+		video::IImage *multi = driver->createImage(video::ECF_A8R8G8B8, size);
+		for (u32 f = 0; f < 4; ++f) {
+			src->copyToResampled(single, filters[f], 1);
+			src->copyToResampled(multi, filters[f], 5);
+			if (!sameData(single, multi))
+				throw std::runtime_error(std::string(filterNames[f]) + ": threaded result differs");
+		}
+		multi->drop();
+		single->drop();
+	}
+	src->drop();
+}
+
+//! the pixel mapping copyToScaling used to apply pixel by pixel
+static void referenceScaling(video::IImage *src, video::IImage *dst)
+{
+	const core::dimension2du &from = src->getDimension();
+	const core::dimension2du &to = dst->getDimension();
+	f32 sourceXStep, sourceYStep;
+	f32 sourceXStart = 0.f, sourceYStart = 0.f;
+	if (to.Width % from.Width == 0)
+		sourceXStep = (f32)(from.Width) / (f32)(to.Width);
+	else {
+		sourceXStep = to.Width > 1 ? (f32)(from.Width - 1) / (f32)(to.Width - 1) : 0.f;
+		sourceXStart = 0.5f;
+	}
+	if (to.Height % from.Height == 0)
+		sourceYStep = (f32)(from.Height) / (f32)(to.Height);
+	else {
+		sourceYStep = to.Height > 1 ? (f32)(from.Height - 1) / (f32)(to.Height - 1) : 0.f;
+		sourceYStart = 0.5f;
+	}
+
+	const u32 srcBpp = src->getBytesPerPixel(), dstBpp = dst->getBytesPerPixel();
+	const u8 *srcData = (const u8 *)src->getData();
+	u8 *dstData = (u8 *)dst->getData();
+	u32 syval = 0;
+	f32 sy = sourceYStart;
+	for (u32 y = 0; y < to.Height; ++y) {
+		f32 sx = sourceXStart;
+		for (u32 x = 0; x < to.Width; ++x) {
+			video::CColorConverter::convert_viaFormat(srcData + syval + ((s32)sx) * srcBpp, src->getColorFormat(), 1,
+					dstData + y * dst->getPitch() + x * dstBpp, dst->getColorFormat());
+			sx += sourceXStep;
+		}
+		sy += sourceYStep;
+		syval = (s32)(sy)*src->getPitch();
+	}
+}
+
+static void testScalingUnchanged(video::IVideoDriver *driver)
+{
+	std::mt19937 rng(3);
+	const core::dimension2du sizes[] = {{1, 1}, {5, 40}, {32, 32}, {33, 17}, {128, 96}};
+	for (auto srcFormat : formats) {
+		video::IImage *src = createRandom(driver, srcFormat, {32, 24}, rng);
+		for (auto dstFormat : formats) {
+			for (const auto &size : sizes) {
+				video::IImage *actual = driver->createImage(dstFormat, size);
+				video::IImage *expected = driver->createImage(dstFormat, size);
+				src->copyToScaling(actual);
+				referenceScaling(src, expected);
+				if (!sameData(actual, expected))
+					throw std::runtime_error("copyToScaling result changed");
+				expected->drop();
+				actual->drop();
+			}
+		}
+		src->drop();
+	}
+}
+
+static void benchmark(video::IVideoDriver *driver, bool large)
+{
+	std::mt19937 rng(42);
+	const core::dimension2du srcSize = large ? core::dimension2du(4096, 4096) : core::dimension2du(1024, 1024);
+	const core::dimension2du down(srcSize.Width / 4, srcSize.Height / 4);
+	const core::dimension2du up(srcSize.Width * 3 / 2, srcSize.Height * 3 / 2);
+	const u32 repeats = large ? 2 : 3;
+	video::IImage *src = createRandom(driver, video::ECF_A8R8G8B8, srcSize, rng);
+
+	for (const auto &size : {down, up}) {
+		video::IImage *dst = driver->createImage(video::ECF_A8R8G8B8, size);
+		std::printf("%ux%u -> %ux%u\n", srcSize.Width, srcSize.Height, size.Width, size.Height);
+		std::printf("  %-26s %8.2f ms\n", "copyToScaling", measure(repeats, [&] { src->copyToScaling(dst); }));
+		if (size == down)
+			std::printf("  %-26s %8.2f ms\n", "copyToScalingBoxFilter", measure(repeats, [&] { src->copyToScalingBoxFilter(dst); }));
+		for (u32 f = 0; f < 4; ++f) {
+			const std::string single = std::string(filterNames[f]) + " (1 thread)";
+			std::printf("  %-26s %8.2f ms\n", single.c_str(), measure(repeats, [&] { src->copyToResampled(dst, filters[f], 1); }));
+			const std::string multi = std::string(filterNames[f]) + " (all cores)";
+			std::printf("  %-26s %8.2f ms\n", multi.c_str(), measure(repeats, [&] { src->copyToResampled(dst, filters[f]); }));
+		}
+		dst->drop();
+	}
+	src->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice(ELL_WARNING);
+	auto *driver = device->getVideoDriver();
+
+	testConstantColor(driver);
+	testNearestUpscale(driver);
+	testThreadsMatch(driver);
+	testScalingUnchanged(driver);
+	std::printf("All resampling checks passed\n");
+
+	benchmark(driver, large);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,259 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <matrix4.h>
+#include <quaternion.h>
+#include "test_utils.h"
+
+using namespace irr;
+using core::matrix4;
+
+// Compares the f32 matrix kernels, which use SSE where available, bit for
+// bit with the scalar formulas of the generic template, for random
+// matrices and special values, also transforming arrays of vertices.
+// Prints the time of each kernel and of its scalar formula.
+// Pass "--bench" for more iterations.
+
+//! Equal bits, or both NaN as the payload may depend on the order of the operands
+static bool same(f32 a, f32 b)
+{
+	return std::memcmp(&a, &b, sizeof(f32)) == 0 || (std::isnan(a) && std::isnan(b));
+}
+
+static bool same(const matrix4 &a, const matrix4 &b)
+{
+	for (u32 i = 0; i < 16; ++i)
+		if (!same(a[i], b[i]))
+			return false;
+	return true;
+}
+
+static bool same(const core::vector3df &a, const core::vector3df &b)
+{
+	return same(a.X, b.X) && same(a.Y, b.Y) && same(a.Z, b.Z);
+}
+
+// The scalar formulas of CMatrix4<T>
+
+static void multiplyScalar(f32 *M, const f32 *m1, const f32 *m2)
+{
+	M[0] = m1[0] * m2[0] + m1[4] * m2[1] + m1[8] * m2[2] + m1[12] * m2[3];
+	M[1] = m1[1] * m2[0] + m1[5] * m2[1] + m1[9] * m2[2] + m1[13] * m2[3];
+	M[2] = m1[2] * m2[0] + m1[6] * m2[1] + m1[10] * m2[2] + m1[14] * m2[3];
+	M[3] = m1[3] * m2[0] + m1[7] * m2[1] + m1[11] * m2[2] + m1[15] * m2[3];
+
+	M[4] = m1[0] * m2[4] + m1[4] * m2[5] + m1[8] * m2[6] + m1[12] * m2[7];
+	M[5] = m1[1] * m2[4] + m1[5] * m2[5] + m1[9] * m2[6] + m1[13] * m2[7];
+	M[6] = m1[2] * m2[4] + m1[6] * m2[5] + m1[10] * m2[6] + m1[14] * m2[7];
+	M[7] = m1[3] * m2[4] + m1[7] * m2[5] + m1[11] * m2[6] + m1[15] * m2[7];
+
+	M[8] = m1[0] * m2[8] + m1[4] * m2[9] + m1[8] * m2[10] + m1[12] * m2[11];
+	M[9] = m1[1] * m2[8] + m1[5] * m2[9] + m1[9] * m2[10] + m1[13] * m2[11];
+	M[10] = m1[2] * m2[8] + m1[6] * m2[9] + m1[10] * m2[10] + m1[14] * m2[11];
+	M[11] = m1[3] * m2[8] + m1[7] * m2[9] + m1[11] * m2[10] + m1[15] * m2[11];
+
+	M[12] = m1[0] * m2[12] + m1[4] * m2[13] + m1[8] * m2[14] + m1[12] * m2[15];
+	M[13] = m1[1] * m2[12] + m1[5] * m2[13] + m1[9] * m2[14] + m1[13] * m2[15];
+	M[14] = m1[2] * m2[12] + m1[6] * m2[13] + m1[10] * m2[14] + m1[14] * m2[15];
+	M[15] = m1[3] * m2[12] + m1[7] * m2[13] + m1[11] * m2[14] + m1[15] * m2[15];
+}
+
+static core::vector3df transformScalar(const f32 *M, const core::vector3df &v)
+{
+	return {
+		v.X * M[0] + v.Y * M[4] + v.Z * M[8] + M[12],
+		v.X * M[1] + v.Y * M[5] + v.Z * M[9] + M[13],
+		v.X * M[2] + v.Y * M[6] + v.Z * M[10] + M[14],
+	};
+}
+
+static void transform4Scalar(const f32 *M, f32 *out, const core::vector3df &in)
+{
+	out[0] = in.X * M[0] + in.Y * M[4] + in.Z * M[8] + M[12];
+	out[1] = in.X * M[1] + in.Y * M[5] + in.Z * M[9] + M[13];
+	out[2] = in.X * M[2] + in.Y * M[6] + in.Z * M[10] + M[14];
+	out[3] = in.X * M[3] + in.Y * M[7] + in.Z * M[11] + M[15];
+}
+
+static core::vector3df rotateAndScaleScalar(const f32 *M, const core::vector3df &v)
+{
+	return {
+		v.X * M[0] + v.Y * M[4] + v.Z * M[8],
+		v.X * M[1] + v.Y * M[5] + v.Z * M[9],
+		v.X * M[2] + v.Y * M[6] + v.Z * M[10],
+	};
+}
+
+//! Vertex with the position followed by other attributes, as in S3DVertex
+struct SVertex
+{
+	core::vector3df Pos;
+	core::vector3df Normal;
+	f32 U, V;
+};
+
+static f32 randomValue(std::mt19937 &rng)
+{
+	static const f32 special[] = {0.f, -0.f, 1.f, -1.f, 1e-40f, -1e-42f, 1e30f, -1e30f,
+			std::numeric_limits<f32>::infinity(), -std::numeric_limits<f32>::infinity(),
+			std::numeric_limits<f32>::quiet_NaN()};
+	if (rng() % 16 == 0)
+		return special[rng() % (sizeof(special) / sizeof(special[0]))];
+	return std::uniform_real_distribution<f32>(-100.f, 100.f)(rng);
+}
+
+static matrix4 randomMatrix(std::mt19937 &rng)
+{
+	matrix4 m(matrix4::EM4CONST_NOTHING);
+	for (u32 i = 0; i < 16; ++i)
+		m[i] = randomValue(rng);
+	return m;
+}
+
+static void testExactness()
+{
+	std::mt19937 rng(48);
+	for (u32 i = 0; i < 100000; ++i) {
+		const matrix4 a = randomMatrix(rng);
+		const matrix4 b = randomMatrix(rng);
+		matrix4 expected(matrix4::EM4CONST_NOTHING);
+		multiplyScalar(expected.pointer(), a.pointer(), b.pointer());
+
+		matrix4 m(matrix4::EM4CONST_NOTHING);
+		m.setbyproduct_nocheck(a, b);
+		check(same(m, expected), "setbyproduct_nocheck differs");
+		check(same(a * b, expected), "operator* differs");
+		m = a;
+		m *= b;
+		check(same(m, expected), "operator*= differs");
+
+		const core::vector3df v(randomValue(rng), randomValue(rng), randomValue(rng));
+		check(same(a.transformVect(v), transformScalar(a.pointer(), v)), "transformVect differs");
+		core::vector3df w = v;
+		a.transformVect(w);
+		check(same(w, transformScalar(a.pointer(), v)), "transformVect in place differs");
+		check(same(a.rotateAndScaleVect(v), rotateAndScaleScalar(a.pointer(), v)), "rotateAndScaleVect differs");
+		f32 out[4], expectedOut[4];
+		a.transformVect(out, v);
+		transform4Scalar(a.pointer(), expectedOut, v);
+		for (u32 j = 0; j < 4; ++j)
+			check(same(out[j], expectedOut[j]), "transformVect to four values differs");
+	}
+}
+
+static void testArrays()
+{
+	std::mt19937 rng(50);
+	for (u32 count : {0, 1, 2, 7, 100}) {
+		const matrix4 m = randomMatrix(rng);
+		std::vector<SVertex> vertices(count);
+		std::vector<core::vector3df> packed(count);
+		for (auto &v : vertices) {
+			v.Pos.set(randomValue(rng), randomValue(rng), randomValue(rng));
+			v.Normal.set(randomValue(rng), randomValue(rng), randomValue(rng));
+		}
+		const std::vector<SVertex> original = vertices;
+
+		// in place, leaving the normals alone
+		m.transformVectArray(&vertices.data()->Pos, &vertices.data()->Pos, count, sizeof(SVertex));
+		for (u32 i = 0; i < count; ++i) {
+			check(same(vertices[i].Pos, transformScalar(m.pointer(), original[i].Pos)), "transformVectArray differs");
+			check(same(vertices[i].Normal, original[i].Normal), "transformVectArray wrote after the vector");
+		}
+		m.rotateAndScaleVectArray(&vertices.data()->Normal, &vertices.data()->Normal, count, sizeof(SVertex));
+		for (u32 i = 0; i < count; ++i) {
+			check(same(vertices[i].Normal, rotateAndScaleScalar(m.pointer(), original[i].Normal)), "rotateAndScaleVectArray differs");
+			check(same(vertices[i].Pos, transformScalar(m.pointer(), original[i].Pos)), "rotateAndScaleVectArray wrote before the vector");
+		}
+
+		// packed vectors into another array
+		for (u32 i = 0; i < count; ++i)
+			packed[i] = original[i].Pos;
+		std::vector<core::vector3df> transformed(count);
+		m.transformVectArray(packed.data(), transformed.data(), count);
+		for (u32 i = 0; i < count; ++i)
+			check(same(transformed[i], vertices[i].Pos), "transformVectArray into another array differs");
+		m.rotateAndScaleVectArray(packed.data(), transformed.data(), count);
+		for (u32 i = 0; i < count; ++i)
+			check(same(transformed[i], rotateAndScaleScalar(m.pointer(), packed[i])), "rotateAndScaleVectArray into another array differs");
+	}
+}
+
+template <typename F>
+static double timeLoop(u32 iterations, F f)
+{
+	// in nanoseconds, f gets the number of the iteration
+	u32 i = 0;
+	return measure(iterations, [&] { f(i++); }) * 1e6;
+}
+
+static void benchmark(bool bench)
+{
+	std::mt19937 rng(49);
+	const u32 count = 1024;
+	std::vector<matrix4> matrices;
+	std::vector<core::vector3df> points;
+	for (u32 i = 0; i < count; ++i) {
+		matrix4 m;
+		m.setRotationDegrees(core::vector3df(rng() % 360, rng() % 360, rng() % 360));
+		m.setTranslation(core::vector3df(rng() % 100, rng() % 100, rng() % 100));
+		matrices.push_back(m);
+		points.emplace_back(rng() % 100, rng() % 100, rng() % 100);
+	}
+	const u32 iterations = bench ? 50000000 : 2000000;
+	const u32 mask = count - 1;
+	// const, not to select the overloads transforming in place
+	const std::vector<core::vector3df> &vectors = points;
+
+	// into other matrices in memory, which the compiler cannot tell apart from the factors
+	std::vector<matrix4> products(count);
+	double simd = timeLoop(iterations, [&](u32 i) { products[i & mask].setbyproduct_nocheck(matrices[i & mask], matrices[(i * 7) & mask]); });
+	double scalar = timeLoop(iterations, [&](u32 i) { multiplyScalar(products[i & mask].pointer(), matrices[i & mask].pointer(), matrices[(i * 7) & mask].pointer()); });
+	std::printf("setbyproduct_nocheck: %6.2f ns, scalar %6.2f ns\n", simd, scalar);
+
+	core::vector3df sum;
+	simd = timeLoop(iterations, [&](u32 i) { sum += matrices[i & mask].transformVect(vectors[(i * 7) & mask]); });
+	scalar = timeLoop(iterations, [&](u32 i) { sum += transformScalar(matrices[i & mask].pointer(), vectors[(i * 7) & mask]); });
+	std::printf("transformVect:        %6.2f ns, scalar %6.2f ns\n", simd, scalar);
+
+	simd = timeLoop(iterations, [&](u32 i) { sum += matrices[i & mask].rotateAndScaleVect(vectors[(i * 7) & mask]); });
+	scalar = timeLoop(iterations, [&](u32 i) { sum += rotateAndScaleScalar(matrices[i & mask].pointer(), vectors[(i * 7) & mask]); });
+	std::printf("rotateAndScaleVect:   %6.2f ns, scalar %6.2f ns\n", simd, scalar);
+
+	f32 out[4];
+	simd = timeLoop(iterations, [&](u32 i) { matrices[i & mask].transformVect(out, vectors[(i * 7) & mask]); sum.X += out[3]; });
+	scalar = timeLoop(iterations, [&](u32 i) { transform4Scalar(matrices[i & mask].pointer(), out, vectors[(i * 7) & mask]); sum.X += out[3]; });
+	std::printf("transformVect to f32[4]: %6.2f ns, scalar %6.2f ns\n", simd, scalar);
+
+	// a mesh of 1024 vertices
+	std::vector<SVertex> vertices(count);
+	for (u32 i = 0; i < count; ++i)
+		vertices[i].Pos = vertices[i].Normal = vectors[i];
+	const u32 meshes = iterations / count;
+	simd = timeLoop(meshes, [&](u32 i) { matrices[i & mask].transformVectArray(&vertices.data()->Pos, &vertices.data()->Pos, count, sizeof(SVertex)); });
+	scalar = timeLoop(meshes, [&](u32 i) { for (auto &v : vertices) v.Pos = transformScalar(matrices[i & mask].pointer(), v.Pos); });
+	std::printf("transformVectArray:   %6.2f ns, scalar %6.2f ns per vertex\n", simd / count, scalar / count);
+	simd = timeLoop(meshes, [&](u32 i) { matrices[i & mask].rotateAndScaleVectArray(&vertices.data()->Normal, &vertices.data()->Normal, count, sizeof(SVertex)); });
+	scalar = timeLoop(meshes, [&](u32 i) { for (auto &v : vertices) v.Normal = rotateAndScaleScalar(matrices[i & mask].pointer(), v.Normal); });
+	std::printf("rotateAndScaleVectArray: %6.2f ns, scalar %6.2f ns per vertex\n", simd / count, scalar / count);
+
+	check(std::isfinite(sum.X + sum.Y + sum.Z + products[0][0]) && vertices[0].Pos == vertices[0].Pos, "no result");
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool bench = isBenchmark(argc, argv);
+
+	testExactness();
+	testArrays();
+	std::printf("All matrix SIMD checks passed\n");
+	benchmark(bench);
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,355 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+#include <IFileSystem.h>
+#include <IMeshCache.h>
+#include <IMeshWriter.h>
+#include <IWriteFile.h>
+#include <ISceneManager.h>
+#include <SkinnedMesh.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Writes meshes loaded from .x, .b3d and .obj files to the binary mesh cache,
+// checks that loading the cache gives the same meshes, and compares loading
+// times of the source files and their caches.
+// Pass "--bench" to time larger files.
+
+static std::string tempPath(const std::string &name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static void writeBytes(const std::string &path, const std::string &data)
+{
+	std::ofstream file(path, std::ios::binary);
+	file.write(data.data(), data.size());
+	check(file.good(), "could not write a temporary file");
+}
+
+static std::string readBytes(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+//! Loads a mesh, bypassing the mesh cache of the scene manager
+static scene::IAnimatedMesh *load(IrrlichtDevice *device, const std::string &path)
+{
+	io::IReadFile *file = device->getFileSystem()->createAndOpenFile(path.c_str());
+	check(file, "could not open a mesh file");
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	if (mesh) {
+		mesh->grab();
+		device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+	}
+	return mesh;
+}
+
+static scene::IAnimatedMesh *loadFromMemory(IrrlichtDevice *device, const std::string &data, const char *name)
+{
+	io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(data.data(), data.size(), name);
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	if (mesh) {
+		mesh->grab();
+		device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+	}
+	return mesh;
+}
+
+static void save(IrrlichtDevice *device, scene::IMesh *mesh, const std::string &path)
+{
+	scene::IMeshWriter *writer = device->getSceneManager()->createMeshWriter(scene::EMWT_MESH_CACHE);
+	check(writer && writer->isAWriteableFileExtension(path.c_str()), "no mesh cache writer");
+	io::IWriteFile *file = device->getFileSystem()->createAndWriteFile(path.c_str());
+	check(file, "could not create the cache file");
+	const bool written = writer->writeMesh(file, mesh);
+	file->drop();
+	writer->drop();
+	check(written, "writing the cache failed");
+}
+
+static bool sameBox(const core::aabbox3df &a, const core::aabbox3df &b)
+{
+	return a.MinEdge == b.MinEdge && a.MaxEdge == b.MaxEdge;
+}
+
+static void compareBuffers(const scene::IMeshBuffer *a, const scene::IMeshBuffer *b)
+{
+	check(a->getVertexType() == b->getVertexType() && a->getVertexCount() == b->getVertexCount() &&
+					a->getIndexCount() == b->getIndexCount(),
+			"buffer sizes differ");
+	const u32 vertexSize = a->getVertexBuffer()->getElementSize();
+	check(memcmp(a->getVertices(), b->getVertices(), a->getVertexCount() * vertexSize) == 0, "vertices differ");
+	check(a->getIndexType() == b->getIndexType(), "index types differ");
+	check(memcmp(a->getIndexBuffer()->getData(), b->getIndexBuffer()->getData(),
+				  a->getIndexCount() * a->getIndexBuffer()->getElementSize()) == 0,
+			"indices differ");
+	check(a->getMaterial() == b->getMaterial(), "materials differ");
+	check(sameBox(a->getBoundingBox(), b->getBoundingBox()), "buffer bounding boxes differ");
+	check(a->getPrimitiveType() == b->getPrimitiveType(), "primitive types differ");
+	check(a->getVertexBuffer()->MappingHint == b->getVertexBuffer()->MappingHint, "mapping hints differ");
+
+	const scene::WeightBuffer *wa = a->getVertexBuffer()->getWeightBuffer();
+	const scene::WeightBuffer *wb = b->getVertexBuffer()->getWeightBuffer();
+	check(!wa == !wb, "weights missing");
+	if (wa) {
+		check(memcmp(wa->weights.data(), wb->weights.data(), wa->getCount() * wa->getElementSize()) == 0, "weights differ");
+		check(wa->animated_vertices == wb->animated_vertices, "animated vertices differ");
+	}
+}
+
+static std::vector<core::matrix4> skinMatrices(scene::SkinnedMesh *mesh, f32 frame)
+{
+	std::vector<core::matrix4> matrices;
+	for (const auto &transform : mesh->animateMesh(frame)) {
+		if (const auto *matrix = std::get_if<core::matrix4>(&transform))
+			matrices.push_back(*matrix);
+		else
+			matrices.push_back(std::get<core::Transform>(transform).buildMatrix());
+	}
+	mesh->calculateGlobalMatrices(matrices);
+	return mesh->calculateSkinMatrices(matrices);
+}
+
+static void compareMeshes(scene::IAnimatedMesh *a, scene::IAnimatedMesh *b)
+{
+	check(a->getMeshType() == b->getMeshType(), "mesh types differ");
+	check(a->getMeshBufferCount() == b->getMeshBufferCount(), "mesh buffer counts differ");
+	for (u32 i = 0; i < a->getMeshBufferCount(); ++i) {
+		compareBuffers(a->getMeshBuffer(i), b->getMeshBuffer(i));
+		check(a->getTextureSlot(i) == b->getTextureSlot(i), "texture slots differ");
+	}
+	check(sameBox(a->getBoundingBox(), b->getBoundingBox()), "bounding boxes differ");
+	check(a->getMaxFrameNumber() == b->getMaxFrameNumber(), "frame counts differ");
+
+	auto *sa = dynamic_cast<scene::SkinnedMesh *>(a);
+	auto *sb = dynamic_cast<scene::SkinnedMesh *>(b);
+	check(!sa == !sb, "skinned mesh loaded as static mesh");
+	if (!sa)
+		return;
+
+	check(sa->getSourceFormat() == sb->getSourceFormat() && sa->isStatic() == sb->isStatic() &&
+					sa->hasWeights() == sb->hasWeights(),
+			"skinned mesh properties differ");
+	check(sa->getJointCount() == sb->getJointCount(), "joint counts differ");
+	for (u32 j = 0; j < sa->getJointCount(); ++j) {
+		const scene::SkinnedMesh::SJoint *ja = sa->getAllJoints()[j];
+		const scene::SkinnedMesh::SJoint *jb = sb->getAllJoints()[j];
+		check(ja->Name == jb->Name && ja->ParentJointID == jb->ParentJointID, "joint hierarchy differs");
+		check(ja->AttachedMeshes == jb->AttachedMeshes, "attached meshes differ");
+		check(ja->keys.position.frames.size() == jb->keys.position.frames.size() &&
+						ja->keys.rotation.frames.size() == jb->keys.rotation.frames.size() &&
+						ja->keys.scale.frames.size() == jb->keys.scale.frames.size(),
+				"key frames differ");
+		check(ja->GlobalInversedMatrix == jb->GlobalInversedMatrix, "inverse matrices differ");
+		check(sameBox(ja->LocalBoundingBox, jb->LocalBoundingBox), "joint bounding boxes differ");
+		for (u32 i = 0; i < sa->getMeshBufferCount(); ++i) {
+			check(static_cast<scene::SSkinMeshBuffer *>(sa->getMeshBuffer(i))->Transformation ==
+							static_cast<scene::SSkinMeshBuffer *>(sb->getMeshBuffer(i))->Transformation,
+					"buffer transformations differ");
+		}
+	}
+
+	// both animate the same
+	if (!sa->isStatic()) {
+		for (f32 frame = 0.f; frame <= sa->getMaxFrameNumber(); frame += sa->getMaxFrameNumber() / 7 + 1.f)
+			check(skinMatrices(sa, frame) == skinMatrices(sb, frame), "animation differs");
+	}
+}
+
+static std::string makeObj(u32 size)
+{
+	std::string obj = "# grid\nmtllib missing.mtl\n";
+	char line[96];
+	for (u32 y = 0; y < size; ++y) {
+		for (u32 x = 0; x < size; ++x) {
+			snprintf(line, sizeof(line), "v %u %.4f %u\nvt %.5f %.5f\n", x, 0.25f * ((x * 7 + y * 3) % 5), y, (f32)x / size, (f32)y / size);
+			obj += line;
+		}
+	}
+	// no normals, the loader calculates them
+	for (u32 y = 0; y + 1 < size; ++y) {
+		for (u32 x = 0; x + 1 < size; ++x) {
+			const u32 i = y * size + x + 1;
+			snprintf(line, sizeof(line), "f %u/%u %u/%u %u/%u %u/%u\n", i, i, i + size, i + size, i + size + 1, i + size + 1, i + 1, i + 1);
+			obj += line;
+		}
+	}
+	return obj;
+}
+
+//! Grid with a bone that weights all vertices and has position keys
+static std::string makeB3D(u32 size, u32 keys)
+{
+	std::string data;
+	std::vector<size_t> open;
+	auto put = [&](auto value) { data.append((const char *)&value, sizeof(value)); };
+	auto begin = [&](const char *name) {
+		data.append(name, 4);
+		open.push_back(data.size());
+		put((s32)0);
+	};
+	auto end = [&]() {
+		const s32 length = (s32)(data.size() - open.back() - 4);
+		memcpy(&data[open.back()], &length, 4);
+		open.pop_back();
+	};
+	auto node = [&](const char *name) {
+		begin("NODE");
+		data.append(name, strlen(name) + 1);
+		for (f32 v : {0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f, 0.f, 0.f, 0.f})
+			put(v);
+	};
+
+	begin("BB3D");
+	put((s32)1);
+	node("root");
+	begin("MESH");
+	put((s32)-1);
+	begin("VRTS");
+	put((s32)1); // normals
+	put((s32)1);
+	put((s32)2);
+	for (u32 y = 0; y < size; ++y)
+		for (u32 x = 0; x < size; ++x)
+			for (f32 v : {(f32)x, 0.f, (f32)y, 0.f, 1.f, 0.f, (f32)x / size, (f32)y / size})
+				put(v);
+	end();
+	begin("TRIS");
+	put((s32)-1);
+	for (u32 y = 0; y + 1 < size; ++y) {
+		for (u32 x = 0; x + 1 < size; ++x) {
+			const s32 i = y * size + x;
+			for (s32 v : {i, i + (s32)size, i + 1, i + 1, i + (s32)size, i + (s32)size + 1})
+				put(v);
+		}
+	}
+	end();
+	end(); // MESH
+	node("bone");
+	begin("BONE");
+	for (u32 i = 0; i < size * size; ++i) {
+		put(i);
+		put(1.f);
+	}
+	end();
+	begin("KEYS");
+	put((s32)1);
+	for (u32 k = 1; k <= keys; ++k) {
+		put((s32)k);
+		for (f32 v : {0.f, (f32)k, 0.f})
+			put(v);
+	}
+	end();
+	end(); // NODE bone
+	end(); // NODE root
+	end(); // BB3D
+	return data;
+}
+
+static void testRoundTrip(IrrlichtDevice *device, const std::string &source, const char *name)
+{
+	scene::IAnimatedMesh *mesh = load(device, source);
+	check(mesh, "source mesh not loaded");
+
+	const std::string cache = tempPath(name);
+	save(device, mesh, cache);
+	// mapped from disk
+	scene::IAnimatedMesh *loaded = load(device, cache);
+	check(loaded, "cache not loaded");
+	compareMeshes(mesh, loaded);
+	loaded->drop();
+
+	// from memory
+	const std::string data = readBytes(cache);
+	loaded = loadFromMemory(device, data, "memory.meshcache");
+	check(loaded, "cache not loaded from memory");
+	compareMeshes(mesh, loaded);
+	loaded->drop();
+
+	std::printf("%s: %u buffers, %u KiB\n", name, mesh->getMeshBufferCount(), (u32)(data.size() / 1024));
+	mesh->drop();
+	std::filesystem::remove(cache);
+}
+
+static void testDamaged(IrrlichtDevice *device, const std::string &source)
+{
+	scene::IAnimatedMesh *mesh = load(device, source);
+	const std::string cache = tempPath("damaged.meshcache");
+	save(device, mesh, cache);
+	mesh->drop();
+	const std::string data = readBytes(cache);
+	std::filesystem::remove(cache);
+
+	// every truncation is noticed
+	for (size_t size = 0; size < data.size(); size += 1 + size / 3) {
+		scene::IAnimatedMesh *loaded = loadFromMemory(device, data.substr(0, size), "truncated.meshcache");
+		check(!loaded, "truncated cache loaded");
+	}
+
+	std::string other = data;
+	other[8] ^= 1; // version
+	check(!loadFromMemory(device, other, "version.meshcache"), "cache of another version loaded");
+	other = data;
+	other[0] = 'X';
+	check(!loadFromMemory(device, other, "magic.meshcache"), "file without magic loaded");
+}
+
+static void benchmark(IrrlichtDevice *device, const std::string &source, const char *name, u32 count)
+{
+	scene::IAnimatedMesh *mesh = load(device, source);
+	const std::string cache = tempPath(std::string(name) + ".meshcache");
+	save(device, mesh, cache);
+	mesh->drop();
+
+	const double sourceTime = measure(count, [&]() { load(device, source)->drop(); });
+	const double cacheTime = measure(count, [&]() { load(device, cache)->drop(); });
+	std::printf("%-14s source %6u KiB %8.3f ms, cache %6u KiB %8.3f ms, %5.1fx faster\n", name,
+			(u32)(std::filesystem::file_size(source) / 1024), sourceTime,
+			(u32)(std::filesystem::file_size(cache) / 1024), cacheTime, sourceTime / cacheTime);
+	std::filesystem::remove(cache);
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	const std::string x = "media/coolguy_opt.x";
+	const std::string obj = tempPath("mesh_cache_grid.obj");
+	const std::string b3d = tempPath("mesh_cache_grid.b3d");
+	writeBytes(obj, makeObj(40));
+	writeBytes(b3d, makeB3D(40, 20));
+
+	testRoundTrip(device, x, "coolguy.meshcache");
+	testRoundTrip(device, obj, "grid_obj.meshcache");
+	testRoundTrip(device, b3d, "grid_b3d.meshcache");
+	testDamaged(device, x);
+	std::printf("All mesh cache checks passed\n");
+
+	const u32 size = large ? 250 : 120;
+	writeBytes(obj, makeObj(size));
+	writeBytes(b3d, makeB3D(size, 1000));
+	benchmark(device, x, "coolguy_opt.x", large ? 200 : 20);
+	benchmark(device, obj, "grid.obj", large ? 10 : 3);
+	benchmark(device, b3d, "grid.b3d", large ? 10 : 3);
+	std::filesystem::remove(obj);
+	std::filesystem::remove(b3d);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
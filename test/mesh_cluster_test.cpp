@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+#include <irrlicht.h>
+#include <CMeshBuffer.h>
+#include <ICameraSceneNode.h>
+#include <IMeshManipulator.h>
+#include <IMeshSceneNode.h>
+#include <ISceneManager.h>
+#include <IVideoDriver.h>
+#include <SMesh.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that IMeshManipulator::buildClusters() splits a triangle list into
+// bounded clusters with valid culling data, and that a clustered mesh scene
+// node skips the clusters outside of the view frustum or facing away from
+// the camera. Prints the triangles submitted and culled.
+
+//! Sphere of the given radius with its triangles facing outwards
+static scene::SMeshBuffer *createSphere(f32 radius, u32 rings, u32 segments)
+{
+	auto *buffer = new scene::SMeshBuffer();
+	auto &vertices = buffer->Vertices->Data;
+	for (u32 r = 0; r <= rings; ++r) {
+		const f32 theta = core::PI * r / rings;
+		for (u32 s = 0; s <= segments; ++s) {
+			const f32 phi = 2.f * core::PI * s / segments;
+			const core::vector3df n(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+			vertices.emplace_back(n * radius, n, video::SColor(255, 255, 255, 255), core::vector2df((f32)s / segments, (f32)r / rings));
+		}
+	}
+	auto &indices = buffer->Indices->Data;
+	const u32 row = segments + 1;
+	for (u32 r = 0; r < rings; ++r) {
+		for (u32 s = 0; s < segments; ++s) {
+			const u16 a = r * row + s;
+			const std::array<std::array<u16, 3>, 2> quad = {{{a, (u16)(a + row), (u16)(a + 1)},
+					{(u16)(a + 1), (u16)(a + row), (u16)(a + row + 1)}}};
+			for (auto tri : quad) {
+				const core::vector3df &p0 = vertices[tri[0]].Pos, &p1 = vertices[tri[1]].Pos, &p2 = vertices[tri[2]].Pos;
+				const core::vector3df n = (p1 - p0).crossProduct(p2 - p0);
+				if (n.getLengthSQ() < 1e-10f)
+					continue; // degenerated at the poles
+				if (n.dotProduct(p0 + p1 + p2) < 0.f)
+					std::swap(tri[1], tri[2]);
+				indices.insert(indices.end(), tri.begin(), tri.end());
+			}
+		}
+	}
+	buffer->recalculateBoundingBox();
+	return buffer;
+}
+
+static std::vector<std::array<u16, 3>> sortedTriangles(const scene::SMeshBuffer *buffer)
+{
+	std::vector<std::array<u16, 3>> triangles;
+	const auto &indices = buffer->Indices->Data;
+	for (u32 i = 0; i < indices.size(); i += 3) {
+		std::array<u16, 3> tri = {indices[i], indices[i + 1], indices[i + 2]};
+		std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+		triangles.push_back(tri);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+static void testBuild(scene::IMeshManipulator *manipulator)
+{
+	scene::SMeshBuffer *sphere = createSphere(10.f, 60, 80);
+	const auto before = sortedTriangles(sphere);
+	manipulator->optimizeVertexCache(sphere);
+
+	std::vector<scene::SMeshCluster> clusters;
+	const u32 maxVertices = 64, maxTriangles = 96;
+	check(manipulator->buildClusters(sphere, clusters, maxVertices, maxTriangles) == clusters.size(), "wrong cluster count");
+	check(sortedTriangles(sphere) == before, "clustering changed the triangles");
+	check(clusters.size() >= sphere->getIndexCount() / 3 / maxTriangles, "too few clusters");
+	check(clusters.size() < sphere->getIndexCount() / 3 / 40, "clusters are too small");
+
+	const auto &indices = sphere->Indices->Data;
+	u32 next = 0;
+	for (const scene::SMeshCluster &cluster : clusters) {
+		check(cluster.FirstIndex == next && cluster.IndexCount % 3 == 0, "clusters do not cover the indices in order");
+		next += cluster.IndexCount;
+		check(cluster.IndexCount / 3 <= maxTriangles, "cluster has too many triangles");
+
+		std::vector<u16> used(indices.begin() + cluster.FirstIndex, indices.begin() + cluster.FirstIndex + cluster.IndexCount);
+		std::sort(used.begin(), used.end());
+		check(std::unique(used.begin(), used.end()) - used.begin() <= (s32)maxVertices, "cluster has too many vertices");
+
+		for (u16 v : used)
+			check(sphere->getPosition(v).getDistanceFrom(cluster.Center) <= cluster.Radius * 1.0001f, "vertex outside of the bounding sphere");
+		check(cluster.ConeCutoff < 1.f, "cone of a small part of a sphere too wide");
+		const f32 minDot = sqrtf(1.f - cluster.ConeCutoff * cluster.ConeCutoff);
+		for (u32 i = cluster.FirstIndex; i < cluster.FirstIndex + cluster.IndexCount; i += 3) {
+			const core::vector3df &p0 = sphere->getPosition(indices[i]);
+			const core::vector3df n = (sphere->getPosition(indices[i + 1]) - p0).crossProduct(sphere->getPosition(indices[i + 2]) - p0).normalize();
+			check(n.dotProduct(cluster.ConeAxis) >= minDot - 1e-4f, "triangle normal outside of the cone");
+		}
+	}
+	check(next == sphere->getIndexCount(), "clusters do not cover all indices");
+	sphere->drop();
+}
+
+static video::SFrameStats drawFrame(IrrlichtDevice *device)
+{
+	video::IVideoDriver *driver = device->getVideoDriver();
+	driver->beginScene();
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+	return driver->getFrameStats();
+}
+
+static void testRender(IrrlichtDevice *device)
+{
+	scene::ISceneManager *smgr = device->getSceneManager();
+	scene::SMeshBuffer *sphere = createSphere(10.f, 60, 80);
+	const u32 total = sphere->getIndexCount() / 3;
+	smgr->getMeshManipulator()->optimizeVertexCache(sphere);
+	scene::SMesh *mesh = new scene::SMesh();
+	mesh->addMeshBuffer(sphere);
+	mesh->recalculateBoundingBox();
+	sphere->drop();
+
+	scene::IMeshSceneNode *node = smgr->addClusteredMeshSceneNode(mesh);
+	mesh->drop();
+	check(node != 0, "no clustered mesh scene node");
+	scene::ICameraSceneNode *camera = smgr->addCameraSceneNode(0,
+			core::vector3df(0.f, 0.f, -60.f), core::vector3df(0.f, 0.f, 0.f));
+
+	const auto report = [&](const char *what, const video::SFrameStats &stats) {
+		std::printf("%-28s %6u submitted %6u culled %4u draw calls\n", what,
+				stats.PrimitivesDrawn, total - stats.PrimitivesDrawn, stats.Drawcalls);
+	};
+
+	// the whole sphere in view, the back half faces away
+	video::SFrameStats stats = drawFrame(device);
+	report("whole sphere", stats);
+	check(stats.PrimitivesDrawn < total * 0.75f, "back facing clusters not culled");
+	check(stats.PrimitivesDrawn > total * 0.4f, "front facing clusters culled");
+
+	// without back face culling everything is drawn, in one call
+	node->getMaterial(0).BackfaceCulling = false;
+	stats = drawFrame(device);
+	report("no back face culling", stats);
+	check(stats.PrimitivesDrawn == total && stats.Drawcalls == 1, "clusters culled although all visible");
+
+	// close to the surface, only a small part in view
+	camera->setPosition(core::vector3df(0.f, 0.f, -12.f));
+	camera->setTarget(core::vector3df(0.f, 0.f, 0.f));
+	camera->setFOV(0.4f);
+	stats = drawFrame(device);
+	report("close up", stats);
+	check(stats.PrimitivesDrawn > 0 && stats.PrimitivesDrawn < total * 0.3f, "clusters outside of the frustum not culled");
+
+	node->getMaterial(0).BackfaceCulling = true;
+	const video::SFrameStats culled = drawFrame(device);
+	report("close up, back faces culled", culled);
+	check(culled.PrimitivesDrawn <= stats.PrimitivesDrawn, "more drawn with back face culling");
+}
+
+int main(int argc, char *argv[])
+try {
+	IrrlichtDevice *device = createNullDevice();
+
+	testBuild(device->getSceneManager()->getMeshManipulator());
+	testRender(device);
+	std::printf("All mesh cluster checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,294 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+#include <CMeshBuffer.h>
+#include <IFileSystem.h>
+#include <IMeshCache.h>
+#include <IMeshManipulator.h>
+#include <IMeshWriter.h>
+#include <IWriteFile.h>
+#include <ISceneManager.h>
+#include <SMesh.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that the loaders switch to 32-bit indices for mesh buffers with
+// more than 65536 vertices, that such buffers survive copies and the mesh
+// cache, and that IMeshManipulator::mergeMeshBuffers() joins mesh buffers
+// within the limits of the index type.
+
+static scene::IAnimatedMesh *loadFromMemory(IrrlichtDevice *device, const std::string &data, const char *name)
+{
+	io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(data.data(), data.size(), name);
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	if (mesh) {
+		mesh->grab();
+		device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+	}
+	return mesh;
+}
+
+//! Grid of size * size vertices
+static std::string makeObj(u32 size)
+{
+	std::string obj = "# grid\n";
+	char line[96];
+	for (u32 y = 0; y < size; ++y) {
+		for (u32 x = 0; x < size; ++x) {
+			snprintf(line, sizeof(line), "v %u 0 %u\nvt %.5f %.5f\n", x, y, (f32)x / size, (f32)y / size);
+			obj += line;
+		}
+	}
+	obj += "vn 0 1 0\n";
+	for (u32 y = 0; y + 1 < size; ++y) {
+		for (u32 x = 0; x + 1 < size; ++x) {
+			const u32 i = y * size + x + 1;
+			snprintf(line, sizeof(line), "f %u/%u/1 %u/%u/1 %u/%u/1 %u/%u/1\n", i, i, i + size, i + size, i + size + 1, i + size + 1, i + 1, i + 1);
+			obj += line;
+		}
+	}
+	return obj;
+}
+
+//! Static grid of size * size vertices
+static std::string makeB3D(u32 size)
+{
+	std::string data;
+	std::vector<size_t> open;
+	auto put = [&](auto value) { data.append((const char *)&value, sizeof(value)); };
+	auto begin = [&](const char *name) {
+		data.append(name, 4);
+		open.push_back(data.size());
+		put((s32)0);
+	};
+	auto end = [&]() {
+		const s32 length = (s32)(data.size() - open.back() - 4);
+		memcpy(&data[open.back()], &length, 4);
+		open.pop_back();
+	};
+
+	begin("BB3D");
+	put((s32)1);
+	begin("NODE");
+	data.append("root", 5);
+	for (f32 v : {0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f, 0.f, 0.f, 0.f})
+		put(v);
+	begin("MESH");
+	put((s32)-1);
+	begin("VRTS");
+	put((s32)1); // normals
+	put((s32)1);
+	put((s32)2);
+	for (u32 y = 0; y < size; ++y)
+		for (u32 x = 0; x < size; ++x)
+			for (f32 v : {(f32)x, 0.f, (f32)y, 0.f, 1.f, 0.f, (f32)x / size, (f32)y / size})
+				put(v);
+	end();
+	begin("TRIS");
+	put((s32)-1);
+	for (u32 y = 0; y + 1 < size; ++y) {
+		for (u32 x = 0; x + 1 < size; ++x) {
+			const s32 i = y * size + x;
+			for (s32 v : {i, i + (s32)size, i + 1, i + 1, i + (s32)size, i + (s32)size + 1})
+				put(v);
+		}
+	}
+	end();
+	end(); // MESH
+	end(); // NODE
+	end(); // BB3D
+	return data;
+}
+
+//! Checks a loaded grid of size * size vertices
+static void checkGrid(const scene::IMesh *mesh, u32 size)
+{
+	check(mesh && mesh->getMeshBufferCount() == 1, "grid not loaded as one buffer");
+	const scene::IMeshBuffer *buffer = mesh->getMeshBuffer(0);
+	const u32 vertexCount = buffer->getVertexCount();
+	check(vertexCount == size * size, "wrong vertex count");
+	check(buffer->getIndexType() == (vertexCount > 65536 ? video::EIT_32BIT : video::EIT_16BIT),
+			"unexpected index type");
+	check(buffer->getIndexCount() == (size - 1) * (size - 1) * 6, "wrong index count");
+
+	// every corner of the grid is used, so overflowing indices would lose some
+	const scene::IIndexBuffer *indices = buffer->getIndexBuffer();
+	std::vector<bool> used(vertexCount);
+	for (u32 i = 0; i < indices->getCount(); ++i) {
+		const u32 index = indices->getIndex(i);
+		check(index < vertexCount, "index out of range");
+		used[index] = true;
+	}
+	for (bool u : used)
+		check(u, "vertex not used");
+
+	// the OBJ loader mirrors X
+	const core::aabbox3df &box = buffer->getBoundingBox();
+	check(box.getExtent() == core::vector3df((f32)size - 1, 0, (f32)size - 1), "wrong bounding box");
+}
+
+static void testLoaders(IrrlichtDevice *device)
+{
+	for (u32 size : {40, 260}) {
+		scene::IAnimatedMesh *obj = loadFromMemory(device, makeObj(size), "grid.obj");
+		checkGrid(obj, size);
+
+		// the copy keeps the index type
+		scene::SMesh *copy = device->getSceneManager()->getMeshManipulator()->createMeshCopy(obj);
+		copy->getMeshBuffer(0)->recalculateBoundingBox();
+		checkGrid(copy, size);
+		copy->drop();
+
+		// so does the mesh cache
+		const std::string cache = (std::filesystem::temp_directory_path() / "mesh_index32.meshcache").string();
+		scene::IMeshWriter *writer = device->getSceneManager()->createMeshWriter(scene::EMWT_MESH_CACHE);
+		io::IWriteFile *file = device->getFileSystem()->createAndWriteFile(cache.c_str());
+		check(writer->writeMesh(file, obj), "writing the cache failed");
+		file->drop();
+		writer->drop();
+		io::IReadFile *read = device->getFileSystem()->createAndOpenFile(cache.c_str());
+		scene::IAnimatedMesh *cached = device->getSceneManager()->getMesh(read);
+		read->drop();
+		checkGrid(cached, size);
+		device->getSceneManager()->getMeshCache()->removeMesh(cached);
+		std::filesystem::remove(cache);
+		obj->drop();
+
+		scene::IAnimatedMesh *b3d = loadFromMemory(device, makeB3D(size), "grid.b3d");
+		checkGrid(b3d, size);
+		b3d->drop();
+	}
+}
+
+//! Buffer with a strip of quads along X, starting at the given Z
+static scene::SMeshBuffer *makeStrip(u32 quads, f32 z, video::SColor color)
+{
+	auto *buffer = new scene::SMeshBuffer();
+	for (u32 i = 0; i <= quads; ++i) {
+		buffer->Vertices->Data.emplace_back((f32)i, 0.f, z, 0.f, 1.f, 0.f, color, 0.f, 0.f);
+		buffer->Vertices->Data.emplace_back((f32)i, 0.f, z + 1.f, 0.f, 1.f, 0.f, color, 0.f, 1.f);
+	}
+	for (u32 i = 0; i < quads; ++i) {
+		const u16 v = i * 2;
+		for (u16 index : {v, (u16)(v + 1), (u16)(v + 2), (u16)(v + 2), (u16)(v + 1), (u16)(v + 3)})
+			buffer->Indices->Data.push_back(index);
+	}
+	buffer->recalculateBoundingBox();
+	return buffer;
+}
+
+//! Positions of the triangle corners of the buffers, in drawing order
+static std::vector<core::vector3df> corners(const scene::IMesh *mesh, video::SColor color)
+{
+	std::vector<core::vector3df> result;
+	for (u32 b = 0; b < mesh->getMeshBufferCount(); ++b) {
+		const scene::IMeshBuffer *buffer = mesh->getMeshBuffer(b);
+		const auto *vertices = static_cast<const video::S3DVertex *>(buffer->getVertices());
+		for (u32 i = 0; i < buffer->getIndexCount(); ++i) {
+			const video::S3DVertex &v = vertices[buffer->getIndexBuffer()->getIndex(i)];
+			if (v.Color == color)
+				result.push_back(v.Pos);
+		}
+	}
+	return result;
+}
+
+static scene::SMesh *makeStrips()
+{
+	auto *mesh = new scene::SMesh();
+	// three buffers of 22000 vertices with the same material and texture slot
+	for (u32 i = 0; i < 3; ++i) {
+		scene::SMeshBuffer *buffer = makeStrip(10999, (f32)i * 2, 0xffffffff);
+		mesh->addMeshBuffer(buffer);
+		mesh->setTextureSlot(i, 0);
+		buffer->drop();
+	}
+	// an other material
+	scene::SMeshBuffer *buffer = makeStrip(10, 10.f, 0xffff0000);
+	buffer->Material.Wireframe = true;
+	mesh->addMeshBuffer(buffer);
+	buffer->drop();
+	// the same material, but points
+	buffer = makeStrip(10, 12.f, 0xff00ff00);
+	buffer->PrimitiveType = scene::EPT_POINTS;
+	mesh->addMeshBuffer(buffer);
+	buffer->drop();
+	// the same material and a small strip, but its own texture slot
+	buffer = makeStrip(10, 14.f, 0xff0000ff);
+	mesh->addMeshBuffer(buffer);
+	buffer->drop();
+	mesh->recalculateBoundingBox();
+	return mesh;
+}
+
+static void testMerge(IrrlichtDevice *device)
+{
+	scene::IMeshManipulator *manipulator = device->getSceneManager()->getMeshManipulator();
+
+	const video::SColor colors[] = {0xffffffff, 0xffff0000, 0xff00ff00, 0xff0000ff};
+	scene::SMesh *original = makeStrips();
+
+	// 16-bit indices: the third big strip no longer fits, the small blue one does
+	scene::SMesh *mesh = makeStrips();
+	check(manipulator->mergeMeshBuffers(mesh, false) == 1, "wrong number of merged 16-bit buffers");
+	check(mesh->getMeshBufferCount() == 5, "wrong buffer count with 16-bit indices");
+	check(mesh->getMeshBuffer(0)->getVertexCount() == 44000 &&
+					mesh->getMeshBuffer(0)->getIndexType() == video::EIT_16BIT,
+			"first two strips not merged");
+	check(mesh->getMeshBuffer(1)->getVertexCount() == 22000, "third strip changed");
+	check(mesh->getTextureSlot(4) == 5, "texture slot lost");
+	for (video::SColor color : colors)
+		check(corners(mesh, color) == corners(original, color), "triangles changed by merging");
+	mesh->drop();
+
+	// 32-bit indices: all big strips are merged
+	mesh = makeStrips();
+	check(manipulator->mergeMeshBuffers(mesh, true) == 2, "wrong number of merged 32-bit buffers");
+	check(mesh->getMeshBufferCount() == 4, "wrong buffer count with 32-bit indices");
+	const scene::IMeshBuffer *merged = mesh->getMeshBuffer(0);
+	check(merged->getVertexCount() == 66000 && merged->getIndexType() == video::EIT_32BIT,
+			"big strips not merged into a 32-bit buffer");
+	check(merged->getBoundingBox().MinEdge == core::vector3df(0, 0, 0) &&
+					merged->getBoundingBox().MaxEdge == core::vector3df(10999, 0, 5),
+			"wrong bounding box of the merged buffer");
+	check(mesh->getMeshBuffer(1)->getMaterial().Wireframe, "materials mixed up");
+	check(mesh->getMeshBuffer(2)->getPrimitiveType() == scene::EPT_POINTS, "points merged");
+	for (video::SColor color : colors)
+		check(corners(mesh, color) == corners(original, color), "triangles changed by merging");
+
+	// nothing left to merge
+	check(manipulator->mergeMeshBuffers(mesh, true) == 0, "merged buffers merged again");
+	mesh->drop();
+
+	// the small strip joins the big ones when texture slots do not matter
+	mesh = makeStrips();
+	check(manipulator->mergeMeshBuffers(mesh, true, true) == 3, "wrong number of merged buffers ignoring slots");
+	check(mesh->getMeshBufferCount() == 3 && mesh->getMeshBuffer(0)->getVertexCount() == 66022,
+			"small strip not merged ignoring slots");
+	check(mesh->getTextureSlot(0) == 0, "texture slot of the first buffer not kept");
+	for (video::SColor color : colors)
+		check(corners(mesh, color) == corners(original, color), "triangles changed by merging");
+	mesh->drop();
+	original->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	IrrlichtDevice *device = createNullDevice();
+
+	testLoaders(device);
+	testMerge(device);
+	std::printf("All 32-bit index checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
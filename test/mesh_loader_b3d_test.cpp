@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+#include <IFileSystem.h>
+#include <IMeshCache.h>
+#include <ISceneManager.h>
+#include <SkinnedMesh.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Builds B3D files in memory, checks what the loader makes of them and
+// times loading a large grid. Pass "--bench" for a larger grid.
+
+//! writes B3D chunks, patching in their sizes when they are closed
+struct B3DWriter
+{
+	std::vector<u8> data;
+	std::vector<size_t> open;
+
+	template <class T>
+	void put(T value)
+	{
+		const u8 *bytes = (const u8 *)&value;
+		data.insert(data.end(), bytes, bytes + sizeof(T));
+	}
+
+	void putString(const char *str) { data.insert(data.end(), str, str + strlen(str) + 1); }
+
+	void begin(const char *name)
+	{
+		data.insert(data.end(), name, name + 4);
+		open.push_back(data.size());
+		put<s32>(0);
+	}
+
+	void end()
+	{
+		const s32 size = (s32)(data.size() - open.back() - 4);
+		memcpy(&data[open.back()], &size, 4);
+		open.pop_back();
+	}
+};
+
+//! meshes of size x size vertices with normals, colors and one uv set,
+//! plus a child bone that weights every vertex of the last mesh and has position keys
+static std::vector<u8> makeGrid(u32 size, u32 meshes, u32 keys)
+{
+	B3DWriter w;
+	w.begin("BB3D");
+	w.put<s32>(1);
+
+	w.begin("NODE");
+	w.putString("root");
+	for (f32 v : {0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f, 0.f, 0.f, 0.f})
+		w.put(v);
+
+	for (u32 m = 0; m < meshes; ++m) {
+		w.begin("MESH");
+		w.put<s32>(-1);
+		w.begin("VRTS");
+		w.put<s32>(3); // normals and colors
+		w.put<s32>(1);
+		w.put<s32>(2);
+		for (u32 y = 0; y < size; ++y) {
+			for (u32 x = 0; x < size; ++x) {
+				for (f32 v : {(f32)x, 0.f, (f32)y, 0.f, 1.f, 0.f, 1.f, 0.5f, 0.f, 1.f,
+							 (f32)x / size, (f32)y / size})
+					w.put(v);
+			}
+		}
+		w.end();
+		w.begin("TRIS");
+		w.put<s32>(-1);
+		for (u32 y = 0; y + 1 < size; ++y) {
+			for (u32 x = 0; x + 1 < size; ++x) {
+				const s32 i = y * size + x;
+				for (s32 v : {i, i + (s32)size, i + 1, i + 1, i + (s32)size, i + (s32)size + 1})
+					w.put(v);
+			}
+		}
+		w.end();
+		w.end(); // MESH
+	}
+
+	w.begin("NODE");
+	w.putString("bone");
+	for (f32 v : {0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f, 0.f, 0.f, 0.f})
+		w.put(v);
+	w.begin("BONE");
+	for (u32 i = 0; i < size * size; ++i) {
+		w.put<u32>(i);
+		w.put<f32>(1.f);
+	}
+	w.end();
+	w.begin("KEYS");
+	w.put<s32>(1);
+	for (u32 k = 1; k <= keys; ++k) {
+		w.put<s32>(k);
+		for (f32 v : {0.f, (f32)k, 0.f})
+			w.put(v);
+	}
+	w.end();
+	w.end(); // NODE bone
+
+	w.end(); // NODE root
+	w.end(); // BB3D
+	return w.data;
+}
+
+static scene::IAnimatedMesh *loadFromMemory(IrrlichtDevice *device, const std::vector<u8> &data, const char *name)
+{
+	io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(data.data(), data.size(), name);
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	return mesh;
+}
+
+static void testGrid(IrrlichtDevice *device)
+{
+	const u32 size = 9;
+	scene::IAnimatedMesh *mesh = loadFromMemory(device, makeGrid(size, 1, 5), "grid.b3d");
+	if (!mesh || mesh->getMeshBufferCount() != 1)
+		throw std::runtime_error("grid not loaded");
+
+	scene::IMeshBuffer *buffer = mesh->getMeshBuffer(0);
+	if (buffer->getVertexCount() != size * size || buffer->getIndexCount() != (size - 1) * (size - 1) * 6)
+		throw std::runtime_error("grid has the wrong vertex or index count");
+
+	// vertices are added in the order the triangles use them
+	const video::S3DVertex *vertices = (const video::S3DVertex *)buffer->getVertices();
+	const u16 *indices = buffer->getIndices();
+	const u32 corner = (size - 1) * size + size - 1;
+	for (u32 i = 0; i < buffer->getIndexCount(); ++i) {
+		const video::S3DVertex &v = vertices[indices[i]];
+		if (v.Normal != core::vector3df(0.f, 1.f, 0.f) || v.Color != video::SColor(255, 255, 128, 0))
+			throw std::runtime_error("wrong vertex attributes");
+		if (v.Pos == core::vector3df((f32)(corner % size), 0.f, (f32)(corner / size)) &&
+				v.TCoords != core::vector2df((f32)(size - 1) / size, (f32)(size - 1) / size))
+			throw std::runtime_error("wrong texture coordinates");
+	}
+
+	if (mesh->getMaxFrameNumber() != 4.f)
+		throw std::runtime_error("wrong number of frames");
+	auto *skinned = dynamic_cast<scene::SkinnedMesh *>(mesh);
+	if (!skinned || skinned->getJointCount() != 2 || !skinned->hasWeights())
+		throw std::runtime_error("joints or weights missing");
+
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+}
+
+static void testTruncated(IrrlichtDevice *device)
+{
+	std::vector<u8> data = makeGrid(4, 1, 2);
+	data.resize(data.size() / 2);
+	scene::IAnimatedMesh *mesh = loadFromMemory(device, data, "truncated.b3d");
+	if (mesh)
+		throw std::runtime_error("truncated file loaded");
+
+	// a chunk claiming 2 GiB is rejected before its records are allocated
+	data = makeGrid(4, 1, 2);
+	const char vrts[] = "VRTS";
+	auto chunk = std::search(data.begin(), data.end(), vrts, vrts + 4);
+	const s32 huge = 0x7FFFFFF0;
+	memcpy(&*(chunk + 4), &huge, 4);
+	mesh = loadFromMemory(device, data, "huge_chunk.b3d");
+	if (mesh)
+		throw std::runtime_error("file with an oversized chunk loaded");
+}
+
+static void benchmark(IrrlichtDevice *device, bool large)
+{
+	const u32 size = 250, meshes = large ? 64 : 4;
+	const std::vector<u8> data = makeGrid(size, meshes, 1000);
+
+	scene::IAnimatedMesh *mesh = 0;
+	const double ms = measure(1, [&] { mesh = loadFromMemory(device, data, "bench.b3d"); });
+	if (!mesh)
+		throw std::runtime_error("benchmark mesh not loaded");
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+
+	std::printf("Loaded %u KiB of B3D (%u vertices) in %.1f ms\n",
+			(u32)(data.size() / 1024), size * size * meshes, ms);
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	testGrid(device);
+	testTruncated(device);
+	std::printf("All B3D loader checks passed\n");
+
+	benchmark(device, large);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,154 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <irrlicht.h>
+#include <IFileSystem.h>
+#include <IMeshCache.h>
+#include <ISceneManager.h>
+#include <IAnimatedMesh.h>
+#include <IMeshBuffer.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks the .obj loader on a small hand written file and on generated grids,
+// which are large enough to be parsed by several threads, and times loading.
+// Pass "--bench" to time a much larger grid.
+
+static const char smallMesh[] =
+		"# comment\r\n"
+		"v 1 2 3\r\n"
+		"v 4.5 -5 6e1\r\n"
+		"v 7 8 9\r\n"
+		"v 10 11 12\r\n"
+		"vt 0.25 0.75\r\n"
+		"vn 0 1 0\r\n"
+		"s off\r\n"
+		"f 1/1/1 2/1/1 3/1/1 4/1/1\r\n"
+		"g second\r\n"
+		"usemtl other\r\n"
+		"f -4//-1 -3//-1 -2//-1\r\n"
+		"f -4//1 -3//1 -3//1\r\n";
+
+static scene::IAnimatedMesh *loadFromMemory(IrrlichtDevice *device, const void *data, size_t size, const char *name)
+{
+	io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(data, size, name);
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	return mesh;
+}
+
+static void testSmall(IrrlichtDevice *device)
+{
+	scene::IAnimatedMesh *mesh = loadFromMemory(device, smallMesh, sizeof(smallMesh) - 1, "small.obj");
+	if (!mesh || mesh->getMeshBufferCount() != 2)
+		throw std::runtime_error("small mesh not loaded");
+
+	// the quad is split into two triangles sharing the corners
+	scene::IMeshBuffer *quad = mesh->getMeshBuffer(0);
+	if (quad->getVertexCount() != 4 || quad->getIndexCount() != 6)
+		throw std::runtime_error("quad has the wrong vertex or index count");
+	if (quad->getPosition(1).getDistanceFrom({-4.5f, -5.f, 60.f}) > 1e-5f)
+		throw std::runtime_error("vertex position parsed wrong");
+	if (quad->getTCoords(3).getDistanceFrom({0.25f, 0.25f}) > 1e-6f || quad->getNormal(2) != core::vector3df(0.f, 1.f, 0.f))
+		throw std::runtime_error("texture coordinate or normal parsed wrong");
+
+	// relative indices, the degenerated face is dropped
+	scene::IMeshBuffer *triangle = mesh->getMeshBuffer(1);
+	if (triangle->getVertexCount() != 3 || triangle->getIndexCount() != 3)
+		throw std::runtime_error("triangle has the wrong vertex or index count");
+	if (triangle->getPosition(0) != core::vector3df(-1.f, 2.f, 3.f))
+		throw std::runtime_error("relative index resolved wrong");
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+
+	const char *broken[] = {"v 1 2 3\nf 1 2 4\n", "v 1 2 3\nf 1 1\n"};
+	for (const char *text : broken) {
+		if (loadFromMemory(device, text, strlen(text), "broken.obj"))
+			throw std::runtime_error("broken mesh loaded");
+	}
+}
+
+// quad rows per group, keeps the mesh buffers within 16 bit indices
+static const u32 bandRows = 32;
+
+//! Grid of size x size quads in the xz plane, written row by row with
+//! relative face indices so that they cross the parser's chunk boundaries.
+static std::string makeGrid(u32 size)
+{
+	std::string text;
+	text.reserve((size_t)(size + 1) * (size + 1) * 110);
+	char line[128];
+	for (u32 z = 0; z <= size; ++z) {
+		for (u32 x = 0; x <= size; ++x) {
+			snprintf(line, sizeof(line), "v %u 0 %u\nvt %.6f %.6f\nvn 0 1 0\n", x, z, (f32)x / size, (f32)z / size);
+			text += line;
+		}
+		if (z == 0)
+			continue;
+		if ((z - 1) % bandRows == 0) {
+			snprintf(line, sizeof(line), "g band%u\n", (z - 1) / bandRows);
+			text += line;
+		}
+		const s32 row = size + 1;
+		for (u32 x = 0; x < size; ++x) {
+			// the last vertex written has index -1
+			const s32 a = x - 2 * row, b = a + 1, c = b + row, d = a + row;
+			snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d, d, d);
+			text += line;
+		}
+	}
+	return text;
+}
+
+static void checkGrid(scene::IMesh *mesh, u32 size)
+{
+	const u32 bands = (size + bandRows - 1) / bandRows;
+	if (!mesh || mesh->getMeshBufferCount() != bands)
+		throw std::runtime_error("grid not loaded");
+	for (u32 b = 0; b < bands; ++b) {
+		scene::IMeshBuffer *buffer = mesh->getMeshBuffer(b);
+		const u32 rows = core::min_(size - b * bandRows, bandRows);
+		if (buffer->getVertexCount() != (rows + 1) * (size + 1) || buffer->getIndexCount() != rows * size * 6)
+			throw std::runtime_error("grid has the wrong vertex or index count");
+		for (u32 i = 0; i < buffer->getVertexCount(); ++i) {
+			const core::vector3df &pos = buffer->getPosition(i);
+			const core::vector2df &uv = buffer->getTCoords(i);
+			if (std::fabs(-pos.X / size - uv.X) > 1e-5f || std::fabs(1.f - pos.Z / size - uv.Y) > 1e-5f ||
+					buffer->getNormal(i) != core::vector3df(0.f, 1.f, 0.f))
+				throw std::runtime_error("grid corner resolved to the wrong vertex data");
+		}
+	}
+}
+
+static void testGrid(IrrlichtDevice *device, u32 size, bool time)
+{
+	const std::string text = makeGrid(size);
+	scene::IAnimatedMesh *mesh = 0;
+	const double ms = measure(1, [&] { mesh = loadFromMemory(device, text.data(), text.size(), "grid.obj"); });
+	checkGrid(mesh, size);
+	if (time)
+		std::printf("%ux%u grid, %.1f MB: %8.2f ms\n", size, size, text.size() / 1e6, ms);
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+
+	testSmall(device);
+	testGrid(device, 9, false);
+	testGrid(device, 255, false);
+	std::printf("All obj loader checks passed\n");
+
+	testGrid(device, large ? 1023 : 511, true);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
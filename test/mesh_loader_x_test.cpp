@@ -0,0 +1,149 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+#include <IFileSystem.h>
+#include <IMeshCache.h>
+#include <ISceneManager.h>
+#include <IAnimatedMesh.h>
+#include <IMeshBuffer.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks number parsing of the text .x loader and times loading
+// media/coolguy_opt.x, repeated to get a larger file.
+// Pass "--bench" to time a much larger file.
+
+static const char smallMesh[] =
+		"xof 0303txt 0032\n"
+		"// comment\n"
+		"Mesh test {\n"
+		" 3;\n"
+		" 1.5;-2.25e1;3;,\n"
+		" 0.125;1000000;-0.0;,\n"
+		" -7;.5;1e-3;;\n"
+		" 1;\n"
+		" 3;0,1,2;;\n"
+		"}\n";
+
+// normals in DeclData are floats written as DWORDs, -1.f is 3212836864
+static const char declDataMesh[] =
+		"xof 0303txt 0032\n"
+		"Mesh test {\n"
+		" 3;\n"
+		" 0;0;0;, 1;0;0;, 0;1;0;;\n"
+		" 1;\n"
+		" 3;0,1,2;;\n"
+		" DeclData {\n"
+		"  1;\n"
+		"  2;0;3;0;;\n"
+		"  9;\n"
+		"  0,0,3212836864,0,0,3212836864,0,0,3212836864;\n"
+		" }\n"
+		"}\n";
+
+static scene::IAnimatedMesh *loadFromMemory(IrrlichtDevice *device, const void *data, size_t size, const char *name)
+{
+	io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(data, size, name);
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	return mesh;
+}
+
+static u32 vertexCount(scene::IMesh *mesh)
+{
+	u32 count = 0;
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i)
+		count += mesh->getMeshBuffer(i)->getVertexCount();
+	return count;
+}
+
+static void testNumbers(IrrlichtDevice *device)
+{
+	scene::IAnimatedMesh *mesh = loadFromMemory(device, smallMesh, sizeof(smallMesh) - 1, "small.x");
+	if (!mesh || mesh->getMeshBufferCount() != 1)
+		throw std::runtime_error("small mesh not loaded");
+
+	const core::vector3df expected[] = {{1.5f, -22.5f, 3.f}, {0.125f, 1e6f, 0.f}, {-7.f, 0.5f, 1e-3f}};
+	scene::IMeshBuffer *buffer = mesh->getMeshBuffer(0);
+	if (buffer->getVertexCount() != 3)
+		throw std::runtime_error("small mesh has the wrong vertex count");
+	for (const auto &pos : expected) {
+		bool found = false;
+		for (u32 i = 0; i < 3; ++i)
+			found = found || buffer->getPosition(i).getDistanceFrom(pos) <= pos.getLength() * 1e-6f;
+		if (!found)
+			throw std::runtime_error("vertex position parsed wrong");
+	}
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+
+	mesh = loadFromMemory(device, declDataMesh, sizeof(declDataMesh) - 1, "decldata.x");
+	if (!mesh || mesh->getMeshBufferCount() != 1)
+		throw std::runtime_error("mesh with DeclData not loaded");
+	if (mesh->getMeshBuffer(0)->getNormal(0) != core::vector3df(0.f, 0.f, -1.f))
+		throw std::runtime_error("DWORD above INT_MAX parsed wrong");
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+}
+
+static std::vector<char> readFile(IrrlichtDevice *device, const io::path &path)
+{
+	io::IReadFile *file = device->getFileSystem()->createAndOpenFile(path);
+	if (!file)
+		throw std::runtime_error("media file not found");
+	std::vector<char> data(file->getSize());
+	file->read(data.data(), data.size());
+	file->drop();
+	return data;
+}
+
+static void benchmark(IrrlichtDevice *device, bool large)
+{
+	io::path mediaPath = "media/";
+	if (!device->getFileSystem()->existFile(mediaPath))
+		mediaPath = "../../media/"; // started from bin/PLATFORM/
+	const std::vector<char> original = readFile(device, mediaPath + "coolguy_opt.x");
+
+	scene::IAnimatedMesh *mesh = loadFromMemory(device, original.data(), original.size(), "coolguy.x");
+	if (!mesh)
+		throw std::runtime_error("coolguy_opt.x not loaded");
+	const u32 vertices = vertexCount(mesh);
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+
+	// repeat everything after the header line
+	const u32 copies = large ? 400 : 40;
+	const char *body = (const char *)memchr(original.data(), '\n', original.size()) + 1;
+	std::vector<char> scaled(original.data(), body);
+	for (u32 i = 0; i < copies; ++i)
+		scaled.insert(scaled.end(), body, original.data() + original.size());
+
+	const double ms = measure(1, [&] { mesh = loadFromMemory(device, scaled.data(), scaled.size(), "coolguy_scaled.x"); });
+	if (!mesh || vertexCount(mesh) != vertices * copies)
+		throw std::runtime_error("scaled mesh not loaded completely");
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+
+	std::printf("Loaded %u KiB of .x text (%u vertices) in %.1f ms, %.1f MiB/s\n",
+			(u32)(scaled.size() / 1024), vertices * copies, ms,
+			scaled.size() / ms * 1e3 / (1024 * 1024));
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice(ELL_ERROR);
+
+	testNumbers(device);
+	std::printf("All .x loader checks passed\n");
+
+	benchmark(device, large);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
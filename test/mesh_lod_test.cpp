@@ -0,0 +1,254 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+#include <irrlicht.h>
+#include <ISceneManager.h>
+#include <IMeshManipulator.h>
+#include <IMeshSceneNode.h>
+#include <ICameraSceneNode.h>
+#include <CMeshBuffer.h>
+#include <SMesh.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Creates LOD chains of a sphere with IMeshManipulator::createLODChain,
+// reports triangle counts and the measured error of each level, and checks
+// the level selection of mesh scene nodes.
+// Pass "--bench" to time the simplification of a larger sphere.
+
+//! UV sphere with radius 1, the vertices on the texture seam are duplicated
+static scene::SMesh *createSphere(u32 slices, u32 stacks)
+{
+	scene::SMeshBuffer *buffer = new scene::SMeshBuffer();
+	auto &vertices = buffer->Vertices->Data;
+	const video::SColor white(255, 255, 255, 255);
+	vertices.emplace_back(core::vector3df(0, 1, 0), core::vector3df(0, 1, 0), white, core::vector2df(0.5f, 0));
+	for (u32 j = 1; j < stacks; ++j) {
+		const f32 theta = core::PI * j / stacks;
+		for (u32 i = 0; i <= slices; ++i) {
+			const f32 phi = 2 * core::PI * (i % slices) / slices;
+			const core::vector3df pos(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+			vertices.emplace_back(pos, pos, white, core::vector2df((f32)i / slices, (f32)j / stacks));
+		}
+	}
+	vertices.emplace_back(core::vector3df(0, -1, 0), core::vector3df(0, -1, 0), white, core::vector2df(0.5f, 1));
+
+	auto &indices = buffer->Indices->Data;
+	const u16 row = slices + 1, south = vertices.size() - 1;
+	for (u16 i = 0; i < slices; ++i)
+		indices.insert(indices.end(), {0, (u16)(i + 2), (u16)(i + 1)});
+	for (u16 j = 1; j + 1 < stacks; ++j) {
+		for (u16 i = 0; i < slices; ++i) {
+			const u16 a = 1 + (j - 1) * row + i, b = a + 1, c = a + row, d = c + 1;
+			indices.insert(indices.end(), {a, b, c, b, d, c});
+		}
+	}
+	for (u16 i = 0; i < slices; ++i) {
+		const u16 a = 1 + (stacks - 2) * row + i;
+		indices.insert(indices.end(), {a, (u16)(a + 1), south});
+	}
+	buffer->recalculateBoundingBox();
+
+	scene::SMesh *mesh = new scene::SMesh();
+	mesh->addMeshBuffer(buffer);
+	mesh->recalculateBoundingBox();
+	buffer->drop();
+	return mesh;
+}
+
+static f32 distanceToTriangle(const core::vector3df &p, const core::vector3df &a, const core::vector3df &b, const core::vector3df &c)
+{
+	// closest point by the Voronoi regions of the triangle
+	const core::vector3df ab = b - a, ac = c - a, ap = p - a;
+	const f32 d1 = ab.dotProduct(ap), d2 = ac.dotProduct(ap);
+	if (d1 <= 0.f && d2 <= 0.f)
+		return p.getDistanceFrom(a);
+	const core::vector3df bp = p - b;
+	const f32 d3 = ab.dotProduct(bp), d4 = ac.dotProduct(bp);
+	if (d3 >= 0.f && d4 <= d3)
+		return p.getDistanceFrom(b);
+	const f32 vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+		return p.getDistanceFrom(a + ab * (d1 / (d1 - d3)));
+	const core::vector3df cp = p - c;
+	const f32 d5 = ab.dotProduct(cp), d6 = ac.dotProduct(cp);
+	if (d6 >= 0.f && d5 <= d6)
+		return p.getDistanceFrom(c);
+	const f32 vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+		return p.getDistanceFrom(a + ac * (d2 / (d2 - d6)));
+	const f32 va = d3 * d6 - d5 * d4;
+	if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+		return p.getDistanceFrom(b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))));
+	const f32 denom = 1.f / (va + vb + vc);
+	return p.getDistanceFrom(a + ab * (vb * denom) + ac * (vc * denom));
+}
+
+//! Largest distance of the vertices of one mesh to the surface of another
+static f32 measureError(scene::IMeshBuffer *from, scene::IMeshBuffer *to)
+{
+	f32 maxDistance = 0.f;
+	const u16 *indices = to->getIndices();
+	for (u32 v = 0; v < from->getVertexCount(); ++v) {
+		const core::vector3df &p = from->getPosition(v);
+		f32 distance = FLT_MAX;
+		for (u32 i = 0; i < to->getIndexCount() && distance > 0.f; i += 3) {
+			distance = core::min_(distance, distanceToTriangle(p, to->getPosition(indices[i]),
+					to->getPosition(indices[i + 1]), to->getPosition(indices[i + 2])));
+		}
+		maxDistance = core::max_(maxDistance, distance);
+	}
+	return maxDistance;
+}
+
+static void testChain(scene::IMeshManipulator *manipulator)
+{
+	const u32 slices = 64, stacks = 32;
+	scene::SMesh *sphere = createSphere(slices, stacks);
+	scene::IMeshBuffer *full = sphere->getMeshBuffer(0);
+	const u32 fullTriangles = full->getIndexCount() / 3;
+
+	std::vector<f32> errors;
+	std::vector<scene::SMesh *> chain = manipulator->createLODChain(sphere, 4, 0.5f, &errors);
+	if (chain.size() != 4 || errors.size() != 4)
+		throw std::runtime_error("wrong number of levels");
+
+	std::printf("level  triangles  vertices  reported error  measured error\n");
+	std::printf("%5u  %9u  %8u\n", 0, fullTriangles, full->getVertexCount());
+	u32 lastTriangles = fullTriangles;
+	for (u32 l = 0; l < chain.size(); ++l) {
+		scene::IMeshBuffer *buffer = chain[l]->getMeshBuffer(0);
+		const u32 triangles = buffer->getIndexCount() / 3;
+		const f32 measured = measureError(full, buffer);
+		std::printf("%5u  %9u  %8u  %14.5f  %14.5f\n", l + 1, triangles, buffer->getVertexCount(), errors[l], measured);
+
+		if (triangles > fullTriangles >> (l + 1) || triangles < lastTriangles / 3)
+			throw std::runtime_error("level has the wrong number of triangles");
+		if (measured > 0.05f * (l + 1))
+			throw std::runtime_error("level deviates too much from the sphere");
+		if (l > 0 && errors[l] < errors[l - 1])
+			throw std::runtime_error("error does not grow with the level");
+		lastTriangles = triangles;
+
+		// vertices are never moved and the seam keeps all of its vertices
+		u32 seam = 0;
+		for (u32 v = 0; v < buffer->getVertexCount(); ++v) {
+			if (std::fabs(buffer->getPosition(v).getLength() - 1.f) > 1e-5f)
+				throw std::runtime_error("simplification moved a vertex");
+			const core::vector2df &uv = buffer->getTCoords(v);
+			if (uv.X == 0.f || uv.X == 1.f)
+				++seam;
+		}
+		if (seam != 2 * (stacks - 1))
+			throw std::runtime_error("simplification removed seam vertices");
+		// no triangle may join the two sides of the texture seam, the poles have u = 0.5
+		const u16 *indices = buffer->getIndices();
+		for (u32 i = 0; i < buffer->getIndexCount(); i += 3) {
+			f32 minU = 1.f, maxU = 0.f;
+			for (u32 k = 0; k < 3; ++k) {
+				minU = core::min_(minU, buffer->getTCoords(indices[i + k]).X);
+				maxU = core::max_(maxU, buffer->getTCoords(indices[i + k]).X);
+			}
+			if (minU < 0.25f && maxU > 0.75f)
+				throw std::runtime_error("simplification broke the texture seam");
+		}
+	}
+
+	for (auto *lod : chain)
+		lod->drop();
+	sphere->drop();
+}
+
+static void testNodeSelection(scene::ISceneManager *smgr, scene::IMeshManipulator *manipulator)
+{
+	scene::SMesh *sphere = createSphere(32, 16);
+	const std::vector<scene::SMesh *> chain = manipulator->createLODChain(sphere, 3);
+	scene::IMeshSceneNode *node = smgr->addMeshSceneNode(sphere);
+	node->setLODLevels({chain.begin(), chain.end()}, {0.5f, 0.25f, 0.125f});
+	if (node->getLODLevelCount() != 4)
+		throw std::runtime_error("wrong LOD level count");
+
+	scene::ICameraSceneNode *camera = smgr->addCameraSceneNode(0, {0, 0, -2}, {0, 0, 0});
+	u32 lastLevel = 0;
+	for (f32 distance = 2.f; distance < 200.f; distance *= 1.25f) {
+		camera->setPosition({0, 0, -distance});
+		smgr->drawAll();
+		const u32 level = node->getCurrentLODLevel();
+		if (level < lastLevel)
+			throw std::runtime_error("detail level grows with the distance");
+		lastLevel = level;
+	}
+	if (lastLevel != 3)
+		throw std::runtime_error("far away node does not use the last level");
+
+	camera->setPosition({0, 0, -2});
+	smgr->drawAll();
+	if (node->getCurrentLODLevel() != 0)
+		throw std::runtime_error("close node does not use the mesh itself");
+
+	// disabled again
+	node->setLODLevels({}, {});
+	camera->setPosition({0, 0, -200});
+	smgr->drawAll();
+	if (node->getCurrentLODLevel() != 0 || node->getLODLevelCount() != 1)
+		throw std::runtime_error("LOD levels not removed");
+
+	// missing meshes are left out
+	node->setLODLevels({chain[0], nullptr, chain[2]}, {0.5f, 0.25f, 0.125f});
+	if (node->getLODLevelCount() != 3)
+		throw std::runtime_error("null LOD level kept");
+	smgr->drawAll();
+	if (node->getCurrentLODLevel() != 2)
+		throw std::runtime_error("far away node does not use the last non-null level");
+
+	// the levels of the former mesh are not drawn for another mesh
+	scene::SMesh *other = createSphere(16, 8);
+	node->setMesh(other);
+	if (node->getLODLevelCount() != 1)
+		throw std::runtime_error("LOD levels kept after changing the mesh");
+	smgr->drawAll();
+	if (node->getCurrentLODLevel() != 0)
+		throw std::runtime_error("level of the former mesh drawn");
+	other->drop();
+
+	node->remove();
+	camera->remove();
+	for (auto *lod : chain)
+		lod->drop();
+	sphere->drop();
+}
+
+static void benchmark(scene::IMeshManipulator *manipulator, bool large)
+{
+	scene::SMesh *sphere = large ? createSphere(256, 128) : createSphere(128, 64);
+	std::vector<scene::SMesh *> chain;
+	const double ms = measure(1, [&] { chain = manipulator->createLODChain(sphere, 4); });
+	std::printf("LOD chain of %u triangles: %.2f ms\n", sphere->getMeshBuffer(0)->getIndexCount() / 3, ms);
+	for (auto *lod : chain)
+		lod->drop();
+	sphere->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+	scene::ISceneManager *smgr = device->getSceneManager();
+	scene::IMeshManipulator *manipulator = smgr->getMeshManipulator();
+
+	testChain(manipulator);
+	testNodeSelection(smgr, manipulator);
+	std::printf("All LOD checks passed\n");
+
+	benchmark(manipulator, large);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,233 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <irrlicht.h>
+#include <ISceneManager.h>
+#include <IMeshManipulator.h>
+#include <CMeshBuffer.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that IMeshManipulator::recalculateNormals() gives exactly the
+// result of the former per vertex implementation, also when large buffers
+// are split between threads, and that recalculateTangents() gives
+// orthonormal tangent frames along the texture coordinates, then times
+// both against the former implementation.
+// Pass "--bench" to use a larger mesh.
+
+//! Bumpy grid of size x size quads, with U flipped if mirrored
+template <class TBuffer>
+static TBuffer *createGrid(u32 size, bool mirrored = false)
+{
+	auto *buffer = new TBuffer();
+	auto &vertices = buffer->Vertices->Data;
+	for (u32 z = 0; z <= size; ++z) {
+		for (u32 x = 0; x <= size; ++x) {
+			const f32 y = sinf(x * 0.3f) * cosf(z * 0.2f) * 2.f;
+			vertices.emplace_back((f32)x, y, (f32)z, 0.f, 1.f, 0.f, video::SColor(255, 255, 255, 255),
+					(mirrored ? (f32)(size - x) : (f32)x) / size, (f32)z / size);
+		}
+	}
+	auto &indices = buffer->Indices->Data;
+	const u32 row = size + 1;
+	for (u32 z = 0; z < size; ++z) {
+		for (u32 x = 0; x < size; ++x) {
+			const u32 a = z * row + x;
+			indices.insert(indices.end(), {a, a + row, a + 1, a + 1, a + row, a + row + 1});
+		}
+	}
+	buffer->recalculateBoundingBox();
+	return buffer;
+}
+
+static core::vector3df getAngleWeight(const core::vector3df &v1, const core::vector3df &v2, const core::vector3df &v3)
+{
+	const f32 a = v2.getDistanceFromSQ(v3);
+	const f32 asqrt = sqrtf(a);
+	const f32 b = v1.getDistanceFromSQ(v3);
+	const f32 bsqrt = sqrtf(b);
+	const f32 c = v1.getDistanceFromSQ(v2);
+	const f32 csqrt = sqrtf(c);
+	return core::vector3df(
+			acosf((b + c - a) / (2.f * bsqrt * csqrt)),
+			acosf((-b + c + a) / (2.f * asqrt * csqrt)),
+			acosf((b - c + a) / (2.f * bsqrt * asqrt)));
+}
+
+//! The former implementation, through the virtual accessors
+static void referenceNormals(scene::IMeshBuffer *buffer, bool smooth, bool angleWeighted)
+{
+	const u32 vtxcnt = buffer->getVertexCount();
+	const u32 idxcnt = buffer->getIndexCount();
+	const scene::IIndexBuffer *idx = buffer->getIndexBuffer();
+
+	if (!smooth) {
+		for (u32 i = 0; i < idxcnt; i += 3) {
+			const core::vector3df normal = core::plane3d<f32>(buffer->getPosition(idx->getIndex(i)),
+					buffer->getPosition(idx->getIndex(i + 1)), buffer->getPosition(idx->getIndex(i + 2))).Normal;
+			for (u32 k = 0; k < 3; ++k)
+				buffer->getNormal(idx->getIndex(i + k)) = normal;
+		}
+		return;
+	}
+	for (u32 i = 0; i != vtxcnt; ++i)
+		buffer->getNormal(i).set(0.f, 0.f, 0.f);
+	for (u32 i = 0; i < idxcnt; i += 3) {
+		const core::vector3df &v1 = buffer->getPosition(idx->getIndex(i));
+		const core::vector3df &v2 = buffer->getPosition(idx->getIndex(i + 1));
+		const core::vector3df &v3 = buffer->getPosition(idx->getIndex(i + 2));
+		const core::vector3df normal = core::plane3d<f32>(v1, v2, v3).Normal;
+		core::vector3df weight(1.f, 1.f, 1.f);
+		if (angleWeighted)
+			weight = getAngleWeight(v1, v2, v3);
+		buffer->getNormal(idx->getIndex(i + 0)) += weight.X * normal;
+		buffer->getNormal(idx->getIndex(i + 1)) += weight.Y * normal;
+		buffer->getNormal(idx->getIndex(i + 2)) += weight.Z * normal;
+	}
+	for (u32 i = 0; i != vtxcnt; ++i)
+		buffer->getNormal(i).normalize();
+}
+
+//! Former SkinnedMesh::calculateTangents() for the corners of each triangle
+static void referenceTangents(scene::SMeshBufferTangents32 *buffer)
+{
+	auto &v = buffer->Vertices->Data;
+	const auto &idx = buffer->Indices->Data;
+	for (u32 i = 0; i < idx.size(); i += 3) {
+		for (u32 k = 0; k < 3; ++k) {
+			video::S3DVertexTangents &a = v[idx[i + k]];
+			const video::S3DVertexTangents &b = v[idx[i + (k + 1) % 3]];
+			const video::S3DVertexTangents &c = v[idx[i + (k + 2) % 3]];
+			const core::vector3df v1 = a.Pos - b.Pos;
+			const core::vector3df v2 = c.Pos - a.Pos;
+			const core::vector3df normal = v2.crossProduct(v1).normalize();
+			a.Binormal = ((v1 * (c.TCoords.X - a.TCoords.X)) - (v2 * (a.TCoords.X - b.TCoords.X))).normalize();
+			a.Tangent = ((v1 * (c.TCoords.Y - a.TCoords.Y)) - (v2 * (a.TCoords.Y - b.TCoords.Y))).normalize();
+			if (a.Tangent.crossProduct(a.Binormal).dotProduct(normal) < 0.f) {
+				a.Tangent *= -1.f;
+				a.Binormal *= -1.f;
+			}
+		}
+	}
+}
+
+template <class TBuffer>
+static void checkSameNormals(TBuffer *buffer, bool smooth, bool angleWeighted, scene::IMeshManipulator *manipulator)
+{
+	TBuffer *expected = new TBuffer();
+	expected->Vertices->Data = buffer->Vertices->Data;
+	expected->Indices->Data = buffer->Indices->Data;
+
+	referenceNormals(expected, smooth, angleWeighted);
+	manipulator->recalculateNormals(buffer, smooth, angleWeighted);
+	for (u32 i = 0; i < buffer->getVertexCount(); ++i) {
+		const core::vector3df &a = buffer->getNormal(i), &b = expected->getNormal(i);
+		check(a.X == b.X && a.Y == b.Y && a.Z == b.Z, "normals differ from the former implementation");
+	}
+	expected->drop();
+}
+
+static void testNormals(scene::IMeshManipulator *manipulator)
+{
+	// small enough for one thread and 16-bit indices
+	scene::SMeshBuffer *small = new scene::SMeshBuffer();
+	scene::SMeshBuffer32 *grid = createGrid<scene::SMeshBuffer32>(30);
+	small->Vertices->Data = grid->Vertices->Data;
+	for (u32 i : grid->Indices->Data)
+		small->Indices->Data.push_back((u16)i);
+	grid->drop();
+	checkSameNormals(small, false, false, manipulator);
+	checkSameNormals(small, true, false, manipulator);
+	checkSameNormals(small, true, true, manipulator);
+	small->drop();
+
+	// split between threads
+	scene::SMeshBuffer32 *large = createGrid<scene::SMeshBuffer32>(300);
+	checkSameNormals(large, true, false, manipulator);
+	checkSameNormals(large, true, true, manipulator);
+	large->drop();
+}
+
+static void testTangents(scene::IMeshManipulator *manipulator)
+{
+	// flat plane: the same as the former per triangle tangents
+	for (bool mirrored : {false, true}) {
+		scene::SMeshBufferTangents32 *plane = createGrid<scene::SMeshBufferTangents32>(8, mirrored);
+		for (auto &v : plane->Vertices->Data)
+			v.Pos.Y = 0.f;
+		scene::SMeshBufferTangents32 *expected = createGrid<scene::SMeshBufferTangents32>(8, mirrored);
+		expected->Vertices->Data = plane->Vertices->Data;
+		referenceTangents(expected);
+
+		manipulator->recalculateTangents(plane, true);
+		for (u32 i = 0; i < plane->getVertexCount(); ++i) {
+			const video::S3DVertexTangents &a = plane->Vertices->Data[i], &b = expected->Vertices->Data[i];
+			check(a.Normal.equals(core::vector3df(0.f, 1.f, 0.f)), "wrong normal of the plane");
+			check(a.Tangent.equals(b.Tangent) && a.Binormal.equals(b.Binormal), "tangents differ from the former implementation");
+		}
+		check(plane->Vertices->Data[0].Tangent.equals(core::vector3df(mirrored ? -1.f : 1.f, 0.f, 0.f)), "tangent does not follow U");
+		plane->drop();
+		expected->drop();
+	}
+
+	// curved: orthonormal frames along increasing U
+	scene::SMeshBufferTangents32 *bumps = createGrid<scene::SMeshBufferTangents32>(300);
+	manipulator->recalculateTangents(bumps, true, true);
+	for (const auto &v : bumps->Vertices->Data) {
+		check(fabsf(v.Tangent.getLength() - 1.f) < 1e-4f && fabsf(v.Binormal.getLength() - 1.f) < 1e-4f, "tangent frame not normalized");
+		check(fabsf(v.Tangent.dotProduct(v.Normal)) < 1e-4f && fabsf(v.Binormal.dotProduct(v.Normal)) < 1e-4f, "tangent frame not orthogonal to the normal");
+		check(v.Tangent.X > 0.f && v.Binormal.Z < 0.f, "tangent frame does not follow the texture coordinates");
+	}
+	// the same result when started again
+	std::vector<video::S3DVertexTangents> first = bumps->Vertices->Data;
+	manipulator->recalculateTangents(bumps, true, true);
+	check(memcmp(first.data(), bumps->Vertices->Data.data(), first.size() * sizeof(first[0])) == 0, "tangents not deterministic");
+	bumps->drop();
+}
+
+static void benchmark(scene::IMeshManipulator *manipulator, bool large)
+{
+	const u32 size = large ? 1000 : 300;
+	scene::SMeshBufferTangents32 *buffer = createGrid<scene::SMeshBufferTangents32>(size);
+	scene::SMeshBufferTangents32 *expected = createGrid<scene::SMeshBufferTangents32>(size);
+	std::printf("%u triangles\n", buffer->getIndexCount() / 3);
+
+	std::printf("%-28s %8.2f ms\n", "smooth normals, former",
+			measure(1, [&] { referenceNormals(expected, true, false); }));
+	std::printf("%-28s %8.2f ms\n", "smooth normals",
+			measure(1, [&] { manipulator->recalculateNormals(buffer, true, false); }));
+	std::printf("%-28s %8.2f ms\n", "angle weighted, former",
+			measure(1, [&] { referenceNormals(expected, true, true); }));
+	std::printf("%-28s %8.2f ms\n", "angle weighted",
+			measure(1, [&] { manipulator->recalculateNormals(buffer, true, true); }));
+	std::printf("%-28s %8.2f ms\n", "tangents, former",
+			measure(1, [&] { referenceTangents(expected); }));
+	std::printf("%-28s %8.2f ms\n", "tangents",
+			measure(1, [&] { manipulator->recalculateTangents(buffer); }));
+
+	buffer->drop();
+	expected->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+	scene::IMeshManipulator *manipulator = device->getSceneManager()->getMeshManipulator();
+
+	testNormals(manipulator);
+	testTangents(manipulator);
+	std::printf("All mesh normal checks passed\n");
+
+	benchmark(manipulator, large);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
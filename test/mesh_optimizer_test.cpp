@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <irrlicht.h>
+#include <ISceneManager.h>
+#include <IMeshManipulator.h>
+#include <CMeshBuffer.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that the IMeshManipulator mesh optimizations keep the triangles
+// intact and improve the simulated vertex cache, then times them.
+// Pass "--bench" to use a larger mesh.
+
+//! Grid of size x size quads with the triangles in random order,
+//! so that the vertex cache is of little use before optimizing
+static scene::SMeshBuffer *createShuffledGrid(u32 size, std::mt19937 &rng)
+{
+	scene::SMeshBuffer *buffer = new scene::SMeshBuffer();
+	auto &vertices = buffer->Vertices->Data;
+	for (u32 z = 0; z <= size; ++z) {
+		for (u32 x = 0; x <= size; ++x) {
+			// a bump, so that the triangles face different directions
+			const f32 dx = (f32)x - size * 0.5f, dz = (f32)z - size * 0.5f;
+			const f32 y = size * 0.5f - (dx * dx + dz * dz) / size;
+			vertices.emplace_back((f32)x, y, (f32)z, 0.f, 1.f, 0.f, video::SColor(255, x, z, 0), (f32)x / size, (f32)z / size);
+		}
+	}
+
+	std::vector<std::array<u16, 3>> triangles;
+	const u16 row = size + 1;
+	for (u16 z = 0; z < size; ++z) {
+		for (u16 x = 0; x < size; ++x) {
+			const u16 a = z * row + x;
+			triangles.push_back({a, (u16)(a + row), (u16)(a + 1)});
+			triangles.push_back({(u16)(a + 1), (u16)(a + row), (u16)(a + row + 1)});
+		}
+	}
+	std::shuffle(triangles.begin(), triangles.end(), rng);
+	auto &indices = buffer->Indices->Data;
+	for (const auto &tri : triangles)
+		indices.insert(indices.end(), tri.begin(), tri.end());
+	return buffer;
+}
+
+//! Triangles by their vertex data, rotated to start at the smallest
+//! corner, so that reordering triangles or vertices does not change them
+static std::vector<std::array<core::vector3df, 3>> getTriangles(scene::IMeshBuffer *buffer)
+{
+	std::vector<std::array<core::vector3df, 3>> triangles;
+	const u16 *indices = buffer->getIndices();
+	for (u32 i = 0; i < buffer->getIndexCount(); i += 3) {
+		std::array<core::vector3df, 3> tri = {buffer->getPosition(indices[i]),
+				buffer->getPosition(indices[i + 1]), buffer->getPosition(indices[i + 2])};
+		std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+		triangles.push_back(tri);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+static void checkTriangles(scene::IMeshBuffer *buffer, const std::vector<std::array<core::vector3df, 3>> &expected, const char *what)
+{
+	if (getTriangles(buffer) != expected)
+		throw std::runtime_error(std::string(what) + " changed the triangles");
+}
+
+static void testOptimize(scene::IMeshManipulator *manipulator)
+{
+	std::mt19937 rng(5);
+	scene::SMeshBuffer *buffer = createShuffledGrid(40, rng);
+	const auto triangles = getTriangles(buffer);
+	const scene::SVertexCacheStatistics before = manipulator->analyzeVertexCache(buffer);
+	if (before.ACMR < 1.5f || before.Transformed != (u32)(before.ATVR * buffer->getVertexCount() + 0.5f))
+		throw std::runtime_error("unexpected statistics of the shuffled grid");
+
+	manipulator->optimizeVertexCache(buffer);
+	checkTriangles(buffer, triangles, "optimizeVertexCache");
+	const scene::SVertexCacheStatistics cached = manipulator->analyzeVertexCache(buffer);
+	if (cached.ACMR > 0.8f)
+		throw std::runtime_error("optimizeVertexCache did not improve the cache use enough");
+
+	manipulator->optimizeOverdraw(buffer, 1.05f);
+	checkTriangles(buffer, triangles, "optimizeOverdraw");
+	const scene::SVertexCacheStatistics sorted = manipulator->analyzeVertexCache(buffer);
+	if (sorted.ACMR > cached.ACMR * 1.1f)
+		throw std::runtime_error("optimizeOverdraw lost too much of the cache use");
+
+	manipulator->optimizeVertexFetch(buffer);
+	checkTriangles(buffer, triangles, "optimizeVertexFetch");
+	// every new vertex is used right after the previous ones
+	const u16 *indices = buffer->getIndices();
+	u32 next = 0;
+	for (u32 i = 0; i < buffer->getIndexCount(); ++i) {
+		if (indices[i] > next)
+			throw std::runtime_error("vertices are not in order of first use");
+		if (indices[i] == next)
+			++next;
+	}
+	// the vertex data moved with the position
+	for (u32 i = 0; i < buffer->getVertexCount(); ++i) {
+		const video::S3DVertex &v = buffer->Vertices->Data[i];
+		if (v.Color.getRed() != (u32)v.Pos.X || v.Color.getGreen() != (u32)v.Pos.Z)
+			throw std::runtime_error("vertex attributes got separated");
+	}
+	if (manipulator->analyzeVertexCache(buffer).ACMR != sorted.ACMR)
+		throw std::runtime_error("optimizeVertexFetch changed the cache use");
+
+	buffer->drop();
+}
+
+static void benchmark(scene::IMeshManipulator *manipulator, bool large)
+{
+	std::mt19937 rng(9);
+	// u16 indices limit the grid size, use several buffers for the large run
+	const u32 repeats = large ? 16 : 2;
+	std::vector<scene::SMeshBuffer *> buffers;
+	for (u32 i = 0; i < repeats; ++i)
+		buffers.push_back(createShuffledGrid(250, rng));
+
+	const auto report = [&](const char *what, double ms) {
+		const scene::SVertexCacheStatistics stats = manipulator->analyzeVertexCache(buffers[0]);
+		std::printf("%-20s %8.2f ms   ACMR %.3f  ATVR %.3f\n", what, ms, stats.ACMR, stats.ATVR);
+	};
+	std::printf("%u x %u triangles, FIFO cache of 16\n", repeats, buffers[0]->getIndexCount() / 3);
+	report("shuffled", 0.0);
+	report("optimizeVertexCache", measure(1, [&] {
+		for (auto *buffer : buffers)
+			manipulator->optimizeVertexCache(buffer);
+	}));
+	report("optimizeOverdraw", measure(1, [&] {
+		for (auto *buffer : buffers)
+			manipulator->optimizeOverdraw(buffer);
+	}));
+	report("optimizeVertexFetch", measure(1, [&] {
+		for (auto *buffer : buffers)
+			manipulator->optimizeVertexFetch(buffer);
+	}));
+
+	for (auto *buffer : buffers)
+		buffer->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool large = isBenchmark(argc, argv);
+
+	IrrlichtDevice *device = createNullDevice();
+	scene::IMeshManipulator *manipulator = device->getSceneManager()->getMeshManipulator();
+
+	testOptimize(manipulator);
+	std::printf("All mesh optimizer checks passed\n");
+
+	benchmark(manipulator, large);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,150 @@
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <irrlicht.h>
+#include <ISceneManager.h>
+#include <IMeshManipulator.h>
+#include <CMeshBuffer.h>
+#include <QuantizedVertexBuffer.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks the half float conversion and the precision of the compact vertex
+// copies made by IMeshManipulator::quantizeVertices.
+
+using scene::QuantizedVertexBuffer;
+
+static void testHalf()
+{
+	check(QuantizedVertexBuffer::toHalf(0.f) == 0x0000, "0");
+	check(QuantizedVertexBuffer::toHalf(-0.f) == 0x8000, "-0");
+	check(QuantizedVertexBuffer::toHalf(1.f) == 0x3c00, "1");
+	check(QuantizedVertexBuffer::toHalf(-2.f) == 0xc000, "-2");
+	check(QuantizedVertexBuffer::toHalf(0.1f) == 0x2e66, "0.1");
+	check(QuantizedVertexBuffer::toHalf(1.f / 3) == 0x3555, "1/3");
+	check(QuantizedVertexBuffer::toHalf(65504.f) == 0x7bff, "largest half");
+	check(QuantizedVertexBuffer::toHalf(65520.f) == 0x7c00, "rounding to infinity");
+	check(QuantizedVertexBuffer::toHalf(1e9f) == 0x7c00, "overflow");
+	check(QuantizedVertexBuffer::toHalf(-std::numeric_limits<f32>::infinity()) == 0xfc00, "-infinity");
+	check((QuantizedVertexBuffer::toHalf(std::numeric_limits<f32>::quiet_NaN()) & 0x7fff) > 0x7c00, "NaN");
+	check(QuantizedVertexBuffer::toHalf(std::ldexp(1.f, -24)) == 0x0001, "smallest subnormal");
+	check(QuantizedVertexBuffer::toHalf(std::ldexp(1.f, -25)) == 0x0000, "subnormal tie to even");
+	check(QuantizedVertexBuffer::toHalf(std::ldexp(3.f, -25)) == 0x0002, "subnormal rounding");
+	check(QuantizedVertexBuffer::toHalf(1.f + std::ldexp(1.f, -11)) == 0x3c00, "tie to even");
+	check(QuantizedVertexBuffer::toHalf(1.f + std::ldexp(3.f, -11)) == 0x3c02, "tie to even upwards");
+
+	// every half except NaN survives the round trip
+	for (u32 h = 0; h < 0x10000; ++h) {
+		if ((h & 0x7c00) == 0x7c00 && (h & 0x3ff))
+			continue;
+		check(QuantizedVertexBuffer::toHalf(QuantizedVertexBuffer::fromHalf(h)) == h, "half round trip");
+	}
+}
+
+static scene::SMeshBuffer *createRandomBuffer(u32 count, std::mt19937 &rng)
+{
+	// far from the origin, as world meshes are
+	const core::vector3df origin(1000.f, -50.f, 300.f), extent(16.f, 8.f, 4.f);
+	std::uniform_real_distribution<f32> unit(0.f, 1.f), sym(-1.f, 1.f), uv(-4.f, 4.f);
+
+	scene::SMeshBuffer *buffer = new scene::SMeshBuffer();
+	for (u32 i = 0; i < count; ++i) {
+		const core::vector3df pos = origin + extent * core::vector3df(unit(rng), unit(rng), unit(rng));
+		core::vector3df normal;
+		do
+			normal.set(sym(rng), sym(rng), sym(rng));
+		while (normal.getLengthSQ() < 0.01f);
+		normal.normalize();
+		buffer->Vertices->Data.emplace_back(pos, normal, video::SColor(rng()), core::vector2df(uv(rng), uv(rng)), (u16)rng());
+	}
+	buffer->recalculateBoundingBox();
+	return buffer;
+}
+
+static void testBuffer(scene::IMeshManipulator *manipulator)
+{
+	std::mt19937 rng(34);
+	const u32 count = 10000;
+	scene::SMeshBuffer *buffer = createRandomBuffer(count, rng);
+
+	check(manipulator->quantizeVertices(buffer), "quantizing failed");
+	const QuantizedVertexBuffer *quantized = buffer->getVertexBuffer()->getQuantizedBuffer();
+	check(quantized && quantized->getCount() == count, "no compact copy");
+	check(quantized->isCurrent(buffer->getVertexBuffer()), "compact copy is outdated");
+
+	const core::matrix4 dequantize = quantized->getDequantizationMatrix();
+	const f32 step = quantized->size / 65535.f;
+	f32 maxPos = 0.f, maxAngle = 0.f, maxUV = 0.f;
+	for (u32 i = 0; i < count; ++i) {
+		const video::S3DVertex &v = buffer->Vertices->Data[i];
+		const video::S3DVertex d = quantized->decode(i);
+
+		const core::vector3df dp = d.Pos - v.Pos;
+		maxPos = core::max_(maxPos, core::max_(fabsf(dp.X), fabsf(dp.Y), fabsf(dp.Z)));
+
+		// the driver's view of the position
+		const QuantizedVertexBuffer::Vertex &q = quantized->vertices[i];
+		core::vector3df normalized(q.pos[0] / 65535.f, q.pos[1] / 65535.f, q.pos[2] / 65535.f);
+		dequantize.transformVect(normalized);
+		check(normalized.getDistanceFrom(d.Pos) < 1e-3f * step + 1e-4f, "dequantization matrix does not match");
+
+		core::vector3df normal = d.Normal;
+		normal.normalize();
+		maxAngle = core::max_(maxAngle, acosf(core::clamp(normal.dotProduct(v.Normal), -1.f, 1.f)) * core::RADTODEG);
+
+		const core::vector2df duv = d.TCoords - v.TCoords;
+		maxUV = core::max_(maxUV, fabsf(duv.X) / (fabsf(v.TCoords.X) + 1e-3f), fabsf(duv.Y) / (fabsf(v.TCoords.Y) + 1e-3f));
+
+		check(d.Color == v.Color && d.Aux == v.Aux, "color or aux changed");
+	}
+	std::printf("%u vertices: %u bytes instead of %u\n", count,
+			(u32)(quantized->getElementSize() * count), (u32)(sizeof(video::S3DVertex) * count));
+	std::printf("largest errors: position %.6f (step %.6f), normal %.3f degrees, texture coordinates %.6f relative\n",
+			maxPos, step, maxAngle, maxUV);
+
+	// half a step plus the float rounding of positions around 1000
+	check(maxPos <= step * 0.5f + 1e-4f, "position error too large");
+	check(maxAngle < 1.f, "normal error too large");
+	check(maxUV <= 1.f / 2048, "texture coordinate error too large");
+
+	buffer->setDirty(scene::EBT_VERTEX);
+	check(!quantized->isCurrent(buffer->getVertexBuffer()), "change of the vertices not noticed");
+	check(manipulator->quantizeVertices(buffer) && quantized->isCurrent(buffer->getVertexBuffer()), "quantizing again failed");
+
+	buffer->drop();
+}
+
+static void testUnsupported(scene::IMeshManipulator *manipulator)
+{
+	scene::SMeshBufferLightMap *lightmap = new scene::SMeshBufferLightMap();
+	lightmap->Vertices->Data.resize(3);
+	check(!manipulator->quantizeVertices(lightmap), "vertices with two texture coordinates quantized");
+	lightmap->drop();
+
+	scene::SMeshBuffer *skinned = new scene::SMeshBuffer();
+	skinned->Vertices->Data.resize(3);
+	skinned->Vertices->Weights.reset(new scene::WeightBuffer(3));
+	check(!manipulator->quantizeVertices(skinned), "skinned vertices quantized");
+	check(!skinned->getVertexBuffer()->getQuantizedBuffer(), "skinned vertices have a compact copy");
+	skinned->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	IrrlichtDevice *device = createNullDevice();
+	scene::IMeshManipulator *manipulator = device->getSceneManager()->getMeshManipulator();
+
+	testHalf();
+	testBuffer(manipulator);
+	testUnsupported(manipulator);
+	std::printf("All quantization checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+#include <irrlicht.h>
+#include <CMeshBuffer.h>
+#include <ICameraSceneNode.h>
+#include <IMeshSceneNode.h>
+#include <ISceneManager.h>
+#include <IVideoDriver.h>
+#include <SMesh.h>
+#include "test_utils.h"
+
+using namespace irr;
+
+// Checks that ISceneManager::addStaticBatchSceneNode() merges mesh scene
+// nodes per material into world space mesh buffers and only draws the
+// parts of it inside the view frustum.
+
+//! Unit quad in the XZ plane facing up
+static scene::SMesh *makeQuad()
+{
+	auto *mb = new scene::SMeshBuffer();
+	const video::SColor white(255, 255, 255, 255);
+	mb->Vertices->Data.emplace_back(0.f, 0.f, 0.f, 0.f, 1.f, 0.f, white, 0.f, 0.f);
+	mb->Vertices->Data.emplace_back(0.f, 0.f, 1.f, 0.f, 1.f, 0.f, white, 0.f, 1.f);
+	mb->Vertices->Data.emplace_back(1.f, 0.f, 1.f, 0.f, 1.f, 0.f, white, 1.f, 1.f);
+	mb->Vertices->Data.emplace_back(1.f, 0.f, 0.f, 0.f, 1.f, 0.f, white, 1.f, 0.f);
+	mb->Indices->Data = {0, 1, 2, 0, 2, 3};
+	mb->recalculateBoundingBox();
+
+	auto *mesh = new scene::SMesh();
+	mesh->addMeshBuffer(mb);
+	mesh->recalculateBoundingBox();
+	mb->drop();
+	return mesh;
+}
+
+static bool equals(const core::vector3df &a, const core::vector3df &b)
+{
+	return (a - b).getLength() < 0.001f;
+}
+
+static video::SFrameStats drawFrame(IrrlichtDevice *device)
+{
+	video::IVideoDriver *driver = device->getVideoDriver();
+	driver->beginScene();
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+	return driver->getFrameStats();
+}
+
+//! Nodes which the batch cannot draw completely stay as they are
+static void testLeftOut(scene::ISceneManager *smgr)
+{
+	scene::SMesh *quad = makeQuad();
+
+	// a triangle buffer together with a line buffer
+	scene::SMesh *mixed = makeQuad();
+	auto *lines = new scene::SMeshBuffer();
+	lines->Vertices->Data = static_cast<scene::SMeshBuffer *>(quad->getMeshBuffer(0))->Vertices->Data;
+	lines->Indices->Data = {0, 1, 1, 2};
+	lines->setPrimitiveType(scene::EPT_LINES);
+	lines->recalculateBoundingBox();
+	mixed->addMeshBuffer(lines);
+	lines->drop();
+
+	scene::SMesh *skinned = makeQuad();
+	static_cast<scene::SMeshBuffer *>(skinned->getMeshBuffer(0))->Vertices->Weights.reset(new scene::WeightBuffer(4));
+
+	std::vector<scene::IMeshSceneNode *> nodes = {
+		smgr->addMeshSceneNode(quad),
+		smgr->addMeshSceneNode(mixed),
+		smgr->addMeshSceneNode(skinned),
+		smgr->addMeshSceneNode(quad),
+	};
+	scene::ISceneNode *child = smgr->addMeshSceneNode(quad, nodes[3]);
+
+	scene::IMeshSceneNode *batch = smgr->addStaticBatchSceneNode(nodes);
+	check(batch->getMesh()->getMeshBufferCount() == 1, "wrong number of merged mesh buffers");
+	check(batch->getMesh()->getMeshBuffer(0)->getVertexCount() == 4, "a left out node merged");
+	check(!nodes[0]->isVisible(), "merged node still visible");
+	check(nodes[1]->isVisible(), "node with lines hidden");
+	check(nodes[2]->isVisible(), "skinned node hidden");
+	check(nodes[3]->isVisible() && child->isTrulyVisible(), "node with children hidden");
+
+	batch->remove();
+	for (auto *node : nodes)
+		node->remove();
+	quad->drop();
+	mixed->drop();
+	skinned->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	IrrlichtDevice *device = createNullDevice();
+	scene::ISceneManager *smgr = device->getSceneManager();
+
+	// 10x10 grid of quads, every fifth one with another material
+	const u32 gridSize = 10;
+	scene::SMesh *quad = makeQuad();
+	std::vector<scene::IMeshSceneNode *> nodes;
+	for (u32 z = 0; z < gridSize; ++z) {
+		for (u32 x = 0; x < gridSize; ++x) {
+			auto *node = smgr->addMeshSceneNode(quad, 0, -1,
+					core::vector3df(x * 10.f, 0.f, z * 10.f), core::vector3df(0, 0, 0),
+					core::vector3df(2.f, 1.f, 2.f));
+			if (nodes.size() % 5 == 4)
+				node->getMaterial(0).Wireframe = true;
+			nodes.push_back(node);
+		}
+	}
+	// rotated so that the quad faces along +Z
+	nodes[0]->setRotation(core::vector3df(90.f, 0.f, 0.f));
+	quad->drop();
+
+	scene::IMeshSceneNode *batch = smgr->addStaticBatchSceneNode(nodes);
+	check(batch != 0, "no batch node");
+	for (auto *node : nodes)
+		check(!node->isVisible(), "source node still visible");
+
+	scene::IMesh *mesh = batch->getMesh();
+	check(mesh->getMeshBufferCount() == 2, "wrong number of merged mesh buffers");
+	const scene::IMeshBuffer *solid = mesh->getMeshBuffer(0);
+	const scene::IMeshBuffer *wireframe = mesh->getMeshBuffer(1);
+	check(solid->getVertexCount() == 80 * 4 && solid->getIndexCount() == 80 * 6, "wrong size of first buffer");
+	check(wireframe->getVertexCount() == 20 * 4 && wireframe->getIndexCount() == 20 * 6, "wrong size of second buffer");
+	check(!solid->getMaterial().Wireframe && wireframe->getMaterial().Wireframe, "materials not kept");
+	check(solid->getVertexBuffer()->MappingHint == scene::EHM_STATIC, "batch not mapped as static");
+	check(solid->getIndexType() == video::EIT_16BIT, "16-bit indices expected with the null driver");
+
+	// vertices are in world space
+	check(equals(solid->getPosition(1), core::vector3df(0.f, -2.f, 0.f)), "rotated node not transformed");
+	check(equals(solid->getNormal(1), core::vector3df(0.f, 0.f, 1.f)), "rotated normal not transformed");
+	check(equals(solid->getPosition(6), core::vector3df(12.f, 0.f, 2.f)), "scaled node not transformed");
+	check(equals(solid->getNormal(6), core::vector3df(0.f, 1.f, 0.f)), "normal not normalized");
+	check(equals(wireframe->getPosition(2), core::vector3df(42.f, 0.f, 2.f)), "node of second buffer not transformed");
+	check(wireframe->getIndexBuffer()->getIndex(6) == 4, "indices not offset");
+
+	// the whole grid in view: one draw call per material
+	scene::ICameraSceneNode *camera = smgr->addCameraSceneNode(0,
+			core::vector3df(50.f, 200.f, 45.f), core::vector3df(50.f, 0.f, 50.f));
+	video::SFrameStats stats = drawFrame(device);
+	check(stats.Drawcalls == 2, "visible parts not drawn together");
+	check(stats.PrimitivesDrawn == 200, "not all triangles drawn");
+
+	// only a corner of the grid in view
+	camera->setPosition(core::vector3df(-5.f, 5.f, -5.f));
+	camera->setTarget(core::vector3df(0.f, 0.f, 0.f));
+	camera->setFarValue(30.f);
+	stats = drawFrame(device);
+	check(stats.PrimitivesDrawn > 0 && stats.PrimitivesDrawn < 40, "parts outside of the frustum not skipped");
+
+	// looking away from the grid
+	camera->setTarget(core::vector3df(-10.f, 5.f, -10.f));
+	stats = drawFrame(device);
+	check(stats.Drawcalls == 0, "batch drawn while out of view");
+
+	testLeftOut(smgr);
+	std::printf("All static batch checks passed\n");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
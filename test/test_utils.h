@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <irrlicht.h>
+
+// Helpers shared by the tests in this directory. A failed check throws, main()
+// catches it, prints the message and returns 1.
+
+//! Fails the test with the message unless the condition holds
+inline void check(bool condition, const char *message)
+{
+	if (!condition)
+		throw std::runtime_error(message);
+}
+
+//! Whether the test was started with "--bench", to time larger inputs
+inline bool isBenchmark(int argc, char *argv[])
+{
+	return argc > 1 && strcmp(argv[1], "--bench") == 0;
+}
+
+//! Creates a device with the null driver, throws if that fails
+inline irr::IrrlichtDevice *createNullDevice(irr::ELOG_LEVEL logLevel = irr::ELL_NONE)
+{
+	irr::SIrrlichtCreationParameters p;
+	p.DriverType = irr::video::EDT_NULL;
+	p.WindowSize = irr::core::dimension2du(640, 480);
+	p.LoggingLevel = logLevel;
+
+	irr::IrrlichtDevice *device = irr::createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+	return device;
+}
+
+//! Calls func repeats times, returns the average time of a call in milliseconds
+template <typename F>
+double measure(irr::u32 repeats, F &&func)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (irr::u32 i = 0; i < repeats; ++i)
+		func();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() * 1e3 / repeats;
+}